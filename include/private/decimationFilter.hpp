@@ -0,0 +1,56 @@
+#ifndef PRIVATE_DECIMATIONFILTER_HPP
+#define PRIVATE_DECIMATIONFILTER_HPP
+#include <vector>
+#include <string>
+#include <climits>
+#include <stdexcept>
+#include "rtseis/filterDesign/fir.hpp"
+#include "rtseis/filterRepresentations/fir.hpp"
+namespace
+{
+/// @brief Designs the Hamming window-based anti-alias filter used by the
+///        decimators.
+/// @param[in] downFactor         The downsampling factor.
+/// @param[in] filterLength       The desired filter length.
+/// @param[in] lRemovePhaseShift  If true then the filter length is
+///                               increased until the filter is odd and its
+///                               group delay is evenly divisible by the
+///                               downsampling factor.
+/// @param[out] groupDelay        The group delay when removing the phase
+///                               shift.  Otherwise, this is 0.
+/// @result The filter taps.
+[[maybe_unused]]
+std::vector<double> designDecimationFilter(const int downFactor,
+                                           const int filterLength,
+                                           const bool lRemovePhaseShift,
+                                           int *groupDelay)
+{
+    *groupDelay = 0;
+    int nfir = filterLength;
+    if (lRemovePhaseShift)
+    {
+        bool lfail = true;
+        for (auto k=0; k<INT_MAX-1; ++k)
+        {
+            int delay = (nfir-1)/2;
+            if (delay%downFactor == 0 && nfir%2 == 1)
+            {
+                lfail = false;
+                break;
+            }
+            nfir = nfir + 1;
+        }
+        if (lfail)
+        {
+            throw std::runtime_error("Padding algorithmic failure");
+        }
+        *groupDelay = nfir/2;
+    }
+    int order = nfir - 1;
+    auto r = 1.0/static_cast<double> (downFactor);
+    auto fir = RTSeis::FilterDesign::FIR::FIR1Lowpass(
+                   order, r, RTSeis::FilterDesign::FIRWindow::HAMMING);
+    return fir.getFilterTaps();
+}
+}
+#endif
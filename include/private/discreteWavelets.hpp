@@ -0,0 +1,209 @@
+#ifndef PRIVATE_DISCRETEWAVELETS_HPP
+#define PRIVATE_DISCRETEWAVELETS_HPP
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "rtseis/transforms/enums.hpp"
+namespace
+{
+/// The Daubechies scaling (reconstruction lowpass) filters of orders 1 to 10.
+/// The coefficients sum to sqrt(2).
+const double DAUBECHIES_1[2] = {
+    7.07106781186547524e-01, 7.07106781186547524e-01
+};
+const double DAUBECHIES_2[4] = {
+    4.82962913144534143e-01, 8.36516303737807906e-01, 2.24143868042013381e-01,
+    -1.29409522551260381e-01
+};
+const double DAUBECHIES_3[6] = {
+    3.32670552950082616e-01, 8.06891509311092576e-01, 4.59877502118491570e-01,
+    -1.35011020010254589e-01, -8.54412738820266617e-02, 3.52262918857095366e-02
+};
+const double DAUBECHIES_4[8] = {
+    2.30377813308896501e-01, 7.14846570552915647e-01, 6.30880767929858908e-01,
+    -2.79837694168598543e-02, -1.87034811719093084e-01, 3.08413818355607636e-02,
+    3.28830116668851997e-02, -1.05974017850690321e-02
+};
+const double DAUBECHIES_5[10] = {
+    1.60102397974192914e-01, 6.03829269797189670e-01, 7.24308528437772928e-01,
+    1.38428145901320731e-01, -2.42294887066382032e-01, -3.22448695846383747e-02,
+    7.75714938400457135e-02, -6.24149021279827427e-03, -1.25807519990819995e-02,
+    3.33572528547377128e-03
+};
+const double DAUBECHIES_6[12] = {
+    1.11540743350109464e-01, 4.94623890398453086e-01, 7.51133908021095351e-01,
+    3.15250351709197629e-01, -2.26264693965439820e-01, -1.29766867567261936e-01,
+    9.75016055873230491e-02, 2.75228655303057286e-02, -3.15820393174860296e-02,
+    5.53842201161496141e-04, 4.77725751094551064e-03, -1.07730108530847956e-03
+};
+const double DAUBECHIES_7[14] = {
+    7.78520540850091790e-02, 3.96539319481917307e-01, 7.29132090846235120e-01,
+    4.69782287405193122e-01, -1.43906003928564976e-01, -2.24036184993874983e-01,
+    7.13092192668302648e-02, 8.06126091510830719e-02, -3.80299369350144136e-02,
+    -1.65745416306668807e-02, 1.25509985560998406e-02, 4.29577972921366520e-04,
+    -1.80164070404749092e-03, 3.53713799974520248e-04
+};
+const double DAUBECHIES_8[16] = {
+    5.44158422431040100e-02, 3.12871590914299971e-01, 6.75630736297289807e-01,
+    5.85354683654206713e-01, -1.58291052563493057e-02, -2.84015542961546927e-01,
+    4.72484573913283142e-04, 1.28747426620478459e-01, -1.73693010018075461e-02,
+    -4.40882539307947515e-02, 1.39810279173982817e-02, 8.74609404740577672e-03,
+    -4.87035299345157431e-03, -3.91740373376947047e-04, 6.75449406450569367e-04,
+    -1.17476784124769534e-04
+};
+const double DAUBECHIES_9[18] = {
+    3.80779473638783466e-02, 2.43834674612590354e-01, 6.04823123690111112e-01,
+    6.57288078051300538e-01, 1.33197385825007576e-01, -2.93273783279174909e-01,
+    -9.68407832229764605e-02, 1.48540749338106380e-01, 3.07256814793333791e-02,
+    -6.76328290613299737e-02, 2.50947114831452007e-04, 2.23616621236790972e-02,
+    -4.72320475775139728e-03, -4.28150368246342983e-03, 1.84764688305622648e-03,
+    2.30385763523195967e-04, -2.51963188942710137e-04, 3.93473203162715995e-05
+};
+const double DAUBECHIES_10[20] = {
+    2.66700579005555536e-02, 1.88176800077691489e-01, 5.27201188931725586e-01,
+    6.88459039453603566e-01, 2.81172343660577460e-01, -2.49846424327315378e-01,
+    -1.95946274377377046e-01, 1.27369340335793262e-01, 9.30573646035723498e-02,
+    -7.13941471663970863e-02, -2.94575368218758133e-02, 3.32126740593410019e-02,
+    3.60655356695616958e-03, -1.07331754833305750e-02, 1.39535174705290116e-03,
+    1.99240529518505612e-03, -6.85856694959711626e-04, -1.16466855129285451e-04,
+    9.35886703200695913e-05, -1.32642028945212448e-05
+};
+/// The symlet scaling (reconstruction lowpass) filters of orders 2 to 10.
+/// The coefficients sum to sqrt(2).
+const double SYMLET_2[4] = {
+    4.82962913144534143e-01, 8.36516303737807906e-01, 2.24143868042013381e-01,
+    -1.29409522551260381e-01
+};
+const double SYMLET_3[6] = {
+    3.32670552950082616e-01, 8.06891509311092576e-01, 4.59877502118491570e-01,
+    -1.35011020010254589e-01, -8.54412738820266617e-02, 3.52262918857095366e-02
+};
+const double SYMLET_4[8] = {
+    3.22231006040514679e-02, -1.26039672620313038e-02, -9.92195435766335326e-02,
+    2.97857795605306051e-01, 8.03738751805132081e-01, 4.97618667632774990e-01,
+    -2.96355276460024918e-02, -7.57657147895022132e-02
+};
+const double SYMLET_5[10] = {
+    1.95388827352498268e-02, -2.11018340246890410e-02, -1.75328089908056224e-01,
+    1.66021057645108481e-02, 6.33978963456792064e-01, 7.23407690404040792e-01,
+    1.99397533976855597e-01, -3.91342493023138437e-02, 2.95194909257062612e-02,
+    2.73330683449987688e-02
+};
+const double SYMLET_6[12] = {
+    1.54041093270448243e-02, 3.49071208422216253e-03, -1.17990111148520025e-01,
+    -4.83117425856980550e-02, 4.91055941927973733e-01, 7.87641141028650996e-01,
+    3.37929421728165833e-01, -7.26375227863765834e-02, -2.10602925123708480e-02,
+    4.47249017707813847e-02, 1.76771186425400774e-03, -7.80070832503238041e-03
+};
+const double SYMLET_7[14] = {
+    2.29183395405377121e-03, -3.28329784746681070e-03, -1.81266051313384610e-02,
+    2.04642075775460337e-02, 4.47423494683523766e-02, -1.01010920868420299e-01,
+    -5.68044768896669693e-02, 4.83610915682267697e-01, 7.81921593291728125e-01,
+    3.60218460906260201e-01, -6.41312898073858211e-02, -6.49080035471884858e-02,
+    1.72133763008045029e-02, 1.20154192835491891e-02
+};
+const double SYMLET_8[16] = {
+    1.88995033276768918e-03, -3.02920514724133082e-04, -1.49522583370621991e-02,
+    3.80875201389448947e-03, 4.91371796737302868e-02, -2.72190299171034864e-02,
+    -5.19458381078818006e-02, 3.64441894836178936e-01, 7.77185751699628029e-01,
+    4.81359651259053392e-01, -6.12733590678110779e-02, -1.43294238351272663e-01,
+    7.60748732497660819e-03, 3.16950878115259914e-02, -5.42132331800010692e-04,
+    -3.38241595100500260e-03
+};
+const double SYMLET_9[18] = {
+    1.06949003290861192e-03, -4.73154498680043542e-04, -1.02640640276331205e-02,
+    8.85926749340026668e-03, 6.20777893028857476e-02, -1.82337707793955057e-02,
+    -1.91550831297284335e-01, 3.52724880352710426e-02, 6.17338449140934152e-01,
+    7.17897082764412404e-01, 2.38760914607305166e-01, -5.45689584308333511e-02,
+    5.83462746124981854e-04, 3.02248788582751881e-02, -1.15282102076791861e-02,
+    -1.32719677818171338e-02, 6.19780888985507083e-04, 1.40091552591465623e-03
+};
+const double SYMLET_10[20] = {
+    8.62578226225972429e-04, 7.15420542054339718e-04, -7.05676406258730422e-03,
+    5.95682783742519039e-04, 4.96861266469428817e-02, 2.62403650584489869e-02,
+    -1.21552105548548944e-01, -1.50192388391378596e-02, 5.13709873348026343e-01,
+    7.66954836560609563e-01, 3.40216013023462151e-01, -8.78787115119751343e-02,
+    -6.70899078083818020e-02, 3.38423546635752216e-02, -8.68752109689258277e-04,
+    -2.30054613534975098e-02, -1.14042979521732849e-03, 5.07164919853179902e-03,
+    3.40149266314809863e-04, -4.10115915804398334e-04
+};
+/// The coiflet scaling (reconstruction lowpass) filters of orders 1 to 4.
+/// The coefficients sum to sqrt(2).
+const double COIFLET_1[6] = {
+    -7.27326195125264480e-02, 3.37897662457481770e-01, 8.52572020211600420e-01,
+    3.84864846864857747e-01, -7.27326195125264480e-02, -1.56557281357919925e-02
+};
+const double COIFLET_2[12] = {
+    1.63873364632036808e-02, -4.14649367868718426e-02, -6.73725547237257186e-02,
+    3.86110066822763125e-01, 8.12723635449413591e-01, 4.17005184423238637e-01,
+    -7.64885990782806959e-02, -5.94344186464308128e-02, 2.36801719468476627e-02,
+    5.61143481936876549e-03, -1.82320887091099547e-03, -7.20549445520346944e-04
+};
+const double COIFLET_3[18] = {
+    -3.79351286438165248e-03, 7.78259642567423079e-03, 2.34526961420814742e-02,
+    -6.57719112814781048e-02, -6.11233900029805372e-02, 4.05176902409139475e-01,
+    7.93777222626092328e-01, 4.28483476377342653e-01, -7.17998216191518830e-02,
+    -8.23019271062804538e-02, 3.45550275732911838e-02, 1.58805448636624081e-02,
+    -9.00797613672691771e-03, -2.57451768813580635e-03, 1.11751877082992304e-03,
+    4.66216959820358991e-04, -7.09833025063939538e-05, -3.45997731972366961e-05
+};
+const double COIFLET_4[24] = {
+    8.92313902522541054e-04, -1.62949242520211822e-03, -7.34616793616589854e-03,
+    1.60689471313810013e-02, 2.66823046693077952e-02, -8.12667102485287811e-02,
+    -5.60773196031352651e-02, 4.15308426999387460e-01, 7.82238934424018293e-01,
+    4.34386033115919850e-01, -6.66274723669380333e-02, -9.62204245371472943e-02,
+    3.93344226059271647e-02, 2.50822533385128475e-02, -1.52117281879557298e-02,
+    -5.65828380028378645e-03, 3.75143469724362691e-03, 1.26656107894952086e-03,
+    -5.89020224651323427e-04, -2.59974337127156999e-04, 6.23388543146775519e-05,
+    3.12298616005477005e-05, -3.25964794032408585e-06, -1.78499091456567298e-06
+};
+/// @brief Gets the scaling filter of an orthogonal wavelet.
+/// @param[in] family  The wavelet family.
+/// @param[in] order   The order of the wavelet.  For Daubechies wavelets this
+///                    is the number of vanishing moments and is in the range
+///                    [1,10].  For symlets this is in the range [2,10].  For
+///                    coiflets this is in the range [1,4] and the filter has
+///                    2*order vanishing moments.
+/// @result The scaling filter h.  The wavelet filter is
+///         g[l] = (-1)^l h[L-1-l] where L is the filter length.
+/// @throws std::invalid_argument if the order is not supported.
+[[maybe_unused]]
+std::vector<double> getScalingFilter(
+    const RTSeis::Transforms::DiscreteWaveletFamily family,
+    const int order)
+{
+    if (family == RTSeis::Transforms::DiscreteWaveletFamily::DAUBECHIES)
+    {
+        if (order < 1 || order > 10)
+        {
+            throw std::invalid_argument("order = " + std::to_string(order)
+                                      + " must be in range [1,10]");
+        }
+        const double *h[10] = {DAUBECHIES_1, DAUBECHIES_2, DAUBECHIES_3,
+                               DAUBECHIES_4, DAUBECHIES_5, DAUBECHIES_6,
+                               DAUBECHIES_7, DAUBECHIES_8, DAUBECHIES_9,
+                               DAUBECHIES_10};
+        return std::vector<double> (h[order - 1], h[order - 1] + 2*order);
+    }
+    if (family == RTSeis::Transforms::DiscreteWaveletFamily::SYMLET)
+    {
+        if (order < 2 || order > 10)
+        {
+            throw std::invalid_argument("order = " + std::to_string(order)
+                                      + " must be in range [2,10]");
+        }
+        const double *h[9] = {SYMLET_2, SYMLET_3, SYMLET_4, SYMLET_5,
+                              SYMLET_6, SYMLET_7, SYMLET_8, SYMLET_9,
+                              SYMLET_10};
+        return std::vector<double> (h[order - 2], h[order - 2] + 2*order);
+    }
+    if (order < 1 || order > 4)
+    {
+        throw std::invalid_argument("order = " + std::to_string(order)
+                                  + " must be in range [1,4]");
+    }
+    const double *h[4] = {COIFLET_1, COIFLET_2, COIFLET_3, COIFLET_4};
+    return std::vector<double> (h[order - 1], h[order - 1] + 6*order);
+}
+}
+#endif
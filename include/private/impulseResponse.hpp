@@ -0,0 +1,60 @@
+#ifndef PRIVATE_IMPULSERESPONSE_HPP
+#define PRIVATE_IMPULSERESPONSE_HPP
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "rtseis/enums.hpp"
+#include "rtseis/filterRepresentations/sos.hpp"
+#include "rtseis/filterImplementations/sosFilter.hpp"
+namespace
+{
+/// @brief Estimates the number of samples after which the impulse response
+///        of an SOS filter has decayed to a negligible level.
+/// @param[in] sos        The second order sections filter.
+/// @param[in] tol        The impulse response is negligible once it falls
+///                       below tol times its peak amplitude.
+/// @param[in] maxLength  The maximum length to return.
+/// @result The effective length of the impulse response in samples.
+[[maybe_unused]]
+int estimateImpulseResponseLength(
+    const RTSeis::FilterRepresentations::SOS &sos,
+    const double tol = 1.e-10,
+    const int maxLength = 1 << 22)
+{
+    constexpr int blockSize = 4096;
+    RTSeis::FilterImplementations::SOSFilter
+        <RTSeis::ProcessingMode::REAL_TIME, double> filter;
+    auto ns = sos.getNumberOfSections();
+    auto bs = sos.getNumeratorCoefficients();
+    auto as = sos.getDenominatorCoefficients();
+    filter.initialize(ns, bs.data(), as.data());
+    std::vector<double> x(blockSize, 0);
+    std::vector<double> h(blockSize);
+    double *hptr = h.data();
+    x[0] = 1;
+    double hmax = 0;
+    int lastSignificant = 0;
+    for (int i0 = 0; i0 < maxLength; i0 = i0 + blockSize)
+    {
+        filter.apply(blockSize, x.data(), &hptr);
+        x[0] = 0;
+        for (int i = 0; i < blockSize; ++i)
+        {
+            hmax = std::max(hmax, std::abs(h[i]));
+        }
+        bool lsignificant = false;
+        for (int i = 0; i < blockSize; ++i)
+        {
+            if (std::abs(h[i]) > tol*hmax)
+            {
+                lastSignificant = i0 + i;
+                lsignificant = true;
+            }
+        }
+        if (!lsignificant){break;}
+    }
+    return std::min(maxLength, lastSignificant + 1);
+}
+}
+#endif
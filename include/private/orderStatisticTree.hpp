@@ -0,0 +1,194 @@
+#ifndef PRIVATE_ORDERSTATISTICTREE_HPP
+#define PRIVATE_ORDERSTATISTICTREE_HPP
+#include <cstdint>
+#include <vector>
+namespace
+{
+/// @brief A multiset of values that supports insertion, removal, and
+///        selection by rank in expected O(log n) time.  This is a treap whose
+///        nodes carry their subtree sizes.  The nodes live in arrays and
+///        removed nodes are recycled so a sliding window of fixed length does
+///        not allocate after it fills.
+class OrderStatisticTree
+{
+public:
+    /// @brief Reserves space for n values.
+    void reserve(const int n)
+    {
+        mValue.reserve(n);
+        mPriority.reserve(n);
+        mLeft.reserve(n);
+        mRight.reserve(n);
+        mSize.reserve(n);
+    }
+    /// @result The number of values in the tree.
+    [[nodiscard]] int size() const noexcept
+    {
+        return mRoot < 0 ? 0 : mSize[mRoot];
+    }
+    /// @brief Removes all values.
+    void clear() noexcept
+    {
+        mValue.clear();
+        mPriority.clear();
+        mLeft.clear();
+        mRight.clear();
+        mSize.clear();
+        mFree.clear();
+        mRoot =-1;
+    }
+    /// @brief Inserts a value.
+    void insert(const double value)
+    {
+        int node;
+        if (!mFree.empty())
+        {
+            node = mFree.back();
+            mFree.pop_back();
+        }
+        else
+        {
+            node = static_cast<int> (mValue.size());
+            mValue.push_back(0);
+            mPriority.push_back(0);
+            mLeft.push_back(-1);
+            mRight.push_back(-1);
+            mSize.push_back(1);
+        }
+        mValue[node] = value;
+        mPriority[node] = nextPriority();
+        mLeft[node] =-1;
+        mRight[node] =-1;
+        mSize[node] = 1;
+        int less, greaterEqual;
+        split(mRoot, value, &less, &greaterEqual);
+        mRoot = merge(merge(less, node), greaterEqual);
+    }
+    /// @brief Removes one copy of a value.
+    /// @result False indicates the value was not in the tree.
+    bool erase(const double value)
+    {
+        int less, greaterEqual;
+        split(mRoot, value, &less, &greaterEqual);
+        // The smallest value of the right tree is the candidate
+        int first, rest;
+        splitBySize(greaterEqual, 1, &first, &rest);
+        if (first < 0 || mValue[first] != value)
+        {
+            mRoot = merge(less, merge(first, rest));
+            return false;
+        }
+        mFree.push_back(first);
+        mRoot = merge(less, rest);
+        return true;
+    }
+    /// @param[in] k  The rank.  This must be in the range [0, size()).
+    /// @result The k'th smallest value.
+    [[nodiscard]] double select(int k) const
+    {
+        int node = mRoot;
+        while (true)
+        {
+            auto nLeft = mLeft[node] < 0 ? 0 : mSize[mLeft[node]];
+            if (k < nLeft)
+            {
+                node = mLeft[node];
+            }
+            else if (k == nLeft)
+            {
+                return mValue[node];
+            }
+            else
+            {
+                k = k - nLeft - 1;
+                node = mRight[node];
+            }
+        }
+    }
+private:
+    [[nodiscard]] int sizeOf(const int node) const noexcept
+    {
+        return node < 0 ? 0 : mSize[node];
+    }
+    void update(const int node) noexcept
+    {
+        mSize[node] = 1 + sizeOf(mLeft[node]) + sizeOf(mRight[node]);
+    }
+    /// Splits into values less than value and values at least value
+    void split(const int node, const double value, int *less,
+               int *greaterEqual)
+    {
+        if (node < 0)
+        {
+            *less =-1;
+            *greaterEqual =-1;
+            return;
+        }
+        if (mValue[node] < value)
+        {
+            split(mRight[node], value, &mRight[node], greaterEqual);
+            *less = node;
+        }
+        else
+        {
+            split(mLeft[node], value, less, &mLeft[node]);
+            *greaterEqual = node;
+        }
+        update(node);
+    }
+    /// Splits into the k smallest values and the rest
+    void splitBySize(const int node, const int k, int *first, int *rest)
+    {
+        if (node < 0)
+        {
+            *first =-1;
+            *rest =-1;
+            return;
+        }
+        auto nLeft = sizeOf(mLeft[node]);
+        if (k <= nLeft)
+        {
+            splitBySize(mLeft[node], k, first, &mLeft[node]);
+            *rest = node;
+        }
+        else
+        {
+            splitBySize(mRight[node], k - nLeft - 1, &mRight[node], rest);
+            *first = node;
+        }
+        update(node);
+    }
+    /// Merges two trees where all values of left precede those of right
+    int merge(const int left, const int right)
+    {
+        if (left < 0){return right;}
+        if (right < 0){return left;}
+        if (mPriority[left] > mPriority[right])
+        {
+            mRight[left] = merge(mRight[left], right);
+            update(left);
+            return left;
+        }
+        mLeft[right] = merge(left, mLeft[right]);
+        update(right);
+        return right;
+    }
+    /// xorshift
+    uint32_t nextPriority() noexcept
+    {
+        mSeed ^= mSeed << 13;
+        mSeed ^= mSeed >> 17;
+        mSeed ^= mSeed << 5;
+        return mSeed;
+    }
+    std::vector<double> mValue;
+    std::vector<uint32_t> mPriority;
+    std::vector<int> mLeft;
+    std::vector<int> mRight;
+    std::vector<int> mSize;
+    std::vector<int> mFree;
+    int mRoot =-1;
+    uint32_t mSeed = 2463534242;
+};
+}
+#endif
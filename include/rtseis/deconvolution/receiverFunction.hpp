@@ -0,0 +1,158 @@
+#ifndef RTSEIS_DECONVOLUTION_RECEIVERFUNCTION_HPP
+#define RTSEIS_DECONVOLUTION_RECEIVERFUNCTION_HPP 1
+#include <memory>
+#include <vector>
+namespace RTSeis::Deconvolution
+{
+/// @brief Defines the receiver function deconvolution.
+enum class ReceiverFunctionMethod
+{
+    WATER_LEVEL,          /*!< Frequency domain division where the
+                               denominator's power spectrum is clipped from
+                               below at a fraction of its maximum. */
+    ITERATIVE_TIME_DOMAIN /*!< The iterative time domain deconvolution of
+                               Ligorria and Ammon (1999) which builds the
+                               receiver function one spike at a time. */
+};
+
+/// @class ReceiverFunction receiverFunction.hpp "rtseis/deconvolution/receiverFunction.hpp"
+/// @brief Computes receiver functions by deconvolving the vertical component
+///        (the denominator) from the radial and transverse components (the
+///        numerators), e.g., after rotating with
+///        \c RTSeis::Rotate::northEastToRadialTransverse.  The receiver
+///        function is low-pass filtered with the Gaussian
+///        \f$ G(\omega) = e^{-\omega^2/(4 a^2)} \f$ scaled so that
+///        deconvolving a signal from itself gives a pulse with unit peak
+///        amplitude at the time shift.
+/// @note The denominator of each event is transformed once and shared by all
+///       of the event's numerators.  In the iterative method the
+///       cross-correlation of the residual and the denominator is not
+///       recomputed.  Removing a spike of amplitude \f$ a_k \f$ at lag
+///       \f$ \tau_k \f$ updates it with the denominator's autocorrelation
+///       \f$ c[\tau] \leftarrow c[\tau] - a_k A[\tau - \tau_k] \f$ and the
+///       residual energy with \f$ c[\tau_k]^2 / A[0] \f$ so each iteration
+///       is O(n).
+/// @note Events are deconvolved in parallel.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class ReceiverFunction
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    ReceiverFunction();
+    /// @brief Copy constructor.
+    /// @param[in] rf  The receiver function class from which to initialize
+    ///                this class.
+    ReceiverFunction(const ReceiverFunction &rf);
+    /// @brief Move constructor.
+    /// @param[in,out] rf  The receiver function class from which to
+    ///                    initialize this class.  On exit, rf's behavior is
+    ///                    undefined.
+    ReceiverFunction(ReceiverFunction &&rf) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] rf  The receiver function class to copy to this.
+    /// @result A deep copy of the receiver function class.
+    ReceiverFunction& operator=(const ReceiverFunction &rf);
+    /// @brief Move assignment operator.
+    /// @param[in,out] rf  The receiver function class whose memory will be
+    ///                    moved to this.  On exit, rf's behavior is undefined.
+    /// @result The memory from rf moved to this.
+    ReceiverFunction& operator=(ReceiverFunction &&rf) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~ReceiverFunction();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the receiver function deconvolution.
+    /// @param[in] nSamples       The number of samples in each signal.  This
+    ///                           must be at least 2.
+    /// @param[in] samplingRate   The sampling rate in Hz.
+    /// @param[in] method         The deconvolution method.
+    /// @param[in] gaussianWidth  The Gaussian width parameter a in 1/s.
+    /// @param[in] timeShift      The time in seconds at which a zero lag
+    ///                           arrival appears in the receiver function.
+    ///                           This must be in the range
+    ///                           [0, nSamples/samplingRate).
+    /// @param[in] waterLevel     The water level as a fraction of the
+    ///                           maximum of the denominator's power
+    ///                           spectrum.  This must be in the range (0,1]
+    ///                           and is only used by the water level method.
+    /// @param[in] maxIterations  The maximum number of spikes.  This is only
+    ///                           used by the iterative method.
+    /// @param[in] tolerance      The iterative method stops when a spike
+    ///                           improves the fit by less than this
+    ///                           fraction of the numerator's energy.
+    /// @throws std::invalid_argument if any argument is out of range.
+    void initialize(int nSamples,
+                    double samplingRate,
+                    ReceiverFunctionMethod method
+                        = ReceiverFunctionMethod::ITERATIVE_TIME_DOMAIN,
+                    double gaussianWidth = 2.5,
+                    double timeShift = 5,
+                    double waterLevel = 0.01,
+                    int maxIterations = 200,
+                    double tolerance = 1.e-5);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples in each signal.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfSamples() const;
+    /// @result The sampling rate in Hz.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getSamplingRate() const;
+    /// @result The deconvolution method.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] ReceiverFunctionMethod getMethod() const;
+    /// @}
+
+    /// @name Deconvolution
+    /// @{
+    /// @brief Computes the receiver functions.
+    /// @param[in] nEvents       The number of events.
+    /// @param[in] nSamples      The number of samples in each signal.  This
+    ///                          must equal \c getNumberOfSamples().
+    /// @param[in] nNumerators   The number of numerators of each event,
+    ///                          e.g., 2 for the radial and transverse
+    ///                          components.
+    /// @param[in] numerators    The numerators.  This is a row-major
+    ///                          [nEvents x nNumerators x nSamples] array.
+    /// @param[in] denominators  The denominators.  This is a row-major
+    ///                          [nEvents x nSamples] array.
+    /// @param[out] receiverFunctions  The receiver functions.  This is a
+    ///                                row-major
+    ///                                [nEvents x nNumerators x nSamples]
+    ///                                array.  If a denominator is zero then
+    ///                                its receiver functions are zero.
+    /// @throws std::invalid_argument if nEvents or nNumerators is not
+    ///         positive, nSamples is wrong, or an array is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int nEvents, int nSamples, int nNumerators,
+               const T numerators[], const T denominators[],
+               T *receiverFunctions[]);
+    /// @result The fraction of each Gaussian filtered numerator's energy that
+    ///         is predicted by convolving the denominator with the receiver
+    ///         function.  This is an [nEvents x nNumerators] row-major matrix
+    ///         from the last call to \c apply() and is empty before the
+    ///         first call.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<double> getFits() const;
+    /// @}
+private:
+    class ReceiverFunctionImpl;
+    std::unique_ptr<ReceiverFunctionImpl> pImpl;
+};
+}
+#endif
@@ -60,6 +60,31 @@ FIR1Bandpass(int order, const std::pair<double,double> &r,
 [[nodiscard]] RTSeis::FilterRepresentations::FIR
 FIR1Bandstop(int order, const std::pair<double,double> &r,
              FIRWindow window = FIRWindow::HAMMING);
+/// @brief Designs a linear-phase FIR filter that flattens the passband of a
+///        cascaded integrator-comb (CIC) decimator.  The filter runs at the
+///        CIC's output rate.  Its amplitude response is the inverse of the
+///        CIC's droop up to the passband edge, then falls to zero at the
+///        Nyquist frequency with a cosine taper.
+/// @param[in] order              Order of filter.  The number of taps is
+///                               order + 1.  This must be at least 4.
+/// @param[in] downFactor         The CIC's decimation factor.  This must be
+///                               positive.
+/// @param[in] nStages            The number of integrator and comb stages.
+///                               This must be positive.
+/// @param[in] differentialDelay  The comb's differential delay.  This must
+///                               be positive.
+/// @param[in] passband           The passband edge normalized such that 1 is
+///                               the Nyquist frequency of the CIC output.
+///                               This must be in the range (0,1) and less
+///                               than 2/differentialDelay where the CIC has
+///                               its first null.
+/// @result The compensation filter.  The filter is windowed with a Hamming
+///         window and normalized to unit gain at zero frequency.
+/// @throws std::invalid_argument if any arguments are incorrect.
+/// @ingroup rtseis_filterdesign_fir
+[[nodiscard]] RTSeis::FilterRepresentations::FIR
+CICCompensator(int order, int downFactor, int nStages,
+               int differentialDelay = 1, double passband = 0.75);
 /// @brief Designs an FIR Hilbert transform using a Kaiser window.
 ///@param[in] order  Order of the filter.  The number of taps is order + 1.
 ///                  If order is even then the real FIR filter will have one
@@ -0,0 +1,154 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_ADAPTIVEFILTER_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_ADAPTIVEFILTER_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/filterImplementations/enums.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class AdaptiveFilter adaptiveFilter.hpp "rtseis/filterImplementations/adaptiveFilter.hpp"
+/// @brief An adaptive noise canceller.  The noise on a primary channel,
+///        e.g., the tilt noise on an ocean bottom seismometer's vertical, is
+///        predicted from R reference channels, e.g., the horizontals and a
+///        differential pressure gauge, by the L tap filters \f$ w_r \f$ and
+///        removed:
+///        \f[
+///            e[n] = d[n] - \sum_{r=0}^{R-1} \sum_{j=0}^{L-1} w_r[j] u_r[n-j].
+///        \f]
+///        The filters are updated after every sample (NLMS, RLS) or every
+///        block of samples (block LMS) to minimize the power of the cleaned
+///        signal e.  This is a real-time filter; the references' histories
+///        and the weights carry over from packet to packet.
+/// @note Several independent stations can be cleaned at once.  Each channel
+///       has its own primary, references, and weights and the channels are
+///       processed in parallel.
+/// @note The RLS update stores the \f$ RL \times RL \f$ inverse correlation
+///       matrix of each channel so it is intended for short filters.
+/// @note The block LMS update filters with overlap-save transforms of length
+///       \f$ N \ge 2L \f$ and updates the weights every \f$ N - L + 1 \f$
+///       samples.  Samples that do not complete a block are filtered in the
+///       time domain with the current weights so there is no latency.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<class T = double>
+class AdaptiveFilter
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    AdaptiveFilter();
+    /// @brief Copy constructor.
+    /// @param[in] filter  The adaptive filter class from which to initialize
+    ///                    this class.
+    AdaptiveFilter(const AdaptiveFilter &filter);
+    /// @brief Move constructor.
+    /// @param[in,out] filter  The adaptive filter class from which to
+    ///                        initialize this class.  On exit, filter's
+    ///                        behavior is undefined.
+    AdaptiveFilter(AdaptiveFilter &&filter) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] filter  The adaptive filter class to copy to this.
+    /// @result A deep copy of the adaptive filter class.
+    AdaptiveFilter& operator=(const AdaptiveFilter &filter);
+    /// @brief Move assignment operator.
+    /// @param[in,out] filter  The adaptive filter class whose memory will be
+    ///                        moved to this.  On exit, filter's behavior is
+    ///                        undefined.
+    /// @result The memory from filter moved to this.
+    AdaptiveFilter& operator=(AdaptiveFilter &&filter) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~AdaptiveFilter();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the adaptive filter.
+    /// @param[in] nChannels         The number of primary channels.  This
+    ///                              must be positive.
+    /// @param[in] nReferences       The number of reference channels for
+    ///                              each primary channel.  This must be
+    ///                              positive.
+    /// @param[in] filterLength      The number of taps in each reference's
+    ///                              filter.  This must be positive.
+    /// @param[in] type              The weight update.
+    /// @param[in] stepSize          The step size \f$ \mu \f$ of the NLMS and
+    ///                              block LMS updates.  This must be in the
+    ///                              range (0,2).  Smaller steps converge more
+    ///                              slowly but have less misadjustment.
+    /// @param[in] forgettingFactor  The forgetting factor \f$ \lambda \f$ of
+    ///                              the RLS update.  This must be in the
+    ///                              range (0,1].  The RLS update's memory is
+    ///                              about \f$ 1/(1 - \lambda) \f$ samples.
+    /// @param[in] regularization    For the NLMS and block LMS updates this
+    ///                              is added to the references' energy before
+    ///                              dividing.  For the RLS update the inverse
+    ///                              correlation matrix starts as the
+    ///                              identity divided by this number.  This
+    ///                              must be non-negative and, for the RLS
+    ///                              update, positive.
+    /// @throws std::invalid_argument if any argument is out of range.
+    void initialize(int nChannels, int nReferences, int filterLength,
+                    AdaptiveFilterType type = AdaptiveFilterType::NLMS,
+                    double stepSize = 0.1,
+                    double forgettingFactor = 0.999,
+                    double regularization = 1.e-8);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of primary channels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @result The number of references of each channel.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfReferences() const;
+    /// @result The number of taps in each reference's filter.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getFilterLength() const;
+    /// @result The weight update.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] AdaptiveFilterType getType() const;
+    /// @}
+
+    /// @name Filtering
+    /// @{
+    /// @brief Removes the noise predicted by the references from the
+    ///        primary channels.
+    /// @param[in] nSamples     The number of samples in each signal.
+    /// @param[in] primary      The primary channels.  This is a row-major
+    ///                         [nChannels x nSamples] array.
+    /// @param[in] references   The reference channels.  This is a row-major
+    ///                         [nChannels x nReferences x nSamples] array.
+    /// @param[out] cleaned     The primary channels with the predicted noise
+    ///                         removed.  This is a row-major
+    ///                         [nChannels x nSamples] array.
+    /// @throws std::invalid_argument if an array is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int nSamples, const T primary[], const T references[],
+               T *cleaned[]);
+    /// @param[in] channel  The channel index.  This must be in the range
+    ///                     [0, \c getNumberOfChannels()).
+    /// @result The channel's current filters.  This is a row-major
+    ///         [nReferences x filterLength] matrix where entry [r, j] is
+    ///         \f$ w_r[j] \f$.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<double> getWeights(int channel) const;
+    /// @brief Zeros the weights and the references' histories.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class AdaptiveFilterImpl;
+    std::unique_ptr<AdaptiveFilterImpl> pImpl;
+};
+}
+#endif
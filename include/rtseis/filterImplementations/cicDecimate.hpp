@@ -0,0 +1,129 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_CICDECIMATE_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_CICDECIMATE_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/enums.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class CICDecimate cicDecimate.hpp "rtseis/filterImplementations/cicDecimate.hpp"
+/// @brief Decimates a signal with a cascaded integrator-comb (CIC) filter
+///        followed by a compensation FIR filter at the low rate.  The CIC
+///        uses only additions so the cost per input sample is the number
+///        of stages regardless of the downsampling factor.  The compensation
+///        filter flattens the CIC's passband droop and attenuates the band
+///        near the output Nyquist frequency where the CIC's alias rejection
+///        is weakest.
+/// @note The integrators are 64 bit integers with wrap-around arithmetic.
+///       Wrap-around in the integrators is undone exactly by the combs
+///       provided the output fits in the register.  The input is quantized
+///       with a power of two scale chosen from the maximum amplitude and the
+///       register growth \f$ N \log_2(R M) \f$ where N is the number of
+///       stages, R the downsampling factor, and M the differential delay.
+///       Samples exceeding the maximum amplitude are clipped.
+/// @note In post-processing mode every call to apply starts from zero state.
+///       The filter's delay is not removed.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::REAL_TIME,
+         class T = double>
+class CICDecimate
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    CICDecimate();
+    /// @brief Copy constructor.
+    /// @param[in] cic  The CIC decimator from which to initialize this class.
+    CICDecimate(const CICDecimate &cic);
+    /// @brief Move constructor.
+    /// @param[in,out] cic  The CIC decimator from which to initialize this
+    ///                     class.  On exit, cic's behavior is undefined.
+    CICDecimate(CICDecimate &&cic) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] cic  The CIC decimator to copy.
+    /// @result A deep copy of the input class.
+    CICDecimate& operator=(const CICDecimate &cic);
+    /// @brief Move assignment operator.
+    /// @param[in,out] cic  The CIC decimator whose memory will be moved to
+    ///                     this.  On exit, cic's behavior is undefined.
+    /// @result The memory from cic moved to this.
+    CICDecimate& operator=(CICDecimate &&cic) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~CICDecimate();
+    /// @brief Initializes the decimator.
+    /// @param[in] downFactor          The downsampling factor.  This must be
+    ///                                at least 2.
+    /// @param[in] nStages             The number of integrator and comb
+    ///                                stages.  This must be positive.
+    /// @param[in] differentialDelay   The comb's differential delay.  This
+    ///                                must be positive.
+    /// @param[in] compensationLength  The number of taps in the compensation
+    ///                                FIR filter.  This must be at least 5.
+    /// @param[in] passband            The passband edge of the compensation
+    ///                                filter normalized such that 1 is the
+    ///                                output Nyquist frequency.
+    /// @param[in] maxAmplitude        The largest expected absolute input
+    ///                                value, e.g., \f$ 2^{23} \f$ for 24 bit
+    ///                                digitizer counts.  This must be
+    ///                                positive.
+    /// @throws std::invalid_argument if any of the arguments are invalid or
+    ///         the register growth leaves fewer than 8 bits to represent
+    ///         the input.
+    void initialize(int downFactor,
+                    int nStages = 4,
+                    int differentialDelay = 1,
+                    int compensationLength = 31,
+                    double passband = 0.75,
+                    double maxAmplitude = 8388608);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The downsampling factor.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getDownsamplingFactor() const;
+    /// @result The number of integrator and comb stages.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfStages() const;
+    /// @result The compensation filter taps.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] std::vector<double> getCompensationFilterTaps() const;
+    /// @result The delay of the CIC and compensation filter in input
+    ///         samples.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] double getGroupDelay() const;
+    /// @brief Zeros the integrators, combs, and compensation filter and
+    ///        resets the downsampling phase.  This is useful after a gap.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions();
+    /// @brief Estimates the space required to hold the downsampled signal.
+    /// @param[in] n   The length of the signal to downsample.  This must
+    ///                be non-negative.
+    /// @result The number of points required to store the output signal.
+    /// @throws std::invalid_argument if n is negative.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int estimateSpace(int n) const;
+    /// @brief Decimates the signal.
+    /// @param[in] nx       The number of samples in x.
+    /// @param[in] x        The signal to decimate.  This has dimension [nx].
+    /// @param[in] ny       The maximum number of samples in y.  This must be
+    ///                     at least \c estimateSpace(nx).
+    /// @param[out] nyDown  The number of decimated samples in y.
+    /// @param[out] y       The decimated signal.  This has dimension [ny]
+    ///                     however only the first nyDown samples are defined.
+    /// @throws std::invalid_argument if x or y is NULL or ny is too small.
+    /// @throws std::runtime_error if the class is not initialized.
+    void apply(int nx, const T x[], int ny, int *nyDown, T *y[]);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class CICDecimateImpl;
+    std::unique_ptr<CICDecimateImpl> pImpl;
+};
+}
+#endif
@@ -6,6 +6,9 @@ namespace RTSeis::FilterImplementations
 {
 /// @class Decimate decimate.hpp "include/rtseis/filterImplementations/decimate.hpp"
 /// @brief Lowpass filters then downsamples a signal.
+/// @note The FIR filter is only evaluated at the retained samples so the
+///       cost is a factor of the downsampling factor less than filtering
+///       the signal at the full rate.
 /// @copyright Ben Baker distributed under the MIT license.
 /// @ingroup rtseis_filterImplemenations
 template<RTSeis::ProcessingMode E, class T = double>
@@ -37,5 +37,19 @@ enum DetrendType
     LINEAR    /*!< Removes a best fitting line from the time series. */
 };
 
+/// @brief Defines the adaptive filter's weight update.
+/// @ingroup rtseis_filterImplemenations
+enum class AdaptiveFilterType
+{
+    NLMS,      /*!< The normalized least mean squares update which costs
+                    O(L) per sample for L taps. */
+    BLOCK_LMS, /*!< The frequency domain block least mean squares update.
+                    The filtering and gradients are computed with FFTs once
+                    per block of about L samples.  This is advantageous for
+                    long filters. */
+    RLS        /*!< The recursive least squares update.  This converges
+                    quickly but costs O(L^2) per sample. */
+};
+
 }
 #endif
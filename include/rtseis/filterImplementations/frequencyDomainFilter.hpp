@@ -0,0 +1,112 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_FREQUENCYDOMAINFILTER_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_FREQUENCYDOMAINFILTER_HPP 1
+#include <memory>
+#include <array>
+namespace RTSeis::FilterRepresentations
+{
+class SOS;
+}
+namespace RTSeis::FilterImplementations
+{
+/// @class FrequencyDomainFilter frequencyDomainFilter.hpp "rtseis/filterImplementations/frequencyDomainFilter.hpp"
+/// @brief A post-processing zero-phase filter that is applied in the
+///        frequency domain.  The signal is zero-padded, Fourier transformed,
+///        multiplied by a real and non-negative gain, and inverse
+///        transformed.  Because the gain is real the filter does not shift
+///        the phase.  The gain is either the squared amplitude response
+///        \f$ |H(\omega)|^2 \f$ of an IIR filter, which matches a forward and
+///        backward (filtfilt) application of the filter, or a brick-wall
+///        bandpass whose edges are tapered with a cosine.
+/// @note The cost is dominated by two real transforms of length
+///       \f$ N \ge n + p \f$ where p is the pad length.  Hence, for long
+///       traces this can be much cheaper than filtering in the time domain.
+///       The transforms use the library's FFT backend which may be threaded.
+/// @note The pad suppresses wrap-around.  For the IIR gain the result is
+///       then the linear zero-phase convolution of the signal with the
+///       autocorrelation of the impulse response.  This agrees with the time
+///       domain filtfilt away from the end of the trace; filtfilt starts its
+///       backward pass from the truncated forward output so the two differ
+///       over the last few impulse response lengths.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<class T = double>
+class FrequencyDomainFilter
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    FrequencyDomainFilter();
+    /// @brief Copy constructor.
+    /// @param[in] filter  The frequency domain filter class from which to
+    ///                    initialize this class.
+    FrequencyDomainFilter(const FrequencyDomainFilter &filter);
+    /// @brief Move constructor.
+    /// @param[in,out] filter  The frequency domain filter class from which to
+    ///                        initialize this class.  On exit, filter's
+    ///                        behavior is undefined.
+    FrequencyDomainFilter(FrequencyDomainFilter &&filter) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] filter  The frequency domain filter class to copy.
+    /// @result A deep copy of the input class.
+    FrequencyDomainFilter& operator=(const FrequencyDomainFilter &filter);
+    /// @brief Move assignment operator.
+    /// @param[in,out] filter  The frequency domain filter class whose memory
+    ///                        will be moved to this.  On exit, filter's
+    ///                        behavior is undefined.
+    /// @result The memory from filter moved to this.
+    FrequencyDomainFilter& operator=(FrequencyDomainFilter &&filter) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~FrequencyDomainFilter();
+
+    /// @brief Initializes the filter from the squared amplitude response
+    ///        of a second order sections filter.
+    /// @param[in] sos        The second order sections filter.
+    /// @param[in] padLength  The number of zeros appended to the signal prior
+    ///                       to transforming.  If this is negative then the
+    ///                       pad is the length of the filter's impulse
+    ///                       response.
+    /// @throws std::invalid_argument if the filter has no sections.
+    void initialize(const RTSeis::FilterRepresentations::SOS &sos,
+                    int padLength =-1);
+    /// @brief Initializes a bandpass filter with cosine tapered edges.
+    /// @param[in] corners    The corner frequencies normalized such that 1 is
+    ///                       the Nyquist frequency.  The gain is 0 below
+    ///                       corners[0], rises to 1 at corners[1], is 1
+    ///                       until corners[2], and falls to 0 at corners[3].
+    ///                       These must satisfy
+    ///                       \f$ 0 \le c_0 \le c_1 \le c_2 \le c_3 \le 1 \f$
+    ///                       and \f$ c_1 < c_2 \f$.
+    /// @param[in] padLength  The number of zeros appended to the signal prior
+    ///                       to transforming.  If this is negative then the
+    ///                       pad is set from the narrowest taper.
+    /// @throws std::invalid_argument if the corners are invalid.
+    void initialize(const std::array<double, 4> &corners,
+                    int padLength =-1);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The pad length for a signal of length n.
+    /// @param[in] n  The number of samples in the signal.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getPadLength(int n) const;
+    /// @brief Filters the signal.
+    /// @param[in] n   The number of points in the signal.
+    /// @param[in] x   The input signal to filter.  This has dimension [n].
+    /// @param[out] y  The filtered signal.  This has dimension [n].
+    /// @throws std::invalid_argument if x or y is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void apply(int n, const T x[], T *y[]);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class FrequencyDomainFilterImpl;
+    std::unique_ptr<FrequencyDomainFilterImpl> pImpl;
+};
+}
+#endif
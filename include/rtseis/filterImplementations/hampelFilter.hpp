@@ -0,0 +1,124 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_HAMPELFILTER_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_HAMPELFILTER_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/enums.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class HampelFilter hampelFilter.hpp "rtseis/filterImplementations/hampelFilter.hpp"
+/// @brief Removes spikes and glitches with the Hampel filter.  For each
+///        sample the median m and the median absolute deviation (MAD) of the
+///        centered window of k samples are computed.  If
+///        \f$ |x - m| > t \cdot 1.4826 \cdot MAD \f$ then the sample is an
+///        outlier and is replaced by m.  All other samples pass through
+///        unchanged.
+/// @note The window is kept in an order statistic tree so that each new
+///       sample costs \f$ O(\log k) \f$ to insert and remove and the median
+///       is an \f$ O(\log k) \f$ rank query.  The MAD is the k/2'th smallest
+///       deviation; the deviations below and above the median are two sorted
+///       sequences of the tree so the MAD is found with \f$ O(\log k) \f$
+///       rank queries.  Nothing is re-sorted.
+/// @note In real-time mode the output is delayed by \c getGroupDelay() = k/2
+///       samples so the first k/2 outputs of the stream are zero.  The next
+///       k/2 outputs are the first k/2 input samples, which pass through
+///       since their window is incomplete.  In post-processing mode the
+///       output is not delayed and the first and last k/2 samples pass
+///       through.
+/// @note Samples that are not finite, e.g., NaNs from a digitizer glitch,
+///       are always outliers.  They are kept out of the tree and replaced by
+///       the median of the window's finite samples, or zero if there are
+///       none.  This includes samples that would otherwise pass through.
+///       The other samples are tested against the median and MAD of the
+///       window's finite samples.
+/// @note If more than half the window is one value then the MAD is zero and
+///       any sample that differs from the median is an outlier.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class HampelFilter
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    HampelFilter();
+    /// @brief Copy constructor.
+    /// @param[in] hampel  The Hampel filter class from which to initialize
+    ///                    this class.
+    HampelFilter(const HampelFilter &hampel);
+    /// @brief Move constructor.
+    /// @param[in,out] hampel  The Hampel filter class from which to
+    ///                        initialize this class.  On exit, hampel's
+    ///                        behavior is undefined.
+    HampelFilter(HampelFilter &&hampel) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] hampel  The Hampel filter class to copy to this.
+    /// @result A deep copy of the Hampel filter class.
+    HampelFilter& operator=(const HampelFilter &hampel);
+    /// @brief Move assignment operator.
+    /// @param[in,out] hampel  The Hampel filter class whose memory will be
+    ///                        moved to this.  On exit, hampel's behavior is
+    ///                        undefined.
+    /// @result The memory from hampel moved to this.
+    HampelFilter& operator=(HampelFilter &&hampel) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~HampelFilter();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the Hampel filter.
+    /// @param[in] windowLength  The number of samples in the window.  This
+    ///                          must be at least 3.  If it is not odd then it
+    ///                          will be increased by 1.
+    /// @param[in] threshold     The number of scaled MADs that a sample must
+    ///                          deviate from the median to be an outlier.
+    ///                          This must be non-negative.
+    /// @throws std::invalid_argument if any argument is out of range.
+    void initialize(int windowLength, double threshold = 3);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples in the window.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getWindowLength() const;
+    /// @result The number of samples by which the real-time output lags the
+    ///         input.  This is zero for post-processing.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getGroupDelay() const;
+    /// @}
+
+    /// @name Filtering
+    /// @{
+    /// @brief Removes the outliers.
+    /// @param[in] n   The number of samples.
+    /// @param[in] x   The signal.  This is an array whose dimension is [n].
+    /// @param[out] y  The signal with the outliers replaced.  This is an array
+    ///                whose dimension is [n].
+    /// @throws std::invalid_argument if n is positive and x or y is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int n, const T x[], T *y[]);
+    /// @result The indices of the output samples from the last call to
+    ///         \c apply() that were replaced.  These are in increasing order.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<int> getFlaggedSamples() const;
+    /// @brief Empties the window.  This is useful when dealing with a gap.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class HampelFilterImpl;
+    std::unique_ptr<HampelFilterImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,143 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_MULTICHANNELDECIMATE_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_MULTICHANNELDECIMATE_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class MultiChannelDecimate multiChannelDecimate.hpp "rtseis/filterImplementations/multiChannelDecimate.hpp"
+/// @brief Lowpass filters then downsamples many channels that share a
+///        downsampling factor and anti-alias filter.  This is equivalent to
+///        running a \c Decimate on each channel but the channels are
+///        interleaved sample-by-sample in a workspace so that the polyphase
+///        filter is vectorized across channels.
+/// @note Only the filter taps and, for each channel, a downsampling phase
+///       and a delay line of filter order samples are stored.  The channels
+///       receive packets of the same length but a channel can be reset on
+///       its own, e.g., after a gap, so the channels' phases may differ.
+///       Channels that share a phase are filtered together and the common
+///       case of a single phase is vectorized over contiguous channels.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::REAL_TIME,
+         class T = double>
+class MultiChannelDecimate
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    MultiChannelDecimate();
+    /// @brief Copy constructor.
+    /// @param[in] decimate  The multichannel decimator from which to
+    ///                      initialize this class.
+    MultiChannelDecimate(const MultiChannelDecimate &decimate);
+    /// @brief Move constructor.
+    /// @param[in,out] decimate  The multichannel decimator from which to
+    ///                          initialize this class.  On exit, decimate's
+    ///                          behavior is undefined.
+    MultiChannelDecimate(MultiChannelDecimate &&decimate) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] decimate  The multichannel decimator to copy.
+    /// @result A deep copy of the input class.
+    MultiChannelDecimate& operator=(const MultiChannelDecimate &decimate);
+    /// @brief Move assignment operator.
+    /// @param[in,out] decimate  The multichannel decimator whose memory will
+    ///                          be moved to this.  On exit, decimate's
+    ///                          behavior is undefined.
+    /// @result The memory from decimate moved to this.
+    MultiChannelDecimate& operator=(MultiChannelDecimate &&decimate) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~MultiChannelDecimate();
+    /// @brief Initializes the decimator bank.
+    /// @param[in] nChannels          The number of channels.  This must be
+    ///                               positive.
+    /// @param[in] downFactor         The downsampling factor.  This must be
+    ///                               at least 2.
+    /// @param[in] filterLength       The length of the FIR filter.  This must
+    ///                               be at least 5.
+    /// @param[in] lRemovePhaseShift  If true then this will remove the phase
+    ///                               shift introduced by the FIR filter.
+    ///                               This is relevant when post-processing.
+    /// @throws std::invalid_argument if any of the arguments are invalid.
+    /// @note The filter is designed exactly as in \c Decimate so each
+    ///       channel's output matches that of \c Decimate.
+    void initialize(int nChannels, int downFactor,
+                    int filterLength = 30,
+                    bool lRemovePhaseShift = true);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @result The downsampling factor.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getDownsamplingFactor() const;
+    /// @result The number of FIR filter coefficients.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getFIRFilterLength() const;
+    /// @result The length of the initial condition array which is the
+    ///         number of channels times the filter order.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getInitialConditionLength() const;
+    /// @brief Sets the initial conditions for the decimator bank.
+    /// @param[in] nz   The initial condition length.  This must equal
+    ///                 \c getInitialConditionLength().
+    /// @param[in] zi   The initial conditions.  This is a row-major
+    ///                 [nChannels x (filterLength - 1)] matrix whose rows
+    ///                 hold the previous input samples of each channel in
+    ///                 chronological order.
+    /// @throws std::invalid_argument if nz is invalid or zi is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void setInitialConditions(int nz, const double zi[]);
+    /// @brief Resets the delay lines and downsampling phases to the initial
+    ///        conditions set by \c setInitialConditions() or zero.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions();
+    /// @brief Resets a channel's delay line and downsampling phase to the
+    ///        initial conditions set by \c setInitialConditions() or zero.
+    ///        The other channels continue undisturbed.  This is useful after
+    ///        a gap in one channel.
+    /// @param[in] channel  The channel index.  This must be in the range
+    ///                     [0, \c getNumberOfChannels()).
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions(int channel);
+    /// @brief Estimates the space required to hold each channel's
+    ///        downsampled signal.
+    /// @param[in] n   The number of samples in each channel.  This must be
+    ///                non-negative.
+    /// @result The largest number of output samples of any channel.
+    /// @throws std::invalid_argument if n is negative.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int estimateSpace(int n) const;
+    /// @brief Decimates the channels.
+    /// @param[in] nSamples  The number of samples in each channel.
+    /// @param[in] x         The signals to decimate.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @param[in] ny        The leading dimension of y.  This must be at
+    ///                      least \c estimateSpace(nSamples).
+    /// @param[out] nyDown   The number of decimated samples in each channel.
+    ///                      This is an array whose dimension is [nChannels].
+    ///                      Channels with different phases may differ by
+    ///                      one sample.
+    /// @param[out] y        The decimated signals.  This is a row-major
+    ///                      [nChannels x ny] matrix of which only the first
+    ///                      nyDown[c] columns of row c are defined.
+    /// @throws std::invalid_argument if x, nyDown, or y is NULL or ny is too
+    ///         small.
+    /// @throws std::runtime_error if the class is not initialized.
+    void apply(int nSamples, const T x[], int ny, int *nyDown[], T *y[]);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class MultiChannelDecimateImpl;
+    std::unique_ptr<MultiChannelDecimateImpl> pImpl;
+};
+}
+#endif
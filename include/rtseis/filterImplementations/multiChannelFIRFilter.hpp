@@ -0,0 +1,103 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_MULTICHANNELFIRFILTER_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_MULTICHANNELFIRFILTER_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class MultiChannelFIRFilter multiChannelFIRFilter.hpp "rtseis/filterImplementations/multiChannelFIRFilter.hpp"
+/// @brief Applies the same FIR filter to many channels.  The channels are
+///        laid out as a (channels x time) matrix and the filtering is
+///        computed as a sequence of matrix-matrix products with a
+///        Toeplitz matrix of the filter taps.  This moves the work from
+///        many memory-bound single-channel filters into a compute-bound
+///        level 3 BLAS call.
+/// @note The delay lines of all channels are stored contiguously so that
+///       the state touched by a packet stays in cache across channels.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class MultiChannelFIRFilter
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    MultiChannelFIRFilter();
+    /// @brief Copy constructor.
+    /// @param[in] fir   Multichannel FIR class from which to initialize.
+    MultiChannelFIRFilter(const MultiChannelFIRFilter &fir);
+    /// @brief Move constructor.
+    /// @param[in,out] fir  Multichannel FIR class from which to initialize
+    ///                     this class.  On exit, fir's behavior is undefined.
+    MultiChannelFIRFilter(MultiChannelFIRFilter &&fir) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] fir   Multichannel FIR class to copy.
+    /// @result A deep copy of the input class.
+    MultiChannelFIRFilter& operator=(const MultiChannelFIRFilter &fir);
+    /// @brief Move assignment operator.
+    /// @param[in,out] fir  Multichannel FIR class whose memory will be moved
+    ///                     to this.  On exit, fir's behavior is undefined.
+    /// @result The memory from fir moved to this.
+    MultiChannelFIRFilter& operator=(MultiChannelFIRFilter &&fir) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~MultiChannelFIRFilter();
+    /// @brief Initializes the filter bank.
+    /// @param[in] nChannels  The number of channels.  This must be positive.
+    /// @param[in] nb         The number of filter taps.  This must be
+    ///                       positive.
+    /// @param[in] b          The filter taps.  This is an array of
+    ///                       dimension [nb].
+    /// @param[in] blockSize  The number of output samples computed by each
+    ///                       matrix-matrix product.  If this is not positive
+    ///                       then it is chosen from the filter length.
+    /// @throws std::invalid_argument if any of the arguments are invalid.
+    void initialize(int nChannels, int nb, const double b[],
+                    int blockSize = 0);
+    /// @result True indicates that the module is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @result The length of the initial condition array which is the
+    ///         number of channels times the filter order.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getInitialConditionLength() const;
+    /// @brief Sets the initial conditions for the filter bank.
+    /// @param[in] nz   The initial condition length.  This must equal
+    ///                 \c getInitialConditionLength().
+    /// @param[in] zi   The initial conditions.  This is a row-major
+    ///                 [nChannels x (nb - 1)] matrix whose rows hold the
+    ///                 previous nb - 1 input samples of each channel in
+    ///                 chronological order.
+    /// @throws std::invalid_argument if nz is invalid or zi is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void setInitialConditions(int nz, const double zi[]);
+    /// @brief Resets the filter bank to the initial conditions set by
+    ///        \c setInitialConditions() or zero.  This is useful after
+    ///        a gap.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions();
+    /// @brief Filters the channels.
+    /// @param[in] nSamples  The number of samples in each channel.
+    /// @param[in] x         The signals to filter.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @param[out] y        The filtered signals.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @throws std::invalid_argument if x or y is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void apply(int nSamples, const T x[], T *y[]);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class MultiChannelFIRFilterImpl;
+    std::unique_ptr<MultiChannelFIRFilterImpl> pImpl;
+};
+}
+#endif
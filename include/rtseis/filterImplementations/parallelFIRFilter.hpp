@@ -0,0 +1,114 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_PARALLELFIRFILTER_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_PARALLELFIRFILTER_HPP 1
+#include <memory>
+#include "rtseis/filterImplementations/enums.hpp"
+#include "rtseis/utilities/math/convolve.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class ParallelFIRFilter parallelFIRFilter.hpp "rtseis/filterImplementations/parallelFIRFilter.hpp"
+/// @brief A post-processing FIR filter that splits long signals into blocks
+///        and filters the blocks concurrently.  Each block is extended
+///        backwards by a halo of nb - 1 input samples so that the blocks
+///        can be filtered independently with a zero initial state and
+///        written to disjoint parts of the output.
+/// @note The partition is set by the block size and not by the number of
+///       threads.  Hence, with the direct implementation and a given block
+///       size, the result is bit-for-bit identical for any number of
+///       threads, including one thread.
+/// @note The result is not bit-for-bit identical to that of a serial
+///       \c FIRFilter.  Each block is filtered from a zero state by IPP,
+///       whose summation order near the start of a buffer may differ from
+///       that of the unblocked filter.  The direct implementation agrees
+///       with the serial filter to within rounding.  The FFT implementation
+///       agrees only to the FFT's rounding and its result may change with
+///       the block size.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<class T = double>
+class ParallelFIRFilter
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    ParallelFIRFilter();
+    /// @brief Copy constructor.
+    /// @param[in] fir   Parallel FIR class from which to initialize.
+    ParallelFIRFilter(const ParallelFIRFilter &fir);
+    /// @brief Move constructor.
+    /// @param[in,out] fir  Parallel FIR class from which to initialize this
+    ///                     class.  On exit, fir's behavior is undefined.
+    ParallelFIRFilter(ParallelFIRFilter &&fir) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] fir   Parallel FIR class to copy.
+    /// @result A deep copy of the input class.
+    ParallelFIRFilter& operator=(const ParallelFIRFilter &fir);
+    /// @brief Move assignment operator.
+    /// @param[in,out] fir  Parallel FIR class whose memory will be moved to
+    ///                     this.  On exit, fir's behavior is undefined.
+    /// @result The memory from fir moved to this.
+    ParallelFIRFilter& operator=(ParallelFIRFilter &&fir) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~ParallelFIRFilter();
+    /// @brief Initializes the FIR filter.
+    /// @param[in] nb   The number of filter coefficients.  This must be
+    ///                 positive.
+    /// @param[in] b    The filter coefficients.  This is an array of
+    ///                 dimension [nb].
+    /// @param[in] blockSize  The number of output samples computed by a
+    ///                       worker at a time.  This must be positive.
+    /// @param[in] implementation  The FIR filter implementation applied to
+    ///                            each block.
+    /// @throws std::invalid_argument if nb, b, or blockSize is invalid.
+    void initialize(int nb, const double b[],
+                    int blockSize = 65536,
+                    FIRImplementation implementation = FIRImplementation::DIRECT);
+    /// @result True indicates that the module is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @brief Sets the number of worker threads.
+    /// @param[in] nThreads  The number of threads.  If this is 0 then the
+    ///                      OpenMP default is used.
+    /// @throws std::invalid_argument if nThreads is negative.
+    void setNumberOfThreads(int nThreads);
+    /// @result The number of worker threads.  0 indicates the OpenMP default.
+    [[nodiscard]] int getNumberOfThreads() const noexcept;
+    /// @result The block size.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getBlockSize() const;
+    /// @brief Applies the FIR filter to the data.  The result is that of
+    ///        \c FIRFilter in post-processing mode.
+    /// @param[in] n   The number of points in the signal.
+    /// @param[in] x   The input signal to filter.  This has dimension [n].
+    /// @param[out] y  The filtered signal.  This has dimension [n].
+    /// @throws std::invalid_argument if x or y is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void apply(int n, const T x[], T *y[]);
+    /// @brief Convolves the signal with the filter coefficients.
+    /// @param[in] n     The number of points in the signal.
+    /// @param[in] x     The signal.  This has dimension [n].
+    /// @param[in] maxy  The maximum number of samples y can hold.  This must
+    ///                  be at least
+    ///                  Convolve::computeConvolutionLength(n, nb, mode).
+    /// @param[out] ny   The number of samples in y.
+    /// @param[out] y    The convolution of x and b.  This has dimension
+    ///                  [maxy] however only the first ny samples are defined.
+    /// @param[in] mode  Defines the convolution output.
+    /// @throws std::invalid_argument if any arguments are invalid.
+    /// @throws std::runtime_error if the class is not initialized.
+    void convolve(int n, const T x[], int maxy, int *ny, T *y[],
+                  Utilities::Math::Convolve::Mode mode
+                      = Utilities::Math::Convolve::Mode::FULL);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class ParallelFIRFilterImpl;
+    std::unique_ptr<ParallelFIRFilterImpl> pImpl;
+};
+}
+#endif
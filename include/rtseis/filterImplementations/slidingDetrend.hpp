@@ -0,0 +1,96 @@
+#ifndef RTSEIS_FILTERIMPLEMENTATIONS_SLIDINGDETREND_HPP
+#define RTSEIS_FILTERIMPLEMENTATIONS_SLIDINGDETREND_HPP 1
+#include <memory>
+#include "rtseis/filterImplementations/enums.hpp"
+namespace RTSeis::FilterImplementations
+{
+/// @class SlidingDetrend slidingDetrend.hpp "rtseis/filterImplementations/slidingDetrend.hpp"
+/// @brief A real-time module that removes the mean or linear trend of the
+///        last W samples from each sample.  For sample n the mean or best
+///        fitting line is computed from samples n - W + 1, ..., n and is
+///        evaluated at n.  Until W samples have been seen the fit uses all
+///        the samples received since the last reset.
+/// @note The fit is updated with running sums of \f$ \sum x \f$ and
+///       \f$ \sum t x \f$ so each sample costs O(1) regardless of W.  The
+///       sums of t and \f$ t^2 \f$ are analytic.  To keep round-off from
+///       accumulating, the sums are recomputed from the window every W
+///       samples after re-centering the data on the window's mean, which
+///       also removes large offsets before they enter the sums.
+/// @note Many channels can be processed in one call.  The channels share a
+///       window length and detrend type but have independent state.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_filterImplemenations
+template<class T = double>
+class SlidingDetrend
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    SlidingDetrend();
+    /// @brief Copy constructor.
+    /// @param[in] detrend  The sliding detrend class from which to initialize
+    ///                     this class.
+    SlidingDetrend(const SlidingDetrend &detrend);
+    /// @brief Move constructor.
+    /// @param[in,out] detrend  The sliding detrend class from which to
+    ///                         initialize this class.  On exit, detrend's
+    ///                         behavior is undefined.
+    SlidingDetrend(SlidingDetrend &&detrend) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] detrend  The sliding detrend class to copy.
+    /// @result A deep copy of the input class.
+    SlidingDetrend& operator=(const SlidingDetrend &detrend);
+    /// @brief Move assignment operator.
+    /// @param[in,out] detrend  The sliding detrend class whose memory will be
+    ///                         moved to this.  On exit, detrend's behavior is
+    ///                         undefined.
+    /// @result The memory from detrend moved to this.
+    SlidingDetrend& operator=(SlidingDetrend &&detrend) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~SlidingDetrend();
+    /// @brief Initializes the class.
+    /// @param[in] windowLength  The number of samples in the sliding window.
+    ///                          This must be positive.
+    /// @param[in] type          Defines whether the mean or linear trend is
+    ///                          removed.
+    /// @param[in] nChannels     The number of channels.  This must be
+    ///                          positive.
+    /// @throws std::invalid_argument if any of the arguments are invalid.
+    void initialize(int windowLength,
+                    DetrendType type = DetrendType::LINEAR,
+                    int nChannels = 1);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples in the sliding window.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getWindowLength() const;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @brief Empties the sliding windows.  This is useful after a gap.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions();
+    /// @brief Removes the sliding mean or trend from the next packet.
+    /// @param[in] nSamples  The number of samples in each channel.
+    /// @param[in] x         The signals.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @param[out] y        The demeaned or detrended signals.  This is a
+    ///                      row-major [nChannels x nSamples] matrix.
+    /// @throws std::invalid_argument if x or y is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void apply(int nSamples, const T x[], T *y[]);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class SlidingDetrendImpl;
+    std::unique_ptr<SlidingDetrendImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,157 @@
+#ifndef RTSEIS_POSTPROCESSING_SC_CHUNKEDWAVEFORM_HPP
+#define RTSEIS_POSTPROCESSING_SC_CHUNKEDWAVEFORM_HPP 1
+#include <memory>
+#include <functional>
+namespace RTSeis::FilterRepresentations
+{
+class FIR;
+class SOS;
+}
+namespace RTSeis::PostProcessing::SingleChannel
+{
+/// @class ChunkedWaveform chunkedWaveform.hpp "rtseis/postProcessing/singleChannel/chunkedWaveform.hpp"
+/// @brief Applies a chain of post-processing operations to traces that are
+///        too long to hold in memory.  The data is pulled from a source
+///        (e.g., a file reader or a memory-mapped array) in blocks, pushed
+///        through the operations with the filter states carried from block
+///        to block, and handed to a sink.  Hence, the peak memory usage is
+///        proportional to the block size and not the trace length.
+/// @note Zero-phase operations are realized by applying the backwards pass
+///       over a block and an overlap margin of look-ahead samples.  For FIR
+///       filters the margin is the filter length and the result is exactly
+///       that of \c Waveform.  For IIR filters the margin is chosen such that
+///       the truncated impulse response is negligible.
+///       The backwards pass is run once a margin's worth of samples can be
+///       released so the cost per sample does not grow as the block size
+///       shrinks.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_postprocessing_sc
+template<class T = double>
+class ChunkedWaveform
+{
+public:
+    /// @brief Reads up to maxSamples into x and returns the number of samples
+    ///        actually read.  A return value of 0 indicates the end of
+    ///        the trace.
+    using Source = std::function<int (int maxSamples, T x[])>;
+    /// @brief Receives the next n processed samples in y.
+    using Sink = std::function<void (int n, const T y[])>;
+
+    /// @name Constructors
+    /// @{
+    /// @brief Constructor.
+    ChunkedWaveform();
+    /// @brief Copy constructor.
+    /// @param[in] waveform  The chunked waveform class from which to
+    ///                      initialize this class.
+    ChunkedWaveform(const ChunkedWaveform &waveform);
+    /// @brief Move constructor.
+    /// @param[in,out] waveform  The chunked waveform class from which to
+    ///                          initialize this class.  On exit, waveform's
+    ///                          behavior is undefined.
+    ChunkedWaveform(ChunkedWaveform &&waveform) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] waveform  The class to copy to this.
+    /// @result A deep copy of the input class.
+    ChunkedWaveform& operator=(const ChunkedWaveform &waveform);
+    /// @brief Move assignment operator.
+    /// @param[in,out] waveform  The class whose memory will be moved to this.
+    ///                          On exit, waveform's behavior is undefined.
+    /// @result The memory from waveform moved to this.
+    ChunkedWaveform& operator=(ChunkedWaveform &&waveform) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~ChunkedWaveform();
+    /// @brief Removes all operations and restores the defaults.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Parameters
+    /// @{
+    /// @brief Sets the number of samples read from the source per block.
+    /// @param[in] blockSize  The block size.  This must be positive.
+    /// @throws std::invalid_argument if blockSize is not positive.
+    void setBlockSize(int blockSize);
+    /// @result The number of samples read from the source per block.
+    [[nodiscard]] int getBlockSize() const noexcept;
+    /// @brief Sets the overlap margin used by zero-phase IIR filters.
+    /// @param[in] margin  The number of look-ahead samples.  If this is 0
+    ///                    then the margin is set from the length of the
+    ///                    filter's impulse response.
+    /// @throws std::invalid_argument if margin is negative.
+    /// @note This must be called prior to adding the zero-phase operation.
+    void setZeroPhaseMargin(int margin);
+    /// @}
+
+    /// @name Operations
+    /// @{
+    /// @brief Appends an FIR filter to the processing chain.
+    /// @param[in] fir           The FIR filter.
+    /// @param[in] lremovePhase  If true then the filter is applied forwards
+    ///                          and backwards to remove the phase shift.
+    /// @throws std::invalid_argument if the filter has no taps.
+    /// @sa Waveform::firFilter()
+    void firFilter(const RTSeis::FilterRepresentations::FIR &fir,
+                   bool lremovePhase = false);
+    /// @brief Appends an SOS filter to the processing chain.
+    /// @param[in] sos         The second order sections filter.
+    /// @param[in] lzeroPhase  If true then the filter is applied forwards
+    ///                        and backwards to remove the phase shift.
+    /// @throws std::invalid_argument if the filter has no sections.
+    /// @sa Waveform::sosFilter()
+    void sosFilter(const RTSeis::FilterRepresentations::SOS &sos,
+                   bool lzeroPhase = false);
+    /// @brief Appends a downsampler to the processing chain.
+    /// @param[in] nq  The downsampling factor.  This must be positive.
+    /// @throws std::invalid_argument if nq is not positive.
+    /// @sa Waveform::downsample()
+    void downsample(int nq);
+    /// @brief Appends a decimator whose phase shift is removed to the
+    ///        processing chain.
+    /// @param[in] nq  The downsampling factor.  This must be at least 2.
+    /// @param[in] filterLength  The length of the anti-alias FIR filter.
+    ///                          This must be at least 5.
+    /// @throws std::invalid_argument if any arguments are incorrect.
+    /// @sa Waveform::decimate()
+    void decimate(int nq, int filterLength);
+    /// @result The number of operations in the processing chain.
+    [[nodiscard]] int getNumberOfOperations() const noexcept;
+    /// @}
+
+    /// @name Processing
+    /// @{
+    /// @brief Processes a trace pulled from a source.
+    /// @param[in] source  Provides the input samples block by block.
+    /// @param[in] sink    Receives the processed samples.
+    /// @throws std::invalid_argument if the source or sink is not callable.
+    /// @throws std::runtime_error if no operations were set.
+    void process(const Source &source, const Sink &sink);
+    /// @brief Processes a trace that is addressable in memory, e.g., a
+    ///        memory-mapped file.  The trace is only accessed one block at
+    ///        a time.
+    /// @param[in] n     The number of samples in x.
+    /// @param[in] x     The trace.  This is an array whose dimension is [n].
+    /// @param[in] sink  Receives the processed samples.
+    /// @throws std::invalid_argument if x is NULL or sink is not callable.
+    /// @throws std::runtime_error if no operations were set.
+    void process(size_t n, const T x[], const Sink &sink);
+    /// @result The number of samples handed to the sink by the last call
+    ///         to \c process().
+    [[nodiscard]] size_t getNumberOfOutputSamples() const noexcept;
+    /// @result The largest number of samples buffered by any operation
+    ///         during the last call to \c process().
+    [[nodiscard]] size_t getPeakBufferSize() const noexcept;
+    /// @}
+private:
+    class ChunkedWaveformImpl;
+    std::unique_ptr<ChunkedWaveformImpl> pImpl;
+};
+}
+#endif
@@ -1,6 +1,7 @@
 #ifndef RTSEIS_POSTPROCESSING_SC_WAVEFORM
 #define RTSEIS_POSTPROCESSING_SC_WAVEFORM 1
 #include <memory>
+#include <array>
 #include <vector>
 #include <string>
 #ifndef RTSEIS_POSTPROCESSING_SC_TAPER
@@ -129,9 +130,23 @@ enum class ConvolutionImplementation
     DIRECT, /*!< Time domain implementation. */
     FFT     /*!< Frequency domain implementation. */
 };
+/*!
+ * @brief Defines how zero-phase IIR filters are applied.
+ * @ingroup rtseis_postprocessing_sc
+ */
+enum class ZeroPhaseImplementation
+{
+    TIME_DOMAIN,     /*!< Filter the signal forwards and backwards. */
+    FREQUENCY_DOMAIN /*!< Multiply the zero-padded spectrum by the squared
+                          amplitude response of the filter.  This is
+                          typically faster for long signals. */
+};
 /// @class Waveform Waveform "include/rtseis/processing/singleChannel/postProcessing.hpp"
 /// @brief This class is to be used for single-channel post-processing
 ///        applications.
+/// @note The template parameter may be double or float.  When float, the
+///       data is stored and processed in single precision end-to-end;
+///       filter design is still performed in double precision.
 /// @copyright Ben Baker (University of Utah) distributed under the MIT license.
 /// @ingroup rtseis_postprocessing_sc
 template <class T = double>
@@ -349,6 +364,19 @@ public:
     void firBandpassFilter(int ntaps, const std::pair<double,double> fc,
                            const FIRWindow window,
                            const bool lremovePhase=false);
+    /*!
+     * @brief Bandpass filters a signal in the frequency domain with a
+     *        zero-phase brick-wall filter whose edges are cosine tapered.
+     * @param[in] corners  The corner frequencies in Hz.  The gain rises from
+     *                     0 at corners[0] to 1 at corners[1], is 1 until
+     *                     corners[2], and falls to 0 at corners[3].  These
+     *                     must be non-decreasing, not exceed the Nyquist
+     *                     frequency, and corners[1] must be less than
+     *                     corners[2].
+     * @throws std::invalid_argument if the corners are invalid.
+     * @sa FilterImplementations::FrequencyDomainFilter
+     */
+    void cosineTaperBandpassFilter(const std::array<double, 4> &corners);
     /*! 
      * @brief Bandstop (notch) filters a signal using an FIR filter.
      * @param[in] ntaps   The number of filter taps.
@@ -387,6 +415,7 @@ public:
      * @note It is the responsibility of the user to ensure that the
      *       signal sampling rate and the sampling rate used in the digital
      *       filter design are compatible.
+     * @sa setZeroPhaseImplementation()
      */
     void sosFilter(const RTSeis::FilterRepresentations::SOS &sos,
                    bool lzeroPhase=false);
@@ -680,6 +709,30 @@ public:
     double getSamplingPeriod() const noexcept;
     /// @result The Nyquist freuqency in Hz.
     double getNyquistFrequency() const noexcept;
+    /// @brief Sets the number of threads used by the FIR filtering and
+    ///        direct convolution.  The signal is partitioned into blocks of
+    ///        a fixed size that are filtered concurrently.
+    /// @param[in] nThreads  The number of threads.  If this is 0 then the
+    ///                      OpenMP default is used.  By default this is 1.
+    /// @throws std::invalid_argument if nThreads is negative.
+    /// @note Every thread count, including 1, takes the same blocked path
+    ///       so the FIR filtering and direct convolution results are
+    ///       bit-for-bit identical for any number of threads.
+    /// @sa FilterImplementations::ParallelFIRFilter
+    void setNumberOfThreads(int nThreads);
+    /// @result The number of threads used by FIR filtering and direct
+    ///         convolution.
+    int getNumberOfThreads() const noexcept;
+    /// @brief Sets how zero-phase IIR filters are applied.
+    /// @param[in] implementation  The zero-phase implementation.  By default
+    ///                            this is the time domain.
+    /// @note The frequency domain result is the linear zero-phase
+    ///       convolution.  It matches the time domain result except near
+    ///       the end of the signal.
+    /// @sa sosFilter()
+    void setZeroPhaseImplementation(ZeroPhaseImplementation implementation) noexcept;
+    /// @result The zero-phase IIR filter implementation.
+    ZeroPhaseImplementation getZeroPhaseImplementation() const noexcept;
     /// @}
 private:
     class WaveformImpl;
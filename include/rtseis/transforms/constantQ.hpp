@@ -0,0 +1,170 @@
+#ifndef RTSEIS_TRANSFORMS_CONSTANTQ_HPP
+#define RTSEIS_TRANSFORMS_CONSTANTQ_HPP 1
+#include <memory>
+#include <vector>
+#include <complex>
+#include "rtseis/enums.hpp"
+namespace RTSeis::Transforms
+{
+/// @class ConstantQ constantQ.hpp "rtseis/transforms/constantQ.hpp"
+/// @brief Computes a constant-Q transform, i.e., a spectrogram whose
+///        frequencies are geometrically spaced
+///        \f$ f_k = f_{min} 2^{k/B} \f$ and whose analysis windows are
+///        \f$ Q f_s/f_k \f$ samples long where
+///        \f$ Q = 1/(2^{1/B} - 1) \f$ and B is the number of bins per
+///        octave.  Each coefficient is the correlation of a Hann windowed
+///        complex exponential with the signal and is normalized so that a
+///        sinusoid of amplitude A at \f$ f_k \f$ yields \f$ A/2 \f$.
+/// @note The transform is computed one octave at a time.  The highest octave
+///       is computed at the original sampling rate and the signal is then
+///       repeatedly decimated by 2 so that every octave uses analysis
+///       windows of the same length and, hence, one short DFT per window.
+///       Each window's DFT is multiplied by a cached sparse spectral kernel
+///       of the octave.  The total cost is comparable to a single
+///       short-window spectrogram.
+/// @note The transform windows are centered at multiples of the hop length.
+///       In real-time mode the delays of the decimation filters are
+///       compensated so the coefficients of all octaves refer to the same
+///       window center.  A window is returned once every octave has
+///       received the samples within its look-ahead, i.e., half the longest
+///       analysis window, of the window's center.  The input to each window
+///       is truncated to this span in both modes so a returned window does
+///       not depend on the samples that arrive later.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class ConstantQ
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    ConstantQ();
+    /// @brief Copy constructor.
+    /// @param[in] cqt  The constant-Q transform class from which to
+    ///                 initialize this class.
+    ConstantQ(const ConstantQ &cqt);
+    /// @brief Move constructor.
+    /// @param[in,out] cqt  The constant-Q transform class from which to
+    ///                     initialize this class.  On exit, cqt's behavior
+    ///                     is undefined.
+    ConstantQ(ConstantQ &&cqt) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] cqt  The constant-Q transform class to copy to this.
+    /// @result A deep copy of the constant-Q transform.
+    ConstantQ& operator=(const ConstantQ &cqt);
+    /// @brief Move assignment operator.
+    /// @param[in,out] cqt  The constant-Q transform class whose memory will
+    ///                     be moved to this.  On exit, cqt's behavior is
+    ///                     undefined.
+    /// @result The memory from cqt moved to this.
+    ConstantQ& operator=(ConstantQ &&cqt) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~ConstantQ();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the constant-Q transform.
+    /// @param[in] samplingRate   The sampling rate in Hz.
+    /// @param[in] minFrequency   The lowest frequency in Hz.
+    /// @param[in] maxFrequency   The highest frequency in Hz.  The highest
+    ///                           bin is the last bin that does not exceed
+    ///                           this frequency.  So that the decimation
+    ///                           filters pass every octave this cannot
+    ///                           exceed 40 percent of the sampling rate.
+    /// @param[in] binsPerOctave  The number of bins per octave.
+    /// @param[in] hopLength      The number of samples between the centers
+    ///                           of successive transform windows.  This must
+    ///                           be a multiple of \f$ 2^{n_o - 1} \f$ where
+    ///                           \f$ n_o \f$ is the number of octaves.  If
+    ///                           this is not positive then the smallest
+    ///                           such hop is used.
+    /// @throws std::invalid_argument if the sampling rate is not positive,
+    ///         the frequencies are out of range or order, binsPerOctave is
+    ///         not positive, or the hop is not a multiple of
+    ///         \f$ 2^{n_o - 1} \f$.
+    void initialize(double samplingRate,
+                    double minFrequency,
+                    double maxFrequency,
+                    int binsPerOctave = 12,
+                    int hopLength = 0);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The sampling rate in Hz.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getSamplingRate() const;
+    /// @result The number of frequency bins.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfFrequencies() const;
+    /// @result The frequencies in Hz of the bins in increasing order.  This
+    ///         has dimension [\c getNumberOfFrequencies()].
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<T> getFrequencies() const;
+    /// @result The number of octaves.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfOctaves() const;
+    /// @result The number of samples between transform windows.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getHopLength() const;
+    /// @}
+
+    /// @name Transform
+    /// @{
+    /// @brief Computes the constant-Q transform.
+    /// @param[in] nSamples  The number of samples in x.
+    /// @param[in] x         The signal to transform.  This is an array of
+    ///                      dimension [nSamples].  In post-processing mode
+    ///                      this is the entire signal and is zero padded at
+    ///                      both ends.  In real-time mode this is the next
+    ///                      packet of the signal.
+    /// @throws std::invalid_argument if x is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void transform(int nSamples, const T x[]);
+    /// @brief Resets the real-time transform to the start of a new signal.
+    ///        This is useful after a gap.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+
+    /// @name Results
+    /// @{
+    /// @result True indicates the transform has been computed.
+    [[nodiscard]] bool haveTransform() const noexcept;
+    /// @result The number of transform windows computed by the last call
+    ///         to \c transform().  In real-time mode this can be zero.
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    [[nodiscard]] int getNumberOfTransformWindows() const;
+    /// @result The times in seconds of the centers of the transform windows
+    ///         computed by the last call to \c transform() measured from the
+    ///         first sample of the signal.  This has dimension
+    ///         [\c getNumberOfTransformWindows()].
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    [[nodiscard]] std::vector<T> getTimeWindows() const;
+    /// @result The constant-Q transform.  This is a
+    ///         [\c getNumberOfTransformWindows() x \c getNumberOfFrequencies()]
+    ///         matrix stored in row major order.
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    [[nodiscard]] std::vector<std::complex<T>> getTransform() const;
+    /// @result The amplitude of the constant-Q transform.  This is a
+    ///         [\c getNumberOfTransformWindows() x \c getNumberOfFrequencies()]
+    ///         matrix stored in row major order.
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    [[nodiscard]] std::vector<T> getAmplitude() const;
+    /// @}
+private:
+    class ConstantQImpl;
+    std::unique_ptr<ConstantQImpl> pImpl;
+};
+}
+#endif
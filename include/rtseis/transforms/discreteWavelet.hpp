@@ -0,0 +1,134 @@
+#ifndef RTSEIS_TRANSFORMS_DISCRETEWAVELET_HPP
+#define RTSEIS_TRANSFORMS_DISCRETEWAVELET_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/transforms/enums.hpp"
+namespace RTSeis::Transforms
+{
+/// @class DiscreteWavelet discreteWavelet.hpp "rtseis/transforms/discreteWavelet.hpp"
+/// @brief Computes the multilevel discrete wavelet transform (DWT) of a
+///        signal with an orthogonal wavelet.  At each level the
+///        approximation coefficients of the previous level are split into
+///        approximation and detail coefficients
+///        \f[
+///          a_j[k] = \sum_l h[l] a_{j-1}[(2k + l) \mod n_{j-1}], \quad
+///          d_j[k] = \sum_l g[l] a_{j-1}[(2k + l) \mod n_{j-1}]
+///        \f]
+///        where \f$ a_0 \f$ is the signal, h is the scaling filter, and
+///        \f$ g[l] = (-1)^l h[L-1-l] \f$ is the wavelet filter.
+/// @note The signal is periodized so the transform is orthonormal, i.e.,
+///       the energy of the coefficients equals the energy of the signal and
+///       the inverse transform is the adjoint of the forward transform.
+/// @note The approximation and detail filters are applied in one pass over
+///       a periodically extended copy of the signal so that the inner
+///       products vectorize.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class DiscreteWavelet
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    DiscreteWavelet();
+    /// @brief Copy constructor.
+    /// @param[in] dwt  The discrete wavelet transform class from which to
+    ///                 initialize this class.
+    DiscreteWavelet(const DiscreteWavelet &dwt);
+    /// @brief Move constructor.
+    /// @param[in,out] dwt  The discrete wavelet transform class from which to
+    ///                     initialize this class.  On exit, dwt's behavior is
+    ///                     undefined.
+    DiscreteWavelet(DiscreteWavelet &&dwt) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] dwt  The discrete wavelet transform class to copy to this.
+    /// @result A deep copy of the discrete wavelet transform.
+    DiscreteWavelet& operator=(const DiscreteWavelet &dwt);
+    /// @brief Move assignment operator.
+    /// @param[in,out] dwt  The discrete wavelet transform class whose memory
+    ///                     will be moved to this.  On exit, dwt's behavior is
+    ///                     undefined.
+    /// @result The memory from dwt moved to this.
+    DiscreteWavelet& operator=(DiscreteWavelet &&dwt) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~DiscreteWavelet();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the discrete wavelet transform.
+    /// @param[in] family   The wavelet family.
+    /// @param[in] order    The order of the wavelet.  Daubechies wavelets of
+    ///                     order [1,10], symlets of order [2,10], and
+    ///                     coiflets of order [1,4] are available.  The filter
+    ///                     length is 2*order for Daubechies wavelets and
+    ///                     symlets and 6*order for coiflets.
+    /// @param[in] nLevels  The number of decomposition levels.
+    /// @throws std::invalid_argument if the order is not available or
+    ///         nLevels is not positive.
+    void initialize(DiscreteWaveletFamily family,
+                    int order,
+                    int nLevels);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of decomposition levels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfLevels() const;
+    /// @result The scaling filter.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<T> getScalingFilter() const;
+    /// @result The wavelet filter.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<T> getWaveletFilter() const;
+    /// @}
+
+    /// @name Transform
+    /// @{
+    /// @brief Computes the forward transform.
+    /// @param[in] n    The number of samples in x.  This must be a positive
+    ///                 multiple of \f$ 2^{L} \f$ where L is the number of
+    ///                 levels.
+    /// @param[in] x    The signal to transform.  This is an array whose
+    ///                 dimension is [n].
+    /// @param[out] coefficients  The wavelet coefficients.  This is an array
+    ///                           whose dimension is [n].  The first
+    ///                           \f$ n/2^L \f$ coefficients are the
+    ///                           approximation coefficients of level L.
+    ///                           These are followed by the detail
+    ///                           coefficients of levels L, L-1, ..., 1 and
+    ///                           the detail coefficients of level j begin
+    ///                           at index \f$ n/2^j \f$.
+    /// @throws std::invalid_argument if n is invalid or x or coefficients is
+    ///         NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void forwardTransform(int n, const T x[], T *coefficients[]);
+    /// @brief Computes the inverse transform.
+    /// @param[in] n    The number of coefficients.  This must be a positive
+    ///                 multiple of \f$ 2^{L} \f$ where L is the number of
+    ///                 levels.
+    /// @param[in] coefficients  The wavelet coefficients ordered as in
+    ///                          \c forwardTransform().  This is an array
+    ///                          whose dimension is [n].
+    /// @param[out] x   The reconstructed signal.  This is an array whose
+    ///                 dimension is [n].
+    /// @throws std::invalid_argument if n is invalid or coefficients or x is
+    ///         NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void inverseTransform(int n, const T coefficients[], T *x[]);
+    /// @}
+private:
+    class DiscreteWaveletImpl;
+    std::unique_ptr<DiscreteWaveletImpl> pImpl;
+};
+}
+#endif
@@ -30,6 +30,32 @@ enum class SlidingWindowType
     BOXCAR,    /*!< A boxcar (all ones). */ 
     CUSTOM     /*!< A custom window was set. */
 };
- 
+
+/// @brief Defines how the streaming Welch method averages the periodograms
+///        of successive segments.
+enum class WelchAverageType
+{
+    EXPONENTIAL, /*!< An exponentially weighted average whose time constant
+                      is a given number of segments. */
+    SLIDING      /*!< The mean of the most recent segments. */
+};
+
+/// @brief Defines the families of orthogonal wavelets available to the
+///        discrete wavelet transforms.
+enum class DiscreteWaveletFamily
+{
+    DAUBECHIES, /*!< The extremal phase Daubechies wavelets. */
+    SYMLET,     /*!< The least asymmetric Daubechies wavelets (symlets). */
+    COIFLET     /*!< Coiflets, whose scaling functions also have vanishing
+                     moments. */
+};
+/// @brief Defines how wavelet coefficients are thresholded.
+enum class WaveletThresholdType
+{
+    HARD, /*!< Coefficients whose magnitude does not exceed the threshold
+               are zeroed and the others are kept. */
+    SOFT  /*!< Coefficients are shrunk towards zero by the threshold. */
+};
+
 }
 #endif
@@ -0,0 +1,109 @@
+#ifndef RTSEIS_TRANSFORMS_SLIDINGDFT_HPP
+#define RTSEIS_TRANSFORMS_SLIDINGDFT_HPP 1
+#include <memory>
+#include <vector>
+#include <complex>
+#include "rtseis/transforms/enums.hpp"
+namespace RTSeis::Transforms
+{
+/// @class SlidingDFT slidingDFT.hpp "rtseis/transforms/slidingDFT.hpp"
+/// @brief A real-time module that tracks a few bins of the DFT of the last N
+///        samples.  After each sample n the k'th tracked bin is
+///        \f[
+///           X_k[n] = \sum_{m=0}^{N-1} w[m] x[n - N + 1 + m] e^{-2 \pi i k m/N}
+///        \f]
+///        where samples prior to the first sample are zero.  This is the
+///        k'th bin of the DFT of the window ending at n.
+/// @note Each bin is updated with the recursion
+///       \f$ X_k[n] = e^{2 \pi i k/N} (X_k[n-1] + x[n] - x[n-N]) \f$
+///       so that K bins cost O(K) per sample.  The recursion's poles lie on
+///       the unit circle so round-off accumulates.  To stabilize it the
+///       bins are recomputed directly from the window every N samples,
+///       which amortizes to O(K) per sample.
+/// @note Windows are applied in the frequency domain by combining
+///       neighboring bins.  Hence, only the periodic Hann, Hamming, and
+///       Blackman windows and the boxcar are supported.
+/// @note Many channels can be processed in one call.  The channels share
+///       the bins and window but have independent state.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class SlidingDFT
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    SlidingDFT();
+    /// @brief Copy constructor.
+    /// @param[in] sdft  The sliding DFT class from which to initialize this
+    ///                  class.
+    SlidingDFT(const SlidingDFT &sdft);
+    /// @brief Move constructor.
+    /// @param[in,out] sdft  The sliding DFT class from which to initialize
+    ///                      this class.  On exit, sdft's behavior is
+    ///                      undefined.
+    SlidingDFT(SlidingDFT &&sdft) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] sdft  The sliding DFT class to copy.
+    /// @result A deep copy of the input class.
+    SlidingDFT& operator=(const SlidingDFT &sdft);
+    /// @brief Move assignment operator.
+    /// @param[in,out] sdft  The sliding DFT class whose memory will be moved
+    ///                      to this.  On exit, sdft's behavior is undefined.
+    /// @result The memory from sdft moved to this.
+    SlidingDFT& operator=(SlidingDFT &&sdft) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~SlidingDFT();
+    /// @brief Initializes the class.
+    /// @param[in] windowLength  The DFT length, N.  This must be at least 2.
+    /// @param[in] bins          The DFT bins to track.  Each bin must be in
+    ///                          the range [0, windowLength/2].  Bin k
+    ///                          corresponds to the frequency k f_s/N where
+    ///                          f_s is the sampling rate.
+    /// @param[in] window        The window applied to the data.  This must
+    ///                          be BOXCAR, HANN, HAMMING, or BLACKMAN.
+    /// @param[in] nChannels     The number of channels.  This must be
+    ///                          positive.
+    /// @throws std::invalid_argument if any of the arguments are invalid.
+    void initialize(int windowLength,
+                    const std::vector<int> &bins,
+                    SlidingWindowType window = SlidingWindowType::BOXCAR,
+                    int nChannels = 1);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The DFT length.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getWindowLength() const;
+    /// @result The number of tracked bins.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfBins() const;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @brief Zeros the sliding windows.  This is useful after a gap.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions();
+    /// @brief Updates the bins with the next packet.
+    /// @param[in] nSamples  The number of samples in each channel.
+    /// @param[in] x         The signals.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @param[out] y        The tracked bins after each sample.  This is a
+    ///                      row-major [nChannels x nBins x nSamples] array so
+    ///                      that the time series of each bin is contiguous.
+    /// @throws std::invalid_argument if x or y is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void transform(int nSamples, const T x[], std::complex<T> *y[]);
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class SlidingDFTImpl;
+    std::unique_ptr<SlidingDFTImpl> pImpl;
+};
+}
+#endif
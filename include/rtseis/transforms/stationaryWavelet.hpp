@@ -0,0 +1,135 @@
+#ifndef RTSEIS_TRANSFORMS_STATIONARYWAVELET_HPP
+#define RTSEIS_TRANSFORMS_STATIONARYWAVELET_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+#include "rtseis/transforms/enums.hpp"
+namespace RTSeis::Transforms
+{
+/// @class StationaryWavelet stationaryWavelet.hpp "rtseis/transforms/stationaryWavelet.hpp"
+/// @brief Computes the maximal overlap discrete wavelet transform (MODWT),
+///        i.e., the undecimated or stationary wavelet transform.  With the
+///        rescaled filters \f$ \tilde{h} = h/\sqrt{2} \f$ and
+///        \f$ \tilde{g} = g/\sqrt{2} \f$ level j computes
+///        \f[
+///          V_j[t] = \sum_l \tilde{h}[l] V_{j-1}[t - 2^{j-1} l], \quad
+///          W_j[t] = \sum_l \tilde{g}[l] V_{j-1}[t - 2^{j-1} l]
+///        \f]
+///        where \f$ V_0 \f$ is the signal.  Unlike the DWT every level has
+///        as many coefficients as the signal has samples and the transform
+///        is shift invariant.
+/// @note In post-processing mode the signal is periodized so that the
+///       energy of the signal equals the sum of the energies of
+///       \f$ W_1, \ldots, W_L \f$ and \f$ V_L \f$ and the signal can be
+///       reconstructed exactly.
+/// @note In real-time mode the filters are causal and each level keeps its
+///       own delay line so packets of any length can be transformed.  After
+///       the first \f$ (2^L - 1)(n_h - 1) \f$ samples, where \f$ n_h \f$ is
+///       the filter length, the coefficients equal the post-processing
+///       coefficients.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class StationaryWavelet
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    StationaryWavelet();
+    /// @brief Copy constructor.
+    /// @param[in] swt  The stationary wavelet transform class from which to
+    ///                 initialize this class.
+    StationaryWavelet(const StationaryWavelet &swt);
+    /// @brief Move constructor.
+    /// @param[in,out] swt  The stationary wavelet transform class from which
+    ///                     to initialize this class.  On exit, swt's behavior
+    ///                     is undefined.
+    StationaryWavelet(StationaryWavelet &&swt) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] swt  The stationary wavelet transform class to copy to this.
+    /// @result A deep copy of the stationary wavelet transform.
+    StationaryWavelet& operator=(const StationaryWavelet &swt);
+    /// @brief Move assignment operator.
+    /// @param[in,out] swt  The stationary wavelet transform class whose
+    ///                     memory will be moved to this.  On exit, swt's
+    ///                     behavior is undefined.
+    /// @result The memory from swt moved to this.
+    StationaryWavelet& operator=(StationaryWavelet &&swt) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~StationaryWavelet();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the stationary wavelet transform.
+    /// @param[in] family   The wavelet family.
+    /// @param[in] order    The order of the wavelet.  Daubechies wavelets of
+    ///                     order [1,10], symlets of order [2,10], and
+    ///                     coiflets of order [1,4] are available.
+    /// @param[in] nLevels  The number of decomposition levels.
+    /// @throws std::invalid_argument if the order is not available or
+    ///         nLevels is not positive.
+    void initialize(DiscreteWaveletFamily family,
+                    int order,
+                    int nLevels);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of decomposition levels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfLevels() const;
+    /// @result The number of samples at the start of a real-time stream
+    ///         after which the coefficients no longer depend on the initial
+    ///         conditions.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getTransientLength() const;
+    /// @}
+
+    /// @name Transform
+    /// @{
+    /// @brief Computes the forward transform.
+    /// @param[in] n    The number of samples in x.
+    /// @param[in] x    The signal to transform.  In real-time mode this is
+    ///                 the next packet.  This is an array whose dimension
+    ///                 is [n].
+    /// @param[out] coefficients  The wavelet coefficients.  This is an
+    ///                           [L+1 x n] matrix stored in row major order
+    ///                           where L is the number of levels.  The first
+    ///                           L rows are the wavelet coefficients
+    ///                           \f$ W_1, \ldots, W_L \f$ and the last row
+    ///                           is the scaling coefficients \f$ V_L \f$.
+    /// @throws std::invalid_argument if x or coefficients is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void forwardTransform(int n, const T x[], T *coefficients[]);
+    /// @brief Computes the inverse transform.  This is only available in
+    ///        post-processing mode.
+    /// @param[in] n    The number of samples.
+    /// @param[in] coefficients  The wavelet coefficients ordered as in
+    ///                          \c forwardTransform().  This is an
+    ///                          [L+1 x n] matrix stored in row major order.
+    /// @param[out] x   The reconstructed signal.  This is an array whose
+    ///                 dimension is [n].
+    /// @throws std::invalid_argument if coefficients or x is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false or this is
+    ///         a real-time transform.
+    void inverseTransform(int n, const T coefficients[], T *x[]);
+    /// @brief Resets the delay lines of the real-time transform to zero.
+    ///        This is useful after a gap.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class StationaryWaveletImpl;
+    std::unique_ptr<StationaryWaveletImpl> pImpl;
+};
+}
+#endif
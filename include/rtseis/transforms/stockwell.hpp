@@ -0,0 +1,166 @@
+#ifndef RTSEIS_TRANSFORMS_STOCKWELL_HPP
+#define RTSEIS_TRANSFORMS_STOCKWELL_HPP 1
+#include <memory>
+#include <vector>
+#include <complex>
+namespace RTSeis::Transforms
+{
+/// @class Stockwell stockwell.hpp "rtseis/transforms/stockwell.hpp"
+/// @brief Computes the Stockwell transform (S-transform) of a signal
+///        \f[
+///          S[n, j]
+///        = \frac{1}{N} \sum_{m=-\lfloor (N-1)/2 \rfloor}^{\lfloor N/2 \rfloor}
+///          X[(m + n) \bmod N] e^{-2 \pi^2 m^2/n^2} e^{i 2 \pi m j/N}
+///        \f]
+///        where \f$ X \f$ is the DFT of the N samples of the signal and
+///        \f$ n \f$ is the voice, i.e., the frequency index.  The Gaussian
+///        is centered on the voice so the sum is over the symmetric window
+///        of frequency offsets m.  The signal is
+///        transformed once and each voice is the inverse DFT of the shifted
+///        spectrum multiplied by a Gaussian.  The zero frequency voice is the
+///        signal's mean.
+/// @note The voices are computed in parallel with batched inverse DFTs.
+///       Because the Gaussian's width grows with the frequency only the
+///       non-negligible part of it is applied.
+/// @note For long records the output, which is \f$ O(N^2) \f$ when all
+///       voices are kept, can be bounded by restricting the frequency band,
+///       by keeping every k'th voice, and by storing only the amplitude.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class Stockwell
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    Stockwell();
+    /// @brief Copy constructor.
+    /// @param[in] stockwell  The Stockwell transform class from which to
+    ///                       initialize this class.
+    Stockwell(const Stockwell &stockwell);
+    /// @brief Move constructor.
+    /// @param[in,out] stockwell  The Stockwell transform class from which to
+    ///                           initialize this class.  On exit,
+    ///                           stockwell's behavior is undefined.
+    Stockwell(Stockwell &&stockwell) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] stockwell  The Stockwell transform class to copy to this.
+    /// @result A deep copy of the Stockwell transform.
+    Stockwell& operator=(const Stockwell &stockwell);
+    /// @brief Move assignment operator.
+    /// @param[in,out] stockwell  The Stockwell transform class whose memory
+    ///                           will be moved to this.  On exit, stockwell's
+    ///                           behavior is undefined.
+    /// @result The memory from stockwell moved to this.
+    Stockwell& operator=(Stockwell &&stockwell) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~Stockwell();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the Stockwell transform.
+    /// @param[in] nSamples      The number of samples in the signal to
+    ///                          transform.  This must be at least 2.
+    /// @param[in] samplingRate  The sampling rate in Hz.
+    /// @param[in] minFrequency  The lowest frequency in Hz to compute.  This
+    ///                          is rounded to the nearest voice.
+    /// @param[in] maxFrequency  The highest frequency in Hz to compute.  This
+    ///                          is rounded to the nearest voice.  If this is
+    ///                          negative then the Nyquist frequency is used.
+    /// @param[in] frequencyDecimation  Only every frequencyDecimation'th
+    ///                                 voice starting at minFrequency is
+    ///                                 computed.
+    /// @param[in] amplitudeOnly  If true then only the amplitude of the
+    ///                           transform is stored.  This halves the
+    ///                           memory in the output.
+    /// @throws std::invalid_argument if nSamples is less than 2, the
+    ///         sampling rate is not positive, the frequencies are not in
+    ///         the range [0, samplingRate/2] or are out of order, or the
+    ///         decimation is not positive.
+    void initialize(int nSamples,
+                    double samplingRate = 1,
+                    double minFrequency = 0,
+                    double maxFrequency =-1,
+                    int frequencyDecimation = 1,
+                    bool amplitudeOnly = false);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples in the signal.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfSamples() const;
+    /// @result The number of frequencies (voices) in the transform.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfFrequencies() const;
+    /// @result The frequencies in Hz of the voices.  This has dimension
+    ///         [\c getNumberOfFrequencies()].
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<T> getFrequencies() const;
+    /// @result The sampling rate in Hz.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getSamplingRate() const;
+    /// @result True indicates that only the amplitude is stored.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] bool isAmplitudeOnly() const;
+    /// @}
+
+    /// @name Transform
+    /// @{
+    /// @brief Computes the Stockwell transform of the given signal.
+    /// @param[in] n   The number of samples in x.  This must match
+    ///                \c getNumberOfSamples().
+    /// @param[in] x   The signal to transform.  This is an array whose
+    ///                dimension is [n].
+    /// @throws std::invalid_argument if n is the wrong size or x is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void transform(int n, const T x[]);
+    /// @}
+
+    /// @name Results
+    /// @{
+    /// @result True indicates the transform has been computed.
+    [[nodiscard]] bool haveTransform() const noexcept;
+    /// @brief Gets the Stockwell transform.
+    /// @param[in] nSamples      The number of samples.  This must match
+    ///                          \c getNumberOfSamples().
+    /// @param[in] nFrequencies  The number of frequencies.  This must match
+    ///                          \c getNumberOfFrequencies().
+    /// @param[out] st           The transform.  This is an
+    ///                          [nFrequencies x nSamples] matrix stored in
+    ///                          row major order.
+    /// @throws std::runtime_error if \c haveTransform() is false or only the
+    ///         amplitude is stored.
+    /// @throws std::invalid_argument if nSamples or nFrequencies is the wrong
+    ///         size or st is NULL.
+    void getTransform(int nSamples, int nFrequencies,
+                      std::complex<T> *st[]) const;
+    /// @brief Gets the amplitude of the Stockwell transform.
+    /// @param[in] nSamples      The number of samples.  This must match
+    ///                          \c getNumberOfSamples().
+    /// @param[in] nFrequencies  The number of frequencies.  This must match
+    ///                          \c getNumberOfFrequencies().
+    /// @param[out] amplitude    The amplitude of the transform.  This is an
+    ///                          [nFrequencies x nSamples] matrix stored in
+    ///                          row major order.
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    /// @throws std::invalid_argument if nSamples or nFrequencies is the wrong
+    ///         size or amplitude is NULL.
+    void getAmplitudeTransform(int nSamples, int nFrequencies,
+                               T *amplitude[]) const;
+    /// @}
+private:
+    class StockwellImpl;
+    std::unique_ptr<StockwellImpl> pImpl;
+};
+}
+#endif
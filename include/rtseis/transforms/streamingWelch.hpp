@@ -0,0 +1,124 @@
+#ifndef RTSEIS_TRANSFORMS_STREAMINGWELCH_HPP
+#define RTSEIS_TRANSFORMS_STREAMINGWELCH_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/transforms/enums.hpp"
+namespace RTSeis::Transforms
+{
+class SlidingWindowRealDFTParameters;
+/// @class StreamingWelch streamingWelch.hpp "rtseis/transforms/streamingWelch.hpp"
+/// @brief A real-time variant of Welch's method.  Packets are buffered until
+///        a segment is complete.  Each segment is transformed once and its
+///        modified periodogram is folded into a running average.  Only the
+///        current segment is retained so the stream may be arbitrarily long.
+/// @note The channels advance in lockstep so one batched real-to-complex
+///       transform plan serves every channel.
+/// @note The scaling matches \c Welch.  Hence, with a sliding average that
+///       spans every segment of a signal the estimate equals the result of
+///       \c Welch on that signal.  An exponential average uses the weight
+///       \f$ \max(1/n, 1/L) \f$ for the n'th segment so that the first L
+///       segments are averaged uniformly.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class StreamingWelch
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    StreamingWelch();
+    /// @brief Copy constructor.
+    /// @param[in] welch  The streaming Welch class from which to initialize
+    ///                   this class.
+    StreamingWelch(const StreamingWelch &welch);
+    /// @brief Move constructor.
+    /// @param[in,out] welch  The streaming Welch class from which to
+    ///                       initialize this class.  On exit, welch's
+    ///                       behavior is undefined.
+    StreamingWelch(StreamingWelch &&welch) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] welch  The streaming Welch class to copy.
+    /// @result A deep copy of the input class.
+    StreamingWelch& operator=(const StreamingWelch &welch);
+    /// @brief Move assignment operator.
+    /// @param[in,out] welch  The streaming Welch class whose memory will be
+    ///                       moved to this.  On exit, welch's behavior is
+    ///                       undefined.
+    /// @result The memory from welch moved to this.
+    StreamingWelch& operator=(StreamingWelch &&welch) noexcept;
+    /// @}
+
+    /// @brief Destructor.
+    ~StreamingWelch();
+    /// @brief Initializes the class.
+    /// @param[in] parameters       The window, overlap, DFT length, and
+    ///                             detrend strategy of each segment.  The
+    ///                             number of samples is ignored.
+    /// @param[in] samplingRate     The sampling rate in Hz.
+    /// @param[in] nChannels        The number of channels.  This must be
+    ///                             positive.
+    /// @param[in] averaging        Defines how the periodograms are averaged.
+    /// @param[in] averagingLength  The number of segments in the sliding
+    ///                             average or the time constant, in segments,
+    ///                             of the exponential average.  This must be
+    ///                             positive.
+    /// @throws std::invalid_argument if any of the arguments are invalid or
+    ///         the window was not set on the parameters.
+    void initialize(const SlidingWindowRealDFTParameters &parameters,
+                    double samplingRate,
+                    int nChannels = 1,
+                    WelchAverageType averaging = WelchAverageType::EXPONENTIAL,
+                    int averagingLength = 16);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @result The number of frequencies.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfFrequencies() const;
+    /// @result The frequencies (Hz) at which the power spectral density is
+    ///         estimated.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] std::vector<T> getFrequencies() const;
+    /// @brief Adds the next packet to the estimate.
+    /// @param[in] nSamples  The number of samples in each channel.
+    /// @param[in] x         The signals.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @throws std::invalid_argument if x is NULL.
+    /// @throws std::runtime_error if the class is not initialized.
+    void transform(int nSamples, const T x[]);
+    /// @result The number of segments that have been transformed since
+    ///         initialization or the last reset.
+    /// @throws std::runtime_error if the class is not initialized.
+    [[nodiscard]] int getNumberOfSegments() const;
+    /// @retval True indicates that at least one segment has been transformed.
+    [[nodiscard]] bool haveTransform() const noexcept;
+    /// @param[in] channel  The channel index.  This must be in the range
+    ///                     [0, \c getNumberOfChannels() - 1].
+    /// @result The current power spectral density estimate of the channel.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    [[nodiscard]] std::vector<T> getPowerSpectralDensity(int channel) const;
+    /// @param[in] channel  The channel index.  This must be in the range
+    ///                     [0, \c getNumberOfChannels() - 1].
+    /// @result The current power spectrum estimate of the channel.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c haveTransform() is false.
+    [[nodiscard]] std::vector<T> getPowerSpectrum(int channel) const;
+    /// @brief Discards the buffered samples and the running averages.  This
+    ///        is useful after a gap.
+    /// @throws std::runtime_error if the class is not initialized.
+    void resetInitialConditions();
+    /// @brief Releases memory on the module.
+    void clear() noexcept;
+private:
+    class StreamingWelchImpl;
+    std::unique_ptr<StreamingWelchImpl> pImpl;
+};
+}
+#endif
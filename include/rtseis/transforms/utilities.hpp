@@ -149,6 +149,16 @@ void realToComplexDFTFrequencies(int nSamples,
 /// @throws std::runtime_error if n is too large and there is an overflow.
 /// @ingroup rtseis_utils_transforms_utils
 [[nodiscard]] int nextPowerOfTwo(const int n);
+/// @brief Finds the smallest number, n2, such that n2 is greater than or
+///        equal to n and n2 has no prime factors other than 2, 3, and 5.
+///        Such lengths are transformed efficiently by mixed-radix FFTs
+///        and are often much shorter than the next power of 2.
+/// @param[in] n  Non-negative number of which to find the next fast length.
+/// @result The next fast transform length.
+/// @throws std::invalid_argument if n is negative.
+/// @throws std::runtime_error if n is too large and there is an overflow.
+/// @ingroup rtseis_utils_transforms_utils
+[[nodiscard]] int nextFastLength(const int n);
 
 /// @name Shuffle
 /// @{
@@ -0,0 +1,113 @@
+#ifndef RTSEIS_TRANSFORMS_WAVELETDENOISER_HPP
+#define RTSEIS_TRANSFORMS_WAVELETDENOISER_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/transforms/enums.hpp"
+namespace RTSeis::Transforms
+{
+/// @class WaveletDenoiser waveletDenoiser.hpp "rtseis/transforms/waveletDenoiser.hpp"
+/// @brief Denoises traces by thresholding their discrete wavelet transform.
+///        The noise level of each trace is estimated from the finest
+///        detail coefficients as
+///        \f$ \sigma = \textrm{median}(|d_1|)/0.6745 \f$ and the detail
+///        coefficients of every level are thresholded with the universal
+///        threshold \f$ \lambda = \sigma \sqrt{2 \ln n} \f$ before the
+///        inverse transform.  The approximation coefficients are kept.
+/// @note Traces are reflected about their last sample so that their length
+///       is a multiple of \f$ 2^L \f$ where L is the number of levels.
+///       This avoids the discontinuity that periodization would introduce.
+/// @note A batch of traces is denoised in parallel.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class WaveletDenoiser
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    WaveletDenoiser();
+    /// @brief Copy constructor.
+    /// @param[in] denoiser  The wavelet denoiser class from which to
+    ///                      initialize this class.
+    WaveletDenoiser(const WaveletDenoiser &denoiser);
+    /// @brief Move constructor.
+    /// @param[in,out] denoiser  The wavelet denoiser class from which to
+    ///                          initialize this class.  On exit, denoiser's
+    ///                          behavior is undefined.
+    WaveletDenoiser(WaveletDenoiser &&denoiser) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] denoiser  The wavelet denoiser class to copy to this.
+    /// @result A deep copy of the wavelet denoiser.
+    WaveletDenoiser& operator=(const WaveletDenoiser &denoiser);
+    /// @brief Move assignment operator.
+    /// @param[in,out] denoiser  The wavelet denoiser class whose memory will
+    ///                          be moved to this.  On exit, denoiser's
+    ///                          behavior is undefined.
+    /// @result The memory from denoiser moved to this.
+    WaveletDenoiser& operator=(WaveletDenoiser &&denoiser) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~WaveletDenoiser();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the denoiser.
+    /// @param[in] family   The wavelet family.
+    /// @param[in] order    The order of the wavelet.  Daubechies wavelets of
+    ///                     order [1,10], symlets of order [2,10], and
+    ///                     coiflets of order [1,4] are available.
+    /// @param[in] nLevels  The number of decomposition levels.
+    /// @param[in] thresholdType  Defines hard or soft thresholding.
+    /// @throws std::invalid_argument if the order is not available or
+    ///         nLevels is not positive.
+    void initialize(DiscreteWaveletFamily family,
+                    int order,
+                    int nLevels,
+                    WaveletThresholdType thresholdType = WaveletThresholdType::SOFT);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of decomposition levels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfLevels() const;
+    /// @result The threshold type.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] WaveletThresholdType getThresholdType() const;
+    /// @}
+
+    /// @name Denoising
+    /// @{
+    /// @brief Denoises a batch of traces.
+    /// @param[in] nTraces   The number of traces.
+    /// @param[in] nSamples  The number of samples in each trace.  This must
+    ///                      be at least 2.
+    /// @param[in] x         The traces to denoise.  This is an
+    ///                      [nTraces x nSamples] matrix stored in row major
+    ///                      order.
+    /// @param[out] y        The denoised traces.  This is an
+    ///                      [nTraces x nSamples] matrix stored in row major
+    ///                      order.
+    /// @throws std::invalid_argument if nSamples is too small or x or y is
+    ///         NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int nTraces, int nSamples, const T x[], T *y[]);
+    /// @result The threshold applied to each trace by the last call to
+    ///         \c apply().  This has dimension [nTraces].
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<T> getThresholds() const;
+    /// @}
+private:
+    class WaveletDenoiserImpl;
+    std::unique_ptr<WaveletDenoiserImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,126 @@
+#ifndef RTSEIS_TRIGGER_ARAICPICKER_HPP
+#define RTSEIS_TRIGGER_ARAICPICKER_HPP 1
+#include <memory>
+#include "rtseis/utilities/math/autoRegressive.hpp"
+namespace RTSeis::Trigger
+{
+/// @class ARAICPicker "arAICPicker.hpp" "rtseis/trigger/arAICPicker.hpp"
+/// @brief Refines coarse triggers, e.g., from an STA/LTA, with the
+///        autoregressive Akaike information criterion picker of
+///        Sleeman and van Eck (1999).  A window is taken around each trigger.
+///        An autoregressive model of order M is fit to the start of the window
+///        (the noise) and to the end of the window (the signal).  The noise
+///        model's forward prediction errors and the signal model's backward
+///        prediction errors give
+///        \f[
+///            AIC(k) = (k - M) \log \sigma_1^2(k)
+///                   + (N - M - k) \log \sigma_2^2(k)
+///        \f]
+///        where \f$ \sigma_1^2(k) \f$ is the variance of the noise model's
+///        errors before k and \f$ \sigma_2^2(k) \f$ is the variance of the
+///        signal model's errors from k onward.  The pick is the minimum of
+///        the AIC.
+/// @note The error variances are accumulated with cumulative sums so each
+///       window costs O(N M).  The triggers are refined in parallel.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class ARAICPicker
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    ARAICPicker();
+    /// @brief Copy constructor.
+    /// @param[in] picker  The picker class from which to initialize this
+    ///                    class.
+    ARAICPicker(const ARAICPicker &picker);
+    /// @brief Move constructor.
+    /// @param[in,out] picker  The picker class from which to initialize this
+    ///                        class.  On exit, picker's behavior is undefined.
+    ARAICPicker(ARAICPicker &&picker) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] picker  The picker class to copy to this.
+    /// @result A deep copy of the picker class.
+    ARAICPicker& operator=(const ARAICPicker &picker);
+    /// @brief Move assignment operator.
+    /// @param[in,out] picker  The picker class whose memory will be moved to
+    ///                        this.  On exit, picker's behavior is undefined.
+    /// @result The memory from picker moved to this.
+    ARAICPicker& operator=(ARAICPicker &&picker) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~ARAICPicker();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the picker.
+    /// @param[in] windowBefore  The number of samples before a trigger in the
+    ///                          window.  This must be positive.
+    /// @param[in] windowAfter   The number of samples at and after a trigger
+    ///                          in the window.  This must be positive.
+    /// @param[in] noiseLength   The number of samples at the start of the
+    ///                          window to which the noise model is fit.  This
+    ///                          must be greater than order and at most the
+    ///                          window length.
+    /// @param[in] signalLength  The number of samples at the end of the window
+    ///                          to which the signal model is fit.  This must
+    ///                          be greater than order and at most the window
+    ///                          length.
+    /// @param[in] order         The autoregressive model order.  This must be
+    ///                          positive.
+    /// @param[in] method        The autoregressive model estimator.
+    /// @throws std::invalid_argument if any argument is out of range or the
+    ///         window is too short for the order.
+    void initialize(int windowBefore, int windowAfter,
+                    int noiseLength, int signalLength,
+                    int order = 4,
+                    RTSeis::Utilities::Math::AutoRegressive::Method method
+                        = RTSeis::Utilities::Math::AutoRegressive::Method::BURG);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples before a trigger in the window.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getWindowBefore() const;
+    /// @result The number of samples at and after a trigger in the window.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getWindowAfter() const;
+    /// @result The autoregressive model order.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getOrder() const;
+    /// @}
+
+    /// @name Picking
+    /// @{
+    /// @brief Refines the triggers.
+    /// @param[in] nSamples   The number of samples in the lookback buffer.
+    /// @param[in] x          The lookback buffer.  This is an array whose
+    ///                       dimension is [nSamples].
+    /// @param[in] nTriggers  The number of triggers.
+    /// @param[in] triggers   The coarse trigger sample indices in x.  This is
+    ///                       an array whose dimension is [nTriggers].
+    /// @param[out] picks     The refined pick sample indices in x.  This is
+    ///                       an array whose dimension is [nTriggers].  If
+    ///                       a trigger's window does not fit in x then its
+    ///                       pick is -1.
+    /// @throws std::invalid_argument if an array is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void pick(int nSamples, const T x[],
+              int nTriggers, const int triggers[], int *picks[]) const;
+    /// @}
+private:
+    class ARAICPickerImpl;
+    std::unique_ptr<ARAICPickerImpl> pImpl;
+};
+}
+#endif
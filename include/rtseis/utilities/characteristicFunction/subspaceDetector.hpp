@@ -0,0 +1,141 @@
+#ifndef RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_SUBSPACEDETECTOR_HPP
+#define RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_SUBSPACEDETECTOR_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/enums.hpp"
+namespace RTSeis::Utilities::CharacteristicFunction
+{
+/// @class SubspaceDetector subspaceDetector.hpp "rtseis/utilities/characteristicFunction/subspaceDetector.hpp"
+/// @brief Computes the detection statistic of a multichannel subspace
+///        detector (Harris, 2006).  The aligned templates are normalized
+///        and their channels are concatenated into the columns of a
+///        matrix whose left singular vectors
+///        \f$ \mathbf{u}_1, \ldots, \mathbf{u}_d \f$ corresponding to the d
+///        largest singular values form an orthonormal basis.  For the
+///        multichannel window \f$ \mathbf{x}_n \f$ of length \f$ N \f$
+///        ending at sample n the statistic is the fraction of the window's
+///        energy captured by the subspace
+///        \f[
+///          c[n] = \frac{ \sum_{k=1}^d (\mathbf{u}_k^T \mathbf{x}_n)^2 }
+///                      { \mathbf{x}_n^T \mathbf{x}_n }
+///        \f]
+///        which is in the range [0,1].  Matching d templates with one
+///        subspace replaces correlating every template.
+/// @note The projections are overlap-save FFT correlations.  Each block of
+///       each channel is transformed once and the channels' spectra are
+///       combined before one inverse transform per basis vector.  The
+///       window energy is a running sum that is recomputed at the start of
+///       each block.  Blocks are processed in parallel.
+/// @note In real-time mode the last N-1 samples of each channel are saved
+///       between calls.  In post-processing mode and after
+///       \c resetInitialConditions() the samples preceding the signal are
+///       zero.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class SubspaceDetector
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    SubspaceDetector();
+    /// @brief Copy constructor.
+    /// @param[in] detector  The subspace detector from which to initialize
+    ///                      this class.
+    SubspaceDetector(const SubspaceDetector &detector);
+    /// @brief Move constructor.
+    /// @param[in,out] detector  The subspace detector from which to
+    ///                          initialize this class.  On exit, detector's
+    ///                          behavior is undefined.
+    SubspaceDetector(SubspaceDetector &&detector) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] detector  The subspace detector to copy to this.
+    /// @result A deep copy of the subspace detector.
+    SubspaceDetector& operator=(const SubspaceDetector &detector);
+    /// @brief Move assignment operator.
+    /// @param[in,out] detector  The subspace detector whose memory will be
+    ///                          moved to this.  On exit, detector's behavior
+    ///                          is undefined.
+    /// @result The memory from detector moved to this.
+    SubspaceDetector& operator=(SubspaceDetector &&detector) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~SubspaceDetector();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the subspace detector.
+    /// @param[in] nChannels       The number of channels.
+    /// @param[in] templateLength  The number of samples in each channel of a
+    ///                            template.  This must be at least 2.
+    /// @param[in] nTemplates      The number of templates.
+    /// @param[in] templates       The aligned templates.  This is a row-major
+    ///                            [nTemplates x nChannels x templateLength]
+    ///                            array.
+    /// @param[in] dimension       The dimension of the subspace.  This must be
+    ///                            in the range
+    ///                            [1, min(nTemplates, nChannels*templateLength)].
+    /// @throws std::invalid_argument if any argument is out of range, the
+    ///         templates are NULL, or a template has no energy.
+    void initialize(int nChannels,
+                    int templateLength,
+                    int nTemplates,
+                    const double templates[],
+                    int dimension);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @result The number of samples in each channel of a template.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getTemplateLength() const;
+    /// @result The dimension of the subspace.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getDimension() const;
+    /// @result The singular values of the normalized template matrix in
+    ///         decreasing order.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<double> getSingularValues() const;
+    /// @result The fraction of the templates' energy captured by the
+    ///         subspace, i.e., the sum of the d largest squared singular
+    ///         values divided by the sum of all squared singular values.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getCapturedEnergyFraction() const;
+    /// @}
+
+    /// @name Detection
+    /// @{
+    /// @brief Computes the detection statistic.
+    /// @param[in] nSamples  The number of samples in each channel.
+    /// @param[in] x         The signals.  This is a row-major
+    ///                      [nChannels x nSamples] matrix.
+    /// @param[out] y        The detection statistic.  y[n] corresponds to the
+    ///                      window that starts at sample
+    ///                      n - templateLength + 1.  This is an array whose
+    ///                      dimension is [nSamples].
+    /// @throws std::invalid_argument if x or y is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int nSamples, const T x[], T *y[]);
+    /// @brief Zeros the saved samples of each channel.  This is useful when
+    ///        dealing with a gap.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class SubspaceDetectorImpl;
+    std::unique_ptr<SubspaceDetectorImpl> pImpl;
+};
+}
+#endif
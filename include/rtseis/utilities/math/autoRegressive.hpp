@@ -0,0 +1,157 @@
+#ifndef RTSEIS_UTILS_MATH_AUTOREGRESSIVE_HPP
+#define RTSEIS_UTILS_MATH_AUTOREGRESSIVE_HPP 1
+#include <memory>
+#include <vector>
+namespace RTSeis::Utilities::Math::AutoRegressive
+{
+/// @brief Defines the autoregressive model estimator.
+enum class Method
+{
+    BURG,       /*!< Burg's method which minimizes the sum of the forward
+                     and backward prediction errors.  This is well suited
+                     to short windows. */
+    YULE_WALKER /*!< The biased autocorrelation is solved with the
+                     Levinson-Durbin recursion. */
+};
+
+/// @name Autoregressive Model Estimation
+/// @{
+/// @brief Solves the Yule-Walker equations with the Levinson-Durbin
+///        recursion.  The model is
+///        \f[
+///            x[n] + \sum_{k=1}^p a_k x[n-k] = e[n].
+///        \f]
+/// @param[in] order            The model order p.  This must be positive.
+/// @param[in] autocorrelation  The autocorrelation at lags 0, 1, ..., p.
+///                             This is an array whose dimension is
+///                             [order + 1].
+/// @param[out] variance        If not NULL then this is the prediction error
+///                             variance.
+/// @result The coefficients \f$ 1, a_1, \ldots, a_p \f$.  This has dimension
+///         [order + 1].  If the recursion becomes singular the remaining
+///         coefficients are zero.
+/// @throws std::invalid_argument if order is not positive or
+///         autocorrelation is NULL.
+/// @ingroup rtseis_utils_math_autoregressive
+std::vector<double> levinsonDurbin(int order, const double autocorrelation[],
+                                   double *variance = nullptr);
+/// @brief Estimates an autoregressive model of a signal.
+/// @param[in] n          The number of samples in x.  This must be greater
+///                       than order.
+/// @param[in] x          The signal.  This is an array whose dimension is
+///                       [n].
+/// @param[in] order      The model order.  This must be positive.
+/// @param[out] variance  If not NULL then this is the prediction error
+///                       variance.
+/// @param[in] method     The estimator.
+/// @result The coefficients \f$ 1, a_1, \ldots, a_p \f$.  This has dimension
+///         [order + 1].
+/// @throws std::invalid_argument if order is not positive, n is too small,
+///         or x is NULL.
+/// @ingroup rtseis_utils_math_autoregressive
+template<typename T>
+std::vector<double> estimate(int n, const T x[], int order,
+                             double *variance = nullptr,
+                             Method method = Method::BURG);
+/// @}
+
+/// @class SlidingAutoRegressive autoRegressive.hpp "rtseis/utilities/math/autoRegressive.hpp"
+/// @brief Tracks the Yule-Walker autoregressive model of the latest samples
+///        of a stream.  The autocorrelation at lags 0 through p of the
+///        window is updated incrementally as samples enter and leave the
+///        window so each sample costs O(p).  The model is obtained with the
+///        Levinson-Durbin recursion on request.
+/// @note To keep roundoff from accumulating the autocorrelation is
+///       recomputed from the window after every window length updates.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+/// @ingroup rtseis_utils_math_autoregressive
+template<class T = double>
+class SlidingAutoRegressive
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    SlidingAutoRegressive();
+    /// @brief Copy constructor.
+    /// @param[in] ar  The sliding autoregressive class from which to
+    ///                initialize this class.
+    SlidingAutoRegressive(const SlidingAutoRegressive &ar);
+    /// @brief Move constructor.
+    /// @param[in,out] ar  The sliding autoregressive class from which to
+    ///                    initialize this class.  On exit, ar's behavior is
+    ///                    undefined.
+    SlidingAutoRegressive(SlidingAutoRegressive &&ar) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] ar  The sliding autoregressive class to copy to this.
+    /// @result A deep copy of the sliding autoregressive class.
+    SlidingAutoRegressive& operator=(const SlidingAutoRegressive &ar);
+    /// @brief Move assignment operator.
+    /// @param[in,out] ar  The sliding autoregressive class whose memory will
+    ///                    be moved to this.  On exit, ar's behavior is
+    ///                    undefined.
+    /// @result The memory from ar moved to this.
+    SlidingAutoRegressive& operator=(SlidingAutoRegressive &&ar) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~SlidingAutoRegressive();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the sliding autoregressive model.
+    /// @param[in] windowLength  The number of samples in the window.  This
+    ///                          must be greater than order.
+    /// @param[in] order         The model order.  This must be positive.
+    /// @throws std::invalid_argument if the order or window length is
+    ///         invalid.
+    void initialize(int windowLength, int order);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples in the window.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getWindowLength() const;
+    /// @result The model order.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getOrder() const;
+    /// @}
+
+    /// @name Streaming
+    /// @{
+    /// @brief Pushes samples into the window.
+    /// @param[in] nSamples  The number of samples.
+    /// @param[in] x         The samples.  This is an array whose dimension
+    ///                      is [nSamples].
+    /// @throws std::invalid_argument if x is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void update(int nSamples, const T x[]);
+    /// @result The biased autocorrelation of the window at lags 0 through
+    ///         order.  Samples that have not been pushed are zero.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<double> getAutocorrelation() const;
+    /// @param[out] variance  If not NULL then this is the prediction error
+    ///                       variance.
+    /// @result The model coefficients \f$ 1, a_1, \ldots, a_p \f$ of the
+    ///         window.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<double>
+        getCoefficients(double *variance = nullptr) const;
+    /// @brief Zeros the window.  This is useful when dealing with a gap.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class SlidingAutoRegressiveImpl;
+    std::unique_ptr<SlidingAutoRegressiveImpl> pImpl;
+};
+}
+#endif
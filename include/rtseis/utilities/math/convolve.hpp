@@ -90,6 +90,17 @@ void convolve(const int na, const double a[],
               int *nc, double *c[],
               const Mode mode = Mode::FULL,
               const Implementation implementation = Implementation::AUTO);
+/*!
+ * @brief Computes the convolution \f$ c[k] = \sum_n a[n] b[n-k] \f$.
+ *        This is the float analog of the above function.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void convolve(const int na, const float a[],
+              const int nb, const float b[],
+              const int maxc,
+              int *nc, float *c[],
+              const Mode mode = Mode::FULL,
+              const Implementation implementation = Implementation::AUTO);
 /*!
  * @brief Computes the correlation \f$ c[k] = \sum_n a[n] b[n+k] \f$.
  * @param[in] a        First array in correlation.  This has length [m]
@@ -134,6 +145,17 @@ void correlate(const int na, const double a[],
                int *nc, double *c[],
                const Mode mode = Mode::FULL,
                const Implementation implementation = Implementation::AUTO);
+/*!
+ * @brief Computes the correlation \f$ c[k] = \sum_n a[n] b[n+k] \f$.
+ *        This is the float analog of the above function.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void correlate(const int na, const float a[],
+               const int nb, const float b[],
+               const int maxc,
+               int *nc, float *c[],
+               const Mode mode = Mode::FULL,
+               const Implementation implementation = Implementation::AUTO);
 /*!
  * @brief Computes the autocorrelation \f$ c[k] = \sum_n a[n] a[n+k] \f$.
  * @param[in] a     Array to autocorrelation.  This has length [m].
@@ -168,6 +190,15 @@ void autocorrelate(const int na, const double a[],
                    const int maxc, int *nc, double *c[],
                    const Mode mode = Convolve::Mode::FULL,
                    const Implementation implementation = Implementation::AUTO);
+/*!
+ * @brief Computes the autocorrelation \f$ c[k] = \sum_n a[n] a[n+k] \f$.
+ *        This is the float analog of the above function.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void autocorrelate(const int na, const float a[],
+                   const int maxc, int *nc, float *c[],
+                   const Mode mode = Convolve::Mode::FULL,
+                   const Implementation implementation = Implementation::AUTO);
 
 /*!
  * @brief Utility routine to deterimine the length of a convolution or 
@@ -64,6 +64,8 @@ public:
     /// @throws std::invalid_argument if nx is too small, x is NULL, or x is
     ///         comprised of all identical values.
     void initialize(int nx, const double x[]);
+    /// @copydoc initialize
+    void initialize(int nx, const float x[]);
     /// @result True indicates that the class is initialized.
     [[nodiscard]] bool isInitialized() const noexcept;
     /// @brief Applies the z-score normalization.
@@ -0,0 +1,183 @@
+#ifndef RTSEIS_UTILITIES_QUALITY_ACTIVITYGATE_HPP
+#define RTSEIS_UTILITIES_QUALITY_ACTIVITYGATE_HPP 1
+#include <memory>
+#include <cstdint>
+namespace RTSeis::Utilities::Quality
+{
+/// @brief Defines what the caller should do with a packet.
+enum class GateDecision
+{
+    PROCESS, /*!< Run the packet through the processing chain. */
+    RESUME,  /*!< The channel became active after being skipped.  Set the
+                  chain's stateful stages, e.g., filters and STA/LTA
+                  averages, to their steady state for a constant input
+                  equal to \c ActivityGate::getRestingLevel() then process
+                  the packet. */
+    SKIP     /*!< The channel is inactive and the chain's states have
+                  settled so the packet need not be processed. */
+};
+
+/// @class ActivityGate activityGate.hpp "rtseis/utilities/quality/activityGate.hpp"
+/// @brief Decides which packets of streaming channels need to run through
+///        an expensive processing chain, e.g., SOS filtering, STA/LTA, and
+///        polarization.  Dead, flatlined, or quiet channels are skipped.
+/// @note A packet is inactive if its peak-to-peak range is at most the quiet
+///       level.  Unlike the variance, the range bounds every sample's
+///       deviation from the packet's mean so a short transient cannot hide
+///       in a long packet.  The range is computed in one vectorized pass.
+///       A packet with a NaN or infinite sample is active so that the
+///       chain, which must handle it anyway, sees it.
+/// @note An inactive channel need not be near zero, e.g., a flatlined
+///       digitizer may sit at a large DC offset.  The chain's states are kept
+///       consistent as follows.  After the last active packet the gate keeps
+///       processing for the hold duration so that the chain settles to its
+///       steady state for the near-constant input.  Only then are packets
+///       skipped.  The gate records the resting level, i.e., the mean of the
+///       latest inactive packet.  The first active packet after skipping is
+///       flagged so the caller can restart the chain from the steady state
+///       for the resting level.  This matches the settled states so no step
+///       transient is injected.  Resetting to a zero state instead is only
+///       correct when the resting level is near zero.  The hold should be at
+///       least the longest memory of the chain, e.g., the LTA window or the
+///       time for the filters' impulse responses to decay.
+/// @note A channel starts skipped so its first active packet is a
+///       resumption.
+/// @note Channels do not share state so different channels may be updated
+///       from different threads.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class ActivityGate
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    ActivityGate();
+    /// @brief Copy constructor.
+    /// @param[in] gate  The gate from which to initialize this class.
+    ActivityGate(const ActivityGate &gate);
+    /// @brief Move constructor.
+    /// @param[in,out] gate  The gate from which to initialize this class.
+    ///                      On exit, gate's behavior is undefined.
+    ActivityGate(ActivityGate &&gate) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] gate  The gate to copy to this.
+    /// @result A deep copy of the gate.
+    ActivityGate& operator=(const ActivityGate &gate);
+    /// @brief Move assignment operator.
+    /// @param[in,out] gate  The gate whose memory will be moved to this.
+    ///                      On exit, gate's behavior is undefined.
+    /// @result The memory from gate moved to this.
+    ActivityGate& operator=(ActivityGate &&gate) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~ActivityGate();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the gate.
+    /// @param[in] nChannels    The number of channels.  This must be
+    ///                         positive.
+    /// @param[in] quietLevel   Packets whose peak-to-peak range is at most
+    ///                         this are inactive, e.g., a few counts above
+    ///                         the digitizer noise.  Setting this to zero
+    ///                         skips only dead or flatlined channels.  This
+    ///                         must be non-negative.
+    /// @param[in] holdSamples  The number of inactive samples to process
+    ///                         after an active packet before skipping.  This
+    ///                         must be non-negative.
+    /// @throws std::invalid_argument if any argument is out of range.
+    void initialize(int nChannels, double quietLevel, int holdSamples);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @}
+
+    /// @name Gating
+    /// @{
+    /// @brief Decides whether a channel's packet needs to be processed and
+    ///        updates the counters.
+    /// @param[in] channel   The channel index.  This must be in the range
+    ///                      [0, \c getNumberOfChannels()).
+    /// @param[in] nSamples  The number of samples in the packet.
+    /// @param[in] x         The packet.  This is an array whose dimension is
+    ///                      [nSamples].
+    /// @result What the caller should do with the packet.  An empty packet
+    ///         is skipped without changing the gate.
+    /// @throws std::invalid_argument if channel is out of range or x is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] GateDecision update(int channel, int nSamples, const T x[]);
+    /// @param[in] channel  The channel index.
+    /// @result True indicates that the channel's packets are being skipped.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] bool isSkipping(int channel) const;
+    /// @param[in] channel  The channel index.
+    /// @result The mean of the channel's latest inactive packet.  This is
+    ///         the constant input from which to restart the chain on
+    ///         \c GateDecision::RESUME.  If no inactive packet preceded the
+    ///         resumption then this is the resuming packet's first finite
+    ///         sample or zero if it has none.  This is always finite.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getRestingLevel(int channel) const;
+    /// @brief Restarts every channel as skipped.  The counters are kept.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+
+    /// @name Counters
+    /// @{
+    /// @param[in] channel  The channel index.  If this is negative then the
+    ///                     result is the sum over all channels.
+    /// @result The number of packets passed to \c update().
+    /// @throws std::invalid_argument if channel is too large.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int64_t getNumberOfPackets(int channel = -1) const;
+    /// @param[in] channel  The channel index or a negative number for all
+    ///                     channels.
+    /// @result The number of skipped packets.
+    /// @throws std::invalid_argument if channel is too large.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int64_t getNumberOfSkippedPackets(int channel = -1) const;
+    /// @param[in] channel  The channel index or a negative number for all
+    ///                     channels.
+    /// @result The number of samples passed to \c update().
+    /// @throws std::invalid_argument if channel is too large.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int64_t getNumberOfSamples(int channel = -1) const;
+    /// @param[in] channel  The channel index or a negative number for all
+    ///                     channels.
+    /// @result The number of skipped samples.  This over the number of
+    ///         samples is the fraction of the processing that was saved.
+    /// @throws std::invalid_argument if channel is too large.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int64_t getNumberOfSkippedSamples(int channel = -1) const;
+    /// @param[in] channel  The channel index or a negative number for all
+    ///                     channels.
+    /// @result The number of times that the channel resumed processing.
+    /// @throws std::invalid_argument if channel is too large.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int64_t getNumberOfResumptions(int channel = -1) const;
+    /// @brief Zeros the counters.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetCounters();
+    /// @}
+private:
+    class ActivityGateImpl;
+    std::unique_ptr<ActivityGateImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,157 @@
+#ifndef RTSEIS_UTILITIES_QUALITY_QUALITYMETRICS_HPP
+#define RTSEIS_UTILITIES_QUALITY_QUALITYMETRICS_HPP 1
+#include <memory>
+#include <vector>
+#include "rtseis/utilities/quality/qualitySummary.hpp"
+namespace RTSeis::Utilities::Quality
+{
+/// @class QualityMetrics qualityMetrics.hpp "rtseis/utilities/quality/qualityMetrics.hpp"
+/// @brief Computes data quality metrics of streaming channels.  Packets are
+///        summarized into bins of fixed duration, e.g., an hour, that are
+///        aligned to the epoch.  For each bin and channel the metrics are the
+///        availability, the number of gaps, the mean (DC offset), the RMS,
+///        the extrema, the number of clipped samples, the number of spikes,
+///        the longest flatline, and whether the channel is dead.  See
+///        \c QualitySummary.
+/// @note A sample is clipped if its magnitude is at least the clip level.
+///       A sample is a spike if the differences to its neighbors both exceed
+///       the spike threshold in magnitude and have opposite signs.  A gap is
+///       a packet that starts more than half a sample after the previous
+///       packet ended.  Spikes and flatlines are tracked across packets but
+///       not across gaps.
+/// @note Bins without samples, e.g., during an outage, are reported as
+///       empty summaries with zero availability so that a dead channel is
+///       not silently missing from the reports.  Since a channel that has
+///       stopped sends no packets, call \c advance() with the wall-clock
+///       time to complete its bins.
+/// @note Each packet is processed in one vectorized pass for the moments,
+///       extrema, clips, and spikes and one pass for the flatlines.  A
+///       channel's state is a few numbers plus its open bin so the memory
+///       does not grow with the bin duration.
+/// @note Channels do not share state so different channels may be updated
+///       from different threads.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class QualityMetrics
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    QualityMetrics();
+    /// @brief Copy constructor.
+    /// @param[in] metrics  The metrics class from which to initialize this
+    ///                     class.
+    QualityMetrics(const QualityMetrics &metrics);
+    /// @brief Move constructor.
+    /// @param[in,out] metrics  The metrics class from which to initialize
+    ///                         this class.  On exit, metrics's behavior is
+    ///                         undefined.
+    QualityMetrics(QualityMetrics &&metrics) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] metrics  The metrics class to copy to this.
+    /// @result A deep copy of the metrics class.
+    QualityMetrics& operator=(const QualityMetrics &metrics);
+    /// @brief Move assignment operator.
+    /// @param[in,out] metrics  The metrics class whose memory will be moved
+    ///                         to this.  On exit, metrics's behavior is
+    ///                         undefined.
+    /// @result The memory from metrics moved to this.
+    QualityMetrics& operator=(QualityMetrics &&metrics) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~QualityMetrics();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the metrics.
+    /// @param[in] nChannels       The number of channels.  This must be
+    ///                            positive.
+    /// @param[in] samplingRate    The sampling rate in Hz.  This must be
+    ///                            positive.
+    /// @param[in] clipLevel       Samples whose magnitude is at least this
+    ///                            are clipped, e.g., the digitizer's full
+    ///                            scale.  This must be positive.
+    /// @param[in] spikeThreshold  The first difference magnitude that
+    ///                            defines a spike.  This must be positive.
+    /// @param[in] binDuration     The duration of a bin in seconds, e.g., 3600
+    ///                            for hourly or 86400 for daily summaries.
+    ///                            This must be at least one sample.
+    /// @throws std::invalid_argument if any argument is out of range.
+    void initialize(int nChannels, double samplingRate,
+                    double clipLevel, double spikeThreshold,
+                    double binDuration = 3600);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of channels.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfChannels() const;
+    /// @result The bin duration in seconds.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getBinDuration() const;
+    /// @}
+
+    /// @name Streaming
+    /// @{
+    /// @brief Adds a packet to a channel's metrics.  Packets of a channel
+    ///        should arrive in time order.  A packet that belongs to a bin
+    ///        that has already been completed is summarized on its own and
+    ///        returned with the completed summaries.  A late packet, i.e.,
+    ///        one that ends before the previous packets ended, is summarized
+    ///        without changing the gap and continuity tracking of the
+    ///        in-order packets.
+    /// @param[in] channel    The channel index.  This must be in the range
+    ///                       [0, \c getNumberOfChannels()).
+    /// @param[in] startTime  The time of the first sample in UTC seconds
+    ///                       since the epoch.
+    /// @param[in] nSamples   The number of samples in the packet.
+    /// @param[in] x          The packet.  This is an array whose dimension
+    ///                       is [nSamples].
+    /// @throws std::invalid_argument if channel is out of range or x is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void update(int channel, double startTime, int nSamples, const T x[]);
+    /// @param[in] channel  The channel index.
+    /// @result The summaries of the channel's completed bins since the last
+    ///         call.  The summaries are removed from the class.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] std::vector<QualitySummary> popCompletedSummaries(int channel);
+    /// @param[in] channel  The channel index.
+    /// @result The summary of the channel's open bin so far.  This is empty
+    ///         if no packet has arrived since the last completed bin.
+    /// @throws std::invalid_argument if channel is out of range.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] QualitySummary getCurrentSummary(int channel) const;
+    /// @brief Completes every channel's bins that end at or before the
+    ///        given time.  Bins that received no samples are reported as
+    ///        empty summaries.  A channel that has not received a packet
+    ///        starts reporting with the bin containing the time of the
+    ///        first call.
+    /// @param[in] time  The time, e.g., the current wall-clock time less the
+    ///                  expected latency, in UTC seconds since the epoch.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void advance(double time);
+    /// @brief Completes every channel's open bin, e.g., at shutdown.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void flush();
+    /// @brief Discards the open bins and the completed summaries and
+    ///        forgets the previous packets.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class QualityMetricsImpl;
+    std::unique_ptr<QualityMetricsImpl> pImpl;
+};
+}
+#endif
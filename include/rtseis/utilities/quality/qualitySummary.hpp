@@ -0,0 +1,150 @@
+#ifndef RTSEIS_UTILITIES_QUALITY_QUALITYSUMMARY_HPP
+#define RTSEIS_UTILITIES_QUALITY_QUALITYSUMMARY_HPP 1
+#include <memory>
+#include <vector>
+#include <cstdint>
+namespace RTSeis::Utilities::Quality
+{
+/// @class QualitySummary qualitySummary.hpp "rtseis/utilities/quality/qualitySummary.hpp"
+/// @brief Summarizes the data quality of a channel over a time interval,
+///        e.g., an hour or a day.  The summary holds the number of expected
+///        and received samples, the number of gaps, the mean and sum of
+///        squared deviations, the extrema, the number of clipped samples,
+///        the number of spikes, and the longest run of identical samples.
+/// @note Summaries are mergeable.  Merging the summaries of disjoint
+///       intervals gives the summary of their union, e.g., 24 hourly
+///       summaries merge to a daily summary.  The moments are combined with
+///       the pairwise update of Chan et al. (1979) so no samples are
+///       revisited.  The longest flatline of a merge is the longer of the
+///       two since runs that straddle the intervals' boundary are not
+///       tracked.
+/// @note A summary serializes to a fixed size array of bytes.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class QualitySummary
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    QualitySummary();
+    /// @brief Copy constructor.
+    /// @param[in] summary  The summary from which to initialize this class.
+    QualitySummary(const QualitySummary &summary);
+    /// @brief Move constructor.
+    /// @param[in,out] summary  The summary from which to initialize this
+    ///                         class.  On exit, summary's behavior is
+    ///                         undefined.
+    QualitySummary(QualitySummary &&summary) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] summary  The summary to copy to this.
+    /// @result A deep copy of the summary.
+    QualitySummary& operator=(const QualitySummary &summary);
+    /// @brief Move assignment operator.
+    /// @param[in,out] summary  The summary whose memory will be moved to
+    ///                         this.  On exit, summary's behavior is
+    ///                         undefined.
+    /// @result The memory from summary moved to this.
+    QualitySummary& operator=(QualitySummary &&summary) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~QualitySummary();
+    /// @brief Resets the summary to an empty interval.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Sets the summary.
+    /// @param[in] startTime        The start of the interval in UTC seconds
+    ///                             since the epoch.
+    /// @param[in] endTime          The end of the interval in UTC seconds
+    ///                             since the epoch.  This must be at least
+    ///                             startTime.
+    /// @param[in] nExpected        The number of samples expected in the
+    ///                             interval.
+    /// @param[in] nSamples         The number of samples received.
+    /// @param[in] nGaps            The number of gaps.
+    /// @param[in] mean             The mean of the received samples.
+    /// @param[in] sumOfSquaredDeviations  The sum of the squared deviations
+    ///                             of the received samples from the mean.
+    /// @param[in] minimum          The smallest received sample.
+    /// @param[in] maximum          The largest received sample.
+    /// @param[in] nClipped         The number of clipped samples.
+    /// @param[in] nSpikes          The number of spikes.
+    /// @param[in] longestFlatline  The length of the longest run of identical
+    ///                             samples that ends in the interval.  The
+    ///                             run may have started before the
+    ///                             interval.
+    /// @throws std::invalid_argument if a count is negative, endTime is less
+    ///         than startTime, the clipped samples or spikes exceed nSamples,
+    ///         sumOfSquaredDeviations is negative, or minimum exceeds
+    ///         maximum.
+    void initialize(double startTime, double endTime,
+                    int64_t nExpected, int64_t nSamples, int64_t nGaps,
+                    double mean, double sumOfSquaredDeviations,
+                    double minimum, double maximum,
+                    int64_t nClipped, int64_t nSpikes,
+                    int64_t longestFlatline);
+    /// @brief Merges the summary of a disjoint interval into this summary.
+    /// @param[in] summary  The summary to merge.
+    void merge(const QualitySummary &summary);
+    /// @}
+
+    /// @name Metrics
+    /// @{
+    /// @result The start of the interval in UTC seconds since the epoch.
+    [[nodiscard]] double getStartTime() const noexcept;
+    /// @result The end of the interval in UTC seconds since the epoch.
+    [[nodiscard]] double getEndTime() const noexcept;
+    /// @result The number of samples expected in the interval.
+    [[nodiscard]] int64_t getExpectedNumberOfSamples() const noexcept;
+    /// @result The number of samples received.
+    [[nodiscard]] int64_t getNumberOfSamples() const noexcept;
+    /// @result The percentage of the expected samples that were received.
+    ///         This is zero if no samples were expected.
+    [[nodiscard]] double getAvailability() const noexcept;
+    /// @result The number of gaps.
+    [[nodiscard]] int64_t getNumberOfGaps() const noexcept;
+    /// @result The mean, i.e., the DC offset.
+    [[nodiscard]] double getMean() const noexcept;
+    /// @result The root mean square of the samples.
+    [[nodiscard]] double getRMS() const noexcept;
+    /// @result The standard deviation of the samples.
+    [[nodiscard]] double getStandardDeviation() const noexcept;
+    /// @result The smallest sample.
+    [[nodiscard]] double getMinimum() const noexcept;
+    /// @result The largest sample.
+    [[nodiscard]] double getMaximum() const noexcept;
+    /// @result The number of clipped samples.
+    [[nodiscard]] int64_t getNumberOfClippedSamples() const noexcept;
+    /// @result The number of spikes.
+    [[nodiscard]] int64_t getNumberOfSpikes() const noexcept;
+    /// @result The length of the longest run of identical samples.
+    [[nodiscard]] int64_t getLongestFlatline() const noexcept;
+    /// @result True indicates that the channel is dead, i.e., no samples
+    ///         were received or every sample is identical.
+    [[nodiscard]] bool isDead() const noexcept;
+    /// @}
+
+    /// @name Serialization
+    /// @{
+    /// @result The summary as an array of bytes.
+    [[nodiscard]] std::vector<char> serialize() const;
+    /// @brief Sets the summary from an array of bytes.
+    /// @param[in] bytes  The bytes created by \c serialize().
+    /// @throws std::invalid_argument if the bytes are not a summary.
+    void deserialize(const std::vector<char> &bytes);
+    /// @}
+private:
+    class QualitySummaryImpl;
+    std::unique_ptr<QualitySummaryImpl> pImpl;
+};
+}
+#endif
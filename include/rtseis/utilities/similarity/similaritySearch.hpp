@@ -0,0 +1,154 @@
+#ifndef RTSEIS_UTILITIES_SIMILARITY_SIMILARITYSEARCH_HPP
+#define RTSEIS_UTILITIES_SIMILARITY_SIMILARITYSEARCH_HPP 1
+#include <memory>
+#include <vector>
+#include <cstdint>
+namespace RTSeis::Utilities::Similarity
+{
+/// @brief A pair of similar fingerprints.
+struct SimilarPair
+{
+    int first = 0;      /*!< The index of the first fingerprint. */
+    int second = 0;     /*!< The index of the second fingerprint.  This is
+                             greater than first. */
+    int similarity = 0; /*!< The number of hash tables in which the
+                             fingerprints share a bucket. */
+};
+
+/// @class SimilaritySearch similaritySearch.hpp "rtseis/utilities/similarity/similaritySearch.hpp"
+/// @brief An approximate all-pairs similarity search over sparse binary
+///        fingerprints with MinHash locality sensitive hashing (LSH).
+///        Each fingerprint is summarized by \f$ b r \f$ MinHash values.
+///        These are grouped into b hash tables whose keys combine r values
+///        so that two fingerprints whose Jaccard similarity is J share a
+///        bucket in a table with probability \f$ J^r \f$.  Pairs that share
+///        buckets in at least a threshold number of tables are reported.
+///        This replaces the \f$ O(N^2) \f$ comparisons with work that is
+///        nearly linear in the number of fingerprints.
+/// @note The index is stored compactly as one sorted array of keys and one
+///       array of fingerprint indices per table.  It takes 12 bytes per
+///       fingerprint per table.
+/// @note The signatures, the tables, and the search are computed in
+///       parallel.  The results do not depend on the number of threads.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+class SimilaritySearch
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    SimilaritySearch();
+    /// @brief Copy constructor.
+    /// @param[in] search  The similarity search class from which to
+    ///                    initialize this class.
+    SimilaritySearch(const SimilaritySearch &search);
+    /// @brief Move constructor.
+    /// @param[in,out] search  The similarity search class from which to
+    ///                        initialize this class.  On exit, search's
+    ///                        behavior is undefined.
+    SimilaritySearch(SimilaritySearch &&search) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] search  The similarity search class to copy to this.
+    /// @result A deep copy of the similarity search.
+    SimilaritySearch& operator=(const SimilaritySearch &search);
+    /// @brief Move assignment operator.
+    /// @param[in,out] search  The similarity search class whose memory will
+    ///                        be moved to this.  On exit, search's behavior
+    ///                        is undefined.
+    /// @result The memory from search moved to this.
+    SimilaritySearch& operator=(SimilaritySearch &&search) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~SimilaritySearch();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the search.
+    /// @param[in] nTables             The number of hash tables.
+    /// @param[in] hashesPerTable      The number of MinHash values combined
+    ///                                into a table's key.
+    /// @param[in] detectionThreshold  The minimum number of tables in which
+    ///                                two fingerprints must share a bucket
+    ///                                to be reported.
+    /// @param[in] maxBucketSize       Buckets with more fingerprints than
+    ///                                this are ignored by the all-pairs
+    ///                                search since they typically hold
+    ///                                noise.  If this is not positive then
+    ///                                all buckets are used.
+    /// @param[in] minimumSeparation   Pairs whose indices differ by less
+    ///                                than this are not reported.  This
+    ///                                excludes overlapping fingerprints.
+    /// @param[in] seed                The seed of the hash functions.
+    /// @throws std::invalid_argument if nTables or hashesPerTable is not
+    ///         positive or the threshold is not in the range [1,nTables].
+    void initialize(int nTables = 100,
+                    int hashesPerTable = 4,
+                    int detectionThreshold = 5,
+                    int maxBucketSize = 0,
+                    int minimumSeparation = 1,
+                    uint64_t seed = 8675309);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of hash tables.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfTables() const;
+    /// @}
+
+    /// @name Index
+    /// @{
+    /// @brief Builds the index.  This replaces any existing index.
+    /// @param[in] nFingerprints  The number of fingerprints.
+    /// @param[in] nBits          The number of set bits in each fingerprint.
+    /// @param[in] fingerprints   The indices of the set bits of each
+    ///                           fingerprint.  This is an
+    ///                           [nFingerprints x nBits] matrix stored in
+    ///                           row major order.
+    /// @throws std::invalid_argument if nFingerprints or nBits is not
+    ///         positive or fingerprints is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void buildIndex(int nFingerprints, int nBits, const int fingerprints[]);
+    /// @result True indicates the index was built.
+    [[nodiscard]] bool haveIndex() const noexcept;
+    /// @result The number of fingerprints in the index.
+    /// @throws std::runtime_error if \c haveIndex() is false.
+    [[nodiscard]] int getNumberOfFingerprints() const;
+    /// @}
+
+    /// @name Search
+    /// @{
+    /// @result All pairs of indexed fingerprints that share buckets in at
+    ///         least the detection threshold number of tables.  The pairs
+    ///         are sorted by the first and then the second index.
+    /// @throws std::runtime_error if \c haveIndex() is false.
+    [[nodiscard]] std::vector<SimilarPair> findSimilarPairs() const;
+    /// @brief Finds the indexed fingerprints similar to a query fingerprint.
+    /// @param[in] nBits        The number of set bits in the fingerprint.
+    /// @param[in] fingerprint  The indices of the set bits.  This is an
+    ///                         array whose dimension is [nBits].
+    /// @result The indexed fingerprints that share buckets with the query
+    ///         in at least the detection threshold number of tables.  The
+    ///         first index of each pair is the index of the indexed
+    ///         fingerprint and the second index is -1.  The pairs are sorted
+    ///         by the first index.
+    /// @throws std::invalid_argument if nBits is not positive or fingerprint
+    ///         is NULL.
+    /// @throws std::runtime_error if \c haveIndex() is false.
+    [[nodiscard]] std::vector<SimilarPair> query(int nBits,
+                                                 const int fingerprint[]) const;
+    /// @}
+private:
+    class SimilaritySearchImpl;
+    std::unique_ptr<SimilaritySearchImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,147 @@
+#ifndef RTSEIS_UTILITIES_SIMILARITY_SPECTRALFINGERPRINT_HPP
+#define RTSEIS_UTILITIES_SIMILARITY_SPECTRALFINGERPRINT_HPP 1
+#include <memory>
+#include <vector>
+namespace RTSeis::Utilities::Similarity
+{
+/// @class SpectralFingerprint spectralFingerprint.hpp "rtseis/utilities/similarity/spectralFingerprint.hpp"
+/// @brief Computes the binary waveform fingerprints of Fingerprint And
+///        Similarity Thresholding (FAST) from Yoon et al. (2015).
+///        The amplitude spectrogram of the signal is pooled into a few
+///        frequency bands within the band of interest and cut into
+///        overlapping images.  Each image is compressed with a 2D Haar
+///        wavelet transform.  Each Haar coefficient is standardized with its
+///        median and median absolute deviation over the images.  The
+///        fingerprint keeps the signs of the coefficients with the largest
+///        standardized magnitude.
+/// @note A fingerprint is a sparse binary vector of length
+///       \f$ 2 n_f n_t \f$ where \f$ n_f \f$ and \f$ n_t \f$ are the number
+///       of frequency and time samples in an image.  Coefficient c sets
+///       bit 2c if it is positive and bit 2c+1 if it is negative.  Only the
+///       indices of the set bits are stored.
+/// @note The spectrogram is computed in blocks of windows and the
+///       fingerprints are computed in parallel.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class SpectralFingerprint
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    SpectralFingerprint();
+    /// @brief Copy constructor.
+    /// @param[in] fingerprint  The fingerprint class from which to
+    ///                         initialize this class.
+    SpectralFingerprint(const SpectralFingerprint &fingerprint);
+    /// @brief Move constructor.
+    /// @param[in,out] fingerprint  The fingerprint class from which to
+    ///                             initialize this class.  On exit,
+    ///                             fingerprint's behavior is undefined.
+    SpectralFingerprint(SpectralFingerprint &&fingerprint) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] fingerprint  The fingerprint class to copy to this.
+    /// @result A deep copy of the fingerprint class.
+    SpectralFingerprint& operator=(const SpectralFingerprint &fingerprint);
+    /// @brief Move assignment operator.
+    /// @param[in,out] fingerprint  The fingerprint class whose memory will be
+    ///                             moved to this.  On exit, fingerprint's
+    ///                             behavior is undefined.
+    /// @result The memory from fingerprint moved to this.
+    SpectralFingerprint& operator=(SpectralFingerprint &&fingerprint) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~SpectralFingerprint();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the fingerprinting.
+    /// @param[in] samplingRate       The sampling rate in Hz.
+    /// @param[in] windowLength       The number of samples in each
+    ///                               spectrogram window.  A Hann window is
+    ///                               applied.
+    /// @param[in] windowLag          The number of samples between
+    ///                               successive spectrogram windows.  This
+    ///                               must be in the range [1,windowLength].
+    /// @param[in] imageLength        The number of spectrogram windows in an
+    ///                               image.  This must be a power of 2 and
+    ///                               at least 2.
+    /// @param[in] imageLag           The number of spectrogram windows
+    ///                               between successive images.
+    /// @param[in] nImageFrequencies  The number of frequency bands in an
+    ///                               image.  This must be a power of 2 and
+    ///                               at least 2.
+    /// @param[in] nTopCoefficients   The number of Haar coefficients kept
+    ///                               in each fingerprint.
+    /// @param[in] minFrequency       The lowest frequency in Hz.
+    /// @param[in] maxFrequency       The highest frequency in Hz.  If this
+    ///                               is negative then the Nyquist frequency
+    ///                               is used.
+    /// @throws std::invalid_argument if any argument is out of range or the
+    ///         frequency band does not contain at least nImageFrequencies
+    ///         spectrogram frequencies.
+    void initialize(double samplingRate,
+                    int windowLength,
+                    int windowLag,
+                    int imageLength = 64,
+                    int imageLag = 8,
+                    int nImageFrequencies = 32,
+                    int nTopCoefficients = 200,
+                    double minFrequency = 0,
+                    double maxFrequency =-1);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The sampling rate in Hz.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] double getSamplingRate() const;
+    /// @result The number of bits in a fingerprint.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getFingerprintLength() const;
+    /// @result The number of set bits in each fingerprint.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfTopCoefficients() const;
+    /// @}
+
+    /// @name Fingerprinting
+    /// @{
+    /// @brief Computes the fingerprints of a signal.
+    /// @param[in] nSamples  The number of samples in x.
+    /// @param[in] x         The signal.  This is an array whose dimension is
+    ///                      [nSamples].
+    /// @throws std::invalid_argument if x is NULL or the signal is too short
+    ///         to make one image.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void compute(int nSamples, const T x[]);
+    /// @result True indicates the fingerprints were computed.
+    [[nodiscard]] bool haveFingerprints() const noexcept;
+    /// @result The number of fingerprints.
+    /// @throws std::runtime_error if \c haveFingerprints() is false.
+    [[nodiscard]] int getNumberOfFingerprints() const;
+    /// @result The time in seconds of the start of each fingerprint's image
+    ///         measured from the first sample of the signal.  This has
+    ///         dimension [\c getNumberOfFingerprints()].
+    /// @throws std::runtime_error if \c haveFingerprints() is false.
+    [[nodiscard]] std::vector<double> getFingerprintTimes() const;
+    /// @result The indices of the set bits of the fingerprints in increasing
+    ///         order.  This is a
+    ///         [\c getNumberOfFingerprints() x \c getNumberOfTopCoefficients()]
+    ///         matrix stored in row major order.
+    /// @throws std::runtime_error if \c haveFingerprints() is false.
+    [[nodiscard]] std::vector<int> getFingerprints() const;
+    /// @}
+private:
+    class SpectralFingerprintImpl;
+    std::unique_ptr<SpectralFingerprintImpl> pImpl;
+};
+}
+#endif
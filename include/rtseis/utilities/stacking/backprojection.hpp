@@ -0,0 +1,132 @@
+#ifndef RTSEIS_UTILITIES_STACKING_BACKPROJECTION_HPP
+#define RTSEIS_UTILITIES_STACKING_BACKPROJECTION_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+namespace RTSeis::Utilities::Stacking
+{
+/// @class Backprojection backprojection.hpp "rtseis/utilities/stacking/backprojection.hpp"
+/// @brief Backprojects station envelopes onto a grid of trial sources.
+///        With the travel time from grid point g to station s given as the
+///        integer sample delay \f$ d_{gs} \f$ the brightness of grid point g
+///        at origin time sample t is the mean of the delayed envelopes
+///        \f[
+///          b_g[t] = \frac{1}{N_s} \sum_{s=1}^{N_s} e_s[t + d_{gs}].
+///        \f]
+///        The envelopes are typically computed with
+///        \c RTSeis::Transforms::Envelope or
+///        \c RTSeis::Transforms::FIREnvelope and then decimated so that the
+///        delays are small integers.
+/// @note The brightness is computed on tiles of grid points and origin times
+///       so that the delayed envelope segments used by a tile remain in
+///       cache.  Within a tile each station adds a contiguous envelope
+///       segment to each grid point's times which vectorizes without
+///       gathers.  The tiles are computed in parallel and each brightness
+///       is summed over the stations in order so the result does not depend
+///       on the number of threads.
+/// @note In post-processing mode origin times are computed while every
+///       delayed sample is in the signal.  In real-time mode the last
+///       \c getMaximumDelay() samples of each station are saved between
+///       calls and each packet of n samples produces the brightness of the n
+///       origin times that precede the newest samples by the maximum delay.
+///       Initially the saved samples are zero.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class Backprojection
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    Backprojection();
+    /// @brief Copy constructor.
+    /// @param[in] backprojection  The backprojection class from which to
+    ///                            initialize this class.
+    Backprojection(const Backprojection &backprojection);
+    /// @brief Move constructor.
+    /// @param[in,out] backprojection  The backprojection class from which to
+    ///                                initialize this class.  On exit,
+    ///                                backprojection's behavior is
+    ///                                undefined.
+    Backprojection(Backprojection &&backprojection) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] backprojection  The backprojection class to copy to this.
+    /// @result A deep copy of the backprojection class.
+    Backprojection& operator=(const Backprojection &backprojection);
+    /// @brief Move assignment operator.
+    /// @param[in,out] backprojection  The backprojection class whose memory
+    ///                                will be moved to this.  On exit,
+    ///                                backprojection's behavior is
+    ///                                undefined.
+    /// @result The memory from backprojection moved to this.
+    Backprojection& operator=(Backprojection &&backprojection) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~Backprojection();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the backprojection.
+    /// @param[in] nStations    The number of stations.
+    /// @param[in] nGridPoints  The number of grid points.
+    /// @param[in] delays       The travel time in samples from each grid
+    ///                         point to each station.  This is a row-major
+    ///                         [nGridPoints x nStations] matrix whose
+    ///                         values must be non-negative.
+    /// @throws std::invalid_argument if nStations or nGridPoints is not
+    ///         positive, delays is NULL, or a delay is negative.
+    void initialize(int nStations, int nGridPoints, const int delays[]);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of stations.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfStations() const;
+    /// @result The number of grid points.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfGridPoints() const;
+    /// @result The largest delay in samples.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getMaximumDelay() const;
+    /// @param[in] nSamples  The number of samples in each envelope.
+    /// @result The number of origin times computed from envelopes with
+    ///         nSamples samples.  In post-processing mode this is
+    ///         max(0, nSamples - \c getMaximumDelay()) and in real-time mode
+    ///         this is nSamples.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfOutputSamples(int nSamples) const;
+    /// @}
+
+    /// @name Backprojection
+    /// @{
+    /// @brief Computes the brightness of the grid.
+    /// @param[in] nSamples    The number of samples in each envelope.
+    /// @param[in] envelopes   The station envelopes.  This is a row-major
+    ///                        [nStations x nSamples] matrix.
+    /// @param[out] brightness The brightness of each grid point at each
+    ///                        origin time.  This is a row-major
+    ///                        [\c getNumberOfOutputSamples() x nGridPoints]
+    ///                        matrix so each row is an image of the grid.
+    /// @throws std::invalid_argument if envelopes or brightness is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int nSamples, const T envelopes[], T *brightness[]);
+    /// @brief Zeros the saved samples of each station.  This is useful when
+    ///        dealing with a gap.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void resetInitialConditions();
+    /// @}
+private:
+    class BackprojectionImpl;
+    std::unique_ptr<BackprojectionImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,153 @@
+#ifndef RTSEIS_UTILITIES_STACKING_STACK_HPP
+#define RTSEIS_UTILITIES_STACKING_STACK_HPP 1
+#include <memory>
+namespace RTSeis::Utilities::Stacking
+{
+/// @brief Defines the stack.
+enum class StackType
+{
+    LINEAR,        /*!< The mean of the aligned traces. */
+    NTH_ROOT,      /*!< The nth-root stack
+                        \f$ s = \textrm{sign}(\bar{r}) |\bar{r}|^N \f$
+                        where \f$ \bar{r} \f$ is the mean of
+                        \f$ \textrm{sign}(x_k) |x_k|^{1/N} \f$. */
+    PHASE_WEIGHTED /*!< The phase-weighted stack of Schimmel and Paulssen
+                        (1997) which is the linear stack multiplied by
+                        \f$ | \frac{1}{M} \sum_k e^{i \phi_k} |^\nu \f$
+                        where \f$ \phi_k \f$ is the instantaneous phase of
+                        the k'th trace. */
+};
+/// @brief Defines how traces are shifted by fractions of a sample.
+enum class FractionalShiftMethod
+{
+    FREQUENCY_DOMAIN, /*!< The trace's spectrum is multiplied by a phase
+                           ramp.  The trace is zero padded to at least twice
+                           its length so the shift does not wrap around. */
+    WINDOWED_SINC     /*!< The trace is convolved with a Hann windowed sinc
+                           whose half-width is 8 samples. */
+};
+
+/// @class Stack stack.hpp "rtseis/utilities/stacking/stack.hpp"
+/// @brief Aligns traces with per-trace fractional time shifts and stacks
+///        them with a linear, nth-root, or phase-weighted stack.
+/// @note Traces are processed in fixed blocks.  Each block is aligned and
+///       accumulated into its own partial sum in parallel and the partial
+///       sums are then added in block order.  Hence, the stack does not
+///       depend on the number of threads.
+/// @note The instantaneous phases of the phase-weighted stack are computed
+///       with the \c RTSeis::Transforms::Hilbert transform.
+/// @copyright Ben Baker (University of Utah) distributed under the MIT license.
+template<class T = double>
+class Stack
+{
+public:
+    /// @name Constructors
+    /// @{
+    /// @brief Default constructor.
+    Stack();
+    /// @brief Copy constructor.
+    /// @param[in] stack  The stack class from which to initialize this class.
+    Stack(const Stack &stack);
+    /// @brief Move constructor.
+    /// @param[in,out] stack  The stack class from which to initialize this
+    ///                       class.  On exit, stack's behavior is undefined.
+    Stack(Stack &&stack) noexcept;
+    /// @}
+
+    /// @name Operators
+    /// @{
+    /// @brief Copy assignment operator.
+    /// @param[in] stack  The stack class to copy to this.
+    /// @result A deep copy of the stack class.
+    Stack& operator=(const Stack &stack);
+    /// @brief Move assignment operator.
+    /// @param[in,out] stack  The stack class whose memory will be moved to
+    ///                       this.  On exit, stack's behavior is undefined.
+    /// @result The memory from stack moved to this.
+    Stack& operator=(Stack &&stack) noexcept;
+    /// @}
+
+    /// @name Destructors
+    /// @{
+    /// @brief Destructor.
+    ~Stack();
+    /// @brief Releases all memory and resets the class.
+    void clear() noexcept;
+    /// @}
+
+    /// @name Initialization
+    /// @{
+    /// @brief Initializes the stack.
+    /// @param[in] nSamples     The number of samples in each trace.  This
+    ///                         must be at least 2.
+    /// @param[in] type         The type of stack.
+    /// @param[in] power        For the nth-root stack this is the root N.
+    ///                         For the phase-weighted stack this is the
+    ///                         exponent \f$ \nu \f$ of the phase coherence.
+    ///                         This is ignored for the linear stack.
+    /// @param[in] shiftMethod  Defines how fractional shifts are applied.
+    /// @throws std::invalid_argument if nSamples is too small or the power
+    ///         is not positive.
+    void initialize(int nSamples,
+                    StackType type = StackType::LINEAR,
+                    double power = 2,
+                    FractionalShiftMethod shiftMethod = FractionalShiftMethod::FREQUENCY_DOMAIN);
+    /// @result True indicates that the class is initialized.
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /// @result The number of samples in each trace.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] int getNumberOfSamples() const;
+    /// @result The type of stack.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] StackType getStackType() const;
+    /// @result The method used to apply fractional shifts.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    [[nodiscard]] FractionalShiftMethod getFractionalShiftMethod() const;
+    /// @}
+
+    /// @name Stacking
+    /// @{
+    /// @brief Shifts the traces.
+    /// @param[in] nTraces   The number of traces.
+    /// @param[in] nSamples  The number of samples in each trace.  This must
+    ///                      equal \c getNumberOfSamples().
+    /// @param[in] shifts    The shift in samples of each trace.  A positive
+    ///                      shift delays the trace, i.e., the shifted trace
+    ///                      is \f$ x_k[i - \tau_k] \f$.  Samples shifted in
+    ///                      from outside the trace are zero.  The shifts
+    ///                      must be less than nSamples in magnitude.  If
+    ///                      this is NULL then the traces are not shifted.
+    ///                      Otherwise, this is an array whose dimension is
+    ///                      [nTraces].
+    /// @param[in] x         The traces.  This is an [nTraces x nSamples]
+    ///                      matrix stored in row major order.
+    /// @param[out] y        The shifted traces.  This is an
+    ///                      [nTraces x nSamples] matrix stored in row major
+    ///                      order.
+    /// @throws std::invalid_argument if nSamples is wrong, a shift is too
+    ///         large, or x or y is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void align(int nTraces, int nSamples, const double shifts[],
+               const T x[], T *y[]);
+    /// @brief Shifts and stacks the traces.
+    /// @param[in] nTraces   The number of traces.  This must be positive.
+    /// @param[in] nSamples  The number of samples in each trace.  This must
+    ///                      equal \c getNumberOfSamples().
+    /// @param[in] shifts    The shift in samples of each trace.  See
+    ///                      \c align().  This can be NULL.
+    /// @param[in] x         The traces.  This is an [nTraces x nSamples]
+    ///                      matrix stored in row major order.
+    /// @param[out] y        The stack.  This is an array whose dimension is
+    ///                      [nSamples].
+    /// @throws std::invalid_argument if nTraces is not positive, nSamples is
+    ///         wrong, a shift is too large, or x or y is NULL.
+    /// @throws std::runtime_error if \c isInitialized() is false.
+    void apply(int nTraces, int nSamples, const double shifts[],
+               const T x[], T *y[]);
+    /// @}
+private:
+    class StackImpl;
+    std::unique_ptr<StackImpl> pImpl;
+};
+}
+#endif
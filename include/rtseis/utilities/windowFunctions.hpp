@@ -1,6 +1,7 @@
 #ifndef RTSEIS_UTILS_WINDOWFUNCTIONS_HPP
 #define RTSEIS_UTILS_WINDOWFUNCTIONS_HPP 1
 #include <vector>
+#include <memory>
 
 namespace RTSeis
 {
@@ -120,6 +121,57 @@ void bartlett(int len, float *window[]);
 void kaiser(int len, double *window[], double beta = 0.5);
 void kaiser(int len, float *window[], float beta = 0.5f);
 
+/*!
+ * @brief Defines the windows that can be obtained from the window cache.
+ */
+enum class WindowType
+{
+    HAMMING,  /*!< Hamming window. */
+    HANN,     /*!< Hann window. */
+    BLACKMAN, /*!< Blackman window. */
+    BARTLETT, /*!< Bartlett window. */
+    SINE,     /*!< Sine window. */
+    KAISER    /*!< Kaiser window.  The parameter is \f$ \beta \f$. */
+};
+
+/*!
+ * @brief Gets a window from a process-wide cache.  The cache is keyed on
+ *        the window type, length, parameter, and precision.  If the window
+ *        is not in the cache then it is generated and added to the cache.
+ * @param[in] type       The window type.
+ * @param[in] len        The window length.  This must be positive.
+ * @param[in] parameter  The window parameter, e.g., \f$ \beta \f$ for a
+ *                       Kaiser window.  This is ignored by windows that do
+ *                       not have a parameter.
+ * @result The window of length len.  The window is immutable and remains
+ *         valid after it is evicted from the cache.
+ * @throws std::invalid_argument if len or the parameter is invalid.
+ * @note This is thread-safe.  When the cache exceeds its capacity the least
+ *       recently used windows are evicted.
+ */
+template<class T>
+std::shared_ptr<const std::vector<T>>
+    getCachedWindow(WindowType type, int len, double parameter = 0);
+/*!
+ * @brief Sets the maximum number of bytes held by the window cache.
+ *        Windows are evicted until the cache fits in the new capacity.
+ * @param[in] nBytes  The capacity in bytes.  If this is 0 then windows
+ *                    are not cached.  By default this is 16 MB.
+ */
+void setWindowCacheCapacity(size_t nBytes) noexcept;
+/*!
+ * @result The maximum number of bytes held by the window cache.
+ */
+size_t getWindowCacheCapacity() noexcept;
+/*!
+ * @result The number of bytes currently held by the window cache.
+ */
+size_t getWindowCacheSize() noexcept;
+/*!
+ * @brief Removes all windows from the window cache.
+ */
+void clearWindowCache() noexcept;
+
 /*!
  * @}
  */
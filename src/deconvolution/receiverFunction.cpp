@@ -0,0 +1,565 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/deconvolution/receiverFunction.hpp"
+#include "rtseis/transforms/utilities.hpp"
+
+using namespace RTSeis::Deconvolution;
+
+template<class T>
+class ReceiverFunction<T>::ReceiverFunctionImpl
+{
+public:
+    ReceiverFunctionImpl() = default;
+    ReceiverFunctionImpl(const ReceiverFunctionImpl &rf) :
+        mOutputFilter(rf.mOutputFilter),
+        mGaussian(rf.mGaussian),
+        mWeights(rf.mWeights),
+        mFits(rf.mFits),
+        mSamplingRate(rf.mSamplingRate),
+        mWaterLevel(rf.mWaterLevel),
+        mTolerance(rf.mTolerance),
+        mSamples(rf.mSamples),
+        mDFTLength(rf.mDFTLength),
+        mMaxIterations(rf.mMaxIterations),
+        mMethod(rf.mMethod),
+        mInitialized(rf.mInitialized)
+    {
+        if (mInitialized){makePlans();}
+    }
+    ReceiverFunctionImpl& operator=(const ReceiverFunctionImpl &) = delete;
+    ~ReceiverFunctionImpl()
+    {
+        releasePlans();
+    }
+    void releasePlans() noexcept
+    {
+        if (mHavePlans)
+        {
+            fftw_destroy_plan(mForwardPlan);
+            fftw_destroy_plan(mInversePlan);
+        }
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        mInData = nullptr;
+        mSpectrum = nullptr;
+        mHavePlans = false;
+    }
+    /// The plans are executed on per-thread buffers
+    void makePlans()
+    {
+        releasePlans();
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (mDFTLength)
+                              *sizeof(double)));
+        mSpectrum = reinterpret_cast<fftw_complex *>
+                    (fftw_malloc(static_cast<size_t> (mDFTLength/2 + 1)
+                                *sizeof(fftw_complex)));
+        mForwardPlan = fftw_plan_dft_r2c_1d(mDFTLength, mInData, mSpectrum,
+                                            FFTW_ESTIMATE);
+        mInversePlan = fftw_plan_dft_c2r_1d(mDFTLength, mSpectrum, mInData,
+                                            FFTW_ESTIMATE);
+        mHavePlans = true;
+    }
+    /// Per-thread workspace
+    class Workspace
+    {
+    public:
+        explicit Workspace(const ReceiverFunctionImpl &rf)
+        {
+            auto n = static_cast<size_t> (rf.mDFTLength);
+            auto nFrequencies = n/2 + 1;
+            mInData = static_cast<double *> (fftw_malloc(n*sizeof(double)));
+            mSpectrum = reinterpret_cast<fftw_complex *>
+                        (fftw_malloc(nFrequencies*sizeof(fftw_complex)));
+            mDenominator.resize(nFrequencies);
+            mNumerator.resize(nFrequencies);
+            mAutocorrelation.resize(n);
+            mCorrelation.resize(rf.mSamples);
+        }
+        Workspace(const Workspace &) = delete;
+        Workspace& operator=(const Workspace &) = delete;
+        ~Workspace()
+        {
+            if (mInData != nullptr){fftw_free(mInData);}
+            if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        }
+        std::vector<std::complex<double>> mDenominator;
+        std::vector<std::complex<double>> mNumerator;
+        std::vector<double> mAutocorrelation;
+        std::vector<double> mCorrelation;
+        double *mInData = nullptr;
+        fftw_complex *mSpectrum = nullptr;
+    };
+    /// Transforms the first nSamples of x
+    void forward(const T x[], std::complex<double> X[], Workspace &work) const
+    {
+        std::copy(x, x + mSamples, work.mInData);
+        std::fill(work.mInData + mSamples, work.mInData + mDFTLength, 0.0);
+        fftw_execute_dft_r2c(mForwardPlan, work.mInData, work.mSpectrum);
+        const int nFrequencies = mDFTLength/2 + 1;
+        for (int k = 0; k < nFrequencies; ++k)
+        {
+            X[k] = std::complex<double> (work.mSpectrum[k][0],
+                                         work.mSpectrum[k][1]);
+        }
+    }
+    /// Inverse transforms work.mSpectrum into work.mInData and scales
+    void inverse(Workspace &work) const
+    {
+        fftw_execute_dft_c2r(mInversePlan, work.mSpectrum, work.mInData);
+        const double xnorm = 1.0/mDFTLength;
+        #pragma omp simd
+        for (int i = 0; i < mDFTLength; ++i)
+        {
+            work.mInData[i] = work.mInData[i]*xnorm;
+        }
+    }
+    /// Energy of a real signal from its half spectrum
+    template<class F>
+    double energy(F &&power) const
+    {
+        const int nFrequencies = mDFTLength/2 + 1;
+        double sum = 0;
+        for (int k = 0; k < nFrequencies; ++k)
+        {
+            sum = sum + mWeights[k]*power(k);
+        }
+        return sum/mDFTLength;
+    }
+    /// Writes the receiver function whose unfiltered spectrum is in
+    /// work.mNumerator
+    void output(T rf[], Workspace &work) const
+    {
+        const int nFrequencies = mDFTLength/2 + 1;
+        for (int k = 0; k < nFrequencies; ++k)
+        {
+            auto z = work.mNumerator[k]*mOutputFilter[k];
+            work.mSpectrum[k][0] = z.real();
+            work.mSpectrum[k][1] = z.imag();
+        }
+        inverse(work);
+        for (int i = 0; i < mSamples; ++i)
+        {
+            rf[i] = static_cast<T> (work.mInData[i]);
+        }
+    }
+    /// Water level deconvolution of one event
+    void waterLevel(const int nNumerators, const T numerators[],
+                    const T denominator[], T rfs[], double fits[],
+                    Workspace &work) const
+    {
+        const int nFrequencies = mDFTLength/2 + 1;
+        auto D = work.mDenominator.data();
+        forward(denominator, D, work);
+        double maxPower = 0;
+        for (int k = 0; k < nFrequencies; ++k)
+        {
+            maxPower = std::max(maxPower, std::norm(D[k]));
+        }
+        const double floor = mWaterLevel*maxPower;
+        for (int ic = 0; ic < nNumerators; ++ic)
+        {
+            auto rf = rfs + static_cast<size_t> (ic)*mSamples;
+            fits[ic] = 0;
+            if (!(maxPower > 0))
+            {
+                std::fill(rf, rf + mSamples, 0);
+                continue;
+            }
+            auto N = work.mNumerator.data();
+            forward(numerators + static_cast<size_t> (ic)*mSamples, N, work);
+            auto numeratorEnergy = energy([&](const int k)
+                                   {
+                                       return std::norm(N[k]*mGaussian[k]);
+                                   });
+            auto residualEnergy = energy([&](const int k)
+                                  {
+                                      auto Q = N[k]*std::conj(D[k])
+                                              /std::max(std::norm(D[k]),
+                                                        floor);
+                                      return std::norm((N[k] - D[k]*Q)
+                                                      *mGaussian[k]);
+                                  });
+            if (numeratorEnergy > 0)
+            {
+                fits[ic] = 1 - residualEnergy/numeratorEnergy;
+            }
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                N[k] = N[k]*std::conj(D[k])/std::max(std::norm(D[k]), floor);
+            }
+            output(rf, work);
+        }
+    }
+    /// Iterative time domain deconvolution of one event
+    void iterative(const int nNumerators, const T numerators[],
+                   const T denominator[], T rfs[], double fits[],
+                   Workspace &work) const
+    {
+        const int nFrequencies = mDFTLength/2 + 1;
+        const int n = mSamples;
+        const int nfft = mDFTLength;
+        auto D = work.mDenominator.data();
+        forward(denominator, D, work);
+        // Autocorrelation of the Gaussian filtered denominator
+        for (int k = 0; k < nFrequencies; ++k)
+        {
+            auto g2 = mGaussian[k]*mGaussian[k];
+            work.mSpectrum[k][0] = std::norm(D[k])*g2;
+            work.mSpectrum[k][1] = 0;
+        }
+        inverse(work);
+        std::copy(work.mInData, work.mInData + nfft,
+                  work.mAutocorrelation.begin());
+        const double *A = work.mAutocorrelation.data();
+        const double A0 = A[0];
+        for (int ic = 0; ic < nNumerators; ++ic)
+        {
+            auto rf = rfs + static_cast<size_t> (ic)*n;
+            fits[ic] = 0;
+            if (!(A0 > 0))
+            {
+                std::fill(rf, rf + n, 0);
+                continue;
+            }
+            auto N = work.mNumerator.data();
+            forward(numerators + static_cast<size_t> (ic)*n, N, work);
+            auto numeratorEnergy = energy([&](const int k)
+                                   {
+                                       return std::norm(N[k]*mGaussian[k]);
+                                   });
+            // Cross-correlation of the filtered numerator and denominator
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                auto z = N[k]*std::conj(D[k])*(mGaussian[k]*mGaussian[k]);
+                work.mSpectrum[k][0] = z.real();
+                work.mSpectrum[k][1] = z.imag();
+            }
+            inverse(work);
+            double *c = work.mCorrelation.data();
+            std::copy(work.mInData, work.mInData + n, c);
+            // The spikes accumulate in the time domain buffer
+            std::fill(work.mInData, work.mInData + nfft, 0.0);
+            double *spikes = work.mInData;
+            double residualEnergy = numeratorEnergy;
+            for (int iteration = 0; iteration < mMaxIterations; ++iteration)
+            {
+                int lag = 0;
+                double cMax = 0;
+                for (int j = 0; j < n; ++j)
+                {
+                    if (std::abs(c[j]) > cMax)
+                    {
+                        cMax = std::abs(c[j]);
+                        lag = j;
+                    }
+                }
+                auto gain = c[lag]*c[lag]/A0;
+                if (!(gain > mTolerance*numeratorEnergy)){break;}
+                auto amplitude = c[lag]/A0;
+                spikes[lag] = spikes[lag] + amplitude;
+                residualEnergy = residualEnergy - gain;
+                // c[j] <- c[j] - amplitude A[j - lag]
+                const double *Aminus = A + nfft - lag; // A[-lag..-1]
+                for (int j = 0; j < lag; ++j)
+                {
+                    c[j] = c[j] - amplitude*Aminus[j];
+                }
+                #pragma omp simd
+                for (int j = lag; j < n; ++j)
+                {
+                    c[j] = c[j] - amplitude*A[j - lag];
+                }
+            }
+            if (numeratorEnergy > 0)
+            {
+                fits[ic] = 1 - std::max(0.0, residualEnergy)/numeratorEnergy;
+            }
+            fftw_execute_dft_r2c(mForwardPlan, spikes, work.mSpectrum);
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                N[k] = std::complex<double> (work.mSpectrum[k][0],
+                                             work.mSpectrum[k][1]);
+            }
+            output(rf, work);
+        }
+    }
+    /// The Gaussian normalized to a unit peak and time shifted
+    std::vector<std::complex<double>> mOutputFilter;
+    /// The Gaussian with unit DC gain
+    std::vector<double> mGaussian;
+    /// Parseval weights of the half spectrum
+    std::vector<double> mWeights;
+    /// The [nEvents x nNumerators] fits
+    std::vector<double> mFits;
+    fftw_plan mForwardPlan;
+    fftw_plan mInversePlan;
+    double *mInData = nullptr;
+    fftw_complex *mSpectrum = nullptr;
+    double mSamplingRate = 1;
+    double mWaterLevel = 0.01;
+    double mTolerance = 1.e-5;
+    int mSamples = 0;
+    int mDFTLength = 0;
+    int mMaxIterations = 0;
+    ReceiverFunctionMethod mMethod
+        = ReceiverFunctionMethod::ITERATIVE_TIME_DOMAIN;
+    bool mHavePlans = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+ReceiverFunction<T>::ReceiverFunction() :
+    pImpl(std::make_unique<ReceiverFunctionImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+ReceiverFunction<T>::ReceiverFunction(const ReceiverFunction &rf)
+{
+    *this = rf;
+}
+
+/// Move c'tor
+template<class T>
+ReceiverFunction<T>::ReceiverFunction(ReceiverFunction &&rf) noexcept
+{
+    *this = std::move(rf);
+}
+
+/// Copy assignment
+template<class T>
+ReceiverFunction<T>&
+ReceiverFunction<T>::operator=(const ReceiverFunction &rf)
+{
+    if (&rf == this){return *this;}
+    pImpl = std::make_unique<ReceiverFunctionImpl> (*rf.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+ReceiverFunction<T>&
+ReceiverFunction<T>::operator=(ReceiverFunction &&rf) noexcept
+{
+    if (&rf == this){return *this;}
+    pImpl = std::move(rf.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+ReceiverFunction<T>::~ReceiverFunction() = default;
+
+/// Clear
+template<class T>
+void ReceiverFunction<T>::clear() noexcept
+{
+    pImpl = std::make_unique<ReceiverFunctionImpl> ();
+}
+
+/// Initialize
+template<class T>
+void ReceiverFunction<T>::initialize(const int nSamples,
+                                     const double samplingRate,
+                                     const ReceiverFunctionMethod method,
+                                     const double gaussianWidth,
+                                     const double timeShift,
+                                     const double waterLevel,
+                                     const int maxIterations,
+                                     const double tolerance)
+{
+    clear();
+    if (nSamples < 2)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must be at least 2");
+    }
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (gaussianWidth <= 0)
+    {
+        throw std::invalid_argument("gaussianWidth = "
+                                  + std::to_string(gaussianWidth)
+                                  + " must be positive");
+    }
+    auto duration = nSamples/samplingRate;
+    if (timeShift < 0 || timeShift >= duration)
+    {
+        throw std::invalid_argument("timeShift = " + std::to_string(timeShift)
+                                  + " must be in range [0,"
+                                  + std::to_string(duration) + ")");
+    }
+    if (waterLevel <= 0 || waterLevel > 1)
+    {
+        throw std::invalid_argument("waterLevel = "
+                                  + std::to_string(waterLevel)
+                                  + " must be in range (0,1]");
+    }
+    if (maxIterations < 1)
+    {
+        throw std::invalid_argument("maxIterations = "
+                                  + std::to_string(maxIterations)
+                                  + " must be positive");
+    }
+    if (tolerance < 0)
+    {
+        throw std::invalid_argument("tolerance = " + std::to_string(tolerance)
+                                  + " cannot be negative");
+    }
+    // Linear correlations and convolutions
+    auto nfft = RTSeis::Transforms::DFTUtilities::nextFastLength(2*nSamples);
+    const int nFrequencies = nfft/2 + 1;
+    pImpl->mGaussian.resize(nFrequencies);
+    pImpl->mWeights.resize(nFrequencies);
+    double peak = 0;
+    for (int k = 0; k < nFrequencies; ++k)
+    {
+        auto omega = 2*M_PI*k*samplingRate/nfft;
+        pImpl->mGaussian[k] = std::exp(-omega*omega
+                                       /(4*gaussianWidth*gaussianWidth));
+        pImpl->mWeights[k] = 2;
+        if (k == 0 || 2*k == nfft){pImpl->mWeights[k] = 1;}
+        peak = peak + pImpl->mWeights[k]*pImpl->mGaussian[k];
+    }
+    peak = peak/nfft;
+    pImpl->mOutputFilter.resize(nFrequencies);
+    for (int k = 0; k < nFrequencies; ++k)
+    {
+        auto omega = 2*M_PI*k*samplingRate/nfft;
+        pImpl->mOutputFilter[k] = (pImpl->mGaussian[k]/peak)
+                                 *std::polar(1.0, -omega*timeShift);
+    }
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mWaterLevel = waterLevel;
+    pImpl->mTolerance = tolerance;
+    pImpl->mSamples = nSamples;
+    pImpl->mDFTLength = nfft;
+    pImpl->mMaxIterations = maxIterations;
+    pImpl->mMethod = method;
+    pImpl->makePlans();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool ReceiverFunction<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of samples
+template<class T>
+int ReceiverFunction<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamples;
+}
+
+/// Sampling rate
+template<class T>
+double ReceiverFunction<T>::getSamplingRate() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamplingRate;
+}
+
+/// Method
+template<class T>
+ReceiverFunctionMethod ReceiverFunction<T>::getMethod() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mMethod;
+}
+
+/// Fits
+template<class T>
+std::vector<double> ReceiverFunction<T>::getFits() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mFits;
+}
+
+/// Apply
+template<class T>
+void ReceiverFunction<T>::apply(const int nEvents, const int nSamples,
+                                const int nNumerators,
+                                const T numerators[], const T denominators[],
+                                T *rfsIn[])
+{
+    auto nRef = getNumberOfSamples(); // Throws
+    if (nEvents < 1)
+    {
+        throw std::invalid_argument("nEvents = " + std::to_string(nEvents)
+                                  + " must be positive");
+    }
+    if (nSamples != nRef)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must equal " + std::to_string(nRef));
+    }
+    if (nNumerators < 1)
+    {
+        throw std::invalid_argument("nNumerators = "
+                                  + std::to_string(nNumerators)
+                                  + " must be positive");
+    }
+    T *rfs = *rfsIn;
+    if (numerators == nullptr || denominators == nullptr || rfs == nullptr)
+    {
+        if (numerators == nullptr)
+        {
+            throw std::invalid_argument("numerators is NULL");
+        }
+        if (denominators == nullptr)
+        {
+            throw std::invalid_argument("denominators is NULL");
+        }
+        throw std::invalid_argument("receiverFunctions is NULL");
+    }
+    pImpl->mFits.resize(static_cast<size_t> (nEvents)*nNumerators);
+    auto fits = pImpl->mFits.data();
+    const auto &impl = *pImpl;
+    const bool lIterative
+        = (impl.mMethod == ReceiverFunctionMethod::ITERATIVE_TIME_DOMAIN);
+    #pragma omp parallel default(shared)
+    {
+    typename ReceiverFunctionImpl::Workspace work(impl);
+    #pragma omp for schedule(dynamic)
+    for (int ie = 0; ie < nEvents; ++ie)
+    {
+        auto offset = static_cast<size_t> (ie)*nNumerators*nSamples;
+        auto denominator = denominators + static_cast<size_t> (ie)*nSamples;
+        auto eventFits = fits + static_cast<size_t> (ie)*nNumerators;
+        if (lIterative)
+        {
+            impl.iterative(nNumerators, numerators + offset, denominator,
+                           rfs + offset, eventFits, work);
+        }
+        else
+        {
+            impl.waterLevel(nNumerators, numerators + offset, denominator,
+                            rfs + offset, eventFits, work);
+        }
+    }
+    } // End parallel
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Deconvolution::ReceiverFunction<double>;
+template class RTSeis::Deconvolution::ReceiverFunction<float>;
@@ -213,6 +213,87 @@ FIR::FIR1Bandstop(const int order, const std::pair<double, double> &r,
     return fir;
 }
 
+/// CIC compensator
+RTSeis::FilterRepresentations::FIR
+FIR::CICCompensator(const int order, const int downFactor, const int nStages,
+                    const int differentialDelay, const double passband)
+{
+    if (order < 4)
+    {
+        throw std::invalid_argument("order = " + std::to_string(order)
+                                  + " must be at least 4");
+    }
+    if (downFactor < 1 || nStages < 1 || differentialDelay < 1)
+    {
+        if (downFactor < 1)
+        {
+            throw std::invalid_argument("downFactor = "
+                                      + std::to_string(downFactor)
+                                      + " must be positive");
+        }
+        if (nStages < 1)
+        {
+            throw std::invalid_argument("nStages = " + std::to_string(nStages)
+                                      + " must be positive");
+        }
+        throw std::invalid_argument("differentialDelay = "
+                                  + std::to_string(differentialDelay)
+                                  + " must be positive");
+    }
+    if (passband <= 0 || passband >= 1 || passband*differentialDelay >= 2)
+    {
+        throw std::invalid_argument("passband = " + std::to_string(passband)
+                                  + " must be in (0,1) and less than "
+                                  + std::to_string(2.0/differentialDelay));
+    }
+    // Amplitude response of the CIC at the output frequency r where 1 is
+    // the output Nyquist frequency:
+    //   |sin(pi r M/2)/(R M sin(pi r/(2R)))|^N
+    auto dR = static_cast<double> (downFactor);
+    auto dM = static_cast<double> (differentialDelay);
+    auto cicResponse = [=](const double r)
+    {
+        if (r == 0){return 1.0;}
+        auto num = std::sin(M_PI*r*dM/2);
+        auto den = dR*dM*std::sin(M_PI*r/(2*dR));
+        return std::pow(std::abs(num/den), nStages);
+    };
+    auto gainEdge = 1/cicResponse(passband);
+    // Desired real and even amplitude response integrated against the
+    // cosines with the midpoint rule
+    const int nGrid = 4096;
+    int n = order + 1;
+    auto center = 0.5*static_cast<double> (order);
+    std::vector<double> h(n, 0);
+    auto dr = 1.0/static_cast<double> (nGrid);
+    for (int j = 0; j < nGrid; ++j)
+    {
+        auto r = (static_cast<double> (j) + 0.5)*dr;
+        auto d = gainEdge*0.5*(1 + std::cos(M_PI*(r - passband)
+                                            /(1 - passband)));
+        if (r <= passband){d = 1/cicResponse(r);}
+        for (int k = 0; k < n; ++k)
+        {
+            h[k] = h[k] + d*std::cos(M_PI*r*(static_cast<double> (k) - center));
+        }
+    }
+    auto window = WindowFunctions::getCachedWindow<double>
+                  (WindowFunctions::WindowType::HAMMING, n);
+    double gain = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        h[k] = h[k]*(*window)[k];
+        gain = gain + h[k];
+    }
+#ifndef NDEBUG
+    assert(gain != 0);
+#endif
+    for (auto &hk : h){hk = hk/gain;}
+    RTSeis::FilterRepresentations::FIR fir;
+    fir.setFilterTaps(h);
+    return fir;
+}
+
 /// Hilbert transformer
 std::pair<RTSeis::FilterRepresentations::FIR,RTSeis::FilterRepresentations::FIR>
 FIR::HilbertTransformer(const int order, const double beta)
@@ -229,9 +310,9 @@ FIR::HilbertTransformer(const int order, const double beta)
         return std::pair(realFIR, imagFIR);
     }
     // Create a kaiser window
-    std::vector<double> kaiser(n);
-    double *kaiserData = kaiser.data();
-    WindowFunctions::kaiser(n, &kaiserData, beta);
+    auto kaiserWindow = WindowFunctions::getCachedWindow<double>
+                        (WindowFunctions::WindowType::KAISER, n, beta);
+    const auto &kaiser = *kaiserWindow;
     // Compute the sinc function where fc = 1 and fc/2 = 0.5
     // Part 1: t = fc/2*((1-n)/2:(n-1)/2)
     std::vector<double> t(n);
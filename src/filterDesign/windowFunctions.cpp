@@ -2,6 +2,13 @@
 #include <cstdlib>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
+#include <list>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <tuple>
+#include <type_traits>
 #include <ipps.h>
 #define RTSEIS_LOGGING 1
 #include "private/throw.hpp"
@@ -363,3 +370,223 @@ void WindowFunctions::blackman(const int len, float *winIn[])
     ippsWinBlackmanStd_32f_I(window, len);
     return;
 }
+
+//============================================================================//
+//                                 Window Cache                               //
+//============================================================================//
+
+namespace
+{
+
+using RTSeis::Utilities::WindowFunctions::WindowType;
+
+/// Identifies a window in the cache
+struct WindowKey
+{
+    WindowType type;
+    int length;
+    double parameter;
+    bool lfloat;
+    bool operator<(const WindowKey &key) const
+    {
+        return std::tie(type, length, parameter, lfloat)
+             < std::tie(key.type, key.length, key.parameter, key.lfloat);
+    }
+};
+
+/// Generates a window
+template<class T>
+std::shared_ptr<const std::vector<T>>
+    makeWindow(const WindowType type, const int len, const double parameter)
+{
+    auto window = std::make_shared<std::vector<T>> (len);
+    T *w = window->data();
+    if (type == WindowType::HAMMING)
+    {
+        WindowFunctions::hamming(len, &w);
+    }
+    else if (type == WindowType::HANN)
+    {
+        WindowFunctions::hann(len, &w);
+    }
+    else if (type == WindowType::BLACKMAN)
+    {
+        WindowFunctions::blackman(len, &w);
+    }
+    else if (type == WindowType::BARTLETT)
+    {
+        WindowFunctions::bartlett(len, &w);
+    }
+    else if (type == WindowType::SINE)
+    {
+        WindowFunctions::sine(len, &w);
+    }
+    else if (type == WindowType::KAISER)
+    {
+        if (parameter < 0)
+        {
+            RTSEIS_THROW_IA("beta = %lf cannot be negative", parameter);
+        }
+        WindowFunctions::kaiser(len, &w, static_cast<T> (parameter));
+    }
+    else
+    {
+        RTSEIS_THROW_IA("%s", "Unsupported window type");
+    }
+    return window;
+}
+
+/// A least recently used cache of immutable windows.  Since the windows are
+/// held by shared pointers an evicted window remains valid for as long as
+/// a consumer holds it.
+class WindowCache
+{
+public:
+    static WindowCache &instance()
+    {
+        static WindowCache cache;
+        return cache;
+    }
+    template<class T>
+    std::shared_ptr<const std::vector<T>>
+        get(const WindowType type, const int len, const double parameter)
+    {
+        constexpr bool lfloat = std::is_same<T, float>::value;
+        // Only the Kaiser window is parameterized
+        auto p = (type == WindowType::KAISER) ? parameter : 0;
+        WindowKey key{type, len, p, lfloat};
+        {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto window = find<T>(key);
+        if (window){return window;}
+        }
+        // Generate the window outside of the lock
+        auto window = makeWindow<T>(type, len, p);
+        auto nBytes = static_cast<size_t> (len)*sizeof(T);
+        std::lock_guard<std::mutex> lock(mMutex);
+        // Another thread may have beaten us to it
+        auto existing = find<T>(key);
+        if (existing){return existing;}
+        if (nBytes > mCapacity){return window;}
+        mLRU.push_front(key);
+        Entry entry;
+        if constexpr (lfloat)
+        {
+            entry.w32 = window;
+        }
+        else
+        {
+            entry.w64 = window;
+        }
+        entry.nBytes = nBytes;
+        entry.lru = mLRU.begin();
+        mEntries.insert(std::pair(key, entry));
+        mSize = mSize + nBytes;
+        evict();
+        return window;
+    }
+    void setCapacity(const size_t nBytes) noexcept
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCapacity = nBytes;
+        evict();
+    }
+    size_t getCapacity() noexcept
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCapacity;
+    }
+    size_t getSize() noexcept
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSize;
+    }
+    void clear() noexcept
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.clear();
+        mLRU.clear();
+        mSize = 0;
+    }
+private:
+    struct Entry
+    {
+        std::shared_ptr<const std::vector<double>> w64;
+        std::shared_ptr<const std::vector<float>> w32;
+        std::list<WindowKey>::iterator lru;
+        size_t nBytes = 0;
+    };
+    /// Finds the window and marks it as most recently used.  The caller
+    /// must hold the mutex.
+    template<class T>
+    std::shared_ptr<const std::vector<T>> find(const WindowKey &key)
+    {
+        auto it = mEntries.find(key);
+        if (it == mEntries.end()){return nullptr;}
+        mLRU.splice(mLRU.begin(), mLRU, it->second.lru);
+        if constexpr (std::is_same<T, float>::value)
+        {
+            return it->second.w32;
+        }
+        else
+        {
+            return it->second.w64;
+        }
+    }
+    /// Evicts the least recently used windows until the cache fits.  The
+    /// caller must hold the mutex.
+    void evict() noexcept
+    {
+        while (mSize > mCapacity && !mLRU.empty())
+        {
+            auto it = mEntries.find(mLRU.back());
+            mSize = mSize - it->second.nBytes;
+            mEntries.erase(it);
+            mLRU.pop_back();
+        }
+    }
+    std::mutex mMutex;
+    std::map<WindowKey, Entry> mEntries;
+    std::list<WindowKey> mLRU;
+    size_t mCapacity = 16*1024*1024;
+    size_t mSize = 0;
+};
+
+}
+
+template<class T>
+std::shared_ptr<const std::vector<T>>
+WindowFunctions::getCachedWindow(const WindowType type, const int len,
+                                 const double parameter)
+{
+    if (len < 1){RTSEIS_THROW_IA("Length = %d must be positive", len);}
+    return WindowCache::instance().get<T>(type, len, parameter);
+}
+
+void WindowFunctions::setWindowCacheCapacity(const size_t nBytes) noexcept
+{
+    WindowCache::instance().setCapacity(nBytes);
+}
+
+size_t WindowFunctions::getWindowCacheCapacity() noexcept
+{
+    return WindowCache::instance().getCapacity();
+}
+
+size_t WindowFunctions::getWindowCacheSize() noexcept
+{
+    return WindowCache::instance().getSize();
+}
+
+void WindowFunctions::clearWindowCache() noexcept
+{
+    WindowCache::instance().clear();
+}
+
+/// Template instantiation
+template std::shared_ptr<const std::vector<double>>
+RTSeis::Utilities::WindowFunctions::getCachedWindow<double>(
+    WindowType, int, double);
+template std::shared_ptr<const std::vector<float>>
+RTSeis::Utilities::WindowFunctions::getCachedWindow<float>(
+    WindowType, int, double);
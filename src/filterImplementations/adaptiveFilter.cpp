@@ -0,0 +1,732 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/filterImplementations/adaptiveFilter.hpp"
+#include "rtseis/transforms/utilities.hpp"
+
+using namespace RTSeis::FilterImplementations;
+
+namespace
+{
+/// The block LMS per-frequency power is smoothed with this factor
+constexpr double POWER_SMOOTHING = 0.8;
+}
+
+template<class T>
+class AdaptiveFilter<T>::AdaptiveFilterImpl
+{
+public:
+    /// The adaptive state of a channel
+    class ChannelState
+    {
+    public:
+        /// The [nReferences x historyLength] previous reference samples
+        std::vector<double> mHistory;
+        /// The [nReferences x filterLength] weights.  For the NLMS and RLS
+        /// updates these are in time order, i.e., entry [r, j] multiplies
+        /// u_r[n - (L - 1 - j)], so that they line up with the references'
+        /// window.  For the block LMS update entry [r, j] multiplies
+        /// u_r[n - j].
+        std::vector<double> mWeights;
+        /// The RLS [nReferences*filterLength x nReferences*filterLength]
+        /// inverse correlation matrix
+        std::vector<double> mInverseCorrelation;
+        /// The block LMS smoothed power at each frequency
+        std::vector<double> mPower;
+        /// The block LMS primary samples of the incomplete block
+        std::vector<double> mPending;
+        bool mHavePower = false;
+    };
+    AdaptiveFilterImpl() = default;
+    AdaptiveFilterImpl(const AdaptiveFilterImpl &filter) :
+        mStates(filter.mStates),
+        mType(filter.mType),
+        mStepSize(filter.mStepSize),
+        mForgettingFactor(filter.mForgettingFactor),
+        mRegularization(filter.mRegularization),
+        mChannels(filter.mChannels),
+        mReferences(filter.mReferences),
+        mFilterLength(filter.mFilterLength),
+        mHistoryLength(filter.mHistoryLength),
+        mDFTLength(filter.mDFTLength),
+        mBlockLength(filter.mBlockLength),
+        mInitialized(filter.mInitialized)
+    {
+        if (mInitialized && mType == AdaptiveFilterType::BLOCK_LMS)
+        {
+            makePlans();
+        }
+    }
+    AdaptiveFilterImpl& operator=(const AdaptiveFilterImpl &) = delete;
+    ~AdaptiveFilterImpl()
+    {
+        releasePlans();
+    }
+    void releasePlans() noexcept
+    {
+        if (mHavePlans)
+        {
+            fftw_destroy_plan(mForwardPlan);
+            fftw_destroy_plan(mInversePlan);
+        }
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        mInData = nullptr;
+        mSpectrum = nullptr;
+        mHavePlans = false;
+    }
+    /// The plans are executed on per-thread buffers
+    void makePlans()
+    {
+        releasePlans();
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (mDFTLength)
+                              *sizeof(double)));
+        mSpectrum = reinterpret_cast<fftw_complex *>
+                    (fftw_malloc(static_cast<size_t> (mDFTLength/2 + 1)
+                                *sizeof(fftw_complex)));
+        mForwardPlan = fftw_plan_dft_r2c_1d(mDFTLength, mInData, mSpectrum,
+                                            FFTW_ESTIMATE);
+        mInversePlan = fftw_plan_dft_c2r_1d(mDFTLength, mSpectrum, mInData,
+                                            FFTW_ESTIMATE);
+        mHavePlans = true;
+    }
+    /// Resets a channel's adaptive state
+    void resetState(ChannelState &state) const
+    {
+        const auto nWeights = static_cast<size_t> (mReferences)*mFilterLength;
+        state.mHistory.assign(static_cast<size_t> (mReferences)
+                             *mHistoryLength, 0);
+        state.mWeights.assign(nWeights, 0);
+        state.mPending.clear();
+        state.mHavePower = false;
+        if (mType == AdaptiveFilterType::RLS)
+        {
+            state.mInverseCorrelation.assign(nWeights*nWeights, 0);
+            for (size_t i = 0; i < nWeights; ++i)
+            {
+                state.mInverseCorrelation[i*nWeights + i] = 1/mRegularization;
+            }
+        }
+        if (mType == AdaptiveFilterType::BLOCK_LMS)
+        {
+            state.mPower.assign(mDFTLength/2 + 1, 0);
+        }
+    }
+    /// Per-thread workspace
+    class Workspace
+    {
+    public:
+        explicit Workspace(const AdaptiveFilterImpl &filter)
+        {
+            auto nWeights = static_cast<size_t> (filter.mReferences)
+                           *filter.mFilterLength;
+            mRegressor.resize(nWeights);
+            mGain.resize(nWeights);
+            if (filter.mType == AdaptiveFilterType::BLOCK_LMS)
+            {
+                auto n = static_cast<size_t> (filter.mDFTLength);
+                auto nFrequencies = n/2 + 1;
+                mInData = static_cast<double *>
+                          (fftw_malloc(n*sizeof(double)));
+                mSpectrum = reinterpret_cast<fftw_complex *>
+                            (fftw_malloc(nFrequencies*sizeof(fftw_complex)));
+                mReferenceSpectra.resize(nFrequencies*filter.mReferences);
+                mOutputSpectrum.resize(nFrequencies);
+                mErrorSpectrum.resize(nFrequencies);
+                mErrors.resize(filter.mBlockLength);
+            }
+        }
+        Workspace(const Workspace &) = delete;
+        Workspace& operator=(const Workspace &) = delete;
+        ~Workspace()
+        {
+            if (mInData != nullptr){fftw_free(mInData);}
+            if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        }
+        /// The [nReferences x (historyLength + nSamples)] references with
+        /// their histories prepended
+        std::vector<double> mExtended;
+        /// The RLS regressor and gain
+        std::vector<double> mRegressor;
+        std::vector<double> mGain;
+        /// The block LMS [nReferences x nFrequencies] frame spectra
+        std::vector<std::complex<double>> mReferenceSpectra;
+        std::vector<std::complex<double>> mOutputSpectrum;
+        std::vector<std::complex<double>> mErrorSpectrum;
+        std::vector<double> mErrors;
+        double *mInData = nullptr;
+        fftw_complex *mSpectrum = nullptr;
+    };
+    /// Prepends the histories to the channel's references
+    void extend(const int nSamples, const T references[],
+                const ChannelState &state, Workspace &work) const
+    {
+        const int nExtended = mHistoryLength + nSamples;
+        work.mExtended.resize(static_cast<size_t> (mReferences)*nExtended);
+        for (int r = 0; r < mReferences; ++r)
+        {
+            auto extended = work.mExtended.data()
+                          + static_cast<size_t> (r)*nExtended;
+            auto history = state.mHistory.data()
+                         + static_cast<size_t> (r)*mHistoryLength;
+            auto reference = references + static_cast<size_t> (r)*nSamples;
+            std::copy(history, history + mHistoryLength, extended);
+            std::copy(reference, reference + nSamples,
+                      extended + mHistoryLength);
+        }
+    }
+    /// Saves the newest reference samples
+    void saveHistory(const int nSamples, ChannelState &state,
+                     const Workspace &work) const
+    {
+        const int nExtended = mHistoryLength + nSamples;
+        for (int r = 0; r < mReferences; ++r)
+        {
+            auto extended = work.mExtended.data()
+                          + static_cast<size_t> (r)*nExtended;
+            auto history = state.mHistory.data()
+                         + static_cast<size_t> (r)*mHistoryLength;
+            std::copy(extended + nSamples, extended + nExtended, history);
+        }
+    }
+    /// NLMS
+    void nlms(const int nSamples, const T primary[], T cleaned[],
+              ChannelState &state, const Workspace &work) const
+    {
+        const int L = mFilterLength;
+        const int nExtended = mHistoryLength + nSamples;
+        const double *extended = work.mExtended.data();
+        double *weights = state.mWeights.data();
+        // Energy of the first window
+        double energy = 0;
+        for (int r = 0; r < mReferences; ++r)
+        {
+            auto window = extended + static_cast<size_t> (r)*nExtended;
+            for (int j = 0; j < L; ++j){energy = energy + window[j]*window[j];}
+        }
+        for (int i = 0; i < nSamples; ++i)
+        {
+            if (i > 0)
+            {
+                for (int r = 0; r < mReferences; ++r)
+                {
+                    auto u = extended + static_cast<size_t> (r)*nExtended;
+                    energy = energy + u[i + L - 1]*u[i + L - 1]
+                                    - u[i - 1]*u[i - 1];
+                }
+                energy = std::max(0.0, energy);
+            }
+            double y = 0;
+            for (int r = 0; r < mReferences; ++r)
+            {
+                const double *__restrict__ window
+                    = extended + static_cast<size_t> (r)*nExtended + i;
+                const double *__restrict__ w
+                    = weights + static_cast<size_t> (r)*L;
+                #pragma omp simd reduction(+:y)
+                for (int j = 0; j < L; ++j)
+                {
+                    y = y + w[j]*window[j];
+                }
+            }
+            auto e = static_cast<double> (primary[i]) - y;
+            cleaned[i] = static_cast<T> (e);
+            auto denominator = mRegularization + energy;
+            if (!(denominator > 0)){continue;}
+            auto scale = mStepSize*e/denominator;
+            for (int r = 0; r < mReferences; ++r)
+            {
+                const double *__restrict__ window
+                    = extended + static_cast<size_t> (r)*nExtended + i;
+                double *__restrict__ w = weights + static_cast<size_t> (r)*L;
+                #pragma omp simd
+                for (int j = 0; j < L; ++j)
+                {
+                    w[j] = w[j] + scale*window[j];
+                }
+            }
+        }
+    }
+    /// RLS
+    void rls(const int nSamples, const T primary[], T cleaned[],
+             ChannelState &state, Workspace &work) const
+    {
+        const int L = mFilterLength;
+        const int M = mReferences*L;
+        const int nExtended = mHistoryLength + nSamples;
+        const double lambdaInverse = 1/mForgettingFactor;
+        double *__restrict__ P = state.mInverseCorrelation.data();
+        double *__restrict__ w = state.mWeights.data();
+        double *__restrict__ u = work.mRegressor.data();
+        double *__restrict__ pu = work.mGain.data();
+        for (int i = 0; i < nSamples; ++i)
+        {
+            for (int r = 0; r < mReferences; ++r)
+            {
+                auto window = work.mExtended.data()
+                            + static_cast<size_t> (r)*nExtended + i;
+                std::copy(window, window + L, u + static_cast<size_t> (r)*L);
+            }
+            double y = 0;
+            #pragma omp simd reduction(+:y)
+            for (int j = 0; j < M; ++j){y = y + w[j]*u[j];}
+            auto e = static_cast<double> (primary[i]) - y;
+            cleaned[i] = static_cast<T> (e);
+            // pu = P u and the gain's denominator lambda + u^T P u
+            double uPu = 0;
+            for (int k = 0; k < M; ++k)
+            {
+                const double *__restrict__ Pk = P + static_cast<size_t> (k)*M;
+                double sum = 0;
+                #pragma omp simd reduction(+:sum)
+                for (int j = 0; j < M; ++j){sum = sum + Pk[j]*u[j];}
+                pu[k] = sum;
+                uPu = uPu + u[k]*sum;
+            }
+            auto denominator = mForgettingFactor + uPu;
+            if (!(denominator > 0)){continue;}
+            auto gainScale = 1/denominator;
+            // w = w + k e with k = P u/(lambda + u^T P u)
+            auto scale = e*gainScale;
+            #pragma omp simd
+            for (int j = 0; j < M; ++j){w[j] = w[j] + scale*pu[j];}
+            // P = (P - k (P u)^T)/lambda.  P is symmetric so this stays
+            // symmetric.
+            for (int k = 0; k < M; ++k)
+            {
+                double *__restrict__ Pk = P + static_cast<size_t> (k)*M;
+                auto kk = pu[k]*gainScale;
+                #pragma omp simd
+                for (int j = 0; j < M; ++j)
+                {
+                    Pk[j] = (Pk[j] - kk*pu[j])*lambdaInverse;
+                }
+            }
+        }
+    }
+    /// Block LMS
+    void blockLMS(const int nSamples, const T primary[], T cleaned[],
+                  ChannelState &state, Workspace &work) const
+    {
+        const int L = mFilterLength;
+        const int N = mDFTLength;
+        const int B = mBlockLength;
+        const int H = mHistoryLength;
+        const int nFrequencies = N/2 + 1;
+        const int nExtended = H + nSamples;
+        const int nPending = static_cast<int> (state.mPending.size());
+        const double xnorm = 1.0/N;
+        const double *extended = work.mExtended.data();
+        double *weights = state.mWeights.data();
+        // Primary sample at time t relative to this packet
+        auto desired = [&](const int t)
+        {
+            return t < 0 ? state.mPending[t + nPending] :
+                           static_cast<double> (primary[t]);
+        };
+        int blockStart =-nPending;
+        for (; blockStart + B <= nSamples; blockStart = blockStart + B)
+        {
+            // The frame is the N reference samples ending with the block
+            auto frameStart = blockStart + B - 1 + H - (N - 1);
+            auto outputSpectrum = work.mOutputSpectrum.data();
+            std::fill(outputSpectrum, outputSpectrum + nFrequencies, 0.0);
+            for (int r = 0; r < mReferences; ++r)
+            {
+                auto frame = extended + static_cast<size_t> (r)*nExtended
+                           + frameStart;
+                auto U = work.mReferenceSpectra.data()
+                       + static_cast<size_t> (r)*nFrequencies;
+                std::copy(frame, frame + N, work.mInData);
+                fftw_execute_dft_r2c(mForwardPlan, work.mInData,
+                                     work.mSpectrum);
+                for (int k = 0; k < nFrequencies; ++k)
+                {
+                    U[k] = std::complex<double> (work.mSpectrum[k][0],
+                                                 work.mSpectrum[k][1]);
+                }
+                // Weights' spectrum
+                auto w = weights + static_cast<size_t> (r)*L;
+                std::copy(w, w + L, work.mInData);
+                std::fill(work.mInData + L, work.mInData + N, 0.0);
+                fftw_execute_dft_r2c(mForwardPlan, work.mInData,
+                                     work.mSpectrum);
+                for (int k = 0; k < nFrequencies; ++k)
+                {
+                    outputSpectrum[k] = outputSpectrum[k]
+                        + U[k]*std::complex<double> (work.mSpectrum[k][0],
+                                                     work.mSpectrum[k][1]);
+                }
+            }
+            // The last B samples of the circular convolution are the linear
+            // convolution
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                work.mSpectrum[k][0] = outputSpectrum[k].real();
+                work.mSpectrum[k][1] = outputSpectrum[k].imag();
+            }
+            fftw_execute_dft_c2r(mInversePlan, work.mSpectrum, work.mInData);
+            for (int i = 0; i < B; ++i)
+            {
+                auto t = blockStart + i;
+                auto e = desired(t) - work.mInData[N - B + i]*xnorm;
+                work.mErrors[i] = e;
+                if (t >= 0){cleaned[t] = static_cast<T> (e);}
+            }
+            // Error spectrum
+            std::fill(work.mInData, work.mInData + N - B, 0.0);
+            std::copy(work.mErrors.begin(), work.mErrors.end(),
+                      work.mInData + N - B);
+            fftw_execute_dft_r2c(mForwardPlan, work.mInData, work.mSpectrum);
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                work.mErrorSpectrum[k]
+                    = std::complex<double> (work.mSpectrum[k][0],
+                                            work.mSpectrum[k][1]);
+            }
+            // Smoothed power for the per-frequency step
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                double power = 0;
+                for (int r = 0; r < mReferences; ++r)
+                {
+                    power = power
+                          + std::norm(work.mReferenceSpectra[
+                                      static_cast<size_t> (r)*nFrequencies
+                                    + k]);
+                }
+                state.mPower[k] = state.mHavePower ?
+                                  POWER_SMOOTHING*state.mPower[k]
+                                + (1 - POWER_SMOOTHING)*power : power;
+            }
+            state.mHavePower = true;
+            // Constrained gradient: keep the first L lags of the
+            // normalized cross-correlation
+            for (int r = 0; r < mReferences; ++r)
+            {
+                auto U = work.mReferenceSpectra.data()
+                       + static_cast<size_t> (r)*nFrequencies;
+                for (int k = 0; k < nFrequencies; ++k)
+                {
+                    auto denominator = state.mPower[k] + mRegularization;
+                    std::complex<double> g(0, 0);
+                    if (denominator > 0)
+                    {
+                        g = std::conj(U[k])*work.mErrorSpectrum[k]
+                           /denominator;
+                    }
+                    work.mSpectrum[k][0] = g.real();
+                    work.mSpectrum[k][1] = g.imag();
+                }
+                fftw_execute_dft_c2r(mInversePlan, work.mSpectrum,
+                                     work.mInData);
+                auto w = weights + static_cast<size_t> (r)*L;
+                auto scale = mStepSize*xnorm;
+                #pragma omp simd
+                for (int j = 0; j < L; ++j)
+                {
+                    w[j] = w[j] + scale*work.mInData[j];
+                }
+            }
+        }
+        // Filter the incomplete block in the time domain
+        for (int t = std::max(0, blockStart); t < nSamples; ++t)
+        {
+            double y = 0;
+            for (int r = 0; r < mReferences; ++r)
+            {
+                auto u = extended + static_cast<size_t> (r)*nExtended + t + H;
+                auto w = weights + static_cast<size_t> (r)*L;
+                for (int j = 0; j < L; ++j){y = y + w[j]*u[-j];}
+            }
+            cleaned[t] = static_cast<T> (static_cast<double> (primary[t]) - y);
+        }
+        // Save the incomplete block's primary samples
+        std::vector<double> pending(nSamples - blockStart);
+        for (int t = blockStart; t < nSamples; ++t)
+        {
+            pending[t - blockStart] = desired(t);
+        }
+        state.mPending = std::move(pending);
+    }
+    std::vector<ChannelState> mStates;
+    fftw_plan mForwardPlan;
+    fftw_plan mInversePlan;
+    double *mInData = nullptr;
+    fftw_complex *mSpectrum = nullptr;
+    AdaptiveFilterType mType = AdaptiveFilterType::NLMS;
+    double mStepSize = 0.1;
+    double mForgettingFactor = 0.999;
+    double mRegularization = 1.e-8;
+    int mChannels = 0;
+    int mReferences = 0;
+    int mFilterLength = 0;
+    int mHistoryLength = 0;
+    int mDFTLength = 0;
+    int mBlockLength = 0;
+    bool mHavePlans = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+AdaptiveFilter<T>::AdaptiveFilter() :
+    pImpl(std::make_unique<AdaptiveFilterImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+AdaptiveFilter<T>::AdaptiveFilter(const AdaptiveFilter &filter)
+{
+    *this = filter;
+}
+
+/// Move c'tor
+template<class T>
+AdaptiveFilter<T>::AdaptiveFilter(AdaptiveFilter &&filter) noexcept
+{
+    *this = std::move(filter);
+}
+
+/// Copy assignment
+template<class T>
+AdaptiveFilter<T>& AdaptiveFilter<T>::operator=(const AdaptiveFilter &filter)
+{
+    if (&filter == this){return *this;}
+    pImpl = std::make_unique<AdaptiveFilterImpl> (*filter.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+AdaptiveFilter<T>&
+AdaptiveFilter<T>::operator=(AdaptiveFilter &&filter) noexcept
+{
+    if (&filter == this){return *this;}
+    pImpl = std::move(filter.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+AdaptiveFilter<T>::~AdaptiveFilter() = default;
+
+/// Clear
+template<class T>
+void AdaptiveFilter<T>::clear() noexcept
+{
+    pImpl = std::make_unique<AdaptiveFilterImpl> ();
+}
+
+/// Initialize
+template<class T>
+void AdaptiveFilter<T>::initialize(const int nChannels,
+                                   const int nReferences,
+                                   const int filterLength,
+                                   const AdaptiveFilterType type,
+                                   const double stepSize,
+                                   const double forgettingFactor,
+                                   const double regularization)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (nReferences < 1)
+    {
+        throw std::invalid_argument("nReferences = "
+                                  + std::to_string(nReferences)
+                                  + " must be positive");
+    }
+    if (filterLength < 1)
+    {
+        throw std::invalid_argument("filterLength = "
+                                  + std::to_string(filterLength)
+                                  + " must be positive");
+    }
+    if (type == AdaptiveFilterType::RLS)
+    {
+        if (forgettingFactor <= 0 || forgettingFactor > 1)
+        {
+            throw std::invalid_argument("forgettingFactor = "
+                                      + std::to_string(forgettingFactor)
+                                      + " must be in range (0,1]");
+        }
+        if (regularization <= 0)
+        {
+            throw std::invalid_argument("regularization = "
+                                      + std::to_string(regularization)
+                                      + " must be positive");
+        }
+    }
+    else
+    {
+        if (stepSize <= 0 || stepSize >= 2)
+        {
+            throw std::invalid_argument("stepSize = "
+                                      + std::to_string(stepSize)
+                                      + " must be in range (0,2)");
+        }
+        if (regularization < 0)
+        {
+            throw std::invalid_argument("regularization = "
+                                      + std::to_string(regularization)
+                                      + " must be non-negative");
+        }
+    }
+    pImpl->mType = type;
+    pImpl->mStepSize = stepSize;
+    pImpl->mForgettingFactor = forgettingFactor;
+    pImpl->mRegularization = regularization;
+    pImpl->mChannels = nChannels;
+    pImpl->mReferences = nReferences;
+    pImpl->mFilterLength = filterLength;
+    pImpl->mHistoryLength = filterLength - 1;
+    if (type == AdaptiveFilterType::BLOCK_LMS)
+    {
+        pImpl->mDFTLength
+            = RTSeis::Transforms::DFTUtilities::nextFastLength(2*filterLength);
+        pImpl->mBlockLength = pImpl->mDFTLength - filterLength + 1;
+        pImpl->mHistoryLength = pImpl->mDFTLength - 1;
+        pImpl->makePlans();
+    }
+    pImpl->mStates.resize(nChannels);
+    for (auto &state : pImpl->mStates){pImpl->resetState(state);}
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool AdaptiveFilter<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<class T>
+int AdaptiveFilter<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Number of references
+template<class T>
+int AdaptiveFilter<T>::getNumberOfReferences() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mReferences;
+}
+
+/// Filter length
+template<class T>
+int AdaptiveFilter<T>::getFilterLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mFilterLength;
+}
+
+/// Type
+template<class T>
+AdaptiveFilterType AdaptiveFilter<T>::getType() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mType;
+}
+
+/// Weights
+template<class T>
+std::vector<double> AdaptiveFilter<T>::getWeights(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(pImpl->mChannels - 1)
+                                  + "]");
+    }
+    auto weights = pImpl->mStates[channel].mWeights;
+    if (pImpl->mType != AdaptiveFilterType::BLOCK_LMS)
+    {
+        const int L = pImpl->mFilterLength;
+        for (int r = 0; r < pImpl->mReferences; ++r)
+        {
+            auto w = weights.begin() + static_cast<size_t> (r)*L;
+            std::reverse(w, w + L);
+        }
+    }
+    return weights;
+}
+
+/// Reset initial conditions
+template<class T>
+void AdaptiveFilter<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    for (auto &state : pImpl->mStates){pImpl->resetState(state);}
+}
+
+/// Apply
+template<class T>
+void AdaptiveFilter<T>::apply(const int nSamples, const T primary[],
+                              const T references[], T *cleanedIn[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nSamples < 1){return;} // Nothing to do
+    T *cleaned = *cleanedIn;
+    if (primary == nullptr || references == nullptr || cleaned == nullptr)
+    {
+        if (primary == nullptr){throw std::invalid_argument("primary is NULL");}
+        if (references == nullptr)
+        {
+            throw std::invalid_argument("references is NULL");
+        }
+        throw std::invalid_argument("cleaned is NULL");
+    }
+    const int nChannels = pImpl->mChannels;
+    const int nReferences = pImpl->mReferences;
+    const auto type = pImpl->mType;
+    #pragma omp parallel default(shared)
+    {
+    typename AdaptiveFilterImpl::Workspace work(*pImpl);
+    #pragma omp for schedule(dynamic)
+    for (int c = 0; c < nChannels; ++c)
+    {
+        auto &state = pImpl->mStates[c];
+        auto d = primary + static_cast<size_t> (c)*nSamples;
+        auto u = references + static_cast<size_t> (c)*nReferences*nSamples;
+        auto e = cleaned + static_cast<size_t> (c)*nSamples;
+        pImpl->extend(nSamples, u, state, work);
+        if (type == AdaptiveFilterType::NLMS)
+        {
+            pImpl->nlms(nSamples, d, e, state, work);
+        }
+        else if (type == AdaptiveFilterType::RLS)
+        {
+            pImpl->rls(nSamples, d, e, state, work);
+        }
+        else
+        {
+            pImpl->blockLMS(nSamples, d, e, state, work);
+        }
+        pImpl->saveHistory(nSamples, state, work);
+    }
+    } // End parallel
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::FilterImplementations::AdaptiveFilter<double>;
+template class RTSeis::FilterImplementations::AdaptiveFilter<float>;
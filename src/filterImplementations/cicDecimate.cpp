@@ -0,0 +1,348 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/enums.hpp"
+#include "rtseis/filterImplementations/cicDecimate.hpp"
+#include "rtseis/filterDesign/fir.hpp"
+#include "rtseis/filterRepresentations/fir.hpp"
+
+using namespace RTSeis::FilterImplementations;
+
+template<RTSeis::ProcessingMode E, class T>
+class CICDecimate<E, T>::CICDecimateImpl
+{
+public:
+    /// The number of output samples for a signal of length n
+    [[nodiscard]] int estimateSpace(const int n) const
+    {
+        auto phase = (mMode == RTSeis::ProcessingMode::REAL_TIME) ? mPhase : 0;
+        return std::max(0, (n + mDownFactor - 1 - phase)/mDownFactor);
+    }
+    /// Zeros the state
+    void resetInitialConditions()
+    {
+        std::fill(mIntegrators.begin(), mIntegrators.end(), 0);
+        std::fill(mCombs.begin(), mCombs.end(), 0);
+        std::fill(mDelayLine.begin(), mDelayLine.end(), 0);
+        mCombIndex = 0;
+        mPhase = 0;
+    }
+    /// Runs a quantized sample through the integrators
+    void integrate(const T xi)
+    {
+        auto xc = std::min(mMaxAmplitude,
+                           std::max(-mMaxAmplitude, static_cast<double> (xi)));
+        auto v = static_cast<uint64_t> (std::llround(xc*mInputScale));
+        mIntegrators[0] = mIntegrators[0] + v;
+        for (int s = 1; s < mStages; ++s)
+        {
+            mIntegrators[s] = mIntegrators[s] + mIntegrators[s - 1];
+        }
+    }
+    /// Runs the last integrator through the combs at the low rate
+    [[nodiscard]] double comb()
+    {
+        auto c = mIntegrators[mStages - 1];
+        for (int s = 0; s < mStages; ++s)
+        {
+            auto &delayed = mCombs[s*mDifferentialDelay + mCombIndex];
+            auto previous = delayed;
+            delayed = c;
+            c = c - previous;
+        }
+        mCombIndex = (mCombIndex + 1)%mDifferentialDelay;
+        return static_cast<double> (static_cast<int64_t> (c))*mOutputScale;
+    }
+    void apply(const int nx, const T x[], T y[])
+    {
+        if (mMode != RTSeis::ProcessingMode::REAL_TIME)
+        {
+            resetInitialConditions();
+        }
+        const int order = static_cast<int> (mReversedTaps.size()) - 1;
+        const int nOut = estimateSpace(nx);
+        // CIC at the full rate with the combs at the retained samples
+        mWork.resize(order + nOut);
+        std::copy(mDelayLine.begin(), mDelayLine.end(), mWork.begin());
+        int i = 0;
+        int next = mPhase;
+        for (int k = 0; k < nOut; ++k)
+        {
+            for (; i <= next; ++i){integrate(x[i]);}
+            mWork[order + k] = comb();
+            next = next + mDownFactor;
+        }
+        for (; i < nx; ++i){integrate(x[i]);}
+        mPhase = next - nx;
+        // Compensation filter at the low rate
+        const double *br = mReversedTaps.data();
+        for (int k = 0; k < nOut; ++k)
+        {
+            const double *wk = mWork.data() + k;
+            double yk = 0;
+            #pragma omp simd reduction(+:yk)
+            for (int j = 0; j <= order; ++j)
+            {
+                yk = yk + br[j]*wk[j];
+            }
+            y[k] = static_cast<T> (yk);
+        }
+        std::copy(mWork.begin() + nOut, mWork.begin() + nOut + order,
+                  mDelayLine.begin());
+    }
+    /// The compensation filter taps in reverse order
+    std::vector<double> mReversedTaps;
+    /// The compensation filter's delay line
+    std::vector<double> mDelayLine;
+    /// Workspace holding [delay line, CIC output]
+    std::vector<double> mWork;
+    /// The integrator registers
+    std::vector<uint64_t> mIntegrators;
+    /// The [nStages x differentialDelay] comb delays
+    std::vector<uint64_t> mCombs;
+    /// Scales the input to the integer grid
+    double mInputScale = 1;
+    /// Undoes the input scale and the CIC's gain of (RM)^N
+    double mOutputScale = 1;
+    double mMaxAmplitude = 0;
+    int mDownFactor = 1;
+    int mStages = 0;
+    int mDifferentialDelay = 1;
+    int mCombIndex = 0;
+    /// Index of the next retained sample in the next packet
+    int mPhase = 0;
+    const RTSeis::ProcessingMode mMode = E;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+CICDecimate<E, T>::CICDecimate() :
+    pImpl(std::make_unique<CICDecimateImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+CICDecimate<E, T>::CICDecimate(const CICDecimate &cic)
+{
+    *this = cic;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+CICDecimate<E, T>::CICDecimate(CICDecimate &&cic) noexcept
+{
+    *this = std::move(cic);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+CICDecimate<E, T>& CICDecimate<E, T>::operator=(const CICDecimate &cic)
+{
+    if (&cic == this){return *this;}
+    pImpl = std::make_unique<CICDecimateImpl> (*cic.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+CICDecimate<E, T>& CICDecimate<E, T>::operator=(CICDecimate &&cic) noexcept
+{
+    if (&cic == this){return *this;}
+    pImpl = std::move(cic.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+CICDecimate<E, T>::~CICDecimate() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void CICDecimate<E, T>::clear() noexcept
+{
+    pImpl->mReversedTaps.clear();
+    pImpl->mDelayLine.clear();
+    pImpl->mWork.clear();
+    pImpl->mIntegrators.clear();
+    pImpl->mCombs.clear();
+    pImpl->mInputScale = 1;
+    pImpl->mOutputScale = 1;
+    pImpl->mMaxAmplitude = 0;
+    pImpl->mDownFactor = 1;
+    pImpl->mStages = 0;
+    pImpl->mDifferentialDelay = 1;
+    pImpl->mCombIndex = 0;
+    pImpl->mPhase = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void CICDecimate<E, T>::initialize(const int downFactor,
+                                   const int nStages,
+                                   const int differentialDelay,
+                                   const int compensationLength,
+                                   const double passband,
+                                   const double maxAmplitude)
+{
+    clear();
+    if (downFactor < 2)
+    {
+        throw std::invalid_argument("Downsampling factor = "
+                                  + std::to_string(downFactor)
+                                  + " must be at least 2");
+    }
+    if (nStages < 1)
+    {
+        throw std::invalid_argument("nStages = " + std::to_string(nStages)
+                                  + " must be positive");
+    }
+    if (differentialDelay < 1)
+    {
+        throw std::invalid_argument("differentialDelay = "
+                                  + std::to_string(differentialDelay)
+                                  + " must be positive");
+    }
+    if (compensationLength < 5)
+    {
+        throw std::invalid_argument("Compensation length = "
+                                  + std::to_string(compensationLength)
+                                  + " must be at least 5");
+    }
+    if (maxAmplitude <= 0)
+    {
+        throw std::invalid_argument("maxAmplitude = "
+                                  + std::to_string(maxAmplitude)
+                                  + " must be positive");
+    }
+    // The output of the combs grows by (RM)^N.  Keep a bit of headroom below
+    // the sign bit.
+    auto gain = std::pow(static_cast<double> (downFactor)*differentialDelay,
+                         nStages);
+    auto growthBits = std::log2(gain);
+    auto inputBits = 62 - std::ceil(growthBits);
+    if (inputBits < 8)
+    {
+        throw std::invalid_argument("Register growth of "
+                                  + std::to_string(growthBits)
+                                  + " bits is too large");
+    }
+    auto fir = RTSeis::FilterDesign::FIR::CICCompensator(
+                   compensationLength - 1, downFactor, nStages,
+                   differentialDelay, passband); // Throws
+    auto b = fir.getFilterTaps();
+    pImpl->mReversedTaps.resize(b.size());
+    std::reverse_copy(b.begin(), b.end(), pImpl->mReversedTaps.begin());
+    pImpl->mDelayLine.assign(b.size() - 1, 0);
+    pImpl->mIntegrators.assign(nStages, 0);
+    pImpl->mCombs.assign(static_cast<size_t> (nStages)*differentialDelay, 0);
+    // A power of two scale is exact in floating point
+    auto exponent = std::floor(inputBits - std::log2(maxAmplitude));
+    pImpl->mInputScale = std::pow(2.0, exponent);
+    pImpl->mOutputScale = 1/(pImpl->mInputScale*gain);
+    pImpl->mMaxAmplitude = maxAmplitude;
+    pImpl->mDownFactor = downFactor;
+    pImpl->mStages = nStages;
+    pImpl->mDifferentialDelay = differentialDelay;
+    pImpl->mCombIndex = 0;
+    pImpl->mPhase = 0;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool CICDecimate<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Downsampling factor
+template<RTSeis::ProcessingMode E, class T>
+int CICDecimate<E, T>::getDownsamplingFactor() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mDownFactor;
+}
+
+/// Number of stages
+template<RTSeis::ProcessingMode E, class T>
+int CICDecimate<E, T>::getNumberOfStages() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mStages;
+}
+
+/// Compensation filter
+template<RTSeis::ProcessingMode E, class T>
+std::vector<double> CICDecimate<E, T>::getCompensationFilterTaps() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::vector<double> b(pImpl->mReversedTaps.rbegin(),
+                          pImpl->mReversedTaps.rend());
+    return b;
+}
+
+/// Group delay
+template<RTSeis::ProcessingMode E, class T>
+double CICDecimate<E, T>::getGroupDelay() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    auto dR = static_cast<double> (pImpl->mDownFactor);
+    auto cicDelay = 0.5*pImpl->mStages*(dR*pImpl->mDifferentialDelay - 1);
+    auto firDelay = 0.5*static_cast<double> (pImpl->mReversedTaps.size() - 1);
+    return cicDelay + dR*firDelay;
+}
+
+/// Reset
+template<RTSeis::ProcessingMode E, class T>
+void CICDecimate<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Estimate space
+template<RTSeis::ProcessingMode E, class T>
+int CICDecimate<E, T>::estimateSpace(const int n) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (n < 0){throw std::invalid_argument("n cannot be negative");}
+    return pImpl->estimateSpace(n);
+}
+
+/// Decimate
+template<RTSeis::ProcessingMode E, class T>
+void CICDecimate<E, T>::apply(const int nx, const T x[],
+                              const int ny, int *nyDown, T *yIn[])
+{
+    *nyDown = 0;
+    if (nx <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    auto nyRef = estimateSpace(nx);
+    if (ny < nyRef)
+    {
+        throw std::invalid_argument("ny = " + std::to_string(ny)
+                                  + " must be at least "
+                                  + std::to_string(nyRef));
+    }
+    T *y = *yIn;
+    if (y == nullptr){throw std::invalid_argument("y is NULL");}
+    pImpl->apply(nx, x, y);
+    *nyDown = nyRef;
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::FilterImplementations::CICDecimate<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::FilterImplementations::CICDecimate<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::FilterImplementations::CICDecimate<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::FilterImplementations::CICDecimate<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -4,13 +4,14 @@
 #ifndef NDEBBUG
 #include <cassert>
 #endif
+#include <vector>
+#include <algorithm>
 #include <ipps.h>
 #include "rtseis/enums.hpp"
 #include "rtseis/filterImplementations/decimate.hpp"
 #include "rtseis/filterDesign/fir.hpp"
 #include "rtseis/filterRepresentations/fir.hpp"
-#include "rtseis/filterImplementations/downsample.hpp"
-#include "rtseis/filterImplementations/firFilter.hpp"
+#include "private/decimationFilter.hpp"
 
 using namespace RTSeis::FilterImplementations;
 
@@ -23,97 +24,104 @@ public:
                     const bool lRemovePhaseShift)
     {
         mDownFactor = downFactor;
-        int nfir = filterLength;
         // Postprocessing is a little trickier - may have to extend filter length
-        if (mMode == RTSeis::ProcessingMode::POST_PROCESSING &&
-            lRemovePhaseShift)
+        mRemovePhaseShift
+            = (mMode == RTSeis::ProcessingMode::POST_PROCESSING &&
+               lRemovePhaseShift);
+        // Set the polyphase filter
+        auto b = designDecimationFilter(downFactor, filterLength,
+                                        mRemovePhaseShift, &mGroupDelay);
+        mFIRLength = static_cast<int> (b.size());
+        mReversedTaps.resize(b.size());
+        std::reverse_copy(b.begin(), b.end(), mReversedTaps.begin());
+        mZi.assign(mFIRLength - 1, 0);
+        mDelayLine.assign(mFIRLength - 1, 0);
+        mPhase = 0;
+        mInitialized = true;
+    }
+    /// Evaluates the FIR filter at the output instants n0, n0 + downFactor,
+    /// ..., i.e., y[i] = sum_k b[k] w[order + n0 + i*downFactor - k] where
+    /// the first order samples of w are the delay line.  Only the retained
+    /// samples are computed so this is a factor of downFactor cheaper than
+    /// filtering at the full rate then downsampling.
+    void polyphaseFilter(const T w[], const int n0, const int nOut, T y[])
+    {
+        const T *br = mReversedTaps.data();
+        const int nb = mFIRLength;
+        for (int i = 0; i < nOut; ++i)
         {
-            bool lfail = true;
-            for (auto k=0; k<INT_MAX-1; ++k)
-            {
-                int groupDelay = (nfir-1)/2;
-                if (groupDelay%downFactor == 0 && nfir%2 == 1)
-                {
-                    lfail = false;
-                    break;
-                }
-                nfir = nfir + 1;
-            }
-#ifndef NDEBUG
-            assert(!lfail);
-#endif
-            if (lfail)
+            const T *wi = w + n0 + i*mDownFactor;
+            T yi = 0;
+            #pragma omp simd reduction(+:yi)
+            for (int j = 0; j < nb; ++j)
             {
-                throw std::runtime_error("Padding algorithmic failure");
+                yi = yi + br[j]*wi[j];
             }
-            mGroupDelay = nfir/2;
-            mRemovePhaseShift = true;
-        }
-        // Create a hamming filter.
-        mFIRLength = nfir;
-        int order = nfir - 1;
-        auto r = 1.0/static_cast<double> (downFactor);
-        auto fir = FilterDesign::FIR::FIR1Lowpass(order, r,
-                                                  FilterDesign::FIRWindow::HAMMING);
-        // Set the multirate FIR filter
-        auto b = fir.getFilterTaps();
-        int ntaps = b.size();
-        try
-        {
-            mFIRFilter.initialize(ntaps, b.data());
-            mDownsampler.initialize(downFactor);
-        }
-        catch (std::exception &e)
-        {
-            auto errmsg = std::string("FIR filter initialization failed with: ")
-                        + e.what();
-            throw std::runtime_error(errmsg);
+            y[i] = yi;
         }
-        mInitialized = true;
+    }
+    /// The number of output samples for a signal of length n
+    [[nodiscard]] int estimateSpace(const int n) const
+    {
+        auto phase = (mMode == RTSeis::ProcessingMode::REAL_TIME) ? mPhase : 0;
+        return std::max(0, (n + mDownFactor - 1 - phase)/mDownFactor);
+    }
+    /// Restores the delay line and phase
+    void resetInitialConditions()
+    {
+        std::copy(mZi.begin(), mZi.end(), mDelayLine.begin());
+        mPhase = 0;
     }
     void apply(const int nx, const T x[],
                const int ny, int *nyDown, T y[])
     {
+        const int order = mFIRLength - 1;
+        const int nOut = estimateSpace(nx);
+#ifndef NDEBUG
+        assert(ny >= nOut);
+#endif
+        // Workspace holds [delay line, x, trailing zeros]
+        auto npad = mRemovePhaseShift ? mGroupDelay : 0;
+        mWork.resize(order + nx + npad);
+        std::copy(mDelayLine.begin(), mDelayLine.end(), mWork.begin());
+        std::copy(x, x + nx, mWork.begin() + order);
+        std::fill(mWork.begin() + order + nx, mWork.end(), 0);
         if (mRemovePhaseShift)
         {
 #ifndef NDEBUG
             assert(mGroupDelay%mDownFactor == 0);
 #endif
-            // Postpend zeros so that the filter delay pushes our desired
-            // output to the end of the temporary array
-            int npad = nx + mGroupDelay;
-            auto xpad = reinterpret_cast<T *> (ippsMalloc_8u(npad*sizeof(T)));
-            std::copy(x, x + nx, xpad);
-            std::fill(xpad + nx, xpad + nx + mGroupDelay, 0);
-            //ippsCopy_64f(x, xpad, nx);
-            //ippsZero_64f(&xpad[nx], mGroupDelay);
-            // The FIR filter seems to perform better than the multirate FIR
-            // filter.  So don't fight it.
-            //double *yfilt = ippsMalloc_64f(npad);
-            auto yfilt = reinterpret_cast<T *> (ippsMalloc_8u(npad*sizeof(T)));
-            mFIRFilter.apply(npad, xpad, &yfilt);
-            mDownsampler.apply(nx, &yfilt[mGroupDelay],
-                               ny, nyDown, &y);
-            ippsFree(xpad);
-            ippsFree(yfilt);
+            // The filter delay pushes the desired output by the group delay
+            polyphaseFilter(mWork.data(), mGroupDelay, nOut, y);
         }
         else
         {
-            // Just apply the downsampler
-            //pImpl->mMRFIRFilter.apply(nx, x, ny, nyDown, &y);
-            //double *yfilt = ippsMalloc_64f(nx);
-            auto yfilt = reinterpret_cast<T *> (ippsMalloc_8u(nx*sizeof(T)));
-            mFIRFilter.apply(nx, x, &yfilt);
-            mDownsampler.apply(nx, yfilt, ny, nyDown, &y);
-            ippsFree(yfilt);
+            auto phase = (mMode == RTSeis::ProcessingMode::REAL_TIME) ?
+                         mPhase : 0;
+            polyphaseFilter(mWork.data(), phase, nOut, y);
+            if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+            {
+                // Carry the phase and last order samples to the next packet
+                mPhase = phase + nOut*mDownFactor - nx;
+                std::copy(mWork.begin() + nx, mWork.begin() + nx + order,
+                          mDelayLine.begin());
+            }
         }
+        *nyDown = nOut;
     }
-    //class MultiRateFIRFilter mMRFIRFilter; // TODO implementation is slow!
-    class FIRFilter<E, T> mFIRFilter;
-    class Downsample<E, T> mDownsampler; 
+    /// The filter taps in reverse order
+    std::vector<T> mReversedTaps;
+    /// The initial conditions
+    std::vector<T> mZi;
+    /// The delay line holding the previous order input samples
+    std::vector<T> mDelayLine;
+    /// Workspace
+    std::vector<T> mWork;
     int mDownFactor = 1;
     int mGroupDelay = 0;
     int mFIRLength = 0;
+    /// Index of the next retained sample in the next packet
+    int mPhase = 0;
     const RTSeis::ProcessingMode mMode = E;
     //RTSeis::Precision mPrecision = RTSeis::Precision::DOUBLE;
     bool mRemovePhaseShift = false;
@@ -168,9 +176,11 @@ Decimate<E, T>::~Decimate() = default;
 template<RTSeis::ProcessingMode E, class T>
 void Decimate<E, T>::clear() noexcept
 {
-    //pImpl->mMRFIRFilter.clear();
-    pImpl->mFIRFilter.clear();
-    pImpl->mDownsampler.clear();
+    pImpl->mReversedTaps.clear();
+    pImpl->mZi.clear();
+    pImpl->mDelayLine.clear();
+    pImpl->mWork.clear();
+    pImpl->mPhase = 0;
     //pImpl->mMode = RTSeis::ProcessingMode::POST_PROCESSING;
     //pImpl->mPrecision = RTSeis::Precision::DOUBLE;
     pImpl->mDownFactor = 1;
@@ -353,7 +363,7 @@ int Decimate<E, T>::estimateSpace(const int n) const
 {
     if (!isInitialized()){throw std::runtime_error("Class not initialized");}
     if (n < 0){throw std::invalid_argument("n cannot be negative");}
-    return pImpl->mDownsampler.estimateSpace(n);
+    return pImpl->estimateSpace(n);
 }
 /* TODO - when lashing in a more performant multirate fir filter use this fn
 int Decimate::estimateSpace(const int n) const
@@ -383,7 +393,7 @@ template<RTSeis::ProcessingMode E, class T>
 int Decimate<E, T>::getInitialConditionLength() const
 {
     if (!isInitialized()){throw std::runtime_error("Class not initialized");}
-    return pImpl->mFIRFilter.getInitialConditionLength();
+    return pImpl->mFIRLength - 1;
 }
 
 /// Set initial conditions
@@ -399,9 +409,8 @@ void Decimate<E, T>::setInitialConditions(const int nz,const double zi[])
                                   + std::to_string(nzref));
     }
     if (nz > 0 && zi == nullptr){throw std::invalid_argument("zi is NULL");}
-    //pImpl->mMRFIRFilter.setInitialConditions(nz, zi);
-    pImpl->mFIRFilter.setInitialConditions(nz, zi);
-    pImpl->mDownsampler.resetInitialConditions();
+    std::copy(zi, zi + nz, pImpl->mZi.begin());
+    pImpl->resetInitialConditions();
 }
 
 /// Reset initial conditions
@@ -409,9 +418,7 @@ template<RTSeis::ProcessingMode E, class T>
 void Decimate<E, T>::resetInitialConditions()
 {
     if (!isInitialized()){throw std::runtime_error("Class not initialized");}
-    //pImpl->mMRFIRFilter.resetInitialConditions();
-    pImpl->mFIRFilter.resetInitialConditions();
-    pImpl->mDownsampler.resetInitialConditions();
+    pImpl->resetInitialConditions();
 }
 
 /// Apply decimator (double)
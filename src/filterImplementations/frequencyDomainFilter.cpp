@@ -0,0 +1,354 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/filterImplementations/frequencyDomainFilter.hpp"
+#include "rtseis/filterRepresentations/sos.hpp"
+#include "rtseis/transforms/utilities.hpp"
+#include "private/impulseResponse.hpp"
+
+using namespace RTSeis::FilterImplementations;
+namespace DFTUtilities = RTSeis::Transforms::DFTUtilities;
+
+namespace
+{
+enum class GainType
+{
+    SOS,   /*!< Squared amplitude response of an IIR filter. */
+    TAPER  /*!< Cosine tapered bandpass. */
+};
+}
+
+template<class T>
+class FrequencyDomainFilter<T>::FrequencyDomainFilterImpl
+{
+public:
+    FrequencyDomainFilterImpl() = default;
+    /// The transform plans are not copied; they are rebuilt on the next
+    /// call to apply.
+    FrequencyDomainFilterImpl(const FrequencyDomainFilterImpl &impl) :
+        mBs(impl.mBs),
+        mAs(impl.mAs),
+        mCorners(impl.mCorners),
+        mGainType(impl.mGainType),
+        mPadLength(impl.mPadLength),
+        mImpulseResponseLength(impl.mImpulseResponseLength),
+        mSections(impl.mSections),
+        mInitialized(impl.mInitialized)
+    {
+    }
+    FrequencyDomainFilterImpl& operator=(const FrequencyDomainFilterImpl &)
+        = delete;
+    ~FrequencyDomainFilterImpl()
+    {
+        clear();
+    }
+    void clear() noexcept
+    {
+        releasePlans();
+        mBs.clear();
+        mAs.clear();
+        mCorners = {0, 0, 0, 0};
+        mGainType = GainType::SOS;
+        mPadLength =-1;
+        mImpulseResponseLength = 0;
+        mSections = 0;
+        mInitialized = false;
+    }
+    void releasePlans() noexcept
+    {
+        if constexpr (std::is_same<T, double>::value)
+        {
+            if (mHavePlans)
+            {
+                fftw_destroy_plan(mForwardPlan);
+                fftw_destroy_plan(mInversePlan);
+            }
+            if (mInData != nullptr){fftw_free(mInData);}
+            if (mOutData != nullptr){fftw_free(mOutData);}
+        }
+        else
+        {
+            if (mHavePlans)
+            {
+                fftwf_destroy_plan(mForwardPlan);
+                fftwf_destroy_plan(mInversePlan);
+            }
+            if (mInData != nullptr){fftwf_free(mInData);}
+            if (mOutData != nullptr){fftwf_free(mOutData);}
+        }
+        mInData = nullptr;
+        mOutData = nullptr;
+        mGain.clear();
+        mHavePlans = false;
+        mTransformLength = 0;
+    }
+    /// Gain at the normalized frequency r = omega/pi
+    [[nodiscard]] double computeGain(const double r) const
+    {
+        if (mGainType == GainType::SOS)
+        {
+            auto z1 = std::polar(1.0, -M_PI*r); // z^{-1} = e^{-i omega}
+            auto z2 = z1*z1;
+            double gain = 1;
+            for (int is = 0; is < mSections; ++is)
+            {
+                auto b = mBs[3*is] + mBs[3*is+1]*z1 + mBs[3*is+2]*z2;
+                auto a = mAs[3*is] + mAs[3*is+1]*z1 + mAs[3*is+2]*z2;
+                gain = gain*std::norm(b)/std::norm(a);
+            }
+            return gain;
+        }
+        if (r < mCorners[0]){return 0;}
+        if (r < mCorners[1])
+        {
+            auto arg = M_PI*(r - mCorners[0])/(mCorners[1] - mCorners[0]);
+            return 0.5*(1 - std::cos(arg));
+        }
+        if (r <= mCorners[2]){return 1;}
+        if (r < mCorners[3])
+        {
+            auto arg = M_PI*(r - mCorners[2])/(mCorners[3] - mCorners[2]);
+            return 0.5*(1 + std::cos(arg));
+        }
+        return 0;
+    }
+    /// Creates the transform plans and gain for a transform length
+    void makePlans(const int nfft)
+    {
+        if (mHavePlans && nfft == mTransformLength){return;}
+        releasePlans();
+        auto nfreqs = nfft/2 + 1;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            mInData = static_cast<double *>
+                      (fftw_malloc(static_cast<size_t> (nfft)*sizeof(double)));
+            mOutData = reinterpret_cast<fftw_complex *>
+                       (fftw_malloc(static_cast<size_t> (nfreqs)
+                                   *sizeof(fftw_complex)));
+            mForwardPlan = fftw_plan_dft_r2c_1d(nfft, mInData, mOutData,
+                                                FFTW_ESTIMATE);
+            mInversePlan = fftw_plan_dft_c2r_1d(nfft, mOutData, mInData,
+                                                FFTW_ESTIMATE);
+        }
+        else
+        {
+            mInData = static_cast<float *>
+                      (fftw_malloc(static_cast<size_t> (nfft)*sizeof(float)));
+            mOutData = reinterpret_cast<fftwf_complex *>
+                       (fftw_malloc(static_cast<size_t> (nfreqs)
+                                   *sizeof(fftwf_complex)));
+            mForwardPlan = fftwf_plan_dft_r2c_1d(nfft, mInData, mOutData,
+                                                 FFTW_ESTIMATE);
+            mInversePlan = fftwf_plan_dft_c2r_1d(nfft, mOutData, mInData,
+                                                 FFTW_ESTIMATE);
+        }
+        mHavePlans = true;
+        mTransformLength = nfft;
+        // Fold the inverse transform's normalization into the gain
+        mGain.resize(nfreqs);
+        auto xnorm = 1.0/static_cast<double> (nfft);
+        for (int k = 0; k < nfreqs; ++k)
+        {
+            auto r = 2*static_cast<double> (k)/static_cast<double> (nfft);
+            mGain[k] = static_cast<T> (computeGain(std::min(1.0, r))*xnorm);
+        }
+    }
+    [[nodiscard]] int computePadLength(const int n) const
+    {
+        if (mPadLength >= 0){return mPadLength;}
+        if (mGainType == GainType::SOS){return mImpulseResponseLength;}
+        auto width = std::min(mCorners[1] - mCorners[0],
+                              mCorners[3] - mCorners[2]);
+        if (width <= 0){return n;}
+        return std::min(n, static_cast<int> (std::ceil(8/width)));
+    }
+    void apply(const int n, const T x[], T y[])
+    {
+        auto npad = computePadLength(n);
+        auto nfft = DFTUtilities::nextFastLength(n + npad);
+        makePlans(nfft);
+        std::copy(x, x + n, mInData);
+        std::fill(mInData + n, mInData + nfft, 0);
+        auto nfreqs = nfft/2 + 1;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            fftw_execute(mForwardPlan);
+        }
+        else
+        {
+            fftwf_execute(mForwardPlan);
+        }
+        for (int k = 0; k < nfreqs; ++k)
+        {
+            mOutData[k][0] = mOutData[k][0]*mGain[k];
+            mOutData[k][1] = mOutData[k][1]*mGain[k];
+        }
+        if constexpr (std::is_same<T, double>::value)
+        {
+            fftw_execute(mInversePlan);
+        }
+        else
+        {
+            fftwf_execute(mInversePlan);
+        }
+        std::copy(mInData, mInData + n, y);
+    }
+
+    using PlanType = typename std::conditional<std::is_same<T, double>::value,
+                                               fftw_plan, fftwf_plan>::type;
+    using ComplexType
+        = typename std::conditional<std::is_same<T, double>::value,
+                                    fftw_complex, fftwf_complex>::type;
+    std::vector<double> mBs;
+    std::vector<double> mAs;
+    std::vector<T> mGain;
+    std::array<double, 4> mCorners{0, 0, 0, 0};
+    PlanType mForwardPlan;
+    PlanType mInversePlan;
+    T *mInData = nullptr;
+    ComplexType *mOutData = nullptr;
+    GainType mGainType = GainType::SOS;
+    int mPadLength =-1;
+    int mImpulseResponseLength = 0;
+    int mSections = 0;
+    int mTransformLength = 0;
+    bool mHavePlans = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+FrequencyDomainFilter<T>::FrequencyDomainFilter() :
+    pImpl(std::make_unique<FrequencyDomainFilterImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+FrequencyDomainFilter<T>::FrequencyDomainFilter(
+    const FrequencyDomainFilter &filter)
+{
+    *this = filter;
+}
+
+/// Move c'tor
+template<class T>
+FrequencyDomainFilter<T>::FrequencyDomainFilter(
+    FrequencyDomainFilter &&filter) noexcept
+{
+    *this = std::move(filter);
+}
+
+/// Copy assignment
+template<class T>
+FrequencyDomainFilter<T>&
+FrequencyDomainFilter<T>::operator=(const FrequencyDomainFilter &filter)
+{
+    if (&filter == this){return *this;}
+    pImpl = std::make_unique<FrequencyDomainFilterImpl> (*filter.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+FrequencyDomainFilter<T>&
+FrequencyDomainFilter<T>::operator=(FrequencyDomainFilter &&filter) noexcept
+{
+    if (&filter == this){return *this;}
+    pImpl = std::move(filter.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+FrequencyDomainFilter<T>::~FrequencyDomainFilter() = default;
+
+/// Clear
+template<class T>
+void FrequencyDomainFilter<T>::clear() noexcept
+{
+    pImpl->clear();
+}
+
+/// Initialize from SOS
+template<class T>
+void FrequencyDomainFilter<T>::initialize(
+    const RTSeis::FilterRepresentations::SOS &sos, const int padLength)
+{
+    clear();
+    auto ns = sos.getNumberOfSections();
+    if (ns < 1){throw std::invalid_argument("No sections in filter");}
+    pImpl->mBs = sos.getNumeratorCoefficients();
+    pImpl->mAs = sos.getDenominatorCoefficients();
+    pImpl->mSections = ns;
+    pImpl->mGainType = GainType::SOS;
+    pImpl->mPadLength = padLength;
+    if (padLength < 0)
+    {
+        pImpl->mImpulseResponseLength = estimateImpulseResponseLength(sos);
+    }
+    pImpl->mInitialized = true;
+}
+
+/// Initialize a cosine tapered bandpass
+template<class T>
+void FrequencyDomainFilter<T>::initialize(const std::array<double, 4> &corners,
+                                          const int padLength)
+{
+    clear();
+    if (corners[0] < 0 || corners[3] > 1)
+    {
+        throw std::invalid_argument("Corners must be in range [0,1]");
+    }
+    if (corners[0] > corners[1] || corners[1] >= corners[2] ||
+        corners[2] > corners[3])
+    {
+        throw std::invalid_argument("Corners must satisfy c0 <= c1 < c2 <= c3");
+    }
+    pImpl->mCorners = corners;
+    pImpl->mGainType = GainType::TAPER;
+    pImpl->mPadLength = padLength;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool FrequencyDomainFilter<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Pad length
+template<class T>
+int FrequencyDomainFilter<T>::getPadLength(const int n) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->computePadLength(n);
+}
+
+/// Filter
+template<class T>
+void FrequencyDomainFilter<T>::apply(const int n, const T x[], T *yIn[])
+{
+    if (n <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    pImpl->apply(n, x, y);
+}
+
+/// Template instantiation
+template class RTSeis::FilterImplementations::FrequencyDomainFilter<double>;
+template class RTSeis::FilterImplementations::FrequencyDomainFilter<float>;
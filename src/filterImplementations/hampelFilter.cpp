@@ -0,0 +1,334 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/filterImplementations/hampelFilter.hpp"
+#include "private/orderStatisticTree.hpp"
+
+using namespace RTSeis::FilterImplementations;
+
+namespace
+{
+/// Scales the MAD to the standard deviation of a normal distribution
+constexpr double MAD_TO_SIGMA = 1.4826;
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class HampelFilter<E, T>::HampelFilterImpl
+{
+public:
+    /// Empties the window
+    void reset()
+    {
+        mTree.clear();
+        mTree.reserve(mWindowLength);
+        std::fill(mWindow.begin(), mWindow.end(), 0);
+        mHead = 0;
+        mCount = 0;
+    }
+    /// Adds a sample to the window and removes the oldest sample if the
+    /// window is full.  Only finite samples enter the tree since a NaN
+    /// cannot be ordered and so could never be found to be erased.
+    void push(const double value)
+    {
+        if (mCount == mWindowLength)
+        {
+            if (std::isfinite(mWindow[mHead])){mTree.erase(mWindow[mHead]);}
+            mWindow[mHead] = value;
+            mHead = (mHead + 1)%mWindowLength;
+        }
+        else
+        {
+            mWindow[(mHead + mCount)%mWindowLength] = value;
+            mCount = mCount + 1;
+        }
+        if (std::isfinite(value)){mTree.insert(value);}
+    }
+    /// The sample half a window behind the newest sample.  Before that many
+    /// samples have arrived this is zero.
+    [[nodiscard]] double delayed() const
+    {
+        auto lag = mCount - 1 - mHalfWindow;
+        if (lag < 0){return 0;}
+        return mWindow[(mHead + lag)%mWindowLength];
+    }
+    /// The median of the finite samples in the window.  For an even number
+    /// of samples this is the lower median.  If there are no finite samples
+    /// then this is zero.
+    [[nodiscard]] double windowMedian() const
+    {
+        if (mTree.size() < 1){return 0;}
+        return mTree.select((mTree.size() - 1)/2);
+    }
+    /// The median absolute deviation about the median of the m finite
+    /// samples in the window.  With c = (m - 1)/2 the deviations below the
+    /// median, A[i] = median - s[c - i] for i = 0, ..., c, and above the
+    /// median, B[j] = s[c + 1 + j] - median for j = 0, ..., m - c - 2, are
+    /// sorted so the MAD is the c'th smallest value of their merge.  This
+    /// binary searches for the number of values, a, taken from A.  For a
+    /// full window c is k/2.
+    [[nodiscard]] double mad(const double median) const
+    {
+        const int c = (mTree.size() - 1)/2;
+        const int nA = c + 1;
+        const int nB = mTree.size() - 1 - c;
+        auto A = [&](const int i){return median - mTree.select(c - i);};
+        auto B = [&](const int j){return mTree.select(c + 1 + j) - median;};
+        int lo = std::max(1, c + 1 - nB); // A[0] = 0 is among the smallest
+        int hi = nA;
+        while (true)
+        {
+            auto a = (lo + hi)/2;
+            auto b = c + 1 - a;
+            if (b < nB && A(a - 1) > B(b))
+            {
+                hi = a - 1;
+            }
+            else if (b > 0 && a < nA && B(b - 1) > A(a))
+            {
+                lo = a + 1;
+            }
+            else
+            {
+                auto result = A(a - 1);
+                if (b > 0){result = std::max(result, B(b - 1));}
+                return result;
+            }
+        }
+    }
+    /// Passes a sample whose window is incomplete through unless it is not
+    /// finite, in which case it is an outlier and is replaced by the median.
+    [[nodiscard]] double passThrough(const double value,
+                                     bool *isOutlier) const
+    {
+        *isOutlier = !std::isfinite(value);
+        if (*isOutlier){return windowMedian();}
+        return value;
+    }
+    /// Tests the center of the full window.  On exit, isOutlier indicates
+    /// whether the returned value is the median.  A sample that is not
+    /// finite is always an outlier.  The median and MAD are computed from
+    /// the window's finite samples.
+    [[nodiscard]] double evaluate(bool *isOutlier) const
+    {
+        auto center = delayed();
+        if (!std::isfinite(center)){return passThrough(center, isOutlier);}
+        auto median = windowMedian();
+        auto deviation = std::abs(center - median);
+        *isOutlier = false;
+        if (deviation == 0){return center;}
+        auto scale = MAD_TO_SIGMA*mad(median);
+        if (deviation > mThreshold*scale)
+        {
+            *isOutlier = true;
+            return median;
+        }
+        return center;
+    }
+    OrderStatisticTree mTree;
+    /// The window in a ring buffer.  mHead is the oldest sample.
+    std::vector<double> mWindow;
+    /// Indices of the replaced samples from the last call to apply
+    std::vector<int> mFlagged;
+    double mThreshold = 3;
+    int mWindowLength = 0;
+    int mHalfWindow = 0;
+    int mHead = 0;
+    int mCount = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+HampelFilter<E, T>::HampelFilter() :
+    pImpl(std::make_unique<HampelFilterImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+HampelFilter<E, T>::HampelFilter(const HampelFilter &hampel)
+{
+    *this = hampel;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+HampelFilter<E, T>::HampelFilter(HampelFilter &&hampel) noexcept
+{
+    *this = std::move(hampel);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+HampelFilter<E, T>& HampelFilter<E, T>::operator=(const HampelFilter &hampel)
+{
+    if (&hampel == this){return *this;}
+    pImpl = std::make_unique<HampelFilterImpl> (*hampel.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+HampelFilter<E, T>&
+HampelFilter<E, T>::operator=(HampelFilter &&hampel) noexcept
+{
+    if (&hampel == this){return *this;}
+    pImpl = std::move(hampel.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+HampelFilter<E, T>::~HampelFilter() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void HampelFilter<E, T>::clear() noexcept
+{
+    pImpl = std::make_unique<HampelFilterImpl> ();
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void HampelFilter<E, T>::initialize(const int windowLength,
+                                    const double threshold)
+{
+    clear();
+    if (windowLength < 3)
+    {
+        throw std::invalid_argument("windowLength = "
+                                  + std::to_string(windowLength)
+                                  + " must be at least 3");
+    }
+    if (threshold < 0)
+    {
+        throw std::invalid_argument("threshold = " + std::to_string(threshold)
+                                  + " must be non-negative");
+    }
+    auto n = windowLength;
+    if (n%2 == 0){n = n + 1;}
+    pImpl->mWindow.resize(n, 0);
+    pImpl->mThreshold = threshold;
+    pImpl->mWindowLength = n;
+    pImpl->mHalfWindow = n/2;
+    pImpl->reset();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool HampelFilter<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Window length
+template<RTSeis::ProcessingMode E, class T>
+int HampelFilter<E, T>::getWindowLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowLength;
+}
+
+/// Group delay
+template<RTSeis::ProcessingMode E, class T>
+int HampelFilter<E, T>::getGroupDelay() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if constexpr (E == RTSeis::ProcessingMode::POST){return 0;}
+    return pImpl->mHalfWindow;
+}
+
+/// Flagged samples
+template<RTSeis::ProcessingMode E, class T>
+std::vector<int> HampelFilter<E, T>::getFlaggedSamples() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mFlagged;
+}
+
+/// Reset
+template<RTSeis::ProcessingMode E, class T>
+void HampelFilter<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->reset();
+}
+
+/// Apply
+template<RTSeis::ProcessingMode E, class T>
+void HampelFilter<E, T>::apply(const int n, const T x[], T *yIn[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->mFlagged.clear();
+    if (n <= 0){return;} // Nothing to do
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    const int windowLength = pImpl->mWindowLength;
+    const int h = pImpl->mHalfWindow;
+    bool isOutlier;
+    if constexpr (E == RTSeis::ProcessingMode::POST)
+    {
+        // The edges pass through unless they are not finite, in which case
+        // they take the median of the first or last window
+        pImpl->reset();
+        std::copy(x, x + n, y);
+        for (int i = 0; i < n; ++i)
+        {
+            pImpl->push(static_cast<double> (x[i]));
+            if (pImpl->mCount < windowLength){continue;}
+            if (i == windowLength - 1)
+            {
+                for (int j = 0; j < h; ++j)
+                {
+                    y[j] = static_cast<T> (pImpl->passThrough(
+                               static_cast<double> (x[j]), &isOutlier));
+                    if (isOutlier){pImpl->mFlagged.push_back(j);}
+                }
+            }
+            auto j = i - h;
+            y[j] = static_cast<T> (pImpl->evaluate(&isOutlier));
+            if (isOutlier){pImpl->mFlagged.push_back(j);}
+        }
+        // If no window is full then every sample is an edge
+        for (int j = (n < windowLength ? 0 : n - h); j < n; ++j)
+        {
+            y[j] = static_cast<T> (pImpl->passThrough(
+                       static_cast<double> (x[j]), &isOutlier));
+            if (isOutlier){pImpl->mFlagged.push_back(j);}
+        }
+        pImpl->reset();
+    }
+    else
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            pImpl->push(static_cast<double> (x[i]));
+            if (pImpl->mCount < windowLength)
+            {
+                y[i] = static_cast<T> (pImpl->passThrough(pImpl->delayed(),
+                                                          &isOutlier));
+                if (isOutlier){pImpl->mFlagged.push_back(i);}
+                continue;
+            }
+            y[i] = static_cast<T> (pImpl->evaluate(&isOutlier));
+            if (isOutlier){pImpl->mFlagged.push_back(i);}
+        }
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::FilterImplementations::HampelFilter<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::FilterImplementations::HampelFilter<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::FilterImplementations::HampelFilter<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::FilterImplementations::HampelFilter<RTSeis::ProcessingMode::REAL_TIME, float>;
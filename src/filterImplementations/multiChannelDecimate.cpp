@@ -0,0 +1,438 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#ifndef NDEBUG
+#include <cassert>
+#endif
+#include "rtseis/enums.hpp"
+#include "rtseis/filterImplementations/multiChannelDecimate.hpp"
+#include "private/decimationFilter.hpp"
+
+using namespace RTSeis::FilterImplementations;
+
+template<RTSeis::ProcessingMode E, class T>
+class MultiChannelDecimate<E, T>::MultiChannelDecimateImpl
+{
+public:
+    /// The number of output samples for a packet of length n given the
+    /// index of the next retained sample
+    [[nodiscard]] int estimateSpace(const int n, const int phase) const
+    {
+        return std::max(0, (n + mDownFactor - 1 - phase)/mDownFactor);
+    }
+    /// The largest number of output samples of any channel
+    [[nodiscard]] int estimateSpace(const int n) const
+    {
+        if (mMode != RTSeis::ProcessingMode::REAL_TIME)
+        {
+            return estimateSpace(n, 0);
+        }
+        auto phase = *std::min_element(mPhase.begin(), mPhase.end());
+        return estimateSpace(n, phase);
+    }
+    /// Restores the delay lines and phases
+    void resetInitialConditions()
+    {
+        std::copy(mZi.begin(), mZi.end(), mDelayLine.begin());
+        std::fill(mPhase.begin(), mPhase.end(), 0);
+    }
+    /// Restores a channel's delay line and phase
+    void resetInitialConditions(const int channel)
+    {
+        const int nc = mChannels;
+        for (int i = 0; i < mFIRLength - 1; ++i)
+        {
+            auto k = static_cast<size_t> (i)*nc + channel;
+            mDelayLine[k] = mZi[k];
+        }
+        mPhase[channel] = 0;
+    }
+    /// Decimates a packet.  The workspace is time-major, i.e., W[t*C + c],
+    /// and holds [delay line, x, trailing zeros].  Output i of channel c is
+    ///   y[i] = sum_j b[order - j] W[(n0 + i*downFactor + j)*C + c]
+    /// where n0 is the channel's phase plus, when removing the phase shift,
+    /// the group delay.  The channels are grouped by their
+    /// phase so the inner loop runs over the channels of a group.  When
+    /// every channel shares a phase the group is contiguous.
+    void apply(const int nx, const T x[], const int ny, int nyDown[], T y[])
+    {
+        const int nc = mChannels;
+        const int order = mFIRLength - 1;
+        auto npad = mRemovePhaseShift ? mGroupDelay : 0;
+        auto nw = static_cast<size_t> (order + nx + npad);
+        mWork.resize(nw*nc);
+        std::copy(mDelayLine.begin(), mDelayLine.end(), mWork.begin());
+        T *w = mWork.data();
+        for (int c = 0; c < nc; ++c)
+        {
+            const T *xc = x + static_cast<size_t> (c)*nx;
+            T *wc = w + static_cast<size_t> (order)*nc + c;
+            for (int i = 0; i < nx; ++i){wc[static_cast<size_t> (i)*nc] = xc[i];}
+        }
+        std::fill(mWork.begin() + static_cast<size_t> (order + nx)*nc,
+                  mWork.end(), 0);
+        // Phase of each channel.  Removing the phase shift offsets every
+        // channel by the group delay.
+        int shift = 0;
+        if (mRemovePhaseShift)
+        {
+#ifndef NDEBUG
+            assert(mGroupDelay%mDownFactor == 0);
+#endif
+            shift = mGroupDelay;
+        }
+        mStart.resize(nc);
+        for (int c = 0; c < nc; ++c)
+        {
+            mStart[c] = (mMode == RTSeis::ProcessingMode::REAL_TIME) ?
+                        mPhase[c] : 0;
+        }
+        const int nOutMax = estimateSpace(nx,
+                                *std::min_element(mStart.begin(),
+                                                  mStart.end()));
+        mOut.resize(static_cast<size_t> (nOutMax)*nc);
+        const T *br = mReversedTaps.data();
+        // Accumulate each output instant across the channels of a group
+        mStartValues = mStart;
+        std::sort(mStartValues.begin(), mStartValues.end());
+        mStartValues.erase(std::unique(mStartValues.begin(),
+                                       mStartValues.end()),
+                           mStartValues.end());
+        for (const auto n0 : mStartValues)
+        {
+            mGroup.clear();
+            for (int c = 0; c < nc; ++c)
+            {
+                if (mStart[c] == n0){mGroup.push_back(c);}
+            }
+            const int nOut = estimateSpace(nx, n0);
+            const bool contiguous = (static_cast<int> (mGroup.size()) == nc);
+            const int *group = mGroup.data();
+            const int nGroup = static_cast<int> (mGroup.size());
+            for (int i = 0; i < nOut; ++i)
+            {
+                T *acc = mOut.data() + static_cast<size_t> (i)*nc;
+                const T *wi = w + static_cast<size_t> (shift + n0
+                                                     + i*mDownFactor)*nc;
+                if (contiguous)
+                {
+                    std::fill(acc, acc + nc, 0);
+                    for (int j = 0; j < mFIRLength; ++j)
+                    {
+                        const T bj = br[j];
+                        const T *wij = wi + static_cast<size_t> (j)*nc;
+                        #pragma omp simd
+                        for (int c = 0; c < nc; ++c)
+                        {
+                            acc[c] = acc[c] + bj*wij[c];
+                        }
+                    }
+                }
+                else
+                {
+                    for (int k = 0; k < nGroup; ++k){acc[group[k]] = 0;}
+                    for (int j = 0; j < mFIRLength; ++j)
+                    {
+                        const T bj = br[j];
+                        const T *wij = wi + static_cast<size_t> (j)*nc;
+                        #pragma omp simd
+                        for (int k = 0; k < nGroup; ++k)
+                        {
+                            acc[group[k]] = acc[group[k]] + bj*wij[group[k]];
+                        }
+                    }
+                }
+            }
+            for (int k = 0; k < nGroup; ++k){nyDown[group[k]] = nOut;}
+        }
+        // Transpose to channel-major output
+        for (int c = 0; c < nc; ++c)
+        {
+            T *yc = y + static_cast<size_t> (c)*ny;
+            for (int i = 0; i < nyDown[c]; ++i)
+            {
+                yc[i] = mOut[static_cast<size_t> (i)*nc + c];
+            }
+        }
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME && !mRemovePhaseShift)
+        {
+            // The delay lines are the contiguous rows [nx, nx + order)
+            for (int c = 0; c < nc; ++c)
+            {
+                mPhase[c] = mStart[c] + nyDown[c]*mDownFactor - nx;
+            }
+            std::copy(mWork.begin() + static_cast<size_t> (nx)*nc,
+                      mWork.begin() + static_cast<size_t> (nx + order)*nc,
+                      mDelayLine.begin());
+        }
+    }
+    /// The filter taps in reverse order
+    std::vector<T> mReversedTaps;
+    /// The time-major [order x nChannels] initial conditions
+    std::vector<T> mZi;
+    /// The time-major [order x nChannels] delay lines
+    std::vector<T> mDelayLine;
+    /// Workspace
+    std::vector<T> mWork;
+    /// Time-major decimated signals
+    std::vector<T> mOut;
+    /// Index of the next retained sample in the next packet of each channel
+    std::vector<int> mPhase;
+    /// The first retained sample of each channel in the workspace
+    std::vector<int> mStart;
+    /// The distinct values of mStart
+    std::vector<int> mStartValues;
+    /// The channels that share a phase
+    std::vector<int> mGroup;
+    int mChannels = 0;
+    int mDownFactor = 1;
+    int mGroupDelay = 0;
+    int mFIRLength = 0;
+    const RTSeis::ProcessingMode mMode = E;
+    bool mRemovePhaseShift = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelDecimate<E, T>::MultiChannelDecimate() :
+    pImpl(std::make_unique<MultiChannelDecimateImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelDecimate<E, T>::MultiChannelDecimate(
+    const MultiChannelDecimate &decimate)
+{
+    *this = decimate;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelDecimate<E, T>::MultiChannelDecimate(
+    MultiChannelDecimate &&decimate) noexcept
+{
+    *this = std::move(decimate);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelDecimate<E, T>&
+MultiChannelDecimate<E, T>::operator=(const MultiChannelDecimate &decimate)
+{
+    if (&decimate == this){return *this;}
+    pImpl = std::make_unique<MultiChannelDecimateImpl> (*decimate.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelDecimate<E, T>&
+MultiChannelDecimate<E, T>::operator=(MultiChannelDecimate &&decimate) noexcept
+{
+    if (&decimate == this){return *this;}
+    pImpl = std::move(decimate.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelDecimate<E, T>::~MultiChannelDecimate() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelDecimate<E, T>::clear() noexcept
+{
+    pImpl->mReversedTaps.clear();
+    pImpl->mZi.clear();
+    pImpl->mDelayLine.clear();
+    pImpl->mWork.clear();
+    pImpl->mOut.clear();
+    pImpl->mChannels = 0;
+    pImpl->mDownFactor = 1;
+    pImpl->mGroupDelay = 0;
+    pImpl->mFIRLength = 0;
+    pImpl->mPhase.clear();
+    pImpl->mStart.clear();
+    pImpl->mStartValues.clear();
+    pImpl->mGroup.clear();
+    pImpl->mRemovePhaseShift = false;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelDecimate<E, T>::initialize(const int nChannels,
+                                            const int downFactor,
+                                            const int filterLength,
+                                            const bool lRemovePhaseShift)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (downFactor < 2)
+    {
+        throw std::invalid_argument("Downsampling factor = "
+                                  + std::to_string(downFactor)
+                                  + " must be at least 2");
+    }
+    if (filterLength < 5)
+    {
+        throw std::invalid_argument("Filter length = "
+                                  + std::to_string(filterLength)
+                                  + " must be at least 5");
+    }
+    pImpl->mRemovePhaseShift
+        = (pImpl->mMode == RTSeis::ProcessingMode::POST_PROCESSING &&
+           lRemovePhaseShift);
+    auto b = designDecimationFilter(downFactor, filterLength,
+                                    pImpl->mRemovePhaseShift,
+                                    &pImpl->mGroupDelay);
+    pImpl->mFIRLength = static_cast<int> (b.size());
+    pImpl->mReversedTaps.resize(b.size());
+    std::reverse_copy(b.begin(), b.end(), pImpl->mReversedTaps.begin());
+    auto nz = static_cast<size_t> (nChannels)*(pImpl->mFIRLength - 1);
+    pImpl->mZi.assign(nz, 0);
+    pImpl->mDelayLine.assign(nz, 0);
+    pImpl->mChannels = nChannels;
+    pImpl->mDownFactor = downFactor;
+    pImpl->mPhase.assign(nChannels, 0);
+    pImpl->mGroup.reserve(nChannels);
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool MultiChannelDecimate<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelDecimate<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Downsampling factor
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelDecimate<E, T>::getDownsamplingFactor() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mDownFactor;
+}
+
+/// FIR filter length
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelDecimate<E, T>::getFIRFilterLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mFIRLength;
+}
+
+/// Initial condition length
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelDecimate<E, T>::getInitialConditionLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels*(pImpl->mFIRLength - 1);
+}
+
+/// Set initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelDecimate<E, T>::setInitialConditions(const int nz,
+                                                      const double zi[])
+{
+    auto nzRef = getInitialConditionLength(); // Throws
+    if (nz != nzRef)
+    {
+        throw std::invalid_argument("nz = " + std::to_string(nz)
+                                  + " must equal " + std::to_string(nzRef));
+    }
+    if (nz > 0 && zi == nullptr){throw std::invalid_argument("zi is NULL");}
+    // Interleave the channels
+    const int nc = pImpl->mChannels;
+    const int order = pImpl->mFIRLength - 1;
+    for (int c = 0; c < nc; ++c)
+    {
+        for (int i = 0; i < order; ++i)
+        {
+            pImpl->mZi[static_cast<size_t> (i)*nc + c]
+                = static_cast<T> (zi[static_cast<size_t> (c)*order + i]);
+        }
+    }
+    resetInitialConditions();
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelDecimate<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Reset a channel's initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelDecimate<E, T>::resetInitialConditions(const int channel)
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(pImpl->mChannels - 1)
+                                  + "]");
+    }
+    pImpl->resetInitialConditions(channel);
+}
+
+/// Estimate space
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelDecimate<E, T>::estimateSpace(const int n) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (n < 0){throw std::invalid_argument("n cannot be negative");}
+    return pImpl->estimateSpace(n);
+}
+
+/// Decimate
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelDecimate<E, T>::apply(const int nSamples, const T x[],
+                                       const int ny, int *nyDownIn[],
+                                       T *yIn[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    int *nyDown = *nyDownIn;
+    if (nyDown == nullptr){throw std::invalid_argument("nyDown is NULL");}
+    std::fill(nyDown, nyDown + pImpl->mChannels, 0);
+    if (nSamples <= 0){return;} // Nothing to do
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    auto nyRef = estimateSpace(nSamples);
+    if (ny < nyRef)
+    {
+        throw std::invalid_argument("ny = " + std::to_string(ny)
+                                  + " must be at least "
+                                  + std::to_string(nyRef));
+    }
+    T *y = *yIn;
+    if (y == nullptr){throw std::invalid_argument("y is NULL");}
+    pImpl->apply(nSamples, x, ny, nyDown, y);
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::FilterImplementations::MultiChannelDecimate<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::FilterImplementations::MultiChannelDecimate<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::FilterImplementations::MultiChannelDecimate<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::FilterImplementations::MultiChannelDecimate<RTSeis::ProcessingMode::REAL_TIME, float>;
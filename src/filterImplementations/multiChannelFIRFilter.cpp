@@ -0,0 +1,268 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <mkl.h>
+#include "rtseis/enums.hpp"
+#include "rtseis/filterImplementations/multiChannelFIRFilter.hpp"
+
+using namespace RTSeis::FilterImplementations;
+
+namespace
+{
+/// C = A B for row-major matrices
+void gemm(const int m, const int n, const int k,
+          const double A[], const int lda,
+          const double B[], const int ldb,
+          double C[], const int ldc)
+{
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                m, n, k, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+}
+
+void gemm(const int m, const int n, const int k,
+          const float A[], const int lda,
+          const float B[], const int ldb,
+          float C[], const int ldc)
+{
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                m, n, k, 1.0f, A, lda, B, ldb, 0.0f, C, ldc);
+}
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class MultiChannelFIRFilter<E, T>::MultiChannelFIRFilterImpl
+{
+public:
+    /// Filters a packet.  The workspace holds the [delay line, packet] of
+    /// each channel in a row.  For a block of L outputs starting at t0
+    ///   Y[:, t0:t0+L] = W[:, t0:t0+L+order] Toeplitz
+    /// where Toeplitz[i, t] = b[order - (i - t)] for 0 <= i - t <= order.
+    /// The Toeplitz matrix is the same for every block and the leading
+    /// (L' + order) x L' submatrix handles a short final block.
+    void apply(const int n, const T x[], T y[])
+    {
+        const int order = mTaps - 1;
+        const int ldw = order + n;
+        mWork.resize(static_cast<size_t> (mChannels)*ldw);
+        for (int c = 0; c < mChannels; ++c)
+        {
+            auto wRow = mWork.data() + static_cast<size_t> (c)*ldw;
+            auto dRow = mDelayLine.data() + static_cast<size_t> (c)*order;
+            std::copy(dRow, dRow + order, wRow);
+            std::copy(x + static_cast<size_t> (c)*n,
+                      x + static_cast<size_t> (c + 1)*n, wRow + order);
+        }
+        for (int t0 = 0; t0 < n; t0 = t0 + mBlockSize)
+        {
+            auto nOut = std::min(mBlockSize, n - t0);
+            gemm(mChannels, nOut, nOut + order,
+                 mWork.data() + t0, ldw,
+                 mToeplitz.data(), mBlockSize,
+                 y + t0, n);
+        }
+        // Carry the last order samples of each channel to the next packet
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME && order > 0)
+        {
+            for (int c = 0; c < mChannels; ++c)
+            {
+                auto wRow = mWork.data() + static_cast<size_t> (c)*ldw;
+                std::copy(wRow + n, wRow + n + order,
+                          mDelayLine.data() + static_cast<size_t> (c)*order);
+            }
+        }
+    }
+    /// The (blockSize + order) x blockSize Toeplitz matrix of filter taps
+    std::vector<T> mToeplitz;
+    /// The initial conditions
+    std::vector<T> mZi;
+    /// The [nChannels x order] delay lines
+    std::vector<T> mDelayLine;
+    /// Workspace
+    std::vector<T> mWork;
+    int mChannels = 0;
+    int mTaps = 0;
+    int mBlockSize = 0;
+    const RTSeis::ProcessingMode mMode = E;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelFIRFilter<E, T>::MultiChannelFIRFilter() :
+    pImpl(std::make_unique<MultiChannelFIRFilterImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelFIRFilter<E, T>::MultiChannelFIRFilter(
+    const MultiChannelFIRFilter &fir)
+{
+    *this = fir;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelFIRFilter<E, T>::MultiChannelFIRFilter(
+    MultiChannelFIRFilter &&fir) noexcept
+{
+    *this = std::move(fir);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelFIRFilter<E, T>&
+MultiChannelFIRFilter<E, T>::operator=(const MultiChannelFIRFilter &fir)
+{
+    if (&fir == this){return *this;}
+    pImpl = std::make_unique<MultiChannelFIRFilterImpl> (*fir.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelFIRFilter<E, T>&
+MultiChannelFIRFilter<E, T>::operator=(MultiChannelFIRFilter &&fir) noexcept
+{
+    if (&fir == this){return *this;}
+    pImpl = std::move(fir.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelFIRFilter<E, T>::~MultiChannelFIRFilter() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelFIRFilter<E, T>::clear() noexcept
+{
+    pImpl->mToeplitz.clear();
+    pImpl->mZi.clear();
+    pImpl->mDelayLine.clear();
+    pImpl->mWork.clear();
+    pImpl->mChannels = 0;
+    pImpl->mTaps = 0;
+    pImpl->mBlockSize = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelFIRFilter<E, T>::initialize(const int nChannels,
+                                             const int nb, const double b[],
+                                             const int blockSize)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (nb < 1 || b == nullptr)
+    {
+        if (nb < 1)
+        {
+            throw std::invalid_argument("nb = " + std::to_string(nb)
+                                      + " must be positive");
+        }
+        throw std::invalid_argument("b is NULL");
+    }
+    // A block comparable to the filter length keeps the extra work in the
+    // Toeplitz product's zero triangles to about a factor of two
+    int nBlock = blockSize;
+    if (nBlock < 1){nBlock = std::max(16, ((nb + 7)/8)*8);}
+    const int order = nb - 1;
+    pImpl->mToeplitz.assign(static_cast<size_t> (nBlock + order)*nBlock, 0);
+    for (int t = 0; t < nBlock; ++t)
+    {
+        for (int k = 0; k < nb; ++k)
+        {
+            // Row t + order - k multiplies x[t - k]
+            auto i = static_cast<size_t> (t + order - k);
+            pImpl->mToeplitz[i*nBlock + t] = static_cast<T> (b[k]);
+        }
+    }
+    pImpl->mZi.assign(static_cast<size_t> (nChannels)*order, 0);
+    pImpl->mDelayLine.assign(static_cast<size_t> (nChannels)*order, 0);
+    pImpl->mChannels = nChannels;
+    pImpl->mTaps = nb;
+    pImpl->mBlockSize = nBlock;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool MultiChannelFIRFilter<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelFIRFilter<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Initial condition length
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelFIRFilter<E, T>::getInitialConditionLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels*(pImpl->mTaps - 1);
+}
+
+/// Set initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelFIRFilter<E, T>::setInitialConditions(const int nz,
+                                                       const double zi[])
+{
+    auto nzRef = getInitialConditionLength(); // Throws
+    if (nz != nzRef)
+    {
+        throw std::invalid_argument("nz = " + std::to_string(nz)
+                                  + " must equal " + std::to_string(nzRef));
+    }
+    if (nz > 0 && zi == nullptr){throw std::invalid_argument("zi is NULL");}
+    std::copy(zi, zi + nz, pImpl->mZi.begin());
+    resetInitialConditions();
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelFIRFilter<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::copy(pImpl->mZi.begin(), pImpl->mZi.end(),
+              pImpl->mDelayLine.begin());
+}
+
+/// Filter
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelFIRFilter<E, T>::apply(const int nSamples, const T x[],
+                                        T *yIn[])
+{
+    if (nSamples <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    pImpl->apply(nSamples, x, y);
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::FilterImplementations::MultiChannelFIRFilter<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::FilterImplementations::MultiChannelFIRFilter<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::FilterImplementations::MultiChannelFIRFilter<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::FilterImplementations::MultiChannelFIRFilter<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -0,0 +1,235 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "rtseis/filterImplementations/parallelFIRFilter.hpp"
+#include "rtseis/filterImplementations/firFilter.hpp"
+#include "private/convolve.hpp"
+
+using namespace RTSeis::FilterImplementations;
+namespace Convolve = RTSeis::Utilities::Math::Convolve;
+
+template<class T>
+class ParallelFIRFilter<T>::ParallelFIRFilterImpl
+{
+public:
+    /// Computes samples [k0, k1) of the full convolution of x with the
+    /// filter taps.  x is implicitly zero beyond nx samples.  The output
+    /// index range is partitioned into blocks of mBlockSize samples
+    /// measured from k0 and the partition does not depend on the number
+    /// of threads.
+    void filter(const int nx, const T x[], const int k0, const int k1, T y[])
+    {
+        const int nOut = k1 - k0;
+        if (nOut < 1){return;}
+        const int nBlocks = (nOut + mBlockSize - 1)/mBlockSize;
+        const int halo = mTaps - 1;
+        int nThreads = mThreads;
+#ifdef _OPENMP
+        if (nThreads == 0){nThreads = omp_get_max_threads();}
+#endif
+        nThreads = std::max(1, std::min(nThreads, nBlocks));
+        bool lfail = false;
+        #pragma omp parallel num_threads(nThreads) \
+         shared(lfail, x, y) \
+         default(none) \
+         firstprivate(nx, k0, k1, nBlocks, halo)
+        {
+        // Each worker gets its own IPP state and workspace
+        auto firFilter = mFilter;
+        std::vector<T> xwork(mBlockSize + halo);
+        std::vector<T> ywork(mBlockSize + halo);
+        #pragma omp for schedule(static)
+        for (int iblock = 0; iblock < nBlocks; ++iblock)
+        {
+            auto i0 = k0 + iblock*mBlockSize;
+            auto i1 = std::min(k1, i0 + mBlockSize);
+            auto h0 = std::max(0, i0 - halo); // Start of halo
+            auto len = i1 - h0;
+            // Copy the input and zero-extend past the end of x
+            auto nCopy = std::max(0, std::min(i1, nx) - h0);
+            std::copy(x + h0, x + h0 + nCopy, xwork.data());
+            std::fill(xwork.data() + nCopy, xwork.data() + len, 0);
+            T *yptr = ywork.data();
+            try
+            {
+                firFilter.apply(len, xwork.data(), &yptr);
+            }
+            catch (const std::exception &e)
+            {
+                #pragma omp atomic write
+                lfail = true;
+                continue;
+            }
+            // Discard the halo
+            std::copy(ywork.data() + (i0 - h0), ywork.data() + len,
+                      y + (i0 - k0));
+        }
+        } // End parallel
+        if (lfail){throw std::runtime_error("Block filtering failed");}
+    }
+    FIRFilter<RTSeis::ProcessingMode::POST, T> mFilter;
+    int mTaps = 0;
+    int mBlockSize = 65536;
+    int mThreads = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+ParallelFIRFilter<T>::ParallelFIRFilter() :
+    pImpl(std::make_unique<ParallelFIRFilterImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+ParallelFIRFilter<T>::ParallelFIRFilter(const ParallelFIRFilter &fir)
+{
+    *this = fir;
+}
+
+/// Move c'tor
+template<class T>
+ParallelFIRFilter<T>::ParallelFIRFilter(ParallelFIRFilter &&fir) noexcept
+{
+    *this = std::move(fir);
+}
+
+/// Copy assignment
+template<class T>
+ParallelFIRFilter<T>&
+ParallelFIRFilter<T>::operator=(const ParallelFIRFilter &fir)
+{
+    if (&fir == this){return *this;}
+    pImpl = std::make_unique<ParallelFIRFilterImpl> (*fir.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+ParallelFIRFilter<T>&
+ParallelFIRFilter<T>::operator=(ParallelFIRFilter &&fir) noexcept
+{
+    if (&fir == this){return *this;}
+    pImpl = std::move(fir.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+ParallelFIRFilter<T>::~ParallelFIRFilter() = default;
+
+/// Clear
+template<class T>
+void ParallelFIRFilter<T>::clear() noexcept
+{
+    pImpl->mFilter.clear();
+    pImpl->mTaps = 0;
+    pImpl->mBlockSize = 65536;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<class T>
+void ParallelFIRFilter<T>::initialize(const int nb, const double b[],
+                                      const int blockSize,
+                                      const FIRImplementation implementation)
+{
+    clear();
+    if (blockSize < 1)
+    {
+        throw std::invalid_argument("blockSize = " + std::to_string(blockSize)
+                                  + " must be positive");
+    }
+    pImpl->mFilter.initialize(nb, b, implementation); // Throws
+    pImpl->mTaps = nb;
+    pImpl->mBlockSize = blockSize;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool ParallelFIRFilter<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Threads
+template<class T>
+void ParallelFIRFilter<T>::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 0)
+    {
+        throw std::invalid_argument("nThreads = " + std::to_string(nThreads)
+                                  + " cannot be negative");
+    }
+    pImpl->mThreads = nThreads;
+}
+
+template<class T>
+int ParallelFIRFilter<T>::getNumberOfThreads() const noexcept
+{
+    return pImpl->mThreads;
+}
+
+/// Block size
+template<class T>
+int ParallelFIRFilter<T>::getBlockSize() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mBlockSize;
+}
+
+/// Filter
+template<class T>
+void ParallelFIRFilter<T>::apply(const int n, const T x[], T *yIn[])
+{
+    if (n <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    pImpl->filter(n, x, 0, n, y);
+}
+
+/// Convolve
+template<class T>
+void ParallelFIRFilter<T>::convolve(const int n, const T x[],
+                                    const int maxy, int *ny, T *yIn[],
+                                    const Convolve::Mode mode)
+{
+    *ny = 0;
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (n < 1){throw std::invalid_argument("No points in x");}
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    auto indexes = computeTrimIndices(mode, n, pImpl->mTaps);
+    auto len = indexes.second - indexes.first;
+    if (maxy < len)
+    {
+        throw std::invalid_argument("maxy = " + std::to_string(maxy)
+                                  + " must be at least "
+                                  + std::to_string(len));
+    }
+    pImpl->filter(n, x, indexes.first, indexes.second, y);
+    *ny = len;
+}
+
+/// Template instantiation
+template class RTSeis::FilterImplementations::ParallelFIRFilter<double>;
+template class RTSeis::FilterImplementations::ParallelFIRFilter<float>;
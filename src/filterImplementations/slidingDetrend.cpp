@@ -0,0 +1,266 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/filterImplementations/slidingDetrend.hpp"
+
+using namespace RTSeis::FilterImplementations;
+
+template<class T>
+class SlidingDetrend<T>::SlidingDetrendImpl
+{
+public:
+    /// Empties the windows
+    void resetInitialConditions()
+    {
+        std::fill(mWindow.begin(), mWindow.end(), 0);
+        std::fill(mSum.begin(), mSum.end(), 0);
+        std::fill(mWeightedSum.begin(), mWeightedSum.end(), 0);
+        std::fill(mOffset.begin(), mOffset.end(), 0);
+        std::fill(mCount.begin(), mCount.end(), 0);
+        std::fill(mWriteIndex.begin(), mWriteIndex.end(), 0);
+        std::fill(mSinceRecenter.begin(), mSinceRecenter.end(), 0);
+    }
+    /// Recomputes the sums of channel c from its window after shifting the
+    /// offset to the window's mean
+    void recenter(const int c)
+    {
+        const double *window = mWindow.data()
+                             + static_cast<size_t> (c)*mWindowLength;
+        const int m = mCount[c];
+        const int oldest = (m < mWindowLength) ? 0 : mWriteIndex[c];
+        double mean = 0;
+        for (int k = 0; k < m; ++k){mean = mean + window[k];}
+        mean = mean/static_cast<double> (m);
+        double s1 = 0;
+        double s2 = 0;
+        for (int k = 0; k < m; ++k)
+        {
+            auto v = window[(oldest + k)%mWindowLength] - mean;
+            s1 = s1 + v;
+            s2 = s2 + static_cast<double> (k)*v;
+        }
+        mOffset[c] = mean;
+        mSum[c] = s1;
+        mWeightedSum[c] = s2;
+        mSinceRecenter[c] = 0;
+    }
+    /// Adds a sample to channel c's window and returns the detrended sample
+    [[nodiscard]] double update(const int c, const double x)
+    {
+        double *window = mWindow.data() + static_cast<size_t> (c)*mWindowLength;
+        if (mCount[c] == 0){mOffset[c] = x;}
+        auto v = x - mOffset[c];
+        const int m = mCount[c];
+        if (m < mWindowLength)
+        {
+            // Growing: the new sample has local time m
+            mWeightedSum[c] = mWeightedSum[c] + static_cast<double> (m)*v;
+            mSum[c] = mSum[c] + v;
+            mCount[c] = m + 1;
+        }
+        else
+        {
+            // Sliding: drop the oldest sample and shift the local times down
+            // by one so sum t x loses sum x of the retained samples
+            auto old = window[mWriteIndex[c]] - mOffset[c];
+            auto retained = mSum[c] - old;
+            mWeightedSum[c] = mWeightedSum[c] - retained
+                            + static_cast<double> (mWindowLength - 1)*v;
+            mSum[c] = retained + v;
+        }
+        window[mWriteIndex[c]] = x;
+        mWriteIndex[c] = (mWriteIndex[c] + 1)%mWindowLength;
+        mSinceRecenter[c] = mSinceRecenter[c] + 1;
+        if (mSinceRecenter[c] >= mWindowLength)
+        {
+            recenter(c);
+            v = x - mOffset[c];
+        }
+        // Remove the mean or evaluate the line at the newest sample
+        const auto dm = static_cast<double> (mCount[c]);
+        auto meanV = mSum[c]/dm;
+        if (mType == DetrendType::CONSTANT || mCount[c] < 2)
+        {
+            return v - meanV;
+        }
+        auto meanT = 0.5*(dm - 1);
+        auto varT = (dm*dm - 1)/12;
+        auto covTV = mWeightedSum[c]/dm - meanT*meanV;
+        auto slope = covTV/varT;
+        return v - (meanV + slope*meanT);
+    }
+    /// The [nChannels x windowLength] circular buffers
+    std::vector<double> mWindow;
+    /// Sum of (x - offset) over each window
+    std::vector<double> mSum;
+    /// Sum of t*(x - offset) over each window where t = 0 is the oldest sample
+    std::vector<double> mWeightedSum;
+    /// The offset removed from each channel prior to summing
+    std::vector<double> mOffset;
+    /// Number of samples in each window
+    std::vector<int> mCount;
+    /// Position of the next sample in each circular buffer
+    std::vector<int> mWriteIndex;
+    /// Samples since the sums were last recomputed
+    std::vector<int> mSinceRecenter;
+    DetrendType mType = DetrendType::LINEAR;
+    int mWindowLength = 0;
+    int mChannels = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+SlidingDetrend<T>::SlidingDetrend() :
+    pImpl(std::make_unique<SlidingDetrendImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+SlidingDetrend<T>::SlidingDetrend(const SlidingDetrend &detrend)
+{
+    *this = detrend;
+}
+
+/// Move c'tor
+template<class T>
+SlidingDetrend<T>::SlidingDetrend(SlidingDetrend &&detrend) noexcept
+{
+    *this = std::move(detrend);
+}
+
+/// Copy assignment
+template<class T>
+SlidingDetrend<T>& SlidingDetrend<T>::operator=(const SlidingDetrend &detrend)
+{
+    if (&detrend == this){return *this;}
+    pImpl = std::make_unique<SlidingDetrendImpl> (*detrend.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+SlidingDetrend<T>&
+SlidingDetrend<T>::operator=(SlidingDetrend &&detrend) noexcept
+{
+    if (&detrend == this){return *this;}
+    pImpl = std::move(detrend.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+SlidingDetrend<T>::~SlidingDetrend() = default;
+
+/// Clear
+template<class T>
+void SlidingDetrend<T>::clear() noexcept
+{
+    pImpl->mWindow.clear();
+    pImpl->mSum.clear();
+    pImpl->mWeightedSum.clear();
+    pImpl->mOffset.clear();
+    pImpl->mCount.clear();
+    pImpl->mWriteIndex.clear();
+    pImpl->mSinceRecenter.clear();
+    pImpl->mType = DetrendType::LINEAR;
+    pImpl->mWindowLength = 0;
+    pImpl->mChannels = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<class T>
+void SlidingDetrend<T>::initialize(const int windowLength,
+                                   const DetrendType type,
+                                   const int nChannels)
+{
+    clear();
+    if (windowLength < 1)
+    {
+        throw std::invalid_argument("windowLength = "
+                                  + std::to_string(windowLength)
+                                  + " must be positive");
+    }
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    pImpl->mWindow.resize(static_cast<size_t> (nChannels)*windowLength);
+    pImpl->mSum.resize(nChannels);
+    pImpl->mWeightedSum.resize(nChannels);
+    pImpl->mOffset.resize(nChannels);
+    pImpl->mCount.resize(nChannels);
+    pImpl->mWriteIndex.resize(nChannels);
+    pImpl->mSinceRecenter.resize(nChannels);
+    pImpl->mType = type;
+    pImpl->mWindowLength = windowLength;
+    pImpl->mChannels = nChannels;
+    pImpl->resetInitialConditions();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool SlidingDetrend<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Window length
+template<class T>
+int SlidingDetrend<T>::getWindowLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowLength;
+}
+
+/// Number of channels
+template<class T>
+int SlidingDetrend<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Reset
+template<class T>
+void SlidingDetrend<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Apply
+template<class T>
+void SlidingDetrend<T>::apply(const int nSamples, const T x[], T *yIn[])
+{
+    if (nSamples <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    for (int c = 0; c < pImpl->mChannels; ++c)
+    {
+        auto offset = static_cast<size_t> (c)*nSamples;
+        for (int i = 0; i < nSamples; ++i)
+        {
+            y[offset + i] = static_cast<T>
+                (pImpl->update(c, static_cast<double> (x[offset + i])));
+        }
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                        Template instantiation                            ///
+///--------------------------------------------------------------------------///
+template class RTSeis::FilterImplementations::SlidingDetrend<double>;
+template class RTSeis::FilterImplementations::SlidingDetrend<float>;
@@ -66,7 +66,7 @@ public:
         if (dlyDst64f_ != nullptr){ippsFree(dlyDst64f_);}
         if (pTaps32f_ != nullptr){ippsFree(pTaps32f_);}
         if (dlySrc32f_ != nullptr){ippsFree(dlySrc32f_);}
-        if (dlyDst32f_ != nullptr){ippsFree(dlyDst64f_);}
+        if (dlyDst32f_ != nullptr){ippsFree(dlyDst32f_);}
         if (pBuf_ != nullptr){ippsFree(pBuf_);}
         if (bsRef_ != nullptr){ippsFree(bsRef_);}
         if (asRef_ != nullptr){ippsFree(asRef_);} 
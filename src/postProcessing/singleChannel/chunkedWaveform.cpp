@@ -0,0 +1,596 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "rtseis/enums.hpp"
+#include "rtseis/postProcessing/singleChannel/chunkedWaveform.hpp"
+#include "rtseis/filterRepresentations/fir.hpp"
+#include "rtseis/filterRepresentations/sos.hpp"
+#include "rtseis/filterImplementations/firFilter.hpp"
+#include "rtseis/filterImplementations/sosFilter.hpp"
+#include "rtseis/filterImplementations/downsample.hpp"
+#include "rtseis/filterImplementations/decimate.hpp"
+#include "private/decimationFilter.hpp"
+#include "private/impulseResponse.hpp"
+
+using namespace RTSeis::PostProcessing::SingleChannel;
+namespace FI = RTSeis::FilterImplementations;
+
+namespace
+{
+
+/// A link in the processing chain.  Each operation consumes a block,
+/// appends whatever output is ready to y, and retains its own state.
+template<class T>
+class Operation
+{
+public:
+    virtual ~Operation() = default;
+    /// Deep copy
+    [[nodiscard]] virtual std::unique_ptr<Operation> clone() const = 0;
+    /// Resets the states prior to processing a new trace
+    virtual void reset() = 0;
+    /// Processes the next n samples
+    virtual void push(int n, const T x[], std::vector<T> &y) = 0;
+    /// Emits the samples still buffered at the end of the trace
+    virtual void flush(std::vector<T> &y) = 0;
+    /// The number of samples buffered by the operation
+    [[nodiscard]] virtual size_t getBufferSize() const noexcept{return 0;}
+};
+
+/// Appends the filtered signal to the output
+template<class T, class F>
+void appendFiltered(F &filter, const int n, const T x[], std::vector<T> &y)
+{
+    if (n < 1){return;}
+    auto i0 = y.size();
+    y.resize(i0 + n);
+    T *yptr = y.data() + i0;
+    filter.apply(n, x, &yptr);
+}
+
+/// Causal filtering with the state carried between blocks
+template<class T, class F>
+class CausalFilter : public Operation<T>
+{
+public:
+    explicit CausalFilter(const F &filter) :
+        mFilter(filter)
+    {
+    }
+    std::unique_ptr<Operation<T>> clone() const override
+    {
+        return std::make_unique<CausalFilter> (*this);
+    }
+    void reset() override
+    {
+        mFilter.resetInitialConditions();
+    }
+    void push(const int n, const T x[], std::vector<T> &y) override
+    {
+        appendFiltered(mFilter, n, x, y);
+    }
+    void flush(std::vector<T> &) override
+    {
+    }
+private:
+    F mFilter;
+};
+
+/// Zero-phase filtering.  The forward pass carries its state between blocks.
+/// The backward pass over a block starts mMargin samples in the future so
+/// that the start-up transient of the reversed filter has decayed by the
+/// time the block is reached.  The backward pass is run once at least
+/// mMargin samples can be released so that its cost, which is proportional
+/// to the margin plus the released samples, is amortized even for small
+/// blocks.
+template<class T, class FRT, class FPost>
+class ZeroPhaseFilter : public Operation<T>
+{
+public:
+    ZeroPhaseFilter(const FRT &forward, const FPost &backward,
+                    const int margin) :
+        mForward(forward),
+        mBackward(backward),
+        mMargin(margin)
+    {
+    }
+    std::unique_ptr<Operation<T>> clone() const override
+    {
+        return std::make_unique<ZeroPhaseFilter> (*this);
+    }
+    void reset() override
+    {
+        mForward.resetInitialConditions();
+        mPending.clear();
+    }
+    void push(const int n, const T x[], std::vector<T> &y) override
+    {
+        appendFiltered(mForward, n, x, mPending);
+        auto nPending = static_cast<int> (mPending.size());
+        if (nPending - mMargin < std::max(1, mMargin)){return;}
+        emit(nPending - mMargin, y);
+    }
+    void flush(std::vector<T> &y) override
+    {
+        emit(static_cast<int> (mPending.size()), y);
+    }
+    size_t getBufferSize() const noexcept override
+    {
+        return mPending.capacity();
+    }
+private:
+    /// Runs the backwards pass over all pending samples and releases the
+    /// first nEmit of them.
+    void emit(const int nEmit, std::vector<T> &y)
+    {
+        if (nEmit < 1){return;}
+        auto nPending = static_cast<int> (mPending.size());
+        mReversed.resize(nPending);
+        std::reverse_copy(mPending.begin(), mPending.end(),
+                          mReversed.begin());
+        mWork.resize(nPending);
+        T *work = mWork.data();
+        mBackward.resetInitialConditions();
+        mBackward.apply(nPending, mReversed.data(), &work);
+        // The first nEmit samples are at the end of the reversed output
+        auto i0 = y.size();
+        y.resize(i0 + nEmit);
+        std::reverse_copy(mWork.end() - nEmit, mWork.end(), y.begin() + i0);
+        mPending.erase(mPending.begin(), mPending.begin() + nEmit);
+    }
+    FRT mForward;
+    FPost mBackward;
+    std::vector<T> mPending;
+    std::vector<T> mReversed;
+    std::vector<T> mWork;
+    int mMargin = 0;
+};
+
+/// Decimation with the group delay removed.  The real-time decimator only
+/// evaluates the anti-alias filter at the retained samples.  Since the group
+/// delay is a multiple of the downsampling factor the first
+/// mGroupDelay/nq outputs are discarded and the end of the trace is padded
+/// with mGroupDelay zeros.  This is the decimator's post-processing strategy
+/// applied block by block.
+template<class T>
+class DelayCompensatedDecimator : public Operation<T>
+{
+public:
+    DelayCompensatedDecimator(
+        const FI::Decimate<RTSeis::ProcessingMode::REAL_TIME, T> &decimator,
+        const int groupDelay, const int nq) :
+        mDecimator(decimator),
+        mGroupDelay(groupDelay),
+        mSkipOutputs(groupDelay/nq)
+    {
+        mSkip = mSkipOutputs;
+    }
+    std::unique_ptr<Operation<T>> clone() const override
+    {
+        return std::make_unique<DelayCompensatedDecimator> (*this);
+    }
+    void reset() override
+    {
+        mDecimator.resetInitialConditions();
+        mSkip = mSkipOutputs;
+    }
+    void push(const int n, const T x[], std::vector<T> &y) override
+    {
+        if (n < 1){return;}
+        auto ny = mDecimator.estimateSpace(n);
+        auto i0 = y.size();
+        y.resize(i0 + ny);
+        T *yptr = y.data() + i0;
+        int nyDown = 0;
+        mDecimator.apply(n, x, ny, &nyDown, &yptr);
+        y.resize(i0 + nyDown);
+        auto nSkip = std::min(mSkip, nyDown);
+        if (nSkip > 0)
+        {
+            y.erase(y.begin() + i0, y.begin() + i0 + nSkip);
+            mSkip = mSkip - nSkip;
+        }
+    }
+    void flush(std::vector<T> &y) override
+    {
+        std::vector<T> zeros(mGroupDelay, 0);
+        push(mGroupDelay, zeros.data(), y);
+    }
+private:
+    FI::Decimate<RTSeis::ProcessingMode::REAL_TIME, T> mDecimator;
+    int mGroupDelay = 0;
+    int mSkipOutputs = 0;
+    int mSkip = 0;
+};
+
+/// Downsampling with the phase carried between blocks
+template<class T>
+class Downsampler : public Operation<T>
+{
+public:
+    explicit Downsampler(
+        const FI::Downsample<RTSeis::ProcessingMode::REAL_TIME, T> &down) :
+        mDownsampler(down)
+    {
+    }
+    std::unique_ptr<Operation<T>> clone() const override
+    {
+        return std::make_unique<Downsampler> (*this);
+    }
+    void reset() override
+    {
+        mDownsampler.resetInitialConditions();
+    }
+    void push(const int n, const T x[], std::vector<T> &y) override
+    {
+        if (n < 1){return;}
+        auto ny = mDownsampler.estimateSpace(n);
+        auto i0 = y.size();
+        y.resize(i0 + ny);
+        T *yptr = y.data() + i0;
+        int nyDown = 0;
+        mDownsampler.apply(n, x, ny, &nyDown, &yptr);
+        y.resize(i0 + nyDown);
+    }
+    void flush(std::vector<T> &) override
+    {
+    }
+private:
+    FI::Downsample<RTSeis::ProcessingMode::REAL_TIME, T> mDownsampler;
+};
+
+/// Initializes an SOS filter implementation from its representation
+template<class F>
+void initializeSOS(const RTSeis::FilterRepresentations::SOS &sos, F &filter)
+{
+    auto ns = sos.getNumberOfSections();
+    auto bs = sos.getNumeratorCoefficients();
+    auto as = sos.getDenominatorCoefficients();
+    filter.initialize(ns, bs.data(), as.data());
+}
+
+}
+
+template<class T>
+class ChunkedWaveform<T>::ChunkedWaveformImpl
+{
+public:
+    ChunkedWaveformImpl() = default;
+    /// Copy c'tor
+    ChunkedWaveformImpl(const ChunkedWaveformImpl &impl)
+    {
+        *this = impl;
+    }
+    /// Deep copy of the operations
+    ChunkedWaveformImpl& operator=(const ChunkedWaveformImpl &impl)
+    {
+        if (&impl == this){return *this;}
+        mOperations.clear();
+        mOperations.reserve(impl.mOperations.size());
+        for (const auto &op : impl.mOperations)
+        {
+            mOperations.push_back(op->clone());
+        }
+        mOutputSamples = impl.mOutputSamples;
+        mPeakBuffer = impl.mPeakBuffer;
+        mBlockSize = impl.mBlockSize;
+        mZeroPhaseMargin = impl.mZeroPhaseMargin;
+        return *this;
+    }
+    /// Pushes a block through the operations starting at iop
+    void push(const size_t iop, std::vector<T> &x, const Sink &sink)
+    {
+        for (auto i = iop; i < mOperations.size(); ++i)
+        {
+            mWork.clear();
+            mOperations[i]->push(static_cast<int> (x.size()), x.data(),
+                                 mWork);
+            std::swap(x, mWork);
+            if (x.empty()){break;}
+        }
+        updatePeakBuffer(x.capacity());
+        if (!x.empty())
+        {
+            sink(static_cast<int> (x.size()), x.data());
+            mOutputSamples = mOutputSamples + x.size();
+        }
+    }
+    /// Drains the operations at the end of the trace
+    void flush(const Sink &sink)
+    {
+        for (size_t i = 0; i < mOperations.size(); ++i)
+        {
+            std::vector<T> tail;
+            mOperations[i]->flush(tail);
+            if (!tail.empty()){push(i + 1, tail, sink);}
+        }
+    }
+    /// Tracks the high water mark of the buffers
+    void updatePeakBuffer(const size_t n) noexcept
+    {
+        mPeakBuffer = std::max(mPeakBuffer, n);
+        for (const auto &op : mOperations)
+        {
+            mPeakBuffer = std::max(mPeakBuffer, op->getBufferSize());
+        }
+    }
+    std::vector<std::unique_ptr<Operation<T>>> mOperations;
+    std::vector<T> mWork;
+    size_t mOutputSamples = 0;
+    size_t mPeakBuffer = 0;
+    int mBlockSize = 65536;
+    int mZeroPhaseMargin = 0;
+};
+
+/// C'tor
+template<class T>
+ChunkedWaveform<T>::ChunkedWaveform() :
+    pImpl(std::make_unique<ChunkedWaveformImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+ChunkedWaveform<T>::ChunkedWaveform(const ChunkedWaveform &waveform)
+{
+    *this = waveform;
+}
+
+/// Move c'tor
+template<class T>
+ChunkedWaveform<T>::ChunkedWaveform(ChunkedWaveform &&waveform) noexcept
+{
+    *this = std::move(waveform);
+}
+
+/// Copy assignment
+template<class T>
+ChunkedWaveform<T>&
+ChunkedWaveform<T>::operator=(const ChunkedWaveform &waveform)
+{
+    if (&waveform == this){return *this;}
+    pImpl = std::make_unique<ChunkedWaveformImpl> (*waveform.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+ChunkedWaveform<T>&
+ChunkedWaveform<T>::operator=(ChunkedWaveform &&waveform) noexcept
+{
+    if (&waveform == this){return *this;}
+    pImpl = std::move(waveform.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+ChunkedWaveform<T>::~ChunkedWaveform() = default;
+
+/// Clear
+template<class T>
+void ChunkedWaveform<T>::clear() noexcept
+{
+    pImpl->mOperations.clear();
+    pImpl->mWork.clear();
+    pImpl->mOutputSamples = 0;
+    pImpl->mPeakBuffer = 0;
+    pImpl->mBlockSize = 65536;
+    pImpl->mZeroPhaseMargin = 0;
+}
+
+/// Block size
+template<class T>
+void ChunkedWaveform<T>::setBlockSize(const int blockSize)
+{
+    if (blockSize < 1)
+    {
+        throw std::invalid_argument("blockSize = " + std::to_string(blockSize)
+                                  + " must be positive");
+    }
+    pImpl->mBlockSize = blockSize;
+}
+
+template<class T>
+int ChunkedWaveform<T>::getBlockSize() const noexcept
+{
+    return pImpl->mBlockSize;
+}
+
+/// Zero phase margin
+template<class T>
+void ChunkedWaveform<T>::setZeroPhaseMargin(const int margin)
+{
+    if (margin < 0)
+    {
+        throw std::invalid_argument("margin = " + std::to_string(margin)
+                                  + " cannot be negative");
+    }
+    pImpl->mZeroPhaseMargin = margin;
+}
+
+/// FIR filter
+template<class T>
+void ChunkedWaveform<T>::firFilter(
+    const RTSeis::FilterRepresentations::FIR &fir,
+    const bool lremovePhase)
+{
+    auto taps = fir.getFilterTaps();
+    auto nb = static_cast<int> (taps.size());
+    if (nb < 1){throw std::invalid_argument("No filter taps");}
+    FI::FIRFilter<RTSeis::ProcessingMode::REAL_TIME, T> forward;
+    forward.initialize(nb, taps.data(), FI::FIRImplementation::DIRECT);
+    if (!lremovePhase)
+    {
+        using Filter = FI::FIRFilter<RTSeis::ProcessingMode::REAL_TIME, T>;
+        pImpl->mOperations.push_back(
+            std::make_unique<CausalFilter<T, Filter>> (forward));
+    }
+    else
+    {
+        FI::FIRFilter<RTSeis::ProcessingMode::POST, T> backward;
+        backward.initialize(nb, taps.data(), FI::FIRImplementation::DIRECT);
+        // The backwards pass only sees nb - 1 samples into the future so
+        // this margin is exact.
+        int margin = std::max(nb - 1, pImpl->mZeroPhaseMargin);
+        pImpl->mOperations.push_back(
+            std::make_unique<ZeroPhaseFilter<T,
+                FI::FIRFilter<RTSeis::ProcessingMode::REAL_TIME, T>,
+                FI::FIRFilter<RTSeis::ProcessingMode::POST, T>>>
+                (forward, backward, margin));
+    }
+}
+
+/// SOS filter
+template<class T>
+void ChunkedWaveform<T>::sosFilter(
+    const RTSeis::FilterRepresentations::SOS &sos,
+    const bool lzeroPhase)
+{
+    if (sos.getNumberOfSections() < 1)
+    {
+        throw std::invalid_argument("No sections in sos");
+    }
+    FI::SOSFilter<RTSeis::ProcessingMode::REAL_TIME, T> forward;
+    initializeSOS(sos, forward);
+    if (!lzeroPhase)
+    {
+        using Filter = FI::SOSFilter<RTSeis::ProcessingMode::REAL_TIME, T>;
+        pImpl->mOperations.push_back(
+            std::make_unique<CausalFilter<T, Filter>> (forward));
+    }
+    else
+    {
+        FI::SOSFilter<RTSeis::ProcessingMode::POST, T> backward;
+        initializeSOS(sos, backward);
+        int margin = pImpl->mZeroPhaseMargin;
+        if (margin == 0){margin = estimateImpulseResponseLength(sos);}
+        pImpl->mOperations.push_back(
+            std::make_unique<ZeroPhaseFilter<T,
+                FI::SOSFilter<RTSeis::ProcessingMode::REAL_TIME, T>,
+                FI::SOSFilter<RTSeis::ProcessingMode::POST, T>>>
+                (forward, backward, margin));
+    }
+}
+
+/// Downsample
+template<class T>
+void ChunkedWaveform<T>::downsample(const int nq)
+{
+    if (nq < 1)
+    {
+        throw std::invalid_argument("Downsampling factor = "
+                                  + std::to_string(nq)
+                                  + " must be at least 1");
+    }
+    FI::Downsample<RTSeis::ProcessingMode::REAL_TIME, T> down;
+    down.initialize(nq);
+    pImpl->mOperations.push_back(std::make_unique<Downsampler<T>> (down));
+}
+
+/// Decimate
+template<class T>
+void ChunkedWaveform<T>::decimate(const int nq, const int filterLength)
+{
+    if (nq < 2)
+    {
+        throw std::invalid_argument("Downsampling factor = "
+                                  + std::to_string(nq)
+                                  + " must be at least 2");
+    }
+    if (filterLength < 5)
+    {
+        throw std::invalid_argument("filterLength = "
+                                  + std::to_string(filterLength)
+                                  + " must be at least 5");
+    }
+    // Mimic the post-processing decimator: the filter is odd length and its
+    // group delay is evenly divisible by the downsampling factor.  The
+    // real-time decimator designs the same filter from the padded length.
+    int groupDelay = 0;
+    auto taps = designDecimationFilter(nq, filterLength, true, &groupDelay);
+    FI::Decimate<RTSeis::ProcessingMode::REAL_TIME, T> decimator;
+    decimator.initialize(nq, static_cast<int> (taps.size()), false);
+    pImpl->mOperations.push_back(
+        std::make_unique<DelayCompensatedDecimator<T>>
+            (decimator, groupDelay, nq));
+}
+
+/// Number of operations
+template<class T>
+int ChunkedWaveform<T>::getNumberOfOperations() const noexcept
+{
+    return static_cast<int> (pImpl->mOperations.size());
+}
+
+/// Process from a source
+template<class T>
+void ChunkedWaveform<T>::process(const Source &source, const Sink &sink)
+{
+    if (!source){throw std::invalid_argument("source is not callable");}
+    if (!sink){throw std::invalid_argument("sink is not callable");}
+    if (pImpl->mOperations.empty())
+    {
+        throw std::runtime_error("No operations set");
+    }
+    pImpl->mOutputSamples = 0;
+    pImpl->mPeakBuffer = 0;
+    for (auto &op : pImpl->mOperations){op->reset();}
+    auto blockSize = pImpl->mBlockSize;
+    std::vector<T> block;
+    while (true)
+    {
+        block.resize(blockSize);
+        auto nread = source(blockSize, block.data());
+        if (nread < 1){break;}
+        if (nread > blockSize)
+        {
+            throw std::runtime_error("source read " + std::to_string(nread)
+                                   + " samples but block size is "
+                                   + std::to_string(blockSize));
+        }
+        block.resize(nread);
+        pImpl->push(0, block, sink);
+    }
+    pImpl->flush(sink);
+}
+
+/// Process from memory
+template<class T>
+void ChunkedWaveform<T>::process(const size_t n, const T x[],
+                                 const Sink &sink)
+{
+    if (n > 0 && x == nullptr){throw std::invalid_argument("x is NULL");}
+    size_t i0 = 0;
+    auto source = [&](const int maxSamples, T xblock[]) -> int
+    {
+        auto nread = std::min(n - i0, static_cast<size_t> (maxSamples));
+        std::copy(x + i0, x + i0 + nread, xblock);
+        i0 = i0 + nread;
+        return static_cast<int> (nread);
+    };
+    process(source, sink);
+}
+
+/// Number of output samples
+template<class T>
+size_t ChunkedWaveform<T>::getNumberOfOutputSamples() const noexcept
+{
+    return pImpl->mOutputSamples;
+}
+
+/// Peak buffer size
+template<class T>
+size_t ChunkedWaveform<T>::getPeakBufferSize() const noexcept
+{
+    return pImpl->mPeakBuffer;
+}
+
+/// Template instantiation
+template class RTSeis::PostProcessing::SingleChannel::ChunkedWaveform<double>;
+template class RTSeis::PostProcessing::SingleChannel::ChunkedWaveform<float>;
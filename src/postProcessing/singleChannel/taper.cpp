@@ -32,8 +32,7 @@ class Taper<T>::TaperImpl
 {
 public:
     TaperParameters parms; 
-    std::vector<double> w8;
-    std::vector<float>  w4;
+    std::shared_ptr<const std::vector<T>> window;
     int winLen0 =-1;
     bool linit = true;
 };
@@ -115,6 +114,25 @@ bool TaperParameters::isValid(void) const
 //                                    Tapering                                //
 //============================================================================//
 
+namespace
+{
+/// Maps the taper type to the window in the window cache
+RTSeis::Utilities::WindowFunctions::WindowType
+    classifyTaper(const TaperParameters::Type type)
+{
+    using RTSeis::Utilities::WindowFunctions::WindowType;
+    if (type == TaperParameters::Type::HAMMING){return WindowType::HAMMING;}
+    if (type == TaperParameters::Type::BLACKMAN){return WindowType::BLACKMAN;}
+    if (type == TaperParameters::Type::HANN){return WindowType::HANN;}
+    if (type == TaperParameters::Type::BARTLETT){return WindowType::BARTLETT;}
+    if (type == TaperParameters::Type::SINE){return WindowType::SINE;}
+#ifdef DEBUG
+    assert(false);
+#endif
+    RTSEIS_THROW_IA("%s", "Unsupported window");
+}
+}
+
 template<class T>
 Taper<T>::Taper() :
     pImpl(std::make_unique<TaperImpl>())
@@ -135,8 +153,7 @@ template<class T>
 void Taper<T>::clear()
 {
     pImpl->parms.clear();
-    pImpl->w8.clear();
-    pImpl->w4.clear();
+    pImpl->window.reset();
     pImpl->winLen0 =-1;
     pImpl->linit = true;
 }
@@ -192,40 +209,14 @@ void Taper<double>::apply(const int nx, const double x[], double *yIn[])
     // of the module can't change so we can just use the old window.
     if (pImpl->winLen0 != m)
     {
-        pImpl->w8.resize(m); // Prevent reallocations in a bit
         TaperParameters::Type type = pImpl->parms.getTaperType();
-        double *w8data = pImpl->w8.data();
-        if (type == TaperParameters::Type::HAMMING)
-        {
-            RTSeis::Utilities::WindowFunctions::hamming(m, &w8data);
-        }
-        else if (type == TaperParameters::Type::BLACKMAN)
-        {
-            RTSeis::Utilities::WindowFunctions::blackman(m, &w8data);
-        }
-        else if (type == TaperParameters::Type::HANN)
-        {
-            RTSeis::Utilities::WindowFunctions::hann(m, &w8data);
-        }
-        else if (type == TaperParameters::Type::BARTLETT)
-        {
-            RTSeis::Utilities::WindowFunctions::bartlett(m, &w8data);
-        }
-        else if (type == TaperParameters::SINE)
-        {
-            RTSeis::Utilities::WindowFunctions::sine(m, &w8data);
-        }
-        else
-        {
-#ifdef DEBUG
-            assert(false);
-#endif
-            RTSEIS_THROW_IA("%s", "Unsupported window");
-        }
+        pImpl->window = RTSeis::Utilities::WindowFunctions::getCachedWindow
+                        <double> (classifyTaper(type), m);
+        pImpl->winLen0 = m;
     }
     // Taper first (m+1)/2 points
     int mp12 = m/2;
-    const double *w = pImpl->w8.data();
+    const double *w = pImpl->window->data();
     ippsMul_64f(w, x, y, mp12);
     // Copy the intermediate portion of the signal
     int ncopy = nx - mp12 - mp12; // Subtract out two window lengths
@@ -268,40 +259,14 @@ void Taper<float>::apply(const int nx, const float x[], float *yIn[])
     // of the module can't change so we can just use the old window.
     if (pImpl->winLen0 != m)
     {
-        pImpl->w4.resize(m); // Prevent reallocations in a bit
         TaperParameters::Type type = pImpl->parms.getTaperType();
-        float *w4data = pImpl->w4.data();
-        if (type == TaperParameters::Type::HAMMING)
-        {
-            RTSeis::Utilities::WindowFunctions::hamming(m, &w4data);
-        }
-        else if (type == TaperParameters::Type::BLACKMAN)
-        {
-            RTSeis::Utilities::WindowFunctions::blackman(m, &w4data);
-        }
-        else if (type == TaperParameters::Type::HANN)
-        {
-            RTSeis::Utilities::WindowFunctions::hann(m, &w4data);
-        }
-        else if (type == TaperParameters::Type::BARTLETT)
-        {
-            RTSeis::Utilities::WindowFunctions::bartlett(m, &w4data);
-        }
-        else if (type == TaperParameters::SINE)
-        {
-            RTSeis::Utilities::WindowFunctions::sine(m, &w4data);
-        }
-        else
-        {
-#ifdef DEBUG
-            assert(false);
-#endif
-            RTSEIS_THROW_IA("%s", "Unsupported window");
-        }
+        pImpl->window = RTSeis::Utilities::WindowFunctions::getCachedWindow
+                        <float> (classifyTaper(type), m);
+        pImpl->winLen0 = m;
     }
     // Taper first (m+1)/2 points
     int mp12 = m/2;
-    const float *w = pImpl->w4.data();
+    const float *w = pImpl->window->data();
     ippsMul_32f(w, x, y, mp12);
     // Copy the intermediate portion of the signal
     int ncopy = nx - mp12 - mp12; // Subtract out two window lengths
@@ -9,6 +9,7 @@
 #endif
 #include <memory>
 #include <algorithm>
+#include <type_traits>
 #include <ipps.h>
 #include <ippcore.h>
 #ifdef __INTEL_COMPILER
@@ -26,6 +27,7 @@
 #include "rtseis/filterDesign/enums.hpp"
 #include "rtseis/filterDesign/filterDesigner.hpp"
 #include "rtseis/utilities/math/convolve.hpp"
+#include "rtseis/filterImplementations/parallelFIRFilter.hpp"
 #include "rtseis/filterRepresentations/fir.hpp"
 #include "rtseis/filterRepresentations/ba.hpp"
 #include "rtseis/filterRepresentations/sos.hpp"
@@ -36,6 +38,7 @@
 #include "rtseis/filterImplementations/iirFilter.hpp"
 #include "rtseis/filterImplementations/iiriirFilter.hpp"
 #include "rtseis/filterImplementations/sosFilter.hpp"
+#include "rtseis/filterImplementations/frequencyDomainFilter.hpp"
 #include "rtseis/utilities/interpolation/interpolate.hpp"
 #include "rtseis/utilities/interpolation/weightedAverageSlopes.hpp"
 #include "rtseis/utilities/normalization/minMax.hpp"
@@ -77,23 +80,44 @@ classifyFIRWindow(const FIRWindow windowIn);
     const int nt = static_cast<int> (taps.size()); \
     int nhalf = nt/2; \
     int npad = len + nhalf; \
-    double *xtemp = ippsMalloc_64f(npad); \
-    double *ytemp = ippsMalloc_64f(npad); \
-    const double *x = pImpl->getInputDataPointer(); \
-    ippsCopy_64f(x, xtemp, len); \
-    ippsZero_64f(&xtemp[len], npad - len); \
-    RTSeis::FilterImplementations::FIRFilter<RTSeis::ProcessingMode::POST, double> firFilter; \
+    auto xtemp = reinterpret_cast<T *> (ippsMalloc_8u(npad*sizeof(T))); \
+    auto ytemp = reinterpret_cast<T *> (ippsMalloc_8u(npad*sizeof(T))); \
+    const T *x = pImpl->getInputDataPointer(); \
+    std::copy(x, x + len, xtemp); \
+    std::fill(xtemp + len, xtemp + npad, 0); \
+    RTSeis::FilterImplementations::FIRFilter<RTSeis::ProcessingMode::POST, T> firFilter; \
     firFilter.initialize(nt, taps.data(), \
                    RTSeis::FilterImplementations::FIRImplementation::DIRECT); \
     firFilter.apply(npad, xtemp, &ytemp); \
     ippsFree(xtemp); \
     pImpl->resizeOutputData(len); \
-    double *yout = pImpl->getOutputDataPointer(); \
-    ippsCopy_64f(&ytemp[nhalf], yout, len); \
+    T *yout = pImpl->getOutputDataPointer(); \
+    std::copy(ytemp + nhalf, ytemp + nhalf + len, yout); \
     ippsFree(ytemp); \
     pImpl->lfirstFilter_ = false; \
 };
 
+/// Applies an FIR filter.  If removing the phase then the filter is applied
+/// forwards and backwards.
+template<class T, class F>
+void firFilterWithFilter(F &firFilter, const int len, const T x[],
+                         const bool lremovePhase, T *yout)
+{
+    if (!lremovePhase)
+    {
+        firFilter.apply(len, x, &yout);
+    }
+    else
+    {
+        auto ywork = reinterpret_cast<T *> (ippsMalloc_8u(len*sizeof(T)));
+        firFilter.apply(len, x,    &ywork);          // Filter forwards
+        std::reverse_copy(ywork, ywork + len, yout); // Reverse y
+        firFilter.apply(len, yout, &ywork);          // Filter y backwards
+        std::reverse_copy(ywork, ywork + len, yout); // Reverse it
+        ippsFree(ywork);
+    }
+}
+
 /*
 static inline void reverse(std::vector<double> &x)
 {
@@ -108,8 +132,8 @@ static inline void reverse(std::vector<double> &x)
 */
 
 
-template<>
-class Waveform<double>::WaveformImpl
+template<class T>
+class Waveform<T>::WaveformImpl
 {
 public:
     /// Default constructor
@@ -126,6 +150,8 @@ public:
         xptr_ = waveform.xptr_;
         dt0_ = waveform.dt0_;
         dt_ = waveform.dt_;
+        nThreads_ = waveform.nThreads_;
+        zeroPhaseImplementation_ = waveform.zeroPhaseImplementation_;
         maxx_ = waveform.maxx_;
         maxy_ = waveform.maxy_;
         nx_ = waveform.nx_;
@@ -133,13 +159,19 @@ public:
         lfirstFilter_ = true; 
         if (maxx_ > 0)
         {
-            x_ = ippsMalloc_64f(maxx_);
-            if (waveform.x_ != nullptr){ippsCopy_64f(waveform.x_, x_, maxx_);}
+            x_ = allocate(maxx_);
+            if (waveform.x_ != nullptr)
+            {
+                std::copy(waveform.x_, waveform.x_ + maxx_, x_);
+            }
         }
         if (maxy_ > 0)
         {
-            y_ = ippsMalloc_64f(maxy_);
-            if (waveform.y_ != nullptr){ippsCopy_64f(waveform.y_, y_, maxy_);}
+            y_ = allocate(maxy_);
+            if (waveform.y_ != nullptr)
+            {
+                std::copy(waveform.y_, waveform.y_ + maxy_, y_);
+            }
         }
         return *this;
     }
@@ -159,6 +191,8 @@ public:
         xptr_ = nullptr; //.release(); // = nullptr;
         dt0_ = 1;
         dt_ = 1;
+        nThreads_ = 1;
+        zeroPhaseImplementation_ = ZeroPhaseImplementation::TIME_DOMAIN;
         maxx_ = 0;
         nx_ = 0;
         maxy_ = 0;
@@ -177,7 +211,7 @@ public:
     }
     /// Sets a pointer to the input data
     void setInputDataPointer(const int nx,
-                             const double *x,
+                             const T *x,
                              const bool lfirst = true) noexcept
     {
         xptr_ = nullptr; //.release();
@@ -204,7 +238,7 @@ public:
         dt_ = dt0_;
     }
     /// Sets the input time series
-    void setData(const size_t n, const double x[],
+    void setData(const size_t n, const T x[],
                  const bool lfirst = true)
     {
         xptr_ = nullptr; //.release();
@@ -213,14 +247,14 @@ public:
         if (nx_ > maxx_)
         {
             if (x_){ippsFree(x_);}
-            x_ = ippsMalloc_64f(nx_); 
+            x_ = allocate(nx_);
             maxx_ = nx_; 
         }
         if (nx_ == 0){return;} // Nothing to copy
 #ifdef __INTEL_COMPILER
         std::copy(pstl::execution::unseq, x, x+n, x_); 
 #else
-        ippsCopy_64f(x, x_, nx_);
+        std::copy(x, x + n, x_);
 #endif
         lfirstFilter_ = lfirst;
     }
@@ -231,12 +265,12 @@ public:
         if (ny_ > maxy_)
         {
             if (y_){ippsFree(y_);}
-            y_ = ippsMalloc_64f(ny_);
+            y_ = allocate(ny_);
             maxy_ = ny_;
         }
     }
     /// Returns a pointer to the input data
-    const double *getInputDataPointer() const
+    const T *getInputDataPointer() const
     {
         if (xptr_)
         {
@@ -248,7 +282,7 @@ public:
         }
     }
     /// Gets a pointer to the output data
-    double *getOutputDataPointer()
+    T *getOutputDataPointer()
     {
         return y_;
     }
@@ -257,14 +291,24 @@ public:
     {
         return nx_; //static_cast<int> (x_.size());
     }
+    /// Allocates an aligned array of length n in the module's precision
+    static T *allocate(const int n)
+    {
+        return reinterpret_cast<T *> (ippsMalloc_8u(n*sizeof(T)));
+    }
 //private:
     FilterDesign::FilterDesigner filterDesigner;
     /// A pointer to the input data
-    const double *xptr_ = nullptr;
+    const T *xptr_ = nullptr;
     /// The input data
-    double *x_ = nullptr;
+    T *x_ = nullptr;
     /// The output data
-    double *y_ = nullptr;
+    T *y_ = nullptr;
+    /// The number of threads used in FIR filtering
+    int nThreads_ = 1;
+    /// Defines how zero-phase IIR filters are applied
+    ZeroPhaseImplementation zeroPhaseImplementation_
+        = ZeroPhaseImplementation::TIME_DOMAIN;
     /// Input sampling period
     double dt0_ = 1;
     /// Sampling period
@@ -369,16 +413,16 @@ void Waveform<T>::setData(const size_t n, const T x[])
     pImpl->setData(n, x, true);
 }
 
-template<>
-std::vector<double> Waveform<double>::getData() const
+template<class T>
+std::vector<T> Waveform<T>::getData() const
 {
-    std::vector<double> y;
+    std::vector<T> y;
     int ny = pImpl->getNumberOfOutputSamples();
     y.resize(ny);
     if (ny > 0)
     {
-        const double *yout = pImpl->getOutputDataPointer();
-        ippsCopy_64f(yout, y.data(), ny);
+        const T *yout = pImpl->getOutputDataPointer();
+        std::copy(yout, yout + ny, y.data());
     }
     return y;
 }
@@ -400,7 +444,7 @@ void Waveform<T>::getData(const size_t nwork, T *yIn[]) const
         throw std::invalid_argument("y is NULL");
     }
     const T *yout = pImpl->getOutputDataPointer();
-    ippsCopy_64f(yout, y, leny);
+    std::copy(yout, yout + leny, y);
 }
 
 //----------------------------------------------------------------------------//
@@ -438,6 +482,36 @@ double Waveform<T>::getNyquistFrequency() const noexcept
     return fnyq;
 } 
 
+template<class T>
+void Waveform<T>::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 0)
+    {
+        RTSEIS_THROW_IA("Number of threads = %d cannot be negative",
+                        nThreads);
+    }
+    pImpl->nThreads_ = nThreads;
+}
+
+template<class T>
+int Waveform<T>::getNumberOfThreads() const noexcept
+{
+    return pImpl->nThreads_;
+}
+
+template<class T>
+void Waveform<T>::setZeroPhaseImplementation(
+    const ZeroPhaseImplementation implementation) noexcept
+{
+    pImpl->zeroPhaseImplementation_ = implementation;
+}
+
+template<class T>
+ZeroPhaseImplementation Waveform<T>::getZeroPhaseImplementation() const noexcept
+{
+    return pImpl->zeroPhaseImplementation_;
+}
+
 //----------------------------------------------------------------------------//
 //                     Convolution/Correlation/AutoCorrelation                //
 //----------------------------------------------------------------------------//
@@ -469,10 +543,23 @@ void Waveform<T>::convolve(
         int nyout;
         const T *x = pImpl->getInputDataPointer();
         T *yout = pImpl->getOutputDataPointer();
-        Utilities::Math::Convolve::convolve(nx, x,
-                                            ny, s.data(),
-                                            lenc, &nyout, &yout,
-                                            convcorMode, convcorImpl);
+        // Direct convolution is blocked for every thread count so the
+        // result does not depend on the number of threads
+        if (implementation == ConvolutionImplementation::DIRECT)
+        {
+            std::vector<double> taps(s.begin(), s.end());
+            RTSeis::FilterImplementations::ParallelFIRFilter<T> parallelFIR;
+            parallelFIR.initialize(ny, taps.data());
+            parallelFIR.setNumberOfThreads(pImpl->nThreads_);
+            parallelFIR.convolve(nx, x, lenc, &nyout, &yout, convcorMode);
+        }
+        else
+        {
+            Utilities::Math::Convolve::convolve(nx, x,
+                                                ny, s.data(),
+                                                lenc, &nyout, &yout,
+                                                convcorMode, convcorImpl);
+        }
 #ifdef DEBUG
         assert(lenc == nyout);
 #endif
@@ -679,7 +766,7 @@ void Waveform<T>::downsample(const int nq)
 #ifdef DEBUG
         assert(nyout == leny);
 #endif
-        pImpl->dt_ = pImpl->dt_*static_cast<T> (nq);
+        pImpl->dt_ = pImpl->dt_*static_cast<double> (nq);
         pImpl->lfirstFilter_ = false;
     }
     catch (const std::runtime_error &ra)
@@ -724,7 +811,7 @@ void Waveform<T>::decimate(const int nq, const int filterLength)
 #ifdef DEBUG
         assert(nyout == leny);
 #endif
-        pImpl->dt_ = pImpl->dt_*static_cast<T> (nq);
+        pImpl->dt_ = pImpl->dt_*static_cast<double> (nq);
         pImpl->lfirstFilter_ = false;
     }
     catch (const std::exception &e)
@@ -767,7 +854,9 @@ void Waveform<T>::interpolate(const double newSamplingPeriod,
         // domain extrapolation amounts to wrap around (periodicity).
         // Here, the underlying code will throw if it as asked to extrapolate.
         // So let's approximate then refine the output length.
-        std::pair<T, T> xInterval(0, (len - 1)*pImpl->dt_);
+        // The time axis is in double precision so that long float traces
+        // keep their sub-sample timing.  T only stores the samples.
+        std::pair<double, double> xInterval(0, (len - 1)*pImpl->dt_);
         auto npnew
             = static_cast<int> (len*(pImpl->dt_/newSamplingPeriod) + 0.5);
         auto tmax = (npnew - 1)*newSamplingPeriod;
@@ -776,14 +865,28 @@ void Waveform<T>::interpolate(const double newSamplingPeriod,
             npnew = npnew - 1;
             tmax = (npnew - 1)*newSamplingPeriod;
         }
-        std::pair<T, T> xIntervalNew(0, (npnew - 1)*newSamplingPeriod);
+        std::pair<double, double> xIntervalNew(0,
+                                               (npnew - 1)*newSamplingPeriod);
         // Get pointers
         pImpl->resizeOutputData(npnew);
         T *y = pImpl->getOutputDataPointer(); // Handle on output 
         // Now interpolate 
-        RTSeis::Utilities::Interpolation::WeightedAverageSlopes<T> was;
-        was.initialize(len, xInterval, x);
-        was.interpolate(npnew, xIntervalNew, &y);
+        RTSeis::Utilities::Interpolation::WeightedAverageSlopes<double> was;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            was.initialize(len, xInterval, x);
+            was.interpolate(npnew, xIntervalNew, &y);
+        }
+        else
+        {
+            std::vector<double> x64(x, x + len);
+            std::vector<double> y64(npnew);
+            double *y64Ptr = y64.data();
+            was.initialize(len, xInterval, x64.data());
+            was.interpolate(npnew, xIntervalNew, &y64Ptr);
+            std::transform(y64.begin(), y64.end(), y, [](const double v)
+                           {return static_cast<T> (v);});
+        }
     }
     else
     {
@@ -1038,6 +1141,42 @@ void Waveform<T>::firBandpassFilter(const int ntapsIn,
     }
 }
 
+template<class T>
+void Waveform<T>::cosineTaperBandpassFilter(
+    const std::array<double, 4> &corners)
+{
+    auto fnyq = getNyquistFrequency();
+    for (int i = 0; i < 4; ++i)
+    {
+        if (corners[i] < 0 || corners[i] > fnyq)
+        {
+            RTSEIS_THROW_IA("corners[%d] = %lf must be in range [0,%lf]",
+                            i, corners[i], fnyq);
+        }
+    }
+    if (corners[0] > corners[1] || corners[1] >= corners[2] ||
+        corners[2] > corners[3])
+    {
+        RTSEIS_THROW_IA("%s", "corners must be increasing");
+    }
+    if (!pImpl->lfirstFilter_){pImpl->overwriteInputWithOutput();}
+    int len = pImpl->getLengthOfInputSignal();
+    if (len < 1)
+    {
+        RTSEIS_WARNMSG("%s", "No data is set on the module");
+        return;
+    }
+    std::array<double, 4> r;
+    for (int i = 0; i < 4; ++i){r[i] = std::min(1.0, corners[i]/fnyq);}
+    RTSeis::FilterImplementations::FrequencyDomainFilter<T> fdFilter;
+    fdFilter.initialize(r);
+    pImpl->resizeOutputData(len);
+    const T *x = pImpl->getInputDataPointer();
+    T *yout = pImpl->getOutputDataPointer();
+    fdFilter.apply(len, x, &yout);
+    pImpl->lfirstFilter_ = false;
+}
+
 template<class T>
 void Waveform<T>::iirBandstopFilter(const int order,
                                     const std::pair<double,double> fc, 
@@ -1112,8 +1251,8 @@ void Waveform<T>::firBandstopFilter(const int ntapsIn,
 //                               General Filtering                            //
 //----------------------------------------------------------------------------//
 
-template<>
-void Waveform<double>::firFilter(
+template<class T>
+void Waveform<T>::firFilter(
     const RTSeis::FilterRepresentations::FIR &fir,
     const bool lremovePhase)
 {
@@ -1131,27 +1270,15 @@ void Waveform<double>::firFilter(
     {
         RTSEIS_THROW_IA("%s", "No filter taps");
     }
-    // Initialize filter
-    RTSeis::FilterImplementations::FIRFilter<RTSeis::ProcessingMode::POST, double> firFilter;
-    firFilter.initialize(nb, taps.data(),
-                   RTSeis::FilterImplementations::FIRImplementation::DIRECT);
     pImpl->resizeOutputData(len);
-    // Standard FIR filtering 
-    const double *x = pImpl->getInputDataPointer();
-    double *yout = pImpl->getOutputDataPointer();
-    if (!lremovePhase)
-    {
-        firFilter.apply(len, x, &yout);
-    }
-    else
-    {
-        double *ywork = ippsMalloc_64f(len);
-        firFilter.apply(len, x,    &ywork); // Filter forwards
-        ippsFlip_64f(ywork, yout,  len);    // Reverse y
-        firFilter.apply(len, yout, &ywork); // Filter y backwards
-        ippsFlip_64f(ywork, yout,  len);    // Reverse it
-        ippsFree(ywork);
-    }
+    const T *x = pImpl->getInputDataPointer();
+    T *yout = pImpl->getOutputDataPointer();
+    // Block-parallel FIR filtering.  The blocks are fixed by the block size
+    // and not the number of threads so one thread gives the same result.
+    RTSeis::FilterImplementations::ParallelFIRFilter<T> firFilter;
+    firFilter.initialize(nb, taps.data());
+    firFilter.setNumberOfThreads(pImpl->nThreads_);
+    firFilterWithFilter(firFilter, len, x, lremovePhase, yout);
     pImpl->lfirstFilter_ = false;
 }
 
@@ -1203,8 +1330,8 @@ void Waveform<T>::iirFilter(const RTSeis::FilterRepresentations::BA &ba,
     pImpl->lfirstFilter_ = false;
 }
 
-template<>
-void Waveform<double>::sosFilter(
+template<class T>
+void Waveform<T>::sosFilter(
     const RTSeis::FilterRepresentations::SOS &sos,
     const bool lremovePhase)
 {
@@ -1221,24 +1348,38 @@ void Waveform<double>::sosFilter(
     {
         RTSEIS_THROW_IA("%s", "No sections in fitler");
     }
+    // Apply the squared amplitude response in the frequency domain
+    if (lremovePhase &&
+        pImpl->zeroPhaseImplementation_ ==
+        ZeroPhaseImplementation::FREQUENCY_DOMAIN)
+    {
+        RTSeis::FilterImplementations::FrequencyDomainFilter<T> fdFilter;
+        fdFilter.initialize(sos);
+        pImpl->resizeOutputData(len);
+        const T *x = pImpl->getInputDataPointer();
+        T *yout = pImpl->getOutputDataPointer();
+        fdFilter.apply(len, x, &yout);
+        pImpl->lfirstFilter_ = false;
+        return;
+    }
     const std::vector<double> bs = sos.getNumeratorCoefficients();
     const std::vector<double> as = sos.getDenominatorCoefficients();
     // Initialize filter
     RTSeis::FilterImplementations::SOSFilter
-        <RTSeis::ProcessingMode::POST, double> sosFilter;
+        <RTSeis::ProcessingMode::POST, T> sosFilter;
     sosFilter.initialize(ns, bs.data(), as.data());
     pImpl->resizeOutputData(len);
     // Get handles on pointers
-    const double *x = pImpl->getInputDataPointer();
-    double *yout = pImpl->getOutputDataPointer();
+    const T *x = pImpl->getInputDataPointer();
+    T *yout = pImpl->getOutputDataPointer();
     // Zero-phase filtering needs workspace so that x isn't annihalated
     if (lremovePhase)
     {
-        double *ywork = ippsMalloc_64f(len);
-        sosFilter.apply(len, x,    &ywork); // Filter forwards
-        ippsFlip_64f(ywork, yout,  len);    // Reverse y
-        sosFilter.apply(len, yout, &ywork); // Filter y backwards
-        ippsFlip_64f(ywork, yout,  len);    // Reverse it
+        T *ywork = WaveformImpl::allocate(len);
+        sosFilter.apply(len, x,    &ywork);          // Filter forwards
+        std::reverse_copy(ywork, ywork + len, yout); // Reverse y
+        sosFilter.apply(len, yout, &ywork);          // Filter y backwards
+        std::reverse_copy(ywork, ywork + len, yout); // Reverse it
         ippsFree(ywork);
     }
     else
@@ -1498,3 +1639,4 @@ classifyFIRWindow(const FIRWindow windowIn)
 
 // Template instantiation
 template class PostProcessing::SingleChannel::Waveform<double>;
+template class PostProcessing::SingleChannel::Waveform<float>;
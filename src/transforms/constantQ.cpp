@@ -0,0 +1,652 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/enums.hpp"
+#include "rtseis/transforms/constantQ.hpp"
+#include "rtseis/transforms/utilities.hpp"
+#include "rtseis/filterImplementations/decimate.hpp"
+
+using namespace RTSeis::Transforms;
+namespace DFTUtilities = RTSeis::Transforms::DFTUtilities;
+
+namespace
+{
+/// Length of the half-band decimation filters.  This is odd so that the
+/// filter delay is an integer number of samples.
+constexpr int DECIMATION_FILTER_LENGTH = 65;
+/// Kernel entries smaller than this fraction of the largest entry in a bin
+/// are dropped
+constexpr double SPARSITY_THRESHOLD = 1.e-6;
+/// The largest frequency as a fraction of the sampling rate
+constexpr double MAX_RELATIVE_FREQUENCY = 0.4;
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class ConstantQ<E, T>::ConstantQImpl
+{
+public:
+    /// The state of one octave.  Octave 0 is the highest octave.
+    struct Octave
+    {
+        /// Decimates this octave's signal to feed the next octave
+        RTSeis::FilterImplementations::Decimate<E, T> mDecimator;
+        /// The signal at this octave's sampling rate starting at sample
+        /// mSignalStart
+        std::vector<double> mSignal;
+        /// Sparse kernel for the positive frequencies.  The entries of bin
+        /// i are in [mOffsets[i], mOffsets[i+1]).
+        std::vector<int> mIndices;
+        std::vector<std::complex<double>> mValues;
+        std::vector<int> mOffsets;
+        /// Sparse kernel for the negative frequencies N - j indexed by j
+        std::vector<int> mMirrorIndices;
+        std::vector<std::complex<double>> mMirrorValues;
+        std::vector<int> mMirrorOffsets;
+        /// The [nPending x mBins] computed but unreturned coefficients
+        std::vector<std::complex<double>> mPending;
+        int64_t mSignalStart = 0;
+        /// The next transform window to compute
+        int64_t mNextWindow = 0;
+        /// The index of the lowest bin of this octave
+        int mFirstBin = 0;
+        /// The number of bins in this octave
+        int mBins = 0;
+        /// The hop length at this octave's sampling rate
+        int mHop = 0;
+        /// The integer part of the decimation delay at this octave's rate
+        int mShift = 0;
+        /// The fractional part of the decimation delay
+        double mFraction = 0;
+    };
+
+    ConstantQImpl() = default;
+    /// The plan is rebuilt rather than copied
+    ConstantQImpl(const ConstantQImpl &cqt) :
+        mOctaves(cqt.mOctaves),
+        mFrequencies(cqt.mFrequencies),
+        mTransform(cqt.mTransform),
+        mSamplingRate(cqt.mSamplingRate),
+        mWindowStart(cqt.mWindowStart),
+        mEmitted(cqt.mEmitted),
+        mDFTLength(cqt.mDFTLength),
+        mLookAhead(cqt.mLookAhead),
+        mBinsPerOctave(cqt.mBinsPerOctave),
+        mHop(cqt.mHop),
+        mWindows(cqt.mWindows),
+        mHaveTransform(cqt.mHaveTransform),
+        mInitialized(cqt.mInitialized)
+    {
+        if (mInitialized){makePlan();}
+    }
+    ConstantQImpl& operator=(const ConstantQImpl &) = delete;
+    ~ConstantQImpl()
+    {
+        releasePlan();
+    }
+    void releasePlan() noexcept
+    {
+        if (mHavePlan){fftw_destroy_plan(mPlan);}
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mOutData != nullptr){fftw_free(mOutData);}
+        mInData = nullptr;
+        mOutData = nullptr;
+        mHavePlan = false;
+    }
+    /// All octaves use the same transform length
+    void makePlan()
+    {
+        releasePlan();
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (mDFTLength)*sizeof(double)));
+        mOutData = reinterpret_cast<fftw_complex *>
+                   (fftw_malloc(static_cast<size_t> (mDFTLength/2 + 1)
+                               *sizeof(fftw_complex)));
+        mPlan = fftw_plan_dft_r2c_1d(mDFTLength, mInData, mOutData,
+                                     FFTW_ESTIMATE);
+        mHavePlan = true;
+    }
+    /// Builds the sparse spectral kernel of an octave.  The kernel of bin k
+    /// is conj(DFT(a_k))/N where a_k is the Hann windowed exponential
+    /// centered at N/2 plus the octave's fractional delay.
+    void makeKernel(Octave &octave, const double octaveRate) const
+    {
+        const int n = mDFTLength;
+        const double q = 1/(std::pow(2.0, 1.0/mBinsPerOctave) - 1);
+        auto atom = reinterpret_cast<fftw_complex *>
+                    (fftw_malloc(static_cast<size_t> (n)*sizeof(fftw_complex)));
+        auto spectrum = reinterpret_cast<fftw_complex *>
+                        (fftw_malloc(static_cast<size_t> (n)
+                                    *sizeof(fftw_complex)));
+        auto plan = fftw_plan_dft_1d(n, atom, spectrum, FFTW_FORWARD,
+                                     FFTW_ESTIMATE);
+        octave.mIndices.clear();
+        octave.mValues.clear();
+        octave.mMirrorIndices.clear();
+        octave.mMirrorValues.clear();
+        octave.mOffsets.assign(1, 0);
+        octave.mMirrorOffsets.assign(1, 0);
+        const double center = n/2 + octave.mFraction;
+        for (int i = 0; i < octave.mBins; ++i)
+        {
+            auto f = mFrequencies[octave.mFirstBin + i]/octaveRate;
+            auto width = q/f;
+            double wsum = 0;
+            for (int j = 0; j < n; ++j)
+            {
+                auto t = j - center;
+                atom[j][0] = 0;
+                atom[j][1] = 0;
+                if (std::abs(t) < width/2)
+                {
+                    auto w = 0.5*(1 + std::cos(2*M_PI*t/width));
+                    atom[j][0] = w*std::cos(2*M_PI*f*t);
+                    atom[j][1] = w*std::sin(2*M_PI*f*t);
+                    wsum = wsum + w;
+                }
+            }
+            fftw_execute(plan);
+            auto xnorm = 1/(wsum*n);
+            double kmax = 0;
+            for (int j = 0; j < n; ++j)
+            {
+                kmax = std::max(kmax, std::hypot(spectrum[j][0],
+                                                 spectrum[j][1]));
+            }
+            auto tol = SPARSITY_THRESHOLD*kmax;
+            for (int j = 0; j <= n/2; ++j)
+            {
+                if (std::hypot(spectrum[j][0], spectrum[j][1]) >= tol)
+                {
+                    octave.mIndices.push_back(j);
+                    octave.mValues.push_back(
+                        std::complex<double> (spectrum[j][0],
+                                              -spectrum[j][1])*xnorm);
+                }
+            }
+            for (int j = 1; j < n/2; ++j)
+            {
+                auto k = n - j;
+                if (std::hypot(spectrum[k][0], spectrum[k][1]) >= tol)
+                {
+                    octave.mMirrorIndices.push_back(j);
+                    octave.mMirrorValues.push_back(
+                        std::complex<double> (spectrum[k][0],
+                                              -spectrum[k][1])*xnorm);
+                }
+            }
+            octave.mOffsets.push_back(static_cast<int> (octave.mIndices.size()));
+            octave.mMirrorOffsets.push_back(
+                static_cast<int> (octave.mMirrorIndices.size()));
+        }
+        fftw_destroy_plan(plan);
+        fftw_free(atom);
+        fftw_free(spectrum);
+    }
+    /// Computes the octave's transform windows up to, but not including,
+    /// window mEnd.  Samples outside of the signal are zero.  Only the
+    /// samples within mLookAhead of the window's center are used.  The
+    /// atoms vanish beyond that but the sparse spectral kernels do not quite,
+    /// so truncating the input in time makes a real-time window, which is
+    /// computed once its look-ahead has arrived, independent of whether
+    /// later samples have arrived.
+    void computeWindows(Octave &octave, const int64_t mEnd)
+    {
+        const int n = mDFTLength;
+        const auto nSignal = static_cast<int64_t> (octave.mSignal.size());
+        const int j0 = std::max(0, n/2 - mLookAhead);
+        const int j1 = std::min(n, n/2 + mLookAhead + 1);
+        for (auto m = octave.mNextWindow; m < mEnd; ++m)
+        {
+            auto i0 = m*octave.mHop + octave.mShift - n/2 - octave.mSignalStart;
+            std::fill(mInData, mInData + n, 0.0);
+            for (int j = j0; j < j1; ++j)
+            {
+                auto i = i0 + j;
+                if (i >= 0 && i < nSignal){mInData[j] = octave.mSignal[i];}
+            }
+            fftw_execute(mPlan);
+            for (int ib = 0; ib < octave.mBins; ++ib)
+            {
+                std::complex<double> c = 0;
+                for (int l = octave.mOffsets[ib]; l < octave.mOffsets[ib+1]; ++l)
+                {
+                    auto j = octave.mIndices[l];
+                    c = c + std::complex<double> (mOutData[j][0],
+                                                  mOutData[j][1])
+                           *octave.mValues[l];
+                }
+                for (int l = octave.mMirrorOffsets[ib];
+                     l < octave.mMirrorOffsets[ib+1]; ++l)
+                {
+                    auto j = octave.mMirrorIndices[l];
+                    c = c + std::complex<double> (mOutData[j][0],
+                                                  -mOutData[j][1])
+                           *octave.mMirrorValues[l];
+                }
+                octave.mPending.push_back(c);
+            }
+        }
+        octave.mNextWindow = std::max(octave.mNextWindow, mEnd);
+    }
+    /// Feeds a packet to the octaves and computes the available windows.
+    /// In post-processing nWindows is the number of windows to compute.
+    void transform(const int nSamples, const T x[], const int64_t nWindows)
+    {
+        const int n = mDFTLength;
+        const int nOctaves = static_cast<int> (mOctaves.size());
+        std::vector<T> work(x, x + nSamples);
+        std::vector<T> decimated;
+        for (int io = 0; io < nOctaves; ++io)
+        {
+            auto &octave = mOctaves[io];
+            octave.mSignal.insert(octave.mSignal.end(), work.begin(), work.end());
+            if (io < nOctaves - 1 && !work.empty())
+            {
+                auto nWork = static_cast<int> (work.size());
+                auto ny = octave.mDecimator.estimateSpace(nWork);
+                decimated.resize(std::max(1, ny));
+                int nyDown = 0;
+                auto yPtr = decimated.data();
+                octave.mDecimator.apply(nWork, work.data(), ny, &nyDown, &yPtr);
+                decimated.resize(nyDown);
+                std::swap(work, decimated);
+            }
+            auto mEnd = nWindows;
+            if (mEnd < 0)
+            {
+                // The last window whose samples have all arrived
+                auto iLast = octave.mSignalStart
+                           + static_cast<int64_t> (octave.mSignal.size()) - 1;
+                auto numerator = iLast - octave.mShift - mLookAhead;
+                mEnd = (numerator < 0) ? 0 : numerator/octave.mHop + 1;
+            }
+            computeWindows(octave, mEnd);
+            // Release the samples that no later window needs
+            auto keep = octave.mNextWindow*octave.mHop + octave.mShift - n/2;
+            auto nDrop = std::min(static_cast<int64_t> (octave.mSignal.size()),
+                                  keep - octave.mSignalStart);
+            if (nDrop > 0)
+            {
+                octave.mSignal.erase(octave.mSignal.begin(),
+                                     octave.mSignal.begin() + nDrop);
+                octave.mSignalStart = octave.mSignalStart + nDrop;
+            }
+        }
+        // Return the windows that every octave has computed
+        auto mReady = mOctaves[0].mNextWindow;
+        for (const auto &octave : mOctaves)
+        {
+            mReady = std::min(mReady, octave.mNextWindow);
+        }
+        const int nBins = static_cast<int> (mFrequencies.size());
+        mWindowStart = mEmitted;
+        mWindows = static_cast<int> (mReady - mEmitted);
+        mTransform.resize(static_cast<size_t> (mWindows)*nBins);
+        for (auto &octave : mOctaves)
+        {
+            for (int iw = 0; iw < mWindows; ++iw)
+            {
+                auto src = octave.mPending.begin()
+                         + static_cast<size_t> (iw)*octave.mBins;
+                auto dst = mTransform.begin()
+                         + static_cast<size_t> (iw)*nBins + octave.mFirstBin;
+                std::transform(src, src + octave.mBins, dst,
+                               [](const std::complex<double> &c)
+                               {
+                                   return std::complex<T>
+                                          (static_cast<T> (std::real(c)),
+                                           static_cast<T> (std::imag(c)));
+                               });
+            }
+            octave.mPending.erase(octave.mPending.begin(),
+                                  octave.mPending.begin()
+                                + static_cast<size_t> (mWindows)*octave.mBins);
+        }
+        mEmitted = mReady;
+    }
+    void resetInitialConditions()
+    {
+        for (auto &octave : mOctaves)
+        {
+            if (octave.mDecimator.isInitialized())
+            {
+                octave.mDecimator.resetInitialConditions();
+            }
+            octave.mSignal.clear();
+            octave.mPending.clear();
+            octave.mSignalStart = 0;
+            octave.mNextWindow = 0;
+        }
+        mTransform.clear();
+        mWindowStart = 0;
+        mEmitted = 0;
+        mWindows = 0;
+        mHaveTransform = false;
+    }
+    std::vector<Octave> mOctaves;
+    /// The bin frequencies in Hz
+    std::vector<double> mFrequencies;
+    /// The [mWindows x nBins] transform
+    std::vector<std::complex<T>> mTransform;
+    fftw_plan mPlan;
+    double *mInData = nullptr;
+    fftw_complex *mOutData = nullptr;
+    double mSamplingRate = 1;
+    /// Index of the first window returned by the last transform
+    int64_t mWindowStart = 0;
+    /// Number of windows returned since the start of the signal
+    int64_t mEmitted = 0;
+    int mDFTLength = 0;
+    /// The number of samples after a window's center that the longest
+    /// analysis window reaches
+    int mLookAhead = 0;
+    int mBinsPerOctave = 12;
+    int mHop = 1;
+    int mWindows = 0;
+    bool mHavePlan = false;
+    bool mHaveTransform = false;
+    bool mInitialized = false;
+    const RTSeis::ProcessingMode mMode = E;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+ConstantQ<E, T>::ConstantQ() :
+    pImpl(std::make_unique<ConstantQImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+ConstantQ<E, T>::ConstantQ(const ConstantQ &cqt)
+{
+    *this = cqt;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+ConstantQ<E, T>::ConstantQ(ConstantQ &&cqt) noexcept
+{
+    *this = std::move(cqt);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+ConstantQ<E, T>& ConstantQ<E, T>::operator=(const ConstantQ &cqt)
+{
+    if (&cqt == this){return *this;}
+    pImpl = std::make_unique<ConstantQImpl> (*cqt.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+ConstantQ<E, T>& ConstantQ<E, T>::operator=(ConstantQ &&cqt) noexcept
+{
+    if (&cqt == this){return *this;}
+    pImpl = std::move(cqt.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+ConstantQ<E, T>::~ConstantQ() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void ConstantQ<E, T>::clear() noexcept
+{
+    pImpl = std::make_unique<ConstantQImpl> ();
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void ConstantQ<E, T>::initialize(const double samplingRate,
+                                 const double minFrequency,
+                                 const double maxFrequency,
+                                 const int binsPerOctave,
+                                 const int hopLength)
+{
+    clear();
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (binsPerOctave < 1)
+    {
+        throw std::invalid_argument("binsPerOctave = "
+                                  + std::to_string(binsPerOctave)
+                                  + " must be positive");
+    }
+    if (minFrequency <= 0)
+    {
+        throw std::invalid_argument("minFrequency = "
+                                  + std::to_string(minFrequency)
+                                  + " must be positive");
+    }
+    auto fMax = MAX_RELATIVE_FREQUENCY*samplingRate;
+    if (maxFrequency < minFrequency || maxFrequency > fMax)
+    {
+        throw std::invalid_argument("maxFrequency = "
+                                  + std::to_string(maxFrequency)
+                                  + " must be in range ["
+                                  + std::to_string(minFrequency) + ","
+                                  + std::to_string(fMax) + "]");
+    }
+    // Geometrically spaced bins
+    auto nBins = static_cast<int>
+                 (std::floor(binsPerOctave*std::log2(maxFrequency/minFrequency)
+                             + 1.e-10)) + 1;
+    auto nOctaves = (nBins + binsPerOctave - 1)/binsPerOctave;
+    if (nOctaves > 30)
+    {
+        throw std::invalid_argument("Too many octaves");
+    }
+    auto hopFactor = 1 << (nOctaves - 1);
+    auto hop = hopLength;
+    if (hop < 1){hop = hopFactor;}
+    if (hop%hopFactor != 0)
+    {
+        throw std::invalid_argument("hopLength = " + std::to_string(hopLength)
+                                  + " must be a multiple of "
+                                  + std::to_string(hopFactor));
+    }
+    pImpl->mFrequencies.resize(nBins);
+    for (int k = 0; k < nBins; ++k)
+    {
+        pImpl->mFrequencies[k]
+            = minFrequency*std::pow(2.0, static_cast<double> (k)/binsPerOctave);
+    }
+    // The longest analysis window is at the octave's lowest bin
+    auto q = 1/(std::pow(2.0, 1.0/binsPerOctave) - 1);
+    auto fLowest = pImpl->mFrequencies[std::max(0, nBins - binsPerOctave)];
+    auto width = q*samplingRate/fLowest;
+    pImpl->mDFTLength
+        = DFTUtilities::nextPowerOfTwo(static_cast<int> (std::ceil(width)) + 2);
+    pImpl->mLookAhead = static_cast<int> (std::ceil(width/2)) + 1;
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mBinsPerOctave = binsPerOctave;
+    pImpl->mHop = hop;
+    pImpl->makePlan();
+    // Set the octaves.  In real-time each decimator delays its output by
+    // (length - 1)/2 samples at its input rate.
+    pImpl->mOctaves.resize(nOctaves);
+    double delay = 0; // Delay at the original sampling rate
+    for (int io = 0; io < nOctaves; ++io)
+    {
+        auto &octave = pImpl->mOctaves[io];
+        auto lastBin = nBins - 1 - io*binsPerOctave;
+        octave.mFirstBin = std::max(0, lastBin - binsPerOctave + 1);
+        octave.mBins = lastBin - octave.mFirstBin + 1;
+        octave.mHop = hop >> io;
+        auto octaveDelay = delay/static_cast<double> (1 << io);
+        octave.mShift = static_cast<int> (std::floor(octaveDelay));
+        octave.mFraction = octaveDelay - octave.mShift;
+        if (io < nOctaves - 1)
+        {
+            octave.mDecimator.initialize(2, DECIMATION_FILTER_LENGTH, true);
+            if (E == RTSeis::ProcessingMode::REAL_TIME)
+            {
+                delay = delay + (1 << io)*(DECIMATION_FILTER_LENGTH - 1)/2.0;
+            }
+        }
+        pImpl->makeKernel(octave, samplingRate/static_cast<double> (1 << io));
+    }
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool ConstantQ<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Sampling rate
+template<RTSeis::ProcessingMode E, class T>
+double ConstantQ<E, T>::getSamplingRate() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamplingRate;
+}
+
+/// Number of frequencies
+template<RTSeis::ProcessingMode E, class T>
+int ConstantQ<E, T>::getNumberOfFrequencies() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return static_cast<int> (pImpl->mFrequencies.size());
+}
+
+/// Frequencies
+template<RTSeis::ProcessingMode E, class T>
+std::vector<T> ConstantQ<E, T>::getFrequencies() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::vector<T> frequencies(pImpl->mFrequencies.size());
+    std::copy(pImpl->mFrequencies.begin(), pImpl->mFrequencies.end(),
+              frequencies.begin());
+    return frequencies;
+}
+
+/// Number of octaves
+template<RTSeis::ProcessingMode E, class T>
+int ConstantQ<E, T>::getNumberOfOctaves() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return static_cast<int> (pImpl->mOctaves.size());
+}
+
+/// Hop length
+template<RTSeis::ProcessingMode E, class T>
+int ConstantQ<E, T>::getHopLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mHop;
+}
+
+/// Transform
+template<RTSeis::ProcessingMode E, class T>
+void ConstantQ<E, T>::transform(const int nSamples, const T x[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nSamples > 0 && x == nullptr){throw std::invalid_argument("x is NULL");}
+    auto n = std::max(0, nSamples);
+    if (pImpl->mMode == RTSeis::ProcessingMode::POST)
+    {
+        // Windows are centered on samples 0, hop, 2 hop, ..., n - 1
+        pImpl->resetInitialConditions();
+        int64_t nWindows = 0;
+        if (n > 0){nWindows = (n - 1)/pImpl->mHop + 1;}
+        pImpl->transform(n, x, nWindows);
+    }
+    else
+    {
+        pImpl->transform(n, x, -1);
+    }
+    pImpl->mHaveTransform = true;
+}
+
+/// Reset
+template<RTSeis::ProcessingMode E, class T>
+void ConstantQ<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Have transform?
+template<RTSeis::ProcessingMode E, class T>
+bool ConstantQ<E, T>::haveTransform() const noexcept
+{
+    return pImpl->mHaveTransform;
+}
+
+/// Number of windows
+template<RTSeis::ProcessingMode E, class T>
+int ConstantQ<E, T>::getNumberOfTransformWindows() const
+{
+    if (!haveTransform())
+    {
+        throw std::runtime_error("Transform not yet computed");
+    }
+    return pImpl->mWindows;
+}
+
+/// Window times
+template<RTSeis::ProcessingMode E, class T>
+std::vector<T> ConstantQ<E, T>::getTimeWindows() const
+{
+    auto nWindows = getNumberOfTransformWindows(); // Throws
+    std::vector<T> times(nWindows);
+    for (int i = 0; i < nWindows; ++i)
+    {
+        auto sample = static_cast<double> (pImpl->mWindowStart + i)
+                     *pImpl->mHop;
+        times[i] = static_cast<T> (sample/pImpl->mSamplingRate);
+    }
+    return times;
+}
+
+/// Transform
+template<RTSeis::ProcessingMode E, class T>
+std::vector<std::complex<T>> ConstantQ<E, T>::getTransform() const
+{
+    if (!haveTransform())
+    {
+        throw std::runtime_error("Transform not yet computed");
+    }
+    return pImpl->mTransform;
+}
+
+/// Amplitude
+template<RTSeis::ProcessingMode E, class T>
+std::vector<T> ConstantQ<E, T>::getAmplitude() const
+{
+    if (!haveTransform())
+    {
+        throw std::runtime_error("Transform not yet computed");
+    }
+    std::vector<T> amplitude(pImpl->mTransform.size());
+    std::transform(pImpl->mTransform.begin(), pImpl->mTransform.end(),
+                   amplitude.begin(),
+                   [](const std::complex<T> &c){return std::abs(c);});
+    return amplitude;
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::ConstantQ<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Transforms::ConstantQ<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Transforms::ConstantQ<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Transforms::ConstantQ<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <algorithm>
 #include <valarray>
+#include <limits>
 #include <ipps.h>
 #include "rtseis/transforms/utilities.hpp"
 #include "rtseis/log.h"
@@ -288,6 +289,34 @@ int DFTUtilities::nextPowerOfTwo(const int n)
     return n2;
 }
 
+int DFTUtilities::nextFastLength(const int n)
+{
+    if (n < 0)
+    {
+        throw std::invalid_argument("n = " + std::to_string(n)
+                                 + " must be positive");
+    }
+    if (n <= 1){return 1;}
+    // Enumerate the 2^i 3^j 5^k >= n and keep the smallest
+    auto nn = static_cast<int64_t> (n);
+    auto best = static_cast<int64_t> (nextPowerOfTwo(n)); // Upper bound
+    for (int64_t p5 = 1; p5 < best; p5 = p5*5)
+    {
+        for (int64_t p35 = p5; p35 < best; p35 = p35*3)
+        {
+            // Smallest power of 2 taking p35 to at least n
+            auto p235 = p35;
+            while (p235 < nn){p235 = p235*2;}
+            best = std::min(best, p235);
+        }
+    }
+    if (best > static_cast<int64_t> (std::numeric_limits<int>::max()))
+    {
+        throw std::runtime_error("Overflow error in nextFastLength");
+    }
+    return static_cast<int> (best);
+}
+
 /// fftshift
 template<typename T> std::vector<T> 
 RTSeis::Transforms::DFTUtilities::fftShift(const std::vector<T> &x)
@@ -0,0 +1,269 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/transforms/discreteWavelet.hpp"
+#include "private/discreteWavelets.hpp"
+
+using namespace RTSeis::Transforms;
+
+template<class T>
+class DiscreteWavelet<T>::DiscreteWaveletImpl
+{
+public:
+    /// Splits the n samples of x into the n/2 approximation coefficients a
+    /// and the n/2 detail coefficients d.  The signal is periodically
+    /// extended into the workspace so the inner products do not wrap.
+    void analysis(const int n, const T x[], T a[], T d[])
+    {
+        const int nh = static_cast<int> (mScaling.size());
+        const auto h = mScaling.data();
+        const auto g = mWavelet.data();
+        mExtended.resize(static_cast<size_t> (n + nh - 1));
+        auto ext = mExtended.data();
+        for (int i = 0; i < n + nh - 1; ++i){ext[i] = x[i%n];}
+        for (int k = 0; k < n/2; ++k)
+        {
+            const auto xk = ext + 2*k;
+            T ak = 0;
+            T dk = 0;
+            #pragma omp simd reduction(+:ak, dk)
+            for (int l = 0; l < nh; ++l)
+            {
+                ak = ak + h[l]*xk[l];
+                dk = dk + g[l]*xk[l];
+            }
+            a[k] = ak;
+            d[k] = dk;
+        }
+    }
+    /// Reconstructs the n samples of x from the n/2 approximation and detail
+    /// coefficients.  This is the adjoint of analysis - the coefficients are
+    /// scattered into the extended workspace which is then folded back.
+    void synthesis(const int n, const T a[], const T d[], T x[])
+    {
+        const int nh = static_cast<int> (mScaling.size());
+        const auto h = mScaling.data();
+        const auto g = mWavelet.data();
+        mExtended.assign(static_cast<size_t> (n + nh - 1), 0);
+        auto ext = mExtended.data();
+        for (int k = 0; k < n/2; ++k)
+        {
+            const T ak = a[k];
+            const T dk = d[k];
+            auto xk = ext + 2*k;
+            #pragma omp simd
+            for (int l = 0; l < nh; ++l)
+            {
+                xk[l] = xk[l] + h[l]*ak + g[l]*dk;
+            }
+        }
+        std::copy(ext, ext + n, x);
+        for (int i = n; i < n + nh - 1; ++i){x[i%n] = x[i%n] + ext[i];}
+    }
+    /// The scaling filter
+    std::vector<T> mScaling;
+    /// The wavelet filter
+    std::vector<T> mWavelet;
+    /// Periodically extended signal
+    std::vector<T> mExtended;
+    /// Approximation coefficients of the current level
+    std::vector<T> mApproximation;
+    /// Workspace for the next level's approximation coefficients
+    std::vector<T> mWork;
+    int mLevels = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+DiscreteWavelet<T>::DiscreteWavelet() :
+    pImpl(std::make_unique<DiscreteWaveletImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+DiscreteWavelet<T>::DiscreteWavelet(const DiscreteWavelet &dwt)
+{
+    *this = dwt;
+}
+
+/// Move c'tor
+template<class T>
+DiscreteWavelet<T>::DiscreteWavelet(DiscreteWavelet &&dwt) noexcept
+{
+    *this = std::move(dwt);
+}
+
+/// Copy assignment
+template<class T>
+DiscreteWavelet<T>& DiscreteWavelet<T>::operator=(const DiscreteWavelet &dwt)
+{
+    if (&dwt == this){return *this;}
+    pImpl = std::make_unique<DiscreteWaveletImpl> (*dwt.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+DiscreteWavelet<T>&
+DiscreteWavelet<T>::operator=(DiscreteWavelet &&dwt) noexcept
+{
+    if (&dwt == this){return *this;}
+    pImpl = std::move(dwt.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+DiscreteWavelet<T>::~DiscreteWavelet() = default;
+
+/// Clear
+template<class T>
+void DiscreteWavelet<T>::clear() noexcept
+{
+    pImpl->mScaling.clear();
+    pImpl->mWavelet.clear();
+    pImpl->mExtended.clear();
+    pImpl->mApproximation.clear();
+    pImpl->mWork.clear();
+    pImpl->mLevels = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<class T>
+void DiscreteWavelet<T>::initialize(const DiscreteWaveletFamily family,
+                                    const int order,
+                                    const int nLevels)
+{
+    clear();
+    if (nLevels < 1)
+    {
+        throw std::invalid_argument("nLevels = " + std::to_string(nLevels)
+                                  + " must be positive");
+    }
+    auto h = ::getScalingFilter(family, order); // Throws
+    auto nh = static_cast<int> (h.size());
+    pImpl->mScaling.resize(nh);
+    pImpl->mWavelet.resize(nh);
+    for (int l = 0; l < nh; ++l)
+    {
+        pImpl->mScaling[l] = static_cast<T> (h[l]);
+        auto sign = (l%2 == 0) ? 1 : -1;
+        pImpl->mWavelet[l] = static_cast<T> (sign*h[nh - 1 - l]);
+    }
+    pImpl->mLevels = nLevels;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool DiscreteWavelet<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of levels
+template<class T>
+int DiscreteWavelet<T>::getNumberOfLevels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mLevels;
+}
+
+/// Scaling filter
+template<class T>
+std::vector<T> DiscreteWavelet<T>::getScalingFilter() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mScaling;
+}
+
+/// Wavelet filter
+template<class T>
+std::vector<T> DiscreteWavelet<T>::getWaveletFilter() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWavelet;
+}
+
+/// Forward transform
+template<class T>
+void DiscreteWavelet<T>::forwardTransform(const int n, const T x[],
+                                          T *coefficientsIn[])
+{
+    auto nLevels = getNumberOfLevels(); // Throws
+    auto nBlock = 1 << nLevels;
+    if (n < nBlock || n%nBlock != 0)
+    {
+        throw std::invalid_argument("n = " + std::to_string(n)
+                                  + " must be a positive multiple of "
+                                  + std::to_string(nBlock));
+    }
+    T *coefficients = *coefficientsIn;
+    if (x == nullptr || coefficients == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("coefficients is NULL");
+    }
+    pImpl->mApproximation.assign(x, x + n);
+    pImpl->mWork.resize(n/2);
+    for (int j = 1; j <= nLevels; ++j)
+    {
+        auto nj = n >> (j - 1);
+        pImpl->analysis(nj, pImpl->mApproximation.data(),
+                        pImpl->mWork.data(), coefficients + nj/2);
+        std::copy(pImpl->mWork.begin(), pImpl->mWork.begin() + nj/2,
+                  pImpl->mApproximation.begin());
+    }
+    std::copy(pImpl->mApproximation.begin(),
+              pImpl->mApproximation.begin() + (n >> nLevels), coefficients);
+}
+
+/// Inverse transform
+template<class T>
+void DiscreteWavelet<T>::inverseTransform(const int n, const T coefficients[],
+                                          T *xIn[])
+{
+    auto nLevels = getNumberOfLevels(); // Throws
+    auto nBlock = 1 << nLevels;
+    if (n < nBlock || n%nBlock != 0)
+    {
+        throw std::invalid_argument("n = " + std::to_string(n)
+                                  + " must be a positive multiple of "
+                                  + std::to_string(nBlock));
+    }
+    T *x = *xIn;
+    if (coefficients == nullptr || x == nullptr)
+    {
+        if (coefficients == nullptr)
+        {
+            throw std::invalid_argument("coefficients is NULL");
+        }
+        throw std::invalid_argument("x is NULL");
+    }
+    pImpl->mApproximation.assign(coefficients, coefficients + (n >> nLevels));
+    pImpl->mApproximation.resize(n);
+    pImpl->mWork.resize(n);
+    for (int j = nLevels; j >= 1; --j)
+    {
+        auto nj = n >> (j - 1);
+        pImpl->synthesis(nj, pImpl->mApproximation.data(),
+                         coefficients + nj/2, pImpl->mWork.data());
+        std::copy(pImpl->mWork.begin(), pImpl->mWork.begin() + nj,
+                  pImpl->mApproximation.begin());
+    }
+    std::copy(pImpl->mApproximation.begin(),
+              pImpl->mApproximation.begin() + n, x);
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::DiscreteWavelet<double>;
+template class RTSeis::Transforms::DiscreteWavelet<float>;
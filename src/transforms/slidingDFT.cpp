@@ -0,0 +1,351 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/transforms/slidingDFT.hpp"
+
+using namespace RTSeis::Transforms;
+
+template<class T>
+class SlidingDFT<T>::SlidingDFTImpl
+{
+public:
+    /// Zeros the windows and bins
+    void resetInitialConditions()
+    {
+        std::fill(mBuffer.begin(), mBuffer.end(), 0);
+        std::fill(mState.begin(), mState.end(), std::complex<double> (0, 0));
+        mWriteIndex = 0;
+        mSinceRecompute = 0;
+    }
+    /// Recomputes channel c's bins from its window
+    void recompute(const int c)
+    {
+        const double *buffer = mBuffer.data()
+                             + static_cast<size_t> (c)*mWindowLength;
+        std::complex<double> *state = mState.data()
+                                    + static_cast<size_t> (c)*mTracked.size();
+        for (int u = 0; u < static_cast<int> (mTracked.size()); ++u)
+        {
+            const auto k = static_cast<int64_t> (mTracked[u]);
+            std::complex<double> s(0, 0);
+            for (int m = 0; m < mWindowLength; ++m)
+            {
+                auto xm = buffer[(mWriteIndex + m)%mWindowLength];
+                s = s + xm*mTwiddles[(k*m)%mWindowLength];
+            }
+            state[u] = s;
+        }
+    }
+    /// Number of tracked raw bins per channel
+    [[nodiscard]] int getNumberOfTrackedBins() const
+    {
+        return static_cast<int> (mTracked.size());
+    }
+    /// The raw bin j of channel c where j may be outside [0, N/2]
+    [[nodiscard]] std::complex<double> getBin(const std::complex<double> state[],
+                                              const int j) const
+    {
+        auto jm = ((j%mWindowLength) + mWindowLength)%mWindowLength;
+        // Real signals have Hermitian symmetric spectra
+        if (jm > mWindowLength/2)
+        {
+            return std::conj(state[mTrackedIndex[mWindowLength - jm]]);
+        }
+        return state[mTrackedIndex[jm]];
+    }
+    void transform(const int n, const T x[], std::complex<T> y[])
+    {
+        const int nTracked = getNumberOfTrackedBins();
+        const int nBins = static_cast<int> (mBins.size());
+        const int nTerms = static_cast<int> (mCoefficients.size());
+        // Each channel has the same write index and recompute counter
+        const int writeIndex0 = mWriteIndex;
+        const int sinceRecompute0 = mSinceRecompute;
+        for (int c = 0; c < mChannels; ++c)
+        {
+            mWriteIndex = writeIndex0;
+            mSinceRecompute = sinceRecompute0;
+            double *buffer = mBuffer.data()
+                           + static_cast<size_t> (c)*mWindowLength;
+            std::complex<double> *state = mState.data()
+                                        + static_cast<size_t> (c)*nTracked;
+            const T *xc = x + static_cast<size_t> (c)*n;
+            std::complex<T> *yc = y + static_cast<size_t> (c)*nBins*n;
+            for (int i = 0; i < n; ++i)
+            {
+                auto xi = static_cast<double> (xc[i]);
+                auto delta = xi - buffer[mWriteIndex];
+                buffer[mWriteIndex] = xi;
+                mWriteIndex = (mWriteIndex + 1)%mWindowLength;
+                mSinceRecompute = mSinceRecompute + 1;
+                if (mSinceRecompute < mWindowLength)
+                {
+                    for (int u = 0; u < nTracked; ++u)
+                    {
+                        state[u] = mRotations[u]*(state[u] + delta);
+                    }
+                }
+                else
+                {
+                    recompute(c);
+                    mSinceRecompute = 0;
+                }
+                // Window by combining neighboring bins
+                for (int b = 0; b < nBins; ++b)
+                {
+                    auto yb = mCoefficients[0]*getBin(state, mBins[b]);
+                    for (int j = 1; j < nTerms; ++j)
+                    {
+                        yb = yb + mCoefficients[j]
+                                 *(getBin(state, mBins[b] - j)
+                                 + getBin(state, mBins[b] + j));
+                    }
+                    yc[static_cast<size_t> (b)*n + i]
+                        = std::complex<T> (static_cast<T> (yb.real()),
+                                           static_cast<T> (yb.imag()));
+                }
+            }
+        }
+    }
+    /// The [nChannels x windowLength] circular buffers
+    std::vector<double> mBuffer;
+    /// The [nChannels x nTracked] unwindowed bins
+    std::vector<std::complex<double>> mState;
+    /// The e^{-2 pi i j/N} for j = 0, ..., N - 1
+    std::vector<std::complex<double>> mTwiddles;
+    /// The e^{2 pi i k/N} for each tracked bin
+    std::vector<std::complex<double>> mRotations;
+    /// Coefficients of the frequency domain window for bin offsets 0, 1, 2
+    std::vector<double> mCoefficients;
+    /// The requested bins
+    std::vector<int> mBins;
+    /// The unwindowed bins in [0, N/2] that must be tracked
+    std::vector<int> mTracked;
+    /// Maps a bin in [0, N/2] to its position in mTracked
+    std::vector<int> mTrackedIndex;
+    int mWindowLength = 0;
+    int mChannels = 0;
+    int mWriteIndex = 0;
+    int mSinceRecompute = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+SlidingDFT<T>::SlidingDFT() :
+    pImpl(std::make_unique<SlidingDFTImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+SlidingDFT<T>::SlidingDFT(const SlidingDFT &sdft)
+{
+    *this = sdft;
+}
+
+/// Move c'tor
+template<class T>
+SlidingDFT<T>::SlidingDFT(SlidingDFT &&sdft) noexcept
+{
+    *this = std::move(sdft);
+}
+
+/// Copy assignment
+template<class T>
+SlidingDFT<T>& SlidingDFT<T>::operator=(const SlidingDFT &sdft)
+{
+    if (&sdft == this){return *this;}
+    pImpl = std::make_unique<SlidingDFTImpl> (*sdft.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+SlidingDFT<T>& SlidingDFT<T>::operator=(SlidingDFT &&sdft) noexcept
+{
+    if (&sdft == this){return *this;}
+    pImpl = std::move(sdft.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+SlidingDFT<T>::~SlidingDFT() = default;
+
+/// Clear
+template<class T>
+void SlidingDFT<T>::clear() noexcept
+{
+    pImpl->mBuffer.clear();
+    pImpl->mState.clear();
+    pImpl->mTwiddles.clear();
+    pImpl->mRotations.clear();
+    pImpl->mCoefficients.clear();
+    pImpl->mBins.clear();
+    pImpl->mTracked.clear();
+    pImpl->mTrackedIndex.clear();
+    pImpl->mWindowLength = 0;
+    pImpl->mChannels = 0;
+    pImpl->mWriteIndex = 0;
+    pImpl->mSinceRecompute = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<class T>
+void SlidingDFT<T>::initialize(const int windowLength,
+                               const std::vector<int> &bins,
+                               const SlidingWindowType window,
+                               const int nChannels)
+{
+    clear();
+    if (windowLength < 2)
+    {
+        throw std::invalid_argument("windowLength = "
+                                  + std::to_string(windowLength)
+                                  + " must be at least 2");
+    }
+    if (bins.empty()){throw std::invalid_argument("No bins");}
+    for (const auto &bin : bins)
+    {
+        if (bin < 0 || bin > windowLength/2)
+        {
+            throw std::invalid_argument("bin = " + std::to_string(bin)
+                                      + " must be in range [0,"
+                                      + std::to_string(windowLength/2) + "]");
+        }
+    }
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    // Cosine-sum windows w[m] = sum_j (-1)^j a_j cos(2 pi j m/N) have the
+    // spectrum a_0 X[k] - a_1/2 (X[k-1] + X[k+1]) + a_2/2 (X[k-2] + X[k+2])
+    if (window == SlidingWindowType::BOXCAR)
+    {
+        pImpl->mCoefficients = {1};
+    }
+    else if (window == SlidingWindowType::HANN)
+    {
+        pImpl->mCoefficients = {0.5, -0.25};
+    }
+    else if (window == SlidingWindowType::HAMMING)
+    {
+        pImpl->mCoefficients = {0.54, -0.23};
+    }
+    else if (window == SlidingWindowType::BLACKMAN)
+    {
+        pImpl->mCoefficients = {0.42, -0.25, 0.04};
+    }
+    else
+    {
+        throw std::invalid_argument("Window must be boxcar, Hann, Hamming, "
+                                    "or Blackman");
+    }
+    // Track the requested bins and their neighbors, folded into [0, N/2]
+    auto nTerms = static_cast<int> (pImpl->mCoefficients.size());
+    const int nHalf = windowLength/2;
+    pImpl->mTrackedIndex.assign(nHalf + 1, -1);
+    for (const auto &bin : bins)
+    {
+        for (int j = bin - (nTerms - 1); j <= bin + (nTerms - 1); ++j)
+        {
+            auto jm = ((j%windowLength) + windowLength)%windowLength;
+            if (jm > nHalf){jm = windowLength - jm;}
+            if (pImpl->mTrackedIndex[jm] < 0)
+            {
+                pImpl->mTrackedIndex[jm]
+                    = static_cast<int> (pImpl->mTracked.size());
+                pImpl->mTracked.push_back(jm);
+            }
+        }
+    }
+    auto dN = static_cast<double> (windowLength);
+    pImpl->mTwiddles.resize(windowLength);
+    for (int j = 0; j < windowLength; ++j)
+    {
+        pImpl->mTwiddles[j] = std::polar(1.0, -2*M_PI*j/dN);
+    }
+    pImpl->mRotations.resize(pImpl->mTracked.size());
+    for (int u = 0; u < static_cast<int> (pImpl->mTracked.size()); ++u)
+    {
+        pImpl->mRotations[u] = std::conj(pImpl->mTwiddles[pImpl->mTracked[u]]);
+    }
+    pImpl->mBins = bins;
+    pImpl->mBuffer.resize(static_cast<size_t> (nChannels)*windowLength);
+    pImpl->mState.resize(static_cast<size_t> (nChannels)
+                        *pImpl->mTracked.size());
+    pImpl->mWindowLength = windowLength;
+    pImpl->mChannels = nChannels;
+    pImpl->resetInitialConditions();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool SlidingDFT<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Window length
+template<class T>
+int SlidingDFT<T>::getWindowLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowLength;
+}
+
+/// Number of bins
+template<class T>
+int SlidingDFT<T>::getNumberOfBins() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return static_cast<int> (pImpl->mBins.size());
+}
+
+/// Number of channels
+template<class T>
+int SlidingDFT<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Reset
+template<class T>
+void SlidingDFT<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Transform
+template<class T>
+void SlidingDFT<T>::transform(const int nSamples, const T x[],
+                              std::complex<T> *yIn[])
+{
+    if (nSamples <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::complex<T> *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    pImpl->transform(nSamples, x, y);
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::SlidingDFT<double>;
+template class RTSeis::Transforms::SlidingDFT<float>;
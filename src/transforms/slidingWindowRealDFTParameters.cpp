@@ -123,28 +123,32 @@ void SlidingWindowRealDFTParameters::setWindow(
     // Resize 
     pImpl->mDFTLength = windowLength; 
     pImpl->mWindowType = windowType;
-    pImpl->mWindow.resize(windowLength);
-    // Create window
-    double *windowPtr = pImpl->mWindow.data();
+    // Create window.  The predefined windows are shared through the cache.
+    namespace WindowFunctions = Utilities::WindowFunctions;
     if (windowType == SlidingWindowType::HAMMING)
     {
-        Utilities::WindowFunctions::hamming(windowLength, &windowPtr);
+        pImpl->mWindow = *WindowFunctions::getCachedWindow<double>
+                         (WindowFunctions::WindowType::HAMMING, windowLength);
     }
     else if (windowType == SlidingWindowType::HANN)
     {
-        Utilities::WindowFunctions::hann(windowLength, &windowPtr);
+        pImpl->mWindow = *WindowFunctions::getCachedWindow<double>
+                         (WindowFunctions::WindowType::HANN, windowLength);
     }
     else if (windowType == SlidingWindowType::BLACKMAN)
     {
-        Utilities::WindowFunctions::blackman(windowLength, &windowPtr);
+        pImpl->mWindow = *WindowFunctions::getCachedWindow<double>
+                         (WindowFunctions::WindowType::BLACKMAN, windowLength);
     }
     else if (windowType == SlidingWindowType::BARTLETT)
     {
-        Utilities::WindowFunctions::bartlett(windowLength, &windowPtr);
+        pImpl->mWindow = *WindowFunctions::getCachedWindow<double>
+                         (WindowFunctions::WindowType::BARTLETT, windowLength);
     }
     else if (windowType == SlidingWindowType::BOXCAR)
     {
-        ippsSet_64f(1.0, windowPtr, windowLength);
+        pImpl->mWindow.resize(windowLength);
+        ippsSet_64f(1.0, pImpl->mWindow.data(), windowLength);
     }
 #ifndef NDEBUG
     else
@@ -0,0 +1,305 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/transforms/stationaryWavelet.hpp"
+#include "private/discreteWavelets.hpp"
+
+using namespace RTSeis::Transforms;
+
+template<RTSeis::ProcessingMode E, class T>
+class StationaryWavelet<E, T>::StationaryWaveletImpl
+{
+public:
+    /// Applies the filters of level j to the n samples of v.  The workspace
+    /// holds the D = 2^{j-1} (nh - 1) samples preceding v followed by v.
+    /// These are either the periodic extension of v or the delay line.
+    /// The filter taps are looped over in the outer loop so that the inner
+    /// loop over time is unit stride.
+    void analysis(const int j, const int n, const T v[], T vOut[], T w[])
+    {
+        const int nh = static_cast<int> (mScaling.size());
+        const int stride = 1 << (j - 1);
+        const int nDelay = stride*(nh - 1);
+        mExtended.resize(static_cast<size_t> (nDelay + n));
+        auto ext = mExtended.data();
+        if (mMode == RTSeis::ProcessingMode::POST)
+        {
+            for (int i = 0; i < nDelay; ++i)
+            {
+                auto k = ((i - nDelay)%n + n)%n;
+                ext[i] = v[k];
+            }
+        }
+        else
+        {
+            std::copy(mDelayLines[j - 1].begin(), mDelayLines[j - 1].end(),
+                      ext);
+        }
+        std::copy(v, v + n, ext + nDelay);
+        std::fill(vOut, vOut + n, 0);
+        std::fill(w, w + n, 0);
+        for (int l = 0; l < nh; ++l)
+        {
+            const T hl = mScaling[l];
+            const T gl = mWavelet[l];
+            const auto el = ext + nDelay - stride*l;
+            #pragma omp simd
+            for (int t = 0; t < n; ++t)
+            {
+                vOut[t] = vOut[t] + hl*el[t];
+                w[t] = w[t] + gl*el[t];
+            }
+        }
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME && nDelay > 0)
+        {
+            std::copy(ext + n, ext + n + nDelay, mDelayLines[j - 1].begin());
+        }
+    }
+    /// Inverts level j of the periodized transform.  This is the adjoint of
+    /// analysis so the workspaces hold v and w followed by their first
+    /// D samples.
+    void synthesis(const int j, const int n, const T v[], const T w[],
+                   T vOut[])
+    {
+        const int nh = static_cast<int> (mScaling.size());
+        const int stride = 1 << (j - 1);
+        const int nDelay = stride*(nh - 1);
+        mExtended.resize(static_cast<size_t> (n + nDelay));
+        mExtendedWavelet.resize(static_cast<size_t> (n + nDelay));
+        auto extV = mExtended.data();
+        auto extW = mExtendedWavelet.data();
+        for (int i = 0; i < n + nDelay; ++i)
+        {
+            extV[i] = v[i%n];
+            extW[i] = w[i%n];
+        }
+        std::fill(vOut, vOut + n, 0);
+        for (int l = 0; l < nh; ++l)
+        {
+            const T hl = mScaling[l];
+            const T gl = mWavelet[l];
+            const auto vl = extV + stride*l;
+            const auto wl = extW + stride*l;
+            #pragma omp simd
+            for (int t = 0; t < n; ++t)
+            {
+                vOut[t] = vOut[t] + hl*vl[t] + gl*wl[t];
+            }
+        }
+    }
+    /// The rescaled scaling filter
+    std::vector<T> mScaling;
+    /// The rescaled wavelet filter
+    std::vector<T> mWavelet;
+    /// The delay line of each level in real-time mode
+    std::vector<std::vector<T>> mDelayLines;
+    /// Workspaces
+    std::vector<T> mExtended;
+    std::vector<T> mExtendedWavelet;
+    std::vector<T> mApproximation;
+    std::vector<T> mWork;
+    int mLevels = 0;
+    const RTSeis::ProcessingMode mMode = E;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+StationaryWavelet<E, T>::StationaryWavelet() :
+    pImpl(std::make_unique<StationaryWaveletImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+StationaryWavelet<E, T>::StationaryWavelet(const StationaryWavelet &swt)
+{
+    *this = swt;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+StationaryWavelet<E, T>::StationaryWavelet(StationaryWavelet &&swt) noexcept
+{
+    *this = std::move(swt);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+StationaryWavelet<E, T>&
+StationaryWavelet<E, T>::operator=(const StationaryWavelet &swt)
+{
+    if (&swt == this){return *this;}
+    pImpl = std::make_unique<StationaryWaveletImpl> (*swt.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+StationaryWavelet<E, T>&
+StationaryWavelet<E, T>::operator=(StationaryWavelet &&swt) noexcept
+{
+    if (&swt == this){return *this;}
+    pImpl = std::move(swt.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+StationaryWavelet<E, T>::~StationaryWavelet() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void StationaryWavelet<E, T>::clear() noexcept
+{
+    pImpl->mScaling.clear();
+    pImpl->mWavelet.clear();
+    pImpl->mDelayLines.clear();
+    pImpl->mExtended.clear();
+    pImpl->mExtendedWavelet.clear();
+    pImpl->mApproximation.clear();
+    pImpl->mWork.clear();
+    pImpl->mLevels = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void StationaryWavelet<E, T>::initialize(const DiscreteWaveletFamily family,
+                                         const int order,
+                                         const int nLevels)
+{
+    clear();
+    if (nLevels < 1)
+    {
+        throw std::invalid_argument("nLevels = " + std::to_string(nLevels)
+                                  + " must be positive");
+    }
+    auto h = ::getScalingFilter(family, order); // Throws
+    auto nh = static_cast<int> (h.size());
+    pImpl->mScaling.resize(nh);
+    pImpl->mWavelet.resize(nh);
+    const double scale = 1/std::sqrt(2.0);
+    for (int l = 0; l < nh; ++l)
+    {
+        pImpl->mScaling[l] = static_cast<T> (scale*h[l]);
+        auto sign = (l%2 == 0) ? 1 : -1;
+        pImpl->mWavelet[l] = static_cast<T> (sign*scale*h[nh - 1 - l]);
+    }
+    pImpl->mDelayLines.resize(nLevels);
+    for (int j = 1; j <= nLevels; ++j)
+    {
+        auto nDelay = (1 << (j - 1))*(nh - 1);
+        pImpl->mDelayLines[j - 1].assign(nDelay, 0);
+    }
+    pImpl->mLevels = nLevels;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool StationaryWavelet<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of levels
+template<RTSeis::ProcessingMode E, class T>
+int StationaryWavelet<E, T>::getNumberOfLevels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mLevels;
+}
+
+/// Transient length
+template<RTSeis::ProcessingMode E, class T>
+int StationaryWavelet<E, T>::getTransientLength() const
+{
+    auto nLevels = getNumberOfLevels(); // Throws
+    auto nh = static_cast<int> (pImpl->mScaling.size());
+    return ((1 << nLevels) - 1)*(nh - 1);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void StationaryWavelet<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    for (auto &delayLine : pImpl->mDelayLines)
+    {
+        std::fill(delayLine.begin(), delayLine.end(), 0);
+    }
+}
+
+/// Forward transform
+template<RTSeis::ProcessingMode E, class T>
+void StationaryWavelet<E, T>::forwardTransform(const int n, const T x[],
+                                               T *coefficientsIn[])
+{
+    auto nLevels = getNumberOfLevels(); // Throws
+    if (n <= 0){return;} // Nothing to do
+    T *coefficients = *coefficientsIn;
+    if (x == nullptr || coefficients == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("coefficients is NULL");
+    }
+    pImpl->mApproximation.assign(x, x + n);
+    pImpl->mWork.resize(n);
+    for (int j = 1; j <= nLevels; ++j)
+    {
+        auto w = coefficients + static_cast<size_t> (j - 1)*n;
+        pImpl->analysis(j, n, pImpl->mApproximation.data(),
+                        pImpl->mWork.data(), w);
+        std::swap(pImpl->mApproximation, pImpl->mWork);
+    }
+    std::copy(pImpl->mApproximation.begin(), pImpl->mApproximation.end(),
+              coefficients + static_cast<size_t> (nLevels)*n);
+}
+
+/// Inverse transform
+template<RTSeis::ProcessingMode E, class T>
+void StationaryWavelet<E, T>::inverseTransform(const int n,
+                                               const T coefficients[],
+                                               T *xIn[])
+{
+    auto nLevels = getNumberOfLevels(); // Throws
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+    {
+        throw std::runtime_error(
+            "Inverse transform is only available in post-processing mode");
+    }
+    if (n <= 0){return;} // Nothing to do
+    T *x = *xIn;
+    if (coefficients == nullptr || x == nullptr)
+    {
+        if (coefficients == nullptr)
+        {
+            throw std::invalid_argument("coefficients is NULL");
+        }
+        throw std::invalid_argument("x is NULL");
+    }
+    auto vL = coefficients + static_cast<size_t> (nLevels)*n;
+    pImpl->mApproximation.assign(vL, vL + n);
+    pImpl->mWork.resize(n);
+    for (int j = nLevels; j >= 1; --j)
+    {
+        auto w = coefficients + static_cast<size_t> (j - 1)*n;
+        pImpl->synthesis(j, n, pImpl->mApproximation.data(), w,
+                         pImpl->mWork.data());
+        std::swap(pImpl->mApproximation, pImpl->mWork);
+    }
+    std::copy(pImpl->mApproximation.begin(), pImpl->mApproximation.end(), x);
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::StationaryWavelet<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Transforms::StationaryWavelet<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Transforms::StationaryWavelet<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Transforms::StationaryWavelet<RTSeis::ProcessingMode::REAL_TIME, float>;
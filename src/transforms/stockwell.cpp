@@ -0,0 +1,465 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/transforms/stockwell.hpp"
+
+using namespace RTSeis::Transforms;
+
+namespace
+{
+/// Number of voices inverse transformed by one batched DFT
+constexpr int BATCH_SIZE = 8;
+/// The Gaussian is truncated where it falls below exp(-30)
+const double GAUSSIAN_WIDTH = std::sqrt(30/(2*M_PI*M_PI));
+}
+
+template<class T>
+class Stockwell<T>::StockwellImpl
+{
+public:
+    StockwellImpl() = default;
+    /// The plans are rebuilt rather than copied
+    StockwellImpl(const StockwellImpl &st) :
+        mTransform(st.mTransform),
+        mAmplitude(st.mAmplitude),
+        mVoices(st.mVoices),
+        mSamplingRate(st.mSamplingRate),
+        mSamples(st.mSamples),
+        mAmplitudeOnly(st.mAmplitudeOnly),
+        mHaveTransform(st.mHaveTransform),
+        mInitialized(st.mInitialized)
+    {
+        if (mInitialized){makePlans();}
+    }
+    StockwellImpl& operator=(const StockwellImpl &) = delete;
+    ~StockwellImpl()
+    {
+        releasePlans();
+    }
+    void releasePlans() noexcept
+    {
+        if (mHavePlans)
+        {
+            fftw_destroy_plan(mForwardPlan);
+            fftw_destroy_plan(mInversePlan);
+        }
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mHalfSpectrum != nullptr){fftw_free(mHalfSpectrum);}
+        mInData = nullptr;
+        mHalfSpectrum = nullptr;
+        mSpectrum.clear();
+        mHavePlans = false;
+    }
+    /// The forward plan transforms the signal once.  The inverse plan
+    /// transforms a batch of voices and is executed on per-thread buffers.
+    void makePlans()
+    {
+        releasePlans();
+        const int n = mSamples;
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (n)*sizeof(double)));
+        mHalfSpectrum = reinterpret_cast<fftw_complex *>
+                        (fftw_malloc(static_cast<size_t> (n/2 + 1)
+                                    *sizeof(fftw_complex)));
+        mForwardPlan = fftw_plan_dft_r2c_1d(n, mInData, mHalfSpectrum,
+                                            FFTW_ESTIMATE);
+        auto nBatch = static_cast<size_t> (BATCH_SIZE)*n;
+        auto in = reinterpret_cast<fftw_complex *>
+                  (fftw_malloc(nBatch*sizeof(fftw_complex)));
+        auto out = reinterpret_cast<fftw_complex *>
+                   (fftw_malloc(nBatch*sizeof(fftw_complex)));
+        int nInverse[1] = {n};
+        mInversePlan = fftw_plan_many_dft(1, nInverse, BATCH_SIZE,
+                                          in, nullptr, 1, n,
+                                          out, nullptr, 1, n,
+                                          FFTW_BACKWARD, FFTW_ESTIMATE);
+        fftw_free(in);
+        fftw_free(out);
+        mSpectrum.resize(n);
+        mHavePlans = true;
+    }
+    /// Fills the shifted and Gaussian weighted spectrum of a voice
+    void fillVoice(const int voice, fftw_complex *row) const
+    {
+        const int n = mSamples;
+        std::fill(reinterpret_cast<double *> (row),
+                  reinterpret_cast<double *> (row) + 2*n, 0.0);
+        if (voice == 0)
+        {
+            // The Gaussian collapses to a spike so the voice is the mean
+            row[0][0] = std::real(mSpectrum[0]);
+            row[0][1] = std::imag(mSpectrum[0]);
+            return;
+        }
+        auto mMax = static_cast<int> (std::ceil(GAUSSIAN_WIDTH*voice));
+        auto mLow = std::min(mMax, (n - 1)/2);
+        auto mHigh = std::min(mMax, n/2);
+        auto factor =-2*M_PI*M_PI/(static_cast<double> (voice)*voice);
+        for (int m =-mLow; m <= mHigh; ++m)
+        {
+            auto g = std::exp(factor*static_cast<double> (m)*m);
+            auto x = mSpectrum[(m + voice + n)%n]*g;
+            auto k = (m + n)%n;
+            row[k][0] = std::real(x);
+            row[k][1] = std::imag(x);
+        }
+    }
+    void transform(const T x[])
+    {
+        const int n = mSamples;
+        std::copy(x, x + n, mInData);
+        fftw_execute(mForwardPlan);
+        // Expand the spectrum of the real signal
+        for (int k = 0; k < n/2 + 1; ++k)
+        {
+            mSpectrum[k] = std::complex<double> (mHalfSpectrum[k][0],
+                                                 mHalfSpectrum[k][1]);
+        }
+        for (int k = n/2 + 1; k < n; ++k)
+        {
+            mSpectrum[k] = std::conj(mSpectrum[n - k]);
+        }
+        const int nVoices = static_cast<int> (mVoices.size());
+        const int nBatches = (nVoices + BATCH_SIZE - 1)/BATCH_SIZE;
+        const double xnorm = 1.0/static_cast<double> (n);
+        #pragma omp parallel default(shared)
+        {
+        auto nBatch = static_cast<size_t> (BATCH_SIZE)*n;
+        auto in = reinterpret_cast<fftw_complex *>
+                  (fftw_malloc(nBatch*sizeof(fftw_complex)));
+        auto out = reinterpret_cast<fftw_complex *>
+                   (fftw_malloc(nBatch*sizeof(fftw_complex)));
+        std::fill(reinterpret_cast<double *> (in),
+                  reinterpret_cast<double *> (in) + 2*nBatch, 0.0);
+        #pragma omp for schedule(dynamic)
+        for (int ib = 0; ib < nBatches; ++ib)
+        {
+            auto i1 = ib*BATCH_SIZE;
+            auto i2 = std::min(nVoices, i1 + BATCH_SIZE);
+            for (int iv = i1; iv < i2; ++iv)
+            {
+                fillVoice(mVoices[iv],
+                          in + static_cast<size_t> (iv - i1)*n);
+            }
+            fftw_execute_dft(mInversePlan, in, out);
+            for (int iv = i1; iv < i2; ++iv)
+            {
+                const fftw_complex *row = out + static_cast<size_t> (iv - i1)*n;
+                if (mAmplitudeOnly)
+                {
+                    T *amplitude = mAmplitude.data()
+                                 + static_cast<size_t> (iv)*n;
+                    for (int j = 0; j < n; ++j)
+                    {
+                        amplitude[j] = static_cast<T>
+                            (xnorm*std::hypot(row[j][0], row[j][1]));
+                    }
+                }
+                else
+                {
+                    std::complex<T> *st = mTransform.data()
+                                        + static_cast<size_t> (iv)*n;
+                    for (int j = 0; j < n; ++j)
+                    {
+                        st[j] = std::complex<T>
+                                (static_cast<T> (xnorm*row[j][0]),
+                                 static_cast<T> (xnorm*row[j][1]));
+                    }
+                }
+            }
+        }
+        fftw_free(in);
+        fftw_free(out);
+        } // End parallel
+    }
+    /// The [nVoices x nSamples] transform
+    std::vector<std::complex<T>> mTransform;
+    /// The [nVoices x nSamples] amplitude of the transform
+    std::vector<T> mAmplitude;
+    /// The frequency indices of the voices
+    std::vector<int> mVoices;
+    /// The full spectrum of the signal
+    std::vector<std::complex<double>> mSpectrum;
+    fftw_plan mForwardPlan;
+    fftw_plan mInversePlan;
+    double *mInData = nullptr;
+    fftw_complex *mHalfSpectrum = nullptr;
+    double mSamplingRate = 1;
+    int mSamples = 0;
+    bool mAmplitudeOnly = false;
+    bool mHavePlans = false;
+    bool mHaveTransform = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+Stockwell<T>::Stockwell() :
+    pImpl(std::make_unique<StockwellImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+Stockwell<T>::Stockwell(const Stockwell &stockwell)
+{
+    *this = stockwell;
+}
+
+/// Move c'tor
+template<class T>
+Stockwell<T>::Stockwell(Stockwell &&stockwell) noexcept
+{
+    *this = std::move(stockwell);
+}
+
+/// Copy assignment
+template<class T>
+Stockwell<T>& Stockwell<T>::operator=(const Stockwell &stockwell)
+{
+    if (&stockwell == this){return *this;}
+    pImpl = std::make_unique<StockwellImpl> (*stockwell.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+Stockwell<T>& Stockwell<T>::operator=(Stockwell &&stockwell) noexcept
+{
+    if (&stockwell == this){return *this;}
+    pImpl = std::move(stockwell.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+Stockwell<T>::~Stockwell() = default;
+
+/// Clear
+template<class T>
+void Stockwell<T>::clear() noexcept
+{
+    pImpl = std::make_unique<StockwellImpl> ();
+}
+
+/// Initialize
+template<class T>
+void Stockwell<T>::initialize(const int nSamples,
+                              const double samplingRate,
+                              const double minFrequency,
+                              const double maxFrequency,
+                              const int frequencyDecimation,
+                              const bool amplitudeOnly)
+{
+    clear();
+    if (nSamples < 2)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must be at least 2");
+    }
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (frequencyDecimation < 1)
+    {
+        throw std::invalid_argument("frequencyDecimation = "
+                                  + std::to_string(frequencyDecimation)
+                                  + " must be positive");
+    }
+    auto nyquist = samplingRate/2;
+    auto fMax = maxFrequency;
+    if (fMax < 0){fMax = nyquist;}
+    if (minFrequency < 0 || fMax > nyquist)
+    {
+        throw std::invalid_argument("Frequencies must be in range [0,"
+                                  + std::to_string(nyquist) + "]");
+    }
+    if (minFrequency > fMax)
+    {
+        throw std::invalid_argument("minFrequency = "
+                                  + std::to_string(minFrequency)
+                                  + " cannot exceed maxFrequency = "
+                                  + std::to_string(fMax));
+    }
+    auto df = samplingRate/static_cast<double> (nSamples);
+    auto voice1 = static_cast<int> (std::lround(minFrequency/df));
+    auto voice2 = static_cast<int> (std::lround(fMax/df));
+    voice2 = std::min(voice2, nSamples/2);
+    for (int voice = voice1; voice <= voice2; voice = voice + frequencyDecimation)
+    {
+        pImpl->mVoices.push_back(voice);
+    }
+    auto nOut = pImpl->mVoices.size()*static_cast<size_t> (nSamples);
+    if (amplitudeOnly)
+    {
+        pImpl->mAmplitude.resize(nOut, 0);
+    }
+    else
+    {
+        pImpl->mTransform.resize(nOut, 0);
+    }
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mSamples = nSamples;
+    pImpl->mAmplitudeOnly = amplitudeOnly;
+    pImpl->makePlans();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool Stockwell<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of samples
+template<class T>
+int Stockwell<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamples;
+}
+
+/// Number of frequencies
+template<class T>
+int Stockwell<T>::getNumberOfFrequencies() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return static_cast<int> (pImpl->mVoices.size());
+}
+
+/// Frequencies
+template<class T>
+std::vector<T> Stockwell<T>::getFrequencies() const
+{
+    auto nFrequencies = getNumberOfFrequencies(); // Throws
+    auto df = pImpl->mSamplingRate/static_cast<double> (pImpl->mSamples);
+    std::vector<T> frequencies(nFrequencies);
+    for (int i = 0; i < nFrequencies; ++i)
+    {
+        frequencies[i] = static_cast<T> (pImpl->mVoices[i]*df);
+    }
+    return frequencies;
+}
+
+/// Sampling rate
+template<class T>
+double Stockwell<T>::getSamplingRate() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamplingRate;
+}
+
+/// Amplitude only?
+template<class T>
+bool Stockwell<T>::isAmplitudeOnly() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mAmplitudeOnly;
+}
+
+/// Transform
+template<class T>
+void Stockwell<T>::transform(const int n, const T x[])
+{
+    pImpl->mHaveTransform = false;
+    auto nSamples = getNumberOfSamples(); // Throws
+    if (n != nSamples)
+    {
+        throw std::invalid_argument("Number of samples in x = "
+                                  + std::to_string(n) + " must equal "
+                                  + std::to_string(nSamples));
+    }
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    pImpl->transform(x);
+    pImpl->mHaveTransform = true;
+}
+
+/// Have transform?
+template<class T>
+bool Stockwell<T>::haveTransform() const noexcept
+{
+    return pImpl->mHaveTransform;
+}
+
+/// Get the transform
+template<class T>
+void Stockwell<T>::getTransform(const int nSamples, const int nFrequencies,
+                                std::complex<T> *stOut[]) const
+{
+    if (!haveTransform())
+    {
+        throw std::runtime_error("Transform not yet computed");
+    }
+    if (pImpl->mAmplitudeOnly)
+    {
+        throw std::runtime_error("Only the amplitude was stored");
+    }
+    auto n = getNumberOfSamples();
+    auto nf = getNumberOfFrequencies();
+    if (n != nSamples)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must equal " + std::to_string(n));
+    }
+    if (nf != nFrequencies)
+    {
+        throw std::invalid_argument("nFrequencies = "
+                                  + std::to_string(nFrequencies)
+                                  + " must equal " + std::to_string(nf));
+    }
+    auto st = *stOut;
+    if (st == nullptr){throw std::invalid_argument("st is NULL");}
+    std::copy(pImpl->mTransform.begin(), pImpl->mTransform.end(), st);
+}
+
+/// Get the amplitude of the transform
+template<class T>
+void Stockwell<T>::getAmplitudeTransform(const int nSamples,
+                                         const int nFrequencies,
+                                         T *amplitudeOut[]) const
+{
+    if (!haveTransform())
+    {
+        throw std::runtime_error("Transform not yet computed");
+    }
+    auto n = getNumberOfSamples();
+    auto nf = getNumberOfFrequencies();
+    if (n != nSamples)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must equal " + std::to_string(n));
+    }
+    if (nf != nFrequencies)
+    {
+        throw std::invalid_argument("nFrequencies = "
+                                  + std::to_string(nFrequencies)
+                                  + " must equal " + std::to_string(nf));
+    }
+    auto amplitude = *amplitudeOut;
+    if (amplitude == nullptr){throw std::invalid_argument("amplitude is NULL");}
+    if (pImpl->mAmplitudeOnly)
+    {
+        std::copy(pImpl->mAmplitude.begin(), pImpl->mAmplitude.end(),
+                  amplitude);
+        return;
+    }
+    std::transform(pImpl->mTransform.begin(), pImpl->mTransform.end(),
+                   amplitude,
+                   [](const std::complex<T> &z){return std::abs(z);});
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::Stockwell<double>;
+template class RTSeis::Transforms::Stockwell<float>;
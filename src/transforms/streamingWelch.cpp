@@ -0,0 +1,504 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/transforms/streamingWelch.hpp"
+#include "rtseis/transforms/slidingWindowRealDFTParameters.hpp"
+#include "rtseis/filterImplementations/detrend.hpp"
+
+using namespace RTSeis::Transforms;
+
+template<class T>
+class StreamingWelch<T>::StreamingWelchImpl
+{
+public:
+    StreamingWelchImpl() = default;
+    /// The plan is rebuilt rather than copied
+    StreamingWelchImpl(const StreamingWelchImpl &welch) :
+        mBuffer(welch.mBuffer),
+        mWindow(welch.mWindow),
+        mAverage(welch.mAverage),
+        mHistory(welch.mHistory),
+        mSum(welch.mSum),
+        mSpectrumScaling(welch.mSpectrumScaling),
+        mDensityScaling(welch.mDensityScaling),
+        mSamplingRate(welch.mSamplingRate),
+        mDetrendType(welch.mDetrendType),
+        mAveraging(welch.mAveraging),
+        mChannels(welch.mChannels),
+        mWindowLength(welch.mWindowLength),
+        mOverlap(welch.mOverlap),
+        mDFTLength(welch.mDFTLength),
+        mAveragingLength(welch.mAveragingLength),
+        mFill(welch.mFill),
+        mSegments(welch.mSegments),
+        mHistoryIndex(welch.mHistoryIndex),
+        mInitialized(welch.mInitialized)
+    {
+        if (mInitialized){makePlan();}
+    }
+    StreamingWelchImpl& operator=(const StreamingWelchImpl &) = delete;
+    ~StreamingWelchImpl()
+    {
+        releasePlan();
+    }
+    void releasePlan() noexcept
+    {
+        if (mHavePlan){fftw_destroy_plan(mPlan);}
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mOutData != nullptr){fftw_free(mOutData);}
+        mInData = nullptr;
+        mOutData = nullptr;
+        mHavePlan = false;
+    }
+    /// One batched plan transforms the current segment of every channel
+    void makePlan()
+    {
+        releasePlan();
+        auto nFrequencies = getNumberOfFrequencies();
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (mChannels)*mDFTLength
+                               *sizeof(double)));
+        mOutData = reinterpret_cast<fftw_complex *>
+                   (fftw_malloc(static_cast<size_t> (mChannels)*nFrequencies
+                                *sizeof(fftw_complex)));
+        int nForward[1] = {mDFTLength};
+        mPlan = fftw_plan_many_dft_r2c(1, nForward, mChannels,
+                                       mInData, nullptr, 1, mDFTLength,
+                                       mOutData, nullptr, 1, nFrequencies,
+                                       FFTW_ESTIMATE);
+        mHavePlan = true;
+    }
+    [[nodiscard]] int getNumberOfFrequencies() const noexcept
+    {
+        return mDFTLength/2 + 1;
+    }
+    void resetInitialConditions()
+    {
+        std::fill(mBuffer.begin(), mBuffer.end(), 0);
+        std::fill(mAverage.begin(), mAverage.end(), 0);
+        std::fill(mHistory.begin(), mHistory.end(), 0);
+        std::fill(mSum.begin(), mSum.end(), 0);
+        mFill = 0;
+        mSegments = 0;
+        mHistoryIndex = 0;
+    }
+    /// Transforms the full segment buffers and updates the averages
+    void processSegment()
+    {
+        const int nFrequencies = getNumberOfFrequencies();
+        for (int c = 0; c < mChannels; ++c)
+        {
+            const double *segment = mBuffer.data()
+                                  + static_cast<size_t> (c)*mWindowLength;
+            double *in = mInData + static_cast<size_t> (c)*mDFTLength;
+            if (mDetrendType == SlidingWindowDetrendType::REMOVE_MEAN)
+            {
+                double mean;
+                RTSeis::FilterImplementations::removeMean(mWindowLength,
+                                                          segment, &in, &mean);
+            }
+            else if (mDetrendType == SlidingWindowDetrendType::REMOVE_TREND)
+            {
+                double intercept;
+                double slope;
+                RTSeis::FilterImplementations::removeTrend(mWindowLength,
+                                                           segment, &in,
+                                                           &intercept, &slope);
+            }
+            else
+            {
+                std::copy(segment, segment + mWindowLength, in);
+            }
+            #pragma omp simd
+            for (int i = 0; i < mWindowLength; ++i)
+            {
+                in[i] = in[i]*mWindow[i];
+            }
+            std::fill(in + mWindowLength, in + mDFTLength, 0);
+        }
+        fftw_execute(mPlan);
+        mSegments = mSegments + 1;
+        // Fold the periodograms into the averages
+        auto weight = std::max(1.0/static_cast<double> (mSegments),
+                               1.0/static_cast<double> (mAveragingLength));
+        bool recompute = false;
+        if (mAveraging == WelchAverageType::SLIDING)
+        {
+            // Refresh the sums from the history periodically to bound the
+            // round-off from the subtractions
+            recompute = (mHistoryIndex == mAveragingLength - 1);
+        }
+        auto nAveraged = std::min(mSegments, mAveragingLength);
+        for (int c = 0; c < mChannels; ++c)
+        {
+            const fftw_complex *out = mOutData
+                                    + static_cast<size_t> (c)*nFrequencies;
+            double *average = mAverage.data()
+                            + static_cast<size_t> (c)*nFrequencies;
+            if (mAveraging == WelchAverageType::EXPONENTIAL)
+            {
+                #pragma omp simd
+                for (int k = 0; k < nFrequencies; ++k)
+                {
+                    auto power = out[k][0]*out[k][0] + out[k][1]*out[k][1];
+                    average[k] = average[k] + weight*(power - average[k]);
+                }
+            }
+            else
+            {
+                double *sum = mSum.data() + static_cast<size_t> (c)*nFrequencies;
+                double *history = mHistory.data()
+                                + (static_cast<size_t> (c)*mAveragingLength
+                                  + mHistoryIndex)*nFrequencies;
+                for (int k = 0; k < nFrequencies; ++k)
+                {
+                    auto power = out[k][0]*out[k][0] + out[k][1]*out[k][1];
+                    sum[k] = sum[k] - history[k] + power;
+                    history[k] = power;
+                }
+                if (recompute)
+                {
+                    std::fill(sum, sum + nFrequencies, 0);
+                    for (int j = 0; j < mAveragingLength; ++j)
+                    {
+                        const double *hj = mHistory.data()
+                            + (static_cast<size_t> (c)*mAveragingLength + j)
+                             *nFrequencies;
+                        for (int k = 0; k < nFrequencies; ++k)
+                        {
+                            sum[k] = sum[k] + hj[k];
+                        }
+                    }
+                }
+                auto xnorm = 1.0/static_cast<double> (nAveraged);
+                for (int k = 0; k < nFrequencies; ++k)
+                {
+                    average[k] = sum[k]*xnorm;
+                }
+            }
+        }
+        if (mAveraging == WelchAverageType::SLIDING)
+        {
+            mHistoryIndex = (mHistoryIndex + 1)%mAveragingLength;
+        }
+        // Retain the overlap for the next segment
+        const int shift = mWindowLength - mOverlap;
+        for (int c = 0; c < mChannels; ++c)
+        {
+            double *segment = mBuffer.data()
+                            + static_cast<size_t> (c)*mWindowLength;
+            std::copy(segment + shift, segment + mWindowLength, segment);
+        }
+        mFill = mOverlap;
+    }
+    void transform(const int n, const T x[])
+    {
+        int i0 = 0;
+        while (i0 < n)
+        {
+            auto nCopy = std::min(mWindowLength - mFill, n - i0);
+            for (int c = 0; c < mChannels; ++c)
+            {
+                const T *xc = x + static_cast<size_t> (c)*n + i0;
+                double *segment = mBuffer.data()
+                                + static_cast<size_t> (c)*mWindowLength;
+                std::copy(xc, xc + nCopy, segment + mFill);
+            }
+            mFill = mFill + nCopy;
+            i0 = i0 + nCopy;
+            if (mFill == mWindowLength){processSegment();}
+        }
+    }
+    /// The [nChannels x windowLength] segment buffers
+    std::vector<double> mBuffer;
+    /// The window function
+    std::vector<double> mWindow;
+    /// The [nChannels x nFrequencies] averaged periodograms
+    std::vector<double> mAverage;
+    /// The [nChannels x averagingLength x nFrequencies] recent periodograms
+    /// for the sliding average
+    std::vector<double> mHistory;
+    /// The [nChannels x nFrequencies] sums of the recent periodograms
+    std::vector<double> mSum;
+    fftw_plan mPlan;
+    double *mInData = nullptr;
+    fftw_complex *mOutData = nullptr;
+    double mSpectrumScaling = 1;
+    double mDensityScaling = 1;
+    double mSamplingRate = 1;
+    SlidingWindowDetrendType mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
+    WelchAverageType mAveraging = WelchAverageType::EXPONENTIAL;
+    int mChannels = 0;
+    int mWindowLength = 0;
+    int mOverlap = 0;
+    int mDFTLength = 0;
+    int mAveragingLength = 1;
+    /// Number of samples in the current segment
+    int mFill = 0;
+    int mSegments = 0;
+    int mHistoryIndex = 0;
+    bool mHavePlan = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+StreamingWelch<T>::StreamingWelch() :
+    pImpl(std::make_unique<StreamingWelchImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+StreamingWelch<T>::StreamingWelch(const StreamingWelch &welch)
+{
+    *this = welch;
+}
+
+/// Move c'tor
+template<class T>
+StreamingWelch<T>::StreamingWelch(StreamingWelch &&welch) noexcept
+{
+    *this = std::move(welch);
+}
+
+/// Copy assignment
+template<class T>
+StreamingWelch<T>& StreamingWelch<T>::operator=(const StreamingWelch &welch)
+{
+    if (&welch == this){return *this;}
+    pImpl = std::make_unique<StreamingWelchImpl> (*welch.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+StreamingWelch<T>&
+StreamingWelch<T>::operator=(StreamingWelch &&welch) noexcept
+{
+    if (&welch == this){return *this;}
+    pImpl = std::move(welch.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+StreamingWelch<T>::~StreamingWelch() = default;
+
+/// Clear
+template<class T>
+void StreamingWelch<T>::clear() noexcept
+{
+    pImpl = std::make_unique<StreamingWelchImpl> ();
+}
+
+/// Initialize
+template<class T>
+void StreamingWelch<T>::initialize(
+    const SlidingWindowRealDFTParameters &parameters,
+    const double samplingRate,
+    const int nChannels,
+    const WelchAverageType averaging,
+    const int averagingLength)
+{
+    clear();
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (averagingLength < 1)
+    {
+        throw std::invalid_argument("averagingLength = "
+                                  + std::to_string(averagingLength)
+                                  + " must be positive");
+    }
+    std::vector<double> window;
+    try
+    {
+        window = parameters.getWindow();
+    }
+    catch (const std::exception &e)
+    {
+        throw std::invalid_argument("Window not set on parameters");
+    }
+    auto windowLength = static_cast<int> (window.size());
+    if (windowLength < 1)
+    {
+        throw std::invalid_argument("Window not set on parameters");
+    }
+    auto dftLength = parameters.getDFTLength();
+    auto nFrequencies = dftLength/2 + 1;
+    // Same normalization as Welch
+    double wsum = 0;
+    double wsum2 = 0;
+    for (const auto &w : window)
+    {
+        wsum = wsum + w;
+        wsum2 = wsum2 + w*w;
+    }
+    pImpl->mSpectrumScaling = samplingRate*wsum2;
+    pImpl->mDensityScaling = wsum*wsum;
+    pImpl->mWindow = std::move(window);
+    pImpl->mBuffer.resize(static_cast<size_t> (nChannels)*windowLength);
+    pImpl->mAverage.resize(static_cast<size_t> (nChannels)*nFrequencies);
+    if (averaging == WelchAverageType::SLIDING)
+    {
+        pImpl->mHistory.resize(static_cast<size_t> (nChannels)
+                              *averagingLength*nFrequencies);
+        pImpl->mSum.resize(static_cast<size_t> (nChannels)*nFrequencies);
+    }
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mDetrendType = parameters.getDetrendType();
+    pImpl->mAveraging = averaging;
+    pImpl->mChannels = nChannels;
+    pImpl->mWindowLength = windowLength;
+    pImpl->mOverlap = parameters.getNumberOfSamplesInOverlap();
+    pImpl->mDFTLength = dftLength;
+    pImpl->mAveragingLength = averagingLength;
+    pImpl->resetInitialConditions();
+    pImpl->makePlan();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool StreamingWelch<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<class T>
+int StreamingWelch<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Number of frequencies
+template<class T>
+int StreamingWelch<T>::getNumberOfFrequencies() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->getNumberOfFrequencies();
+}
+
+/// Frequencies
+template<class T>
+std::vector<T> StreamingWelch<T>::getFrequencies() const
+{
+    auto nFrequencies = getNumberOfFrequencies(); // Throws
+    auto df = pImpl->mSamplingRate/static_cast<double> (pImpl->mDFTLength);
+    std::vector<T> frequencies(nFrequencies);
+    for (int k = 0; k < nFrequencies; ++k)
+    {
+        frequencies[k] = static_cast<T> (k*df);
+    }
+    return frequencies;
+}
+
+/// Transform
+template<class T>
+void StreamingWelch<T>::transform(const int nSamples, const T x[])
+{
+    if (nSamples <= 0){return;} // Nothing to do
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    pImpl->transform(nSamples, x);
+}
+
+/// Number of segments
+template<class T>
+int StreamingWelch<T>::getNumberOfSegments() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSegments;
+}
+
+/// Have transform?
+template<class T>
+bool StreamingWelch<T>::haveTransform() const noexcept
+{
+    return pImpl->mSegments > 0;
+}
+
+/// Power spectral density
+template<class T>
+std::vector<T> StreamingWelch<T>::getPowerSpectralDensity(
+    const int channel) const
+{
+    auto nChannels = getNumberOfChannels(); // Throws
+    if (channel < 0 || channel >= nChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(nChannels - 1) + "]");
+    }
+    if (!haveTransform())
+    {
+        throw std::runtime_error("No segments have been transformed");
+    }
+    auto nFrequencies = pImpl->getNumberOfFrequencies();
+    auto xscal = 2.0/pImpl->mDensityScaling;
+    const double *average = pImpl->mAverage.data()
+                          + static_cast<size_t> (channel)*nFrequencies;
+    std::vector<T> psd(nFrequencies);
+    for (int k = 0; k < nFrequencies; ++k)
+    {
+        psd[k] = static_cast<T> (xscal*average[k]);
+    }
+    return psd;
+}
+
+/// Power spectrum
+template<class T>
+std::vector<T> StreamingWelch<T>::getPowerSpectrum(const int channel) const
+{
+    auto nChannels = getNumberOfChannels(); // Throws
+    if (channel < 0 || channel >= nChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(nChannels - 1) + "]");
+    }
+    if (!haveTransform())
+    {
+        throw std::runtime_error("No segments have been transformed");
+    }
+    auto nFrequencies = pImpl->getNumberOfFrequencies();
+    auto xscal = 2.0/pImpl->mSpectrumScaling;
+    const double *average = pImpl->mAverage.data()
+                          + static_cast<size_t> (channel)*nFrequencies;
+    std::vector<T> spectrum(nFrequencies);
+    for (int k = 0; k < nFrequencies; ++k)
+    {
+        spectrum[k] = static_cast<T> (xscal*average[k]);
+    }
+    return spectrum;
+}
+
+/// Reset
+template<class T>
+void StreamingWelch<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::StreamingWelch<double>;
+template class RTSeis::Transforms::StreamingWelch<float>;
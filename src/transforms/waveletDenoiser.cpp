@@ -0,0 +1,238 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/transforms/waveletDenoiser.hpp"
+#include "rtseis/transforms/discreteWavelet.hpp"
+
+using namespace RTSeis::Transforms;
+
+namespace
+{
+/// Maps an index past the end of a signal of length n >= 2 to the sample
+/// obtained by reflecting the signal about its first and last samples.
+int reflect(const int i, const int n)
+{
+    const int period = 2*(n - 1);
+    auto m = i%period;
+    return (m < n) ? m : period - m;
+}
+}
+
+template<class T>
+class WaveletDenoiser<T>::WaveletDenoiserImpl
+{
+public:
+    /// Denoises one trace.  The workspaces are passed in so that each thread
+    /// can use its own.
+    T denoise(DiscreteWavelet<T> &dwt, const int n, const T x[], T y[],
+              std::vector<T> &padded, std::vector<T> &coefficients,
+              std::vector<T> &work) const
+    {
+        const int nBlock = 1 << mLevels;
+        const int nPad = ((n + nBlock - 1)/nBlock)*nBlock;
+        padded.resize(nPad);
+        coefficients.resize(nPad);
+        std::copy(x, x + n, padded.begin());
+        for (int i = n; i < nPad; ++i){padded[i] = x[reflect(i, n)];}
+        auto cPtr = coefficients.data();
+        dwt.forwardTransform(nPad, padded.data(), &cPtr);
+        // Noise estimate from the finest detail coefficients
+        const int nFine = nPad/2;
+        work.resize(nFine);
+        for (int k = 0; k < nFine; ++k)
+        {
+            work[k] = std::abs(coefficients[nFine + k]);
+        }
+        std::nth_element(work.begin(), work.begin() + nFine/2, work.end());
+        T median = work[nFine/2];
+        if (nFine%2 == 0)
+        {
+            auto lower = *std::max_element(work.begin(),
+                                           work.begin() + nFine/2);
+            median = (median + lower)/2;
+        }
+        const T sigma = median/static_cast<T> (0.6745);
+        const T lambda = sigma*std::sqrt(2*std::log(static_cast<T> (n)));
+        // Threshold the detail coefficients
+        const int nApprox = nPad >> mLevels;
+        auto c = coefficients.data();
+        if (mThresholdType == WaveletThresholdType::HARD)
+        {
+            #pragma omp simd
+            for (int k = nApprox; k < nPad; ++k)
+            {
+                c[k] = (std::abs(c[k]) > lambda) ? c[k] : 0;
+            }
+        }
+        else
+        {
+            #pragma omp simd
+            for (int k = nApprox; k < nPad; ++k)
+            {
+                auto shrunk = std::max(std::abs(c[k]) - lambda,
+                                       static_cast<T> (0));
+                c[k] = std::copysign(shrunk, c[k]);
+            }
+        }
+        auto pPtr = padded.data();
+        dwt.inverseTransform(nPad, coefficients.data(), &pPtr);
+        std::copy(padded.begin(), padded.begin() + n, y);
+        return lambda;
+    }
+    DiscreteWavelet<T> mDWT;
+    /// The threshold of each trace
+    std::vector<T> mThresholds;
+    int mLevels = 0;
+    WaveletThresholdType mThresholdType = WaveletThresholdType::SOFT;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+WaveletDenoiser<T>::WaveletDenoiser() :
+    pImpl(std::make_unique<WaveletDenoiserImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+WaveletDenoiser<T>::WaveletDenoiser(const WaveletDenoiser &denoiser)
+{
+    *this = denoiser;
+}
+
+/// Move c'tor
+template<class T>
+WaveletDenoiser<T>::WaveletDenoiser(WaveletDenoiser &&denoiser) noexcept
+{
+    *this = std::move(denoiser);
+}
+
+/// Copy assignment
+template<class T>
+WaveletDenoiser<T>&
+WaveletDenoiser<T>::operator=(const WaveletDenoiser &denoiser)
+{
+    if (&denoiser == this){return *this;}
+    pImpl = std::make_unique<WaveletDenoiserImpl> (*denoiser.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+WaveletDenoiser<T>&
+WaveletDenoiser<T>::operator=(WaveletDenoiser &&denoiser) noexcept
+{
+    if (&denoiser == this){return *this;}
+    pImpl = std::move(denoiser.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+WaveletDenoiser<T>::~WaveletDenoiser() = default;
+
+/// Clear
+template<class T>
+void WaveletDenoiser<T>::clear() noexcept
+{
+    pImpl->mDWT.clear();
+    pImpl->mThresholds.clear();
+    pImpl->mLevels = 0;
+    pImpl->mThresholdType = WaveletThresholdType::SOFT;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize
+template<class T>
+void WaveletDenoiser<T>::initialize(const DiscreteWaveletFamily family,
+                                    const int order,
+                                    const int nLevels,
+                                    const WaveletThresholdType thresholdType)
+{
+    clear();
+    pImpl->mDWT.initialize(family, order, nLevels); // Throws
+    pImpl->mLevels = nLevels;
+    pImpl->mThresholdType = thresholdType;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool WaveletDenoiser<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of levels
+template<class T>
+int WaveletDenoiser<T>::getNumberOfLevels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mLevels;
+}
+
+/// Threshold type
+template<class T>
+WaveletThresholdType WaveletDenoiser<T>::getThresholdType() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mThresholdType;
+}
+
+/// Thresholds
+template<class T>
+std::vector<T> WaveletDenoiser<T>::getThresholds() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mThresholds;
+}
+
+/// Denoise
+template<class T>
+void WaveletDenoiser<T>::apply(const int nTraces, const int nSamples,
+                               const T x[], T *yIn[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nTraces <= 0){return;} // Nothing to do
+    if (nSamples < 2)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must be at least 2");
+    }
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    pImpl->mThresholds.resize(nTraces);
+    auto thresholds = pImpl->mThresholds.data();
+    const auto &impl = *pImpl;
+    #pragma omp parallel default(none) \
+     shared(impl, thresholds, x, y) firstprivate(nTraces, nSamples)
+    {
+        DiscreteWavelet<T> dwt(impl.mDWT);
+        std::vector<T> padded;
+        std::vector<T> coefficients;
+        std::vector<T> work;
+        #pragma omp for
+        for (int i = 0; i < nTraces; ++i)
+        {
+            auto offset = static_cast<size_t> (i)*nSamples;
+            thresholds[i] = impl.denoise(dwt, nSamples, x + offset,
+                                         y + offset, padded,
+                                         coefficients, work);
+        }
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Transforms::WaveletDenoiser<double>;
+template class RTSeis::Transforms::WaveletDenoiser<float>;
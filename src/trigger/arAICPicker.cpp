@@ -0,0 +1,265 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/trigger/arAICPicker.hpp"
+#include "rtseis/utilities/math/autoRegressive.hpp"
+
+using namespace RTSeis::Trigger;
+namespace AR = RTSeis::Utilities::Math::AutoRegressive;
+
+template<class T>
+class ARAICPicker<T>::ARAICPickerImpl
+{
+public:
+    /// Picks the onset in the window w of length mWindowLength.  The
+    /// workspaces have dimension [mWindowLength + 1].
+    int pickWindow(const T w[], double noiseErrors[],
+                   double signalErrors[]) const
+    {
+        const int n = mWindowLength;
+        const int order = mOrder;
+        auto aNoise = AR::estimate(mNoiseLength, w, order, nullptr, mMethod);
+        auto aSignal = AR::estimate(mSignalLength, w + n - mSignalLength,
+                                    order, nullptr, mMethod);
+        // noiseErrors[j] is the sum of the noise model's squared forward
+        // prediction errors at samples order through order + j - 1
+        noiseErrors[0] = 0;
+        for (int i = order; i < n; ++i)
+        {
+            double e = 0;
+            for (int k = 0; k <= order; ++k)
+            {
+                e = e + aNoise[k]*static_cast<double> (w[i - k]);
+            }
+            noiseErrors[i - order + 1] = noiseErrors[i - order] + e*e;
+        }
+        // signalErrors[i] is the sum of the signal model's squared backward
+        // prediction errors at samples i through n - order - 1
+        signalErrors[n - order] = 0;
+        for (int i = n - order - 1; i >= 0; --i)
+        {
+            double e = 0;
+            for (int k = 0; k <= order; ++k)
+            {
+                e = e + aSignal[k]*static_cast<double> (w[i + k]);
+            }
+            signalErrors[i] = signalErrors[i + 1] + e*e;
+        }
+        // Scan the AIC
+        constexpr double tiny = std::numeric_limits<double>::min();
+        int kMin = order + 1;
+        double aicMin = std::numeric_limits<double>::max();
+        for (int k = order + 1; k < n - order; ++k)
+        {
+            auto n1 = k - order;
+            auto n2 = n - order - k;
+            auto variance1 = std::max(tiny, noiseErrors[n1]/n1);
+            auto variance2 = std::max(tiny, signalErrors[k]/n2);
+            auto aic = n1*std::log(variance1) + n2*std::log(variance2);
+            if (aic < aicMin)
+            {
+                aicMin = aic;
+                kMin = k;
+            }
+        }
+        return kMin;
+    }
+    AR::Method mMethod = AR::Method::BURG;
+    int mWindowBefore = 0;
+    int mWindowAfter = 0;
+    int mWindowLength = 0;
+    int mNoiseLength = 0;
+    int mSignalLength = 0;
+    int mOrder = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+ARAICPicker<T>::ARAICPicker() :
+    pImpl(std::make_unique<ARAICPickerImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+ARAICPicker<T>::ARAICPicker(const ARAICPicker &picker)
+{
+    *this = picker;
+}
+
+/// Move c'tor
+template<class T>
+ARAICPicker<T>::ARAICPicker(ARAICPicker &&picker) noexcept
+{
+    *this = std::move(picker);
+}
+
+/// Copy assignment
+template<class T>
+ARAICPicker<T>& ARAICPicker<T>::operator=(const ARAICPicker &picker)
+{
+    if (&picker == this){return *this;}
+    pImpl = std::make_unique<ARAICPickerImpl> (*picker.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+ARAICPicker<T>& ARAICPicker<T>::operator=(ARAICPicker &&picker) noexcept
+{
+    if (&picker == this){return *this;}
+    pImpl = std::move(picker.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+ARAICPicker<T>::~ARAICPicker() = default;
+
+/// Clear
+template<class T>
+void ARAICPicker<T>::clear() noexcept
+{
+    pImpl = std::make_unique<ARAICPickerImpl> ();
+}
+
+/// Initialize
+template<class T>
+void ARAICPicker<T>::initialize(const int windowBefore, const int windowAfter,
+                                const int noiseLength, const int signalLength,
+                                const int order, const AR::Method method)
+{
+    clear();
+    if (windowBefore < 1)
+    {
+        throw std::invalid_argument("windowBefore = "
+                                  + std::to_string(windowBefore)
+                                  + " must be positive");
+    }
+    if (windowAfter < 1)
+    {
+        throw std::invalid_argument("windowAfter = "
+                                  + std::to_string(windowAfter)
+                                  + " must be positive");
+    }
+    if (order < 1)
+    {
+        throw std::invalid_argument("order = " + std::to_string(order)
+                                  + " must be positive");
+    }
+    auto windowLength = windowBefore + windowAfter;
+    if (windowLength < 2*order + 2)
+    {
+        throw std::invalid_argument("window length = "
+                                  + std::to_string(windowLength)
+                                  + " must be at least "
+                                  + std::to_string(2*order + 2));
+    }
+    if (noiseLength <= order || noiseLength > windowLength)
+    {
+        throw std::invalid_argument("noiseLength = "
+                                  + std::to_string(noiseLength)
+                                  + " must be in range ["
+                                  + std::to_string(order + 1) + ","
+                                  + std::to_string(windowLength) + "]");
+    }
+    if (signalLength <= order || signalLength > windowLength)
+    {
+        throw std::invalid_argument("signalLength = "
+                                  + std::to_string(signalLength)
+                                  + " must be in range ["
+                                  + std::to_string(order + 1) + ","
+                                  + std::to_string(windowLength) + "]");
+    }
+    pImpl->mMethod = method;
+    pImpl->mWindowBefore = windowBefore;
+    pImpl->mWindowAfter = windowAfter;
+    pImpl->mWindowLength = windowLength;
+    pImpl->mNoiseLength = noiseLength;
+    pImpl->mSignalLength = signalLength;
+    pImpl->mOrder = order;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool ARAICPicker<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Window before
+template<class T>
+int ARAICPicker<T>::getWindowBefore() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowBefore;
+}
+
+/// Window after
+template<class T>
+int ARAICPicker<T>::getWindowAfter() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowAfter;
+}
+
+/// Order
+template<class T>
+int ARAICPicker<T>::getOrder() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mOrder;
+}
+
+/// Pick
+template<class T>
+void ARAICPicker<T>::pick(const int nSamples, const T x[],
+                          const int nTriggers, const int triggers[],
+                          int *picksIn[]) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nTriggers < 1){return;} // Nothing to do
+    int *picks = *picksIn;
+    if (x == nullptr || triggers == nullptr || picks == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        if (triggers == nullptr)
+        {
+            throw std::invalid_argument("triggers is NULL");
+        }
+        throw std::invalid_argument("picks is NULL");
+    }
+    const int windowBefore = pImpl->mWindowBefore;
+    const int windowLength = pImpl->mWindowLength;
+    #pragma omp parallel default(shared)
+    {
+    std::vector<double> noiseErrors(windowLength + 1);
+    std::vector<double> signalErrors(windowLength + 1);
+    #pragma omp for schedule(dynamic)
+    for (int i = 0; i < nTriggers; ++i)
+    {
+        auto start = triggers[i] - windowBefore;
+        if (start < 0 || start > nSamples - windowLength)
+        {
+            picks[i] =-1;
+            continue;
+        }
+        auto k = pImpl->pickWindow(x + start, noiseErrors.data(),
+                                   signalErrors.data());
+        picks[i] = start + k;
+    }
+    } // End parallel
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Trigger::ARAICPicker<double>;
+template class RTSeis::Trigger::ARAICPicker<float>;
@@ -0,0 +1,496 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include <mkl_lapacke.h>
+#include "rtseis/utilities/characteristicFunction/subspaceDetector.hpp"
+#include "rtseis/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::CharacteristicFunction;
+
+namespace
+{
+/// The smallest DFT length used by the overlap-save correlations
+constexpr int MIN_DFT_LENGTH = 1024;
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class SubspaceDetector<E, T>::SubspaceDetectorImpl
+{
+public:
+    SubspaceDetectorImpl() = default;
+    SubspaceDetectorImpl(const SubspaceDetectorImpl &detector) :
+        mBasisSpectra(detector.mBasisSpectra),
+        mSingularValues(detector.mSingularValues),
+        mHistory(detector.mHistory),
+        mExtended(detector.mExtended),
+        mChannels(detector.mChannels),
+        mTemplateLength(detector.mTemplateLength),
+        mDimension(detector.mDimension),
+        mDFTLength(detector.mDFTLength),
+        mInitialized(detector.mInitialized)
+    {
+        if (mInitialized){makePlans();}
+    }
+    SubspaceDetectorImpl& operator=(const SubspaceDetectorImpl &) = delete;
+    ~SubspaceDetectorImpl()
+    {
+        releasePlans();
+    }
+    void releasePlans() noexcept
+    {
+        if (mHavePlans)
+        {
+            fftw_destroy_plan(mForwardPlan);
+            fftw_destroy_plan(mInversePlan);
+        }
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        mInData = nullptr;
+        mSpectrum = nullptr;
+        mHavePlans = false;
+    }
+    /// The plans are executed on per-thread buffers
+    void makePlans()
+    {
+        releasePlans();
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (mDFTLength)
+                              *sizeof(double)));
+        mSpectrum = reinterpret_cast<fftw_complex *>
+                    (fftw_malloc(static_cast<size_t> (mDFTLength/2 + 1)
+                                *sizeof(fftw_complex)));
+        mForwardPlan = fftw_plan_dft_r2c_1d(mDFTLength, mInData, mSpectrum,
+                                            FFTW_ESTIMATE);
+        mInversePlan = fftw_plan_dft_c2r_1d(mDFTLength, mSpectrum, mInData,
+                                            FFTW_ESTIMATE);
+        mHavePlans = true;
+    }
+    /// Per-thread workspace
+    class Workspace
+    {
+    public:
+        explicit Workspace(const SubspaceDetectorImpl &detector)
+        {
+            auto n = static_cast<size_t> (detector.mDFTLength);
+            auto nFrequencies = n/2 + 1;
+            mInData = static_cast<double *> (fftw_malloc(n*sizeof(double)));
+            mSpectrum = reinterpret_cast<fftw_complex *>
+                        (fftw_malloc(nFrequencies*sizeof(fftw_complex)));
+            mChannelSpectra.resize(nFrequencies*detector.mChannels);
+            mCaptured.resize(n);
+        }
+        Workspace(const Workspace &) = delete;
+        Workspace& operator=(const Workspace &) = delete;
+        ~Workspace()
+        {
+            if (mInData != nullptr){fftw_free(mInData);}
+            if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        }
+        /// The [nChannels x nFrequencies] spectra of the block
+        std::vector<std::complex<double>> mChannelSpectra;
+        /// The energy captured by the subspace
+        std::vector<double> mCaptured;
+        double *mInData = nullptr;
+        fftw_complex *mSpectrum = nullptr;
+    };
+    /// Computes the statistic for the outputs [i1, i2).  Output i
+    /// corresponds to the window starting at sample i of the extended
+    /// signals.
+    void block(const int i1, const int i2, const int nExtended,
+               T y[], Workspace &work) const
+    {
+        const int nfft = mDFTLength;
+        const int nFrequencies = nfft/2 + 1;
+        const int nOut = i2 - i1;
+        const int lag = mTemplateLength - 1;
+        const double *extended = mExtended.data();
+        // Transform each channel's segment
+        for (int c = 0; c < mChannels; ++c)
+        {
+            auto segment = extended + static_cast<size_t> (c)*nExtended + i1;
+            auto nCopy = std::min(nfft, nExtended - i1);
+            std::copy(segment, segment + nCopy, work.mInData);
+            std::fill(work.mInData + nCopy, work.mInData + nfft, 0.0);
+            fftw_execute_dft_r2c(mForwardPlan, work.mInData, work.mSpectrum);
+            auto spectrum = work.mChannelSpectra.data()
+                          + static_cast<size_t> (c)*nFrequencies;
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                spectrum[k] = std::complex<double> (work.mSpectrum[k][0],
+                                                    work.mSpectrum[k][1]);
+            }
+        }
+        // Accumulate the squared projections
+        std::fill(work.mCaptured.begin(), work.mCaptured.begin() + nOut, 0.0);
+        const double xnorm = 1.0/nfft;
+        for (int id = 0; id < mDimension; ++id)
+        {
+            auto basis = mBasisSpectra.data()
+                       + static_cast<size_t> (id)*mChannels*nFrequencies;
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                std::complex<double> sum(0, 0);
+                for (int c = 0; c < mChannels; ++c)
+                {
+                    auto offset = static_cast<size_t> (c)*nFrequencies + k;
+                    sum = sum + work.mChannelSpectra[offset]*basis[offset];
+                }
+                work.mSpectrum[k][0] = sum.real();
+                work.mSpectrum[k][1] = sum.imag();
+            }
+            fftw_execute_dft_c2r(mInversePlan, work.mSpectrum, work.mInData);
+            // The valid part of the circular correlation
+            auto projection = work.mInData + lag;
+            #pragma omp simd
+            for (int i = 0; i < nOut; ++i)
+            {
+                auto p = projection[i]*xnorm;
+                work.mCaptured[i] = work.mCaptured[i] + p*p;
+            }
+        }
+        // Running window energy.  This is recomputed at the block start to
+        // avoid accumulating roundoff.
+        double energy = 0;
+        for (int c = 0; c < mChannels; ++c)
+        {
+            auto xc = extended + static_cast<size_t> (c)*nExtended + i1;
+            for (int j = 0; j < mTemplateLength; ++j)
+            {
+                energy = energy + xc[j]*xc[j];
+            }
+        }
+        for (int i = 0; i < nOut; ++i)
+        {
+            if (i > 0)
+            {
+                for (int c = 0; c < mChannels; ++c)
+                {
+                    auto xc = extended + static_cast<size_t> (c)*nExtended
+                            + i1 + i;
+                    auto xNew = xc[lag];
+                    auto xOld = xc[-1];
+                    energy = energy + (xNew*xNew - xOld*xOld);
+                }
+                energy = std::max(0.0, energy);
+            }
+            double statistic = 0;
+            if (energy > 0)
+            {
+                statistic = std::min(1.0, work.mCaptured[i]/energy);
+            }
+            y[i] = static_cast<T> (statistic);
+        }
+    }
+    /// The [dimension x nChannels x nFrequencies] spectra of the time
+    /// reversed basis vectors
+    std::vector<std::complex<double>> mBasisSpectra;
+    std::vector<double> mSingularValues;
+    /// The [nChannels x (templateLength - 1)] saved samples
+    std::vector<double> mHistory;
+    /// The [nChannels x (templateLength - 1 + nSamples)] signals with the
+    /// saved samples prepended
+    std::vector<double> mExtended;
+    fftw_plan mForwardPlan;
+    fftw_plan mInversePlan;
+    double *mInData = nullptr;
+    fftw_complex *mSpectrum = nullptr;
+    int mChannels = 0;
+    int mTemplateLength = 0;
+    int mDimension = 0;
+    int mDFTLength = 0;
+    bool mHavePlans = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+SubspaceDetector<E, T>::SubspaceDetector() :
+    pImpl(std::make_unique<SubspaceDetectorImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+SubspaceDetector<E, T>::SubspaceDetector(const SubspaceDetector &detector)
+{
+    *this = detector;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+SubspaceDetector<E, T>::SubspaceDetector(SubspaceDetector &&detector) noexcept
+{
+    *this = std::move(detector);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+SubspaceDetector<E, T>&
+SubspaceDetector<E, T>::operator=(const SubspaceDetector &detector)
+{
+    if (&detector == this){return *this;}
+    pImpl = std::make_unique<SubspaceDetectorImpl> (*detector.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+SubspaceDetector<E, T>&
+SubspaceDetector<E, T>::operator=(SubspaceDetector &&detector) noexcept
+{
+    if (&detector == this){return *this;}
+    pImpl = std::move(detector.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+SubspaceDetector<E, T>::~SubspaceDetector() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void SubspaceDetector<E, T>::clear() noexcept
+{
+    pImpl = std::make_unique<SubspaceDetectorImpl> ();
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void SubspaceDetector<E, T>::initialize(const int nChannels,
+                                        const int templateLength,
+                                        const int nTemplates,
+                                        const double templates[],
+                                        const int dimension)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (templateLength < 2)
+    {
+        throw std::invalid_argument("templateLength = "
+                                  + std::to_string(templateLength)
+                                  + " must be at least 2");
+    }
+    if (nTemplates < 1)
+    {
+        throw std::invalid_argument("nTemplates = "
+                                  + std::to_string(nTemplates)
+                                  + " must be positive");
+    }
+    if (templates == nullptr)
+    {
+        throw std::invalid_argument("templates is NULL");
+    }
+    const int nRows = nChannels*templateLength;
+    const int nSingularValues = std::min(nRows, nTemplates);
+    if (dimension < 1 || dimension > nSingularValues)
+    {
+        throw std::invalid_argument("dimension = " + std::to_string(dimension)
+                                  + " must be in range [1,"
+                                  + std::to_string(nSingularValues) + "]");
+    }
+    // Column-major [nRows x nTemplates] matrix of normalized templates
+    std::vector<double> a(static_cast<size_t> (nRows)*nTemplates);
+    for (int it = 0; it < nTemplates; ++it)
+    {
+        auto t = templates + static_cast<size_t> (it)*nRows;
+        double energy = 0;
+        for (int i = 0; i < nRows; ++i){energy = energy + t[i]*t[i];}
+        if (!(energy > 0))
+        {
+            throw std::invalid_argument("Template " + std::to_string(it)
+                                      + " has no energy");
+        }
+        auto xnorm = 1.0/std::sqrt(energy);
+        auto column = a.data() + static_cast<size_t> (it)*nRows;
+        for (int i = 0; i < nRows; ++i){column[i] = t[i]*xnorm;}
+    }
+    // Left singular vectors
+    std::vector<double> s(nSingularValues);
+    std::vector<double> u(static_cast<size_t> (nRows)*nSingularValues);
+    double workSize = 0;
+    auto info = LAPACKE_dgesvd_work(LAPACK_COL_MAJOR, 'S', 'N',
+                                    nRows, nTemplates, a.data(), nRows,
+                                    s.data(), u.data(), nRows,
+                                    nullptr, 1, &workSize, -1);
+    if (info != 0){throw std::runtime_error("dgesvd workspace query failed");}
+    std::vector<double> work(std::max(1, static_cast<int> (workSize)));
+    info = LAPACKE_dgesvd_work(LAPACK_COL_MAJOR, 'S', 'N',
+                               nRows, nTemplates, a.data(), nRows,
+                               s.data(), u.data(), nRows,
+                               nullptr, 1, work.data(),
+                               static_cast<int> (work.size()));
+    if (info != 0)
+    {
+        throw std::runtime_error("dgesvd failed with error "
+                               + std::to_string(info));
+    }
+    // Overlap-save correlations with the time reversed basis vectors
+    auto nfft = RTSeis::Transforms::DFTUtilities::nextFastLength(
+        std::max(MIN_DFT_LENGTH, 4*templateLength));
+    pImpl->mChannels = nChannels;
+    pImpl->mTemplateLength = templateLength;
+    pImpl->mDimension = dimension;
+    pImpl->mDFTLength = nfft;
+    pImpl->makePlans();
+    const int nFrequencies = nfft/2 + 1;
+    pImpl->mBasisSpectra.resize(static_cast<size_t> (dimension)*nChannels
+                               *nFrequencies);
+    for (int id = 0; id < dimension; ++id)
+    {
+        for (int c = 0; c < nChannels; ++c)
+        {
+            auto basis = u.data() + static_cast<size_t> (id)*nRows
+                       + static_cast<size_t> (c)*templateLength;
+            std::fill(pImpl->mInData, pImpl->mInData + nfft, 0.0);
+            std::reverse_copy(basis, basis + templateLength, pImpl->mInData);
+            fftw_execute(pImpl->mForwardPlan);
+            auto spectrum = pImpl->mBasisSpectra.data()
+                          + (static_cast<size_t> (id)*nChannels + c)
+                           *nFrequencies;
+            for (int k = 0; k < nFrequencies; ++k)
+            {
+                spectrum[k] = std::complex<double> (pImpl->mSpectrum[k][0],
+                                                    pImpl->mSpectrum[k][1]);
+            }
+        }
+    }
+    pImpl->mSingularValues = s;
+    pImpl->mHistory.resize(static_cast<size_t> (nChannels)
+                          *(templateLength - 1), 0.0);
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool SubspaceDetector<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<RTSeis::ProcessingMode E, class T>
+int SubspaceDetector<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Template length
+template<RTSeis::ProcessingMode E, class T>
+int SubspaceDetector<E, T>::getTemplateLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mTemplateLength;
+}
+
+/// Dimension
+template<RTSeis::ProcessingMode E, class T>
+int SubspaceDetector<E, T>::getDimension() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mDimension;
+}
+
+/// Singular values
+template<RTSeis::ProcessingMode E, class T>
+std::vector<double> SubspaceDetector<E, T>::getSingularValues() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSingularValues;
+}
+
+/// Captured energy
+template<RTSeis::ProcessingMode E, class T>
+double SubspaceDetector<E, T>::getCapturedEnergyFraction() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    double captured = 0;
+    double total = 0;
+    for (int i = 0; i < static_cast<int> (pImpl->mSingularValues.size()); ++i)
+    {
+        auto s2 = pImpl->mSingularValues[i]*pImpl->mSingularValues[i];
+        if (i < pImpl->mDimension){captured = captured + s2;}
+        total = total + s2;
+    }
+    return captured/total;
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void SubspaceDetector<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::fill(pImpl->mHistory.begin(), pImpl->mHistory.end(), 0.0);
+}
+
+/// Apply
+template<RTSeis::ProcessingMode E, class T>
+void SubspaceDetector<E, T>::apply(const int nSamples, const T x[], T *yIn[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nSamples <= 0){return;} // Nothing to do
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    if constexpr (E == RTSeis::ProcessingMode::POST)
+    {
+        resetInitialConditions();
+    }
+    const int nChannels = pImpl->mChannels;
+    const int lag = pImpl->mTemplateLength - 1;
+    const int nExtended = lag + nSamples;
+    pImpl->mExtended.resize(static_cast<size_t> (nChannels)*nExtended);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        auto extended = pImpl->mExtended.data()
+                      + static_cast<size_t> (c)*nExtended;
+        auto history = pImpl->mHistory.data() + static_cast<size_t> (c)*lag;
+        std::copy(history, history + lag, extended);
+        auto xc = x + static_cast<size_t> (c)*nSamples;
+        std::copy(xc, xc + nSamples, extended + lag);
+    }
+    // Each block of the overlap-save correlation is independent
+    const int nOutPerBlock = pImpl->mDFTLength - lag;
+    const int nBlocks = (nSamples + nOutPerBlock - 1)/nOutPerBlock;
+    const auto &impl = *pImpl;
+    #pragma omp parallel default(shared) if (nBlocks > 1)
+    {
+    typename SubspaceDetectorImpl::Workspace work(impl);
+    #pragma omp for schedule(dynamic)
+    for (int ib = 0; ib < nBlocks; ++ib)
+    {
+        auto i1 = ib*nOutPerBlock;
+        auto i2 = std::min(nSamples, i1 + nOutPerBlock);
+        impl.block(i1, i2, nExtended, y + i1, work);
+    }
+    } // End parallel
+    // Save the last samples
+    for (int c = 0; c < nChannels; ++c)
+    {
+        auto extended = pImpl->mExtended.data()
+                      + static_cast<size_t> (c)*nExtended;
+        auto history = pImpl->mHistory.data() + static_cast<size_t> (c)*lag;
+        std::copy(extended + nSamples, extended + nExtended, history);
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::CharacteristicFunction::SubspaceDetector<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::CharacteristicFunction::SubspaceDetector<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::CharacteristicFunction::SubspaceDetector<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::CharacteristicFunction::SubspaceDetector<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -511,6 +511,203 @@ void WeightedAverageSlopes<double>::interpolate(
     }
 }
 
+/// Initialize the class
+template<>
+void WeightedAverageSlopes<float>::initialize(
+    const int npts,
+    const std::pair<float, float> x,
+    const float y[])
+{
+    clear();
+    if (npts < 2)
+    {
+        throw std::invalid_argument("npts = " + std::to_string(npts)
+                                  + " must be at least 2");
+    }
+    if (x.first >= x.second)
+    {
+        throw std::invalid_argument("x.first = " + std::to_string(x.first)
+                                  + " must be less than x.second = "
+                                  + std::to_string(x.second));
+    }
+    if (y == nullptr){throw std::invalid_argument("y is NULL");}
+    // Compute the spline coefficients
+    auto dx = (x.second - x.first)/static_cast<float> (npts - 1);
+    pImpl->mSites = npts;
+    pImpl->mCoeffs = pImpl->splineOrder*(pImpl->mSites - 1);
+    pImpl->mSplineCoeffs32f = ippsMalloc_32f(pImpl->mCoeffs);
+    auto slopes = ippsMalloc_32f(npts); // Workspace
+    computeUniformSlopes(npts, dx, y, slopes, pImpl->mSplineCoeffs32f);
+    ippsFree(slopes);
+    // Create a custom piecewise 4th order spline
+    pImpl->mTask32f = nullptr;
+    pImpl->mRange.first = x.first;
+    pImpl->mRange.second = x.second;
+    pImpl->mXiEqual32f[0] = x.first;
+    pImpl->mXiEqual32f[1] = x.second;
+    auto status = dfsNewTask1D(&pImpl->mTask32f, npts, pImpl->mXiEqual32f,
+                               DF_UNIFORM_PARTITION, 1, y, DF_NO_HINT); 
+    if (status != DF_STATUS_OK)
+    {
+        dfDeleteTask(&pImpl->mTask32f);
+        throw std::runtime_error("Failed to create task\n");
+    }
+    status = dfsEditPPSpline1D(pImpl->mTask32f, pImpl->splineOrder,
+                               DF_PP_DEFAULT, DF_NO_BC, NULL, DF_NO_IC, NULL,
+                               pImpl->mSplineCoeffs32f, DF_NO_HINT);
+    if (status != DF_STATUS_OK)
+    {
+        dfDeleteTask(&pImpl->mTask32f);
+        throw std::runtime_error("Failed to edit spline pipeline\n");
+    }
+    pImpl->mHaveTask32f = true;
+    pImpl->mPrecision = RTSeis::Precision::FLOAT;
+    pImpl->mInitialized = true;
+}
+
+/// Initialize the class
+template<>
+void WeightedAverageSlopes<float>::initialize(
+    const int npts,
+    const float x[],
+    const float y[])
+{
+    clear();
+    if (npts < 2)
+    {
+        throw std::invalid_argument("npts = " + std::to_string(npts)
+                                  + " must be at least 2");
+    }
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    if (!std::is_sorted(x, x+npts))
+    {
+        throw std::invalid_argument("x is not sorted");
+    }
+    pImpl->mSites = npts;
+    pImpl->mCoeffs = pImpl->splineOrder*(pImpl->mSites - 1);
+    pImpl->mSplineCoeffs32f = ippsMalloc_32f(pImpl->mCoeffs);
+    auto slopes = ippsMalloc_32f(npts); // Workspace
+    computeUniformSlopes(npts, x, y, slopes, pImpl->mSplineCoeffs32f);
+    ippsFree(slopes);
+    // Create a custom piecewise 4th order spline
+    pImpl->mTask32f = nullptr;
+    pImpl->mRange.first = x[0];
+    pImpl->mRange.second = x[npts-1];
+    pImpl->mXiEqual32f[0] = x[0];
+    pImpl->mXiEqual32f[1] = x[npts-1];
+    pImpl->mXi32f = ippsMalloc_32f(npts);
+    ippsCopy_32f(x, pImpl->mXi32f, npts);
+    auto status = dfsNewTask1D(&pImpl->mTask32f, npts, pImpl->mXi32f,
+                               DF_NON_UNIFORM_PARTITION, 1, y, DF_NO_HINT);
+    if (status != DF_STATUS_OK)
+    {
+        dfDeleteTask(&pImpl->mTask32f);
+        throw std::runtime_error("Failed to create task\n");
+    }
+    status = dfsEditPPSpline1D(pImpl->mTask32f, pImpl->splineOrder,
+                               DF_PP_DEFAULT, DF_NO_BC, NULL, DF_NO_IC, NULL,
+                               pImpl->mSplineCoeffs32f, DF_NO_HINT);
+    if (status != DF_STATUS_OK)
+    {
+        dfDeleteTask(&pImpl->mTask32f);
+        throw std::runtime_error("Failed to edit spline pipeline\n");
+    }
+    pImpl->mHaveTask32f = true;
+    pImpl->mPrecision = RTSeis::Precision::FLOAT;
+    pImpl->mInitialized = true;
+}
+
+
+// Interpolate
+template<>
+void WeightedAverageSlopes<float>::interpolate(
+    const int nq, const float xq[], float *yqIn[]) const
+{
+    // Checks
+    if (nq < 1){return;} // Nothing to do
+    double xMin = getMinimumX(); // Throws on initialization
+    double xMax = getMaximumX(); // Throws on initialization
+    float *yq = *yqIn;
+    if (xq == nullptr || yq == nullptr)
+    {
+        if (xq == nullptr){throw std::invalid_argument("xq is NULL");}
+        throw std::invalid_argument("yq is NULL");
+    }
+    float xqMin, xqMax;
+    ippsMinMax_32f(xq, nq, &xqMin, &xqMax);
+    if (xqMin < xMin || xqMax > xMax)
+    {
+        throw std::invalid_argument("Min/max of xq = ("
+                                  + std::to_string(xqMin) + ","
+                                  + std::to_string(xqMax) 
+                                  + ") Must be in range ["
+                                  + std::to_string(xMin) + ","
+                                  + std::to_string(xMax) + "]");
+    }
+    // Check this is sorted
+    bool lsorted = Math::VectorMath::isSorted(nq, xq);
+    // Interpolate
+    const MKL_INT nsite = nq;
+    MKL_INT sortedHint = DF_SORTED_DATA;
+    if (!lsorted){sortedHint = DF_NO_HINT;}
+    constexpr MKL_INT nOrder = 1;  // Length of dorder
+    const MKL_INT dOrder[1] = {0}; // Order of derivatives
+    auto status = dfsInterpolate1D(pImpl->mTask32f, DF_INTERP, DF_METHOD_PP,
+                                   nsite, xq,
+                                   sortedHint, nOrder, dOrder,
+                                   DF_NO_APRIORI_INFO, yq,
+                                   DF_MATRIX_STORAGE_ROWS, NULL);
+    if (status != DF_STATUS_OK)
+    {
+        throw std::runtime_error("Interpolation failed");
+    }
+}
+
+// Uniform interpolation
+template<>
+void WeightedAverageSlopes<float>::interpolate(
+    const int nq, const std::pair<float, float> xInterval,
+    float *yqIn[]) const
+{
+    // Checks
+    if (nq < 1){return;} // Nothing to do
+    double xMin = getMinimumX(); // Throws on initialization
+    double xMax = getMaximumX(); // Throws on initialization
+    float *yq = *yqIn;
+    if (yq == nullptr){RTSEIS_THROW_IA("%s", "yq is NULL");}
+    float xqMin = xInterval.first;
+    float xqMax = xInterval.second;
+    if (xqMin > xqMax)
+    {
+        RTSEIS_THROW_IA("xInterval.first = %lf > xInterval.second = %lf",
+                         xqMin, xqMax);
+    }
+    if (xqMin < xMin || xqMax > xMax)
+    {
+        RTSEIS_THROW_IA("Min/max of xq = (%lf,%lf) must be in range [%lf,%lf]",
+                        xqMin, xqMax, xMin, xMax);
+    }
+    // Interpolate
+    const MKL_INT nsite = nq;
+    MKL_INT sortedHint = DF_UNIFORM_PARTITION;
+    constexpr MKL_INT nOrder = 1;  // Length of dorder
+    const MKL_INT dOrder[1] = {0}; // Order of derivatives
+    float xq[2] = {xqMin, xqMax};
+    auto status = dfsInterpolate1D(pImpl->mTask32f, DF_INTERP, DF_METHOD_PP,
+                                   nsite, xq,
+                                   sortedHint, nOrder, dOrder,
+                                   DF_NO_APRIORI_INFO, yq,
+                                   DF_MATRIX_STORAGE_ROWS, NULL);
+    if (status != DF_STATUS_OK)
+    {
+        throw std::runtime_error("Interpolation failed");
+    }
+}
+
 /// Get minimum x
 template<class T>
 double WeightedAverageSlopes<T>::getMinimumX() const
@@ -535,4 +732,4 @@ double WeightedAverageSlopes<T>::getMaximumX() const
 
 /// Template class instantiation
 template class RTSeis::Utilities::Interpolation::WeightedAverageSlopes<double>;
-//template class RTSeis::Utilities::Interpolation::WeightedAverageSlopes<float>;
+template class RTSeis::Utilities::Interpolation::WeightedAverageSlopes<float>;
@@ -0,0 +1,351 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/math/autoRegressive.hpp"
+
+using namespace RTSeis::Utilities::Math::AutoRegressive;
+
+namespace
+{
+
+/// Burg's method
+template<typename T>
+std::vector<double> burg(const int n, const T x[], const int order,
+                         double *variance)
+{
+    std::vector<double> f(x, x + n);
+    std::vector<double> b(f);
+    std::vector<double> a(order + 1, 0);
+    std::vector<double> aWork(order + 1, 0);
+    a[0] = 1;
+    double error = 0;
+    for (int i = 0; i < n; ++i){error = error + f[i]*f[i];}
+    error = error/n;
+    for (int m = 1; m <= order; ++m)
+    {
+        double numerator = 0;
+        double denominator = 0;
+        for (int i = m; i < n; ++i)
+        {
+            numerator = numerator + f[i]*b[i - 1];
+            denominator = denominator + f[i]*f[i] + b[i - 1]*b[i - 1];
+        }
+        if (!(denominator > 0)){break;} // Perfectly predicted
+        auto k = -2*numerator/denominator;
+        std::copy(a.begin(), a.begin() + m, aWork.begin());
+        for (int j = 1; j <= m; ++j)
+        {
+            a[j] = aWork[j] + k*aWork[m - j];
+        }
+        // Descending so that b[i - 1] has not been updated yet
+        for (int i = n - 1; i >= m; --i)
+        {
+            auto fi = f[i] + k*b[i - 1];
+            b[i] = b[i - 1] + k*f[i];
+            f[i] = fi;
+        }
+        error = error*(1 - k*k);
+    }
+    if (variance != nullptr){*variance = error;}
+    return a;
+}
+
+/// Biased autocorrelation at lags 0 through order
+template<typename T>
+void autocorrelation(const int n, const T x[], const int order, double r[])
+{
+    for (int k = 0; k <= order; ++k)
+    {
+        double sum = 0;
+        for (int i = k; i < n; ++i)
+        {
+            sum = sum + static_cast<double> (x[i])*static_cast<double> (x[i - k]);
+        }
+        r[k] = sum/n;
+    }
+}
+
+}
+
+/// Levinson-Durbin
+std::vector<double>
+RTSeis::Utilities::Math::AutoRegressive::levinsonDurbin(
+    const int order, const double r[], double *variance)
+{
+    if (order < 1)
+    {
+        throw std::invalid_argument("order = " + std::to_string(order)
+                                  + " must be positive");
+    }
+    if (r == nullptr){throw std::invalid_argument("autocorrelation is NULL");}
+    std::vector<double> a(order + 1, 0);
+    std::vector<double> aWork(order + 1, 0);
+    a[0] = 1;
+    double error = r[0];
+    for (int m = 1; m <= order; ++m)
+    {
+        if (!(error > 0)){break;} // Singular
+        double acc = r[m];
+        for (int j = 1; j < m; ++j){acc = acc + a[j]*r[m - j];}
+        auto k =-acc/error;
+        std::copy(a.begin(), a.begin() + m, aWork.begin());
+        for (int j = 1; j < m; ++j)
+        {
+            a[j] = aWork[j] + k*aWork[m - j];
+        }
+        a[m] = k;
+        error = error*(1 - k*k);
+    }
+    if (variance != nullptr){*variance = std::max(0.0, error);}
+    return a;
+}
+
+/// Estimate
+template<typename T>
+std::vector<double>
+RTSeis::Utilities::Math::AutoRegressive::estimate(
+    const int n, const T x[], const int order, double *variance,
+    const Method method)
+{
+    if (order < 1)
+    {
+        throw std::invalid_argument("order = " + std::to_string(order)
+                                  + " must be positive");
+    }
+    if (n <= order)
+    {
+        throw std::invalid_argument("n = " + std::to_string(n)
+                                  + " must be greater than "
+                                  + std::to_string(order));
+    }
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    if (method == Method::BURG)
+    {
+        return burg(n, x, order, variance);
+    }
+    std::vector<double> r(order + 1);
+    autocorrelation(n, x, order, r.data());
+    return levinsonDurbin(order, r.data(), variance);
+}
+
+///--------------------------------------------------------------------------///
+///                           Sliding Autoregressive                         ///
+///--------------------------------------------------------------------------///
+
+template<class T>
+class SlidingAutoRegressive<T>::SlidingAutoRegressiveImpl
+{
+public:
+    /// Recomputes the lag sums from the window
+    void recompute()
+    {
+        const int n = mWindowLength;
+        for (int k = 0; k <= mOrder; ++k)
+        {
+            double sum = 0;
+            for (int i = k; i < n; ++i)
+            {
+                sum = sum + mBuffer[(mHead + i)%n]*mBuffer[(mHead + i - k)%n];
+            }
+            mLagSums[k] = sum;
+        }
+        mUpdates = 0;
+    }
+    /// The ring buffer.  mHead is the oldest sample.
+    std::vector<double> mBuffer;
+    /// The sums of x[i] x[i-k] over the window
+    std::vector<double> mLagSums;
+    int mWindowLength = 0;
+    int mOrder = 0;
+    int mHead = 0;
+    int mUpdates = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+SlidingAutoRegressive<T>::SlidingAutoRegressive() :
+    pImpl(std::make_unique<SlidingAutoRegressiveImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+SlidingAutoRegressive<T>::SlidingAutoRegressive(
+    const SlidingAutoRegressive &ar)
+{
+    *this = ar;
+}
+
+/// Move c'tor
+template<class T>
+SlidingAutoRegressive<T>::SlidingAutoRegressive(
+    SlidingAutoRegressive &&ar) noexcept
+{
+    *this = std::move(ar);
+}
+
+/// Copy assignment
+template<class T>
+SlidingAutoRegressive<T>&
+SlidingAutoRegressive<T>::operator=(const SlidingAutoRegressive &ar)
+{
+    if (&ar == this){return *this;}
+    pImpl = std::make_unique<SlidingAutoRegressiveImpl> (*ar.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+SlidingAutoRegressive<T>&
+SlidingAutoRegressive<T>::operator=(SlidingAutoRegressive &&ar) noexcept
+{
+    if (&ar == this){return *this;}
+    pImpl = std::move(ar.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+SlidingAutoRegressive<T>::~SlidingAutoRegressive() = default;
+
+/// Clear
+template<class T>
+void SlidingAutoRegressive<T>::clear() noexcept
+{
+    pImpl = std::make_unique<SlidingAutoRegressiveImpl> ();
+}
+
+/// Initialize
+template<class T>
+void SlidingAutoRegressive<T>::initialize(const int windowLength,
+                                          const int order)
+{
+    clear();
+    if (order < 1)
+    {
+        throw std::invalid_argument("order = " + std::to_string(order)
+                                  + " must be positive");
+    }
+    if (windowLength <= order)
+    {
+        throw std::invalid_argument("windowLength = "
+                                  + std::to_string(windowLength)
+                                  + " must be greater than "
+                                  + std::to_string(order));
+    }
+    pImpl->mBuffer.resize(windowLength, 0);
+    pImpl->mLagSums.resize(order + 1, 0);
+    pImpl->mWindowLength = windowLength;
+    pImpl->mOrder = order;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool SlidingAutoRegressive<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Window length
+template<class T>
+int SlidingAutoRegressive<T>::getWindowLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowLength;
+}
+
+/// Order
+template<class T>
+int SlidingAutoRegressive<T>::getOrder() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mOrder;
+}
+
+/// Reset
+template<class T>
+void SlidingAutoRegressive<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::fill(pImpl->mBuffer.begin(), pImpl->mBuffer.end(), 0);
+    std::fill(pImpl->mLagSums.begin(), pImpl->mLagSums.end(), 0);
+    pImpl->mHead = 0;
+    pImpl->mUpdates = 0;
+}
+
+/// Update
+template<class T>
+void SlidingAutoRegressive<T>::update(const int nSamples, const T x[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nSamples <= 0){return;} // Nothing to do
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    const int n = pImpl->mWindowLength;
+    const int order = pImpl->mOrder;
+    auto buffer = pImpl->mBuffer.data();
+    auto r = pImpl->mLagSums.data();
+    int head = pImpl->mHead;
+    for (int i = 0; i < nSamples; ++i)
+    {
+        // Remove the products of the oldest sample
+        auto xOld = buffer[head];
+        r[0] = r[0] - xOld*xOld;
+        for (int k = 1; k <= order; ++k)
+        {
+            r[k] = r[k] - xOld*buffer[(head + k)%n];
+        }
+        // Add the products of the newest sample
+        auto xNew = static_cast<double> (x[i]);
+        buffer[head] = xNew;
+        r[0] = r[0] + xNew*xNew;
+        for (int k = 1; k <= order; ++k)
+        {
+            r[k] = r[k] + xNew*buffer[(head - k + n)%n];
+        }
+        head = (head + 1)%n;
+        pImpl->mUpdates = pImpl->mUpdates + 1;
+        if (pImpl->mUpdates == n)
+        {
+            pImpl->mHead = head;
+            pImpl->recompute();
+        }
+    }
+    pImpl->mHead = head;
+}
+
+/// Autocorrelation
+template<class T>
+std::vector<double> SlidingAutoRegressive<T>::getAutocorrelation() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::vector<double> r(pImpl->mLagSums);
+    for (auto &ri : r){ri = ri/pImpl->mWindowLength;}
+    return r;
+}
+
+/// Coefficients
+template<class T>
+std::vector<double>
+SlidingAutoRegressive<T>::getCoefficients(double *variance) const
+{
+    auto r = getAutocorrelation(); // Throws
+    return levinsonDurbin(pImpl->mOrder, r.data(), variance);
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template std::vector<double>
+RTSeis::Utilities::Math::AutoRegressive::estimate(
+    int, const double [], int, double *, Method);
+template std::vector<double>
+RTSeis::Utilities::Math::AutoRegressive::estimate(
+    int, const float [], int, double *, Method);
+template class RTSeis::Utilities::Math::AutoRegressive::SlidingAutoRegressive<double>;
+template class RTSeis::Utilities::Math::AutoRegressive::SlidingAutoRegressive<float>;
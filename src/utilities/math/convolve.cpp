@@ -3,6 +3,7 @@
 #include <cmath>
 #include <vector>
 #include <cassert>
+#include <algorithm>
 #include <ipps.h>
 #define RTSEIS_LOGGING 1
 #include "private/throw.hpp"
@@ -39,6 +40,100 @@ IppEnum getImplementation(const Convolve::Implementation implementation)
         return ippAlgAuto;
     }
 }
+
+/// Precision-dispatched IPP convolution and correlation kernels
+IppStatus convolveGetBufferSize(const int src1Len, const int src2Len,
+                                const double *, const IppEnum funCfg,
+                                int *bufSize)
+{
+    return ippsConvolveGetBufferSize(src1Len, src2Len, ipp64f,
+                                     funCfg, bufSize);
+}
+IppStatus convolveGetBufferSize(const int src1Len, const int src2Len,
+                                const float *, const IppEnum funCfg,
+                                int *bufSize)
+{
+    return ippsConvolveGetBufferSize(src1Len, src2Len, ipp32f,
+                                     funCfg, bufSize);
+}
+IppStatus convolveKernel(const double *pSrc1, const int src1Len,
+                         const double *pSrc2, const int src2Len,
+                         double *pDst, const IppEnum funCfg, Ipp8u *pBuffer)
+{
+    return ippsConvolve_64f(pSrc1, src1Len, pSrc2, src2Len, pDst,
+                            funCfg, pBuffer);
+}
+IppStatus convolveKernel(const float *pSrc1, const int src1Len,
+                         const float *pSrc2, const int src2Len,
+                         float *pDst, const IppEnum funCfg, Ipp8u *pBuffer)
+{
+    return ippsConvolve_32f(pSrc1, src1Len, pSrc2, src2Len, pDst,
+                            funCfg, pBuffer);
+}
+IppStatus crossCorrGetBufferSize(const int src1Len, const int src2Len,
+                                 const int dstLen, const int lowLag,
+                                 const double *, const IppEnum funCfg,
+                                 int *bufSize)
+{
+    return ippsCrossCorrNormGetBufferSize(src1Len, src2Len, dstLen, lowLag,
+                                          ipp64f, funCfg, bufSize);
+}
+IppStatus crossCorrGetBufferSize(const int src1Len, const int src2Len,
+                                 const int dstLen, const int lowLag,
+                                 const float *, const IppEnum funCfg,
+                                 int *bufSize)
+{
+    return ippsCrossCorrNormGetBufferSize(src1Len, src2Len, dstLen, lowLag,
+                                          ipp32f, funCfg, bufSize);
+}
+IppStatus crossCorrKernel(const double *pSrc1, const int src1Len,
+                          const double *pSrc2, const int src2Len,
+                          double *pDst, const int dstLen, const int lowLag,
+                          const IppEnum funCfg, Ipp8u *pBuffer)
+{
+    return ippsCrossCorrNorm_64f(pSrc1, src1Len, pSrc2, src2Len,
+                                 pDst, dstLen, lowLag, funCfg, pBuffer);
+}
+IppStatus crossCorrKernel(const float *pSrc1, const int src1Len,
+                          const float *pSrc2, const int src2Len,
+                          float *pDst, const int dstLen, const int lowLag,
+                          const IppEnum funCfg, Ipp8u *pBuffer)
+{
+    return ippsCrossCorrNorm_32f(pSrc1, src1Len, pSrc2, src2Len,
+                                 pDst, dstLen, lowLag, funCfg, pBuffer);
+}
+IppStatus autoCorrGetBufferSize(const int srcLen, const int dstLen,
+                                const double *, const IppEnum funCfg,
+                                int *bufSize)
+{
+    return ippsAutoCorrNormGetBufferSize(srcLen, dstLen, ipp64f,
+                                         funCfg, bufSize);
+}
+IppStatus autoCorrGetBufferSize(const int srcLen, const int dstLen,
+                                const float *, const IppEnum funCfg,
+                                int *bufSize)
+{
+    return ippsAutoCorrNormGetBufferSize(srcLen, dstLen, ipp32f,
+                                         funCfg, bufSize);
+}
+IppStatus autoCorrKernel(const double *pSrc, const int srcLen,
+                         double *pDst, const int dstLen,
+                         const IppEnum funCfg, Ipp8u *pBuffer)
+{
+    return ippsAutoCorrNorm_64f(pSrc, srcLen, pDst, dstLen, funCfg, pBuffer);
+}
+IppStatus autoCorrKernel(const float *pSrc, const int srcLen,
+                         float *pDst, const int dstLen,
+                         const IppEnum funCfg, Ipp8u *pBuffer)
+{
+    return ippsAutoCorrNorm_32f(pSrc, srcLen, pDst, dstLen, funCfg, pBuffer);
+}
+
+template<class T>
+T *allocate(const int n)
+{
+    return reinterpret_cast<T *> (ippsMalloc_8u(n*sizeof(T)));
+}
 }
 
 std::vector<double>
@@ -69,11 +164,14 @@ Convolve::convolve(const std::vector<double> &a,
     return c;
 }
 
-void Convolve::convolve(const int src1Len, const double a[],
-                        const int src2Len, const double b[],
-                        const int maxc, int *nc, double *cIn[],
-                        const Convolve::Mode mode,
-                        const Convolve::Implementation implementation)
+namespace
+{
+template<class T>
+void convolveArrays(const int src1Len, const T a[],
+                    const int src2Len, const T b[],
+                    const int maxc, int *nc, T *cIn[],
+                    const Convolve::Mode mode,
+                    const Convolve::Implementation implementation)
 {
     // Check the inputs
     *nc = 0;
@@ -86,7 +184,7 @@ void Convolve::convolve(const int src1Len, const double a[],
     }
     std::pair<int,int> indexes = computeTrimIndices(mode, src1Len, src2Len);
     int fullLen = indexes.second - indexes.first;
-    double *c = *cIn;
+    T *c = *cIn;
     if (maxc < fullLen || c == nullptr)
     {
        if (maxc < fullLen)
@@ -100,8 +198,8 @@ void Convolve::convolve(const int src1Len, const double a[],
     // Figure out the buffer size
     int bufSize = 0;
     IppEnum funCfg = getImplementation(implementation);
-    IppStatus status = ippsConvolveGetBufferSize(src1Len, src2Len, ipp64f,
-                                                 funCfg, &bufSize);
+    IppStatus status = convolveGetBufferSize(src1Len, src2Len, a,
+                                             funCfg, &bufSize);
     if (status != ippStsNoErr)
     {
         RTSEIS_ERRMSG("%s", "Failed to compute buffer size");
@@ -109,36 +207,57 @@ void Convolve::convolve(const int src1Len, const double a[],
     }
     Ipp8u *pBuffer = ippsMalloc_8u(bufSize);
     // Perform the convolution
-    const double *pSrc1 = a;
-    const double *pSrc2 = b;
-    double *pDst = nullptr;
-    if (mode == Mode::FULL)
+    const T *pSrc1 = a;
+    const T *pSrc2 = b;
+    T *pDst = nullptr;
+    if (mode == Convolve::Mode::FULL)
     {
         pDst = c;
     }
     else
     {
-        pDst = ippsMalloc_64f(len);
+        pDst = allocate<T> (len);
     }
-    status = ippsConvolve_64f(pSrc1, src1Len, pSrc2, src2Len, pDst,
-                              funCfg, pBuffer);
+    status = convolveKernel(pSrc1, src1Len, pSrc2, src2Len, pDst,
+                            funCfg, pBuffer);
     ippsFree(pBuffer);
     if (status != ippStsNoErr)
     {
         RTSEIS_ERRMSG("%s", "Failed to compute convolution");
-        if (mode != Mode::FULL){ippsFree(pDst);}
+        if (mode != Convolve::Mode::FULL){ippsFree(pDst);}
         return;
     }
     // The full convolution is desired
     *nc = fullLen;
-    if (mode == Mode::FULL){return;}
+    if (mode == Convolve::Mode::FULL){return;}
     // Trim the full convolution
     int i1 = indexes.first;
     int i2 = indexes.second;
     len = i2 - i1;
-    ippsCopy_64f(&pDst[i1], c, len);
+    std::copy(pDst + i1, pDst + i1 + len, c);
     ippsFree(pDst);
 }
+}
+
+void Convolve::convolve(const int src1Len, const double a[],
+                        const int src2Len, const double b[],
+                        const int maxc, int *nc, double *cIn[],
+                        const Convolve::Mode mode,
+                        const Convolve::Implementation implementation)
+{
+    convolveArrays(src1Len, a, src2Len, b, maxc, nc, cIn,
+                   mode, implementation);
+}
+
+void Convolve::convolve(const int src1Len, const float a[],
+                        const int src2Len, const float b[],
+                        const int maxc, int *nc, float *cIn[],
+                        const Convolve::Mode mode,
+                        const Convolve::Implementation implementation)
+{
+    convolveArrays(src1Len, a, src2Len, b, maxc, nc, cIn,
+                   mode, implementation);
+}
 
 //============================================================================//
 //                                     Correlate                              //
@@ -172,11 +291,14 @@ Convolve::correlate(const std::vector<double> &a,
     return c;
 }
 
-void Convolve::correlate(const int src1Len, const double a[],
-                         const int src2Len, const double b[],
-                         const int maxc, int *nc, double *cIn[],
-                         const Convolve::Mode mode,
-                         const Convolve::Implementation implementation)
+namespace
+{
+template<class T>
+void correlateArrays(const int src1Len, const T a[],
+                     const int src2Len, const T b[],
+                     const int maxc, int *nc, T *cIn[],
+                     const Convolve::Mode mode,
+                     const Convolve::Implementation implementation)
 {
     // Check the inputs
     *nc = 0;
@@ -190,7 +312,7 @@ void Convolve::correlate(const int src1Len, const double a[],
     }
     std::pair<int,int> indexes = computeTrimIndices(mode, src1Len, src2Len);
     int fullLen = indexes.second - indexes.first;
-    double *c = *cIn;
+    T *c = *cIn;
     if (maxc < fullLen || c == nullptr)
     {
        if (maxc < fullLen)
@@ -205,9 +327,9 @@ void Convolve::correlate(const int src1Len, const double a[],
     IppEnum funCfg = getImplementation(implementation) | ippsNormNone;
     int bufSize = 0;
     const int lowLag =-src2Len + 1; //(std::max(src1Len, src2Len) - 1);
-    IppStatus status = ippsCrossCorrNormGetBufferSize(src2Len, src1Len, len,
-                                                      lowLag, ipp64f, funCfg,
-                                                      &bufSize);
+    IppStatus status = crossCorrGetBufferSize(src2Len, src1Len, len,
+                                              lowLag, a, funCfg,
+                                              &bufSize);
     if (status != ippStsNoErr)
     {
         RTSEIS_ERRMSG("%s", "Failed to compute buffer size");
@@ -215,39 +337,60 @@ void Convolve::correlate(const int src1Len, const double a[],
     }
     Ipp8u *pBuffer = ippsMalloc_8u(bufSize);
     // Perform the correlation
-    const double *pSrc1 = a;
-    const double *pSrc2 = b;
-    double *pDst = nullptr;
-    if (mode == Mode::FULL)
+    const T *pSrc1 = a;
+    const T *pSrc2 = b;
+    T *pDst = nullptr;
+    if (mode == Convolve::Mode::FULL)
     {
         pDst = c;
     }
     else
     {
-        pDst = ippsMalloc_64f(len);
+        pDst = allocate<T> (len);
     }
     // Perform the correlation noting that IPP uses a formula whose convention
     // is reverse from Matlab's
-    status = ippsCrossCorrNorm_64f(pSrc2, src2Len, pSrc1, src1Len,
-                                   pDst, len, lowLag, funCfg,
-                                   pBuffer);
+    status = crossCorrKernel(pSrc2, src2Len, pSrc1, src1Len,
+                             pDst, len, lowLag, funCfg,
+                             pBuffer);
     ippsFree(pBuffer);
     if (status != ippStsNoErr)
     {
         RTSEIS_ERRMSG("%s", "Failed to compute correlation");
-        if (mode != Mode::FULL){ippsFree(pDst);}
+        if (mode != Convolve::Mode::FULL){ippsFree(pDst);}
         return;
     }
     // The full correlation is desired
     *nc = fullLen;
-    if (mode == Mode::FULL){return;}
+    if (mode == Convolve::Mode::FULL){return;}
     // Trim the full correlation
     int i1 = indexes.first;
     int i2 = indexes.second;
     len = i2 - i1;
-    ippsCopy_64f(&pDst[i1], c, len);
+    std::copy(pDst + i1, pDst + i1 + len, c);
     ippsFree(pDst);
 }
+}
+
+void Convolve::correlate(const int src1Len, const double a[],
+                         const int src2Len, const double b[],
+                         const int maxc, int *nc, double *cIn[],
+                         const Convolve::Mode mode,
+                         const Convolve::Implementation implementation)
+{
+    correlateArrays(src1Len, a, src2Len, b, maxc, nc, cIn,
+                    mode, implementation);
+}
+
+void Convolve::correlate(const int src1Len, const float a[],
+                         const int src2Len, const float b[],
+                         const int maxc, int *nc, float *cIn[],
+                         const Convolve::Mode mode,
+                         const Convolve::Implementation implementation)
+{
+    correlateArrays(src1Len, a, src2Len, b, maxc, nc, cIn,
+                    mode, implementation);
+}
 
 //============================================================================//
 
@@ -273,10 +416,13 @@ Convolve::autocorrelate(const std::vector<double> &a,
     return c;
 }
 
-void Convolve::autocorrelate(const int src1Len, const double a[],
-                             const int maxc, int *nc, double *cIn[],
-                             const Convolve::Mode mode,
-                             const Convolve::Implementation implementation)
+namespace
+{
+template<class T>
+void autocorrelateArrays(const int src1Len, const T a[],
+                         const int maxc, int *nc, T *cIn[],
+                         const Convolve::Mode mode,
+                         const Convolve::Implementation implementation)
 {
     // Check the inputs
     *nc = 0;
@@ -288,7 +434,7 @@ void Convolve::autocorrelate(const int src1Len, const double a[],
     }
     std::pair<int,int> indexes = computeTrimIndices(mode, src1Len, src1Len);
     int fullLen = indexes.second - indexes.first;
-    double *c = *cIn;
+    T *c = *cIn;
     if (maxc < fullLen || c == nullptr)
     {
        if (maxc < fullLen)
@@ -301,8 +447,8 @@ void Convolve::autocorrelate(const int src1Len, const double a[],
     int len = (2*src1Len - 1)/2 + 1;
     IppEnum funCfg = getImplementation(implementation) | ippsNormNone;
     int bufSize = 0;
-    IppStatus status = ippsAutoCorrNormGetBufferSize(src1Len, len,
-                                                     ipp64f, funCfg, &bufSize);
+    IppStatus status = autoCorrGetBufferSize(src1Len, len,
+                                             a, funCfg, &bufSize);
     if (status != ippStsNoErr)
     {
         RTSEIS_ERRMSG("%s", "Failed to compute buffer size");
@@ -310,10 +456,10 @@ void Convolve::autocorrelate(const int src1Len, const double a[],
     }
     Ipp8u *pBuffer = ippsMalloc_8u(bufSize);
     // Perform the autocorrelation
-    const double *pSrc1 = a;
-    double *pDst = nullptr;
-    pDst = ippsMalloc_64f(len);
-    status = ippsAutoCorrNorm_64f(pSrc1, src1Len, pDst, len, funCfg, pBuffer);
+    const T *pSrc1 = a;
+    T *pDst = nullptr;
+    pDst = allocate<T> (len);
+    status = autoCorrKernel(pSrc1, src1Len, pDst, len, funCfg, pBuffer);
     ippsFree(pBuffer);
     if (status != ippStsNoErr)
     {
@@ -322,27 +468,44 @@ void Convolve::autocorrelate(const int src1Len, const double a[],
         return;
     }
     // Only the first half is computed
-    if (mode == Mode::FULL)
+    if (mode == Convolve::Mode::FULL)
     {
-        ippsFlip_64f(pDst, c, len);
-        ippsCopy_64f(&pDst[1], &c[len], len-1); 
+        std::reverse_copy(pDst, pDst + len, c);
+        std::copy(pDst + 1, pDst + len, c + len); 
         ippsFree(pDst);
     }
     else
     {
-        Ipp64f *scratch = ippsMalloc_64f(2*src1Len - 1);
-        ippsFlip_64f(pDst, scratch, len);
-        ippsCopy_64f(&pDst[1], &scratch[len], len-1); 
+        T *scratch = allocate<T> (2*src1Len - 1);
+        std::reverse_copy(pDst, pDst + len, scratch);
+        std::copy(pDst + 1, pDst + len, scratch + len); 
         ippsFree(pDst);
         // Trim the full autocorrelation
         int i1 = indexes.first;
         int i2 = indexes.second;
         len = i2 - i1; 
-        ippsCopy_64f(&scratch[i1], c, len);
+        std::copy(scratch + i1, scratch + i1 + len, c);
         ippsFree(scratch);
     }
     *nc = fullLen;
 }
+}
+
+void Convolve::autocorrelate(const int src1Len, const double a[],
+                             const int maxc, int *nc, double *cIn[],
+                             const Convolve::Mode mode,
+                             const Convolve::Implementation implementation)
+{
+    autocorrelateArrays(src1Len, a, maxc, nc, cIn, mode, implementation);
+}
+
+void Convolve::autocorrelate(const int src1Len, const float a[],
+                             const int maxc, int *nc, float *cIn[],
+                             const Convolve::Mode mode,
+                             const Convolve::Implementation implementation)
+{
+    autocorrelateArrays(src1Len, a, maxc, nc, cIn, mode, implementation);
+}
 
 //============================================================================//
 
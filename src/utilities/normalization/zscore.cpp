@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <cmath>
 #include <ipps.h>
 #include "rtseis/utilities/normalization/zscore.hpp"
 
@@ -75,7 +76,7 @@ void ZScore::initialize(const double mean,
     pImpl->mMean64f = mean;
     pImpl->mStd64f = std;
     pImpl->mMean32f = static_cast<float> (mean);
-    pImpl->mStd32f = static_cast<float> (mean);
+    pImpl->mStd32f = static_cast<float> (std);
     pImpl->mInitialized = true;
 }
 
@@ -101,6 +102,37 @@ void ZScore::initialize(const int nx, const double x[])
     initialize(pMean, pStdDev); 
 }
 
+void ZScore::initialize(const int nx, const float x[])
+{
+    clear();
+    if (nx < 2 || x == nullptr)
+    {
+        if (nx < 2)
+        {
+            throw std::invalid_argument("nx = " + std::to_string(nx)
+                                     + " must be at least 2");
+        }
+        throw std::invalid_argument("x is NULL");
+    }
+    // Accumulate the moments in double so the statistics match the
+    // double precision variant to within float round-off
+    double pMean = 0;
+    for (int i = 0; i < nx; ++i){pMean = pMean + static_cast<double> (x[i]);}
+    pMean = pMean/static_cast<double> (nx);
+    double pVar = 0;
+    for (int i = 0; i < nx; ++i)
+    {
+        double res = static_cast<double> (x[i]) - pMean;
+        pVar = pVar + res*res;
+    }
+    double pStdDev = std::sqrt(pVar/static_cast<double> (nx - 1));
+    if (pStdDev == 0)
+    {
+        throw std::invalid_argument("x cannot be all the same values");
+    }
+    initialize(pMean, pStdDev);
+}
+
 /// Initialized?
 bool ZScore::isInitialized() const noexcept
 {
@@ -0,0 +1,313 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/quality/activityGate.hpp"
+
+using namespace RTSeis::Utilities::Quality;
+
+template<class T>
+class ActivityGate<T>::ActivityGateImpl
+{
+public:
+    /// The gate and counters of a channel
+    class ChannelState
+    {
+    public:
+        int64_t mPackets = 0;
+        int64_t mSkippedPackets = 0;
+        int64_t mSamples = 0;
+        int64_t mSkippedSamples = 0;
+        int64_t mResumptions = 0;
+        /// The mean of the latest inactive packet
+        double mRestingLevel = 0;
+        /// Inactive samples processed since the last active packet
+        int64_t mQuietSamples = 0;
+        bool mSkipping = true;
+        bool mHaveRestingLevel = false;
+    };
+    /// Checks the channel index.  A negative index selects all channels.
+    void checkChannel(const int channel, const bool allowAll) const
+    {
+        if ((channel < 0 && !allowAll) || channel >= mChannels)
+        {
+            throw std::invalid_argument("channel = " + std::to_string(channel)
+                                      + " must be less than "
+                                      + std::to_string(mChannels));
+        }
+    }
+    /// Sums a counter over the selected channels
+    [[nodiscard]] int64_t count(const int channel,
+                                int64_t ChannelState::*counter) const
+    {
+        checkChannel(channel, true);
+        if (channel >= 0){return mStates[channel].*counter;}
+        int64_t result = 0;
+        for (const auto &state : mStates){result = result + state.*counter;}
+        return result;
+    }
+    std::vector<ChannelState> mStates;
+    double mQuietLevel = 0;
+    int64_t mHoldSamples = 0;
+    int mChannels = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+ActivityGate<T>::ActivityGate() :
+    pImpl(std::make_unique<ActivityGateImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+ActivityGate<T>::ActivityGate(const ActivityGate &gate)
+{
+    *this = gate;
+}
+
+/// Move c'tor
+template<class T>
+ActivityGate<T>::ActivityGate(ActivityGate &&gate) noexcept
+{
+    *this = std::move(gate);
+}
+
+/// Copy assignment
+template<class T>
+ActivityGate<T>& ActivityGate<T>::operator=(const ActivityGate &gate)
+{
+    if (&gate == this){return *this;}
+    pImpl = std::make_unique<ActivityGateImpl> (*gate.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+ActivityGate<T>& ActivityGate<T>::operator=(ActivityGate &&gate) noexcept
+{
+    if (&gate == this){return *this;}
+    pImpl = std::move(gate.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+ActivityGate<T>::~ActivityGate() = default;
+
+/// Clear
+template<class T>
+void ActivityGate<T>::clear() noexcept
+{
+    pImpl = std::make_unique<ActivityGateImpl> ();
+}
+
+/// Initialize
+template<class T>
+void ActivityGate<T>::initialize(const int nChannels,
+                                 const double quietLevel,
+                                 const int holdSamples)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (quietLevel < 0)
+    {
+        throw std::invalid_argument("quietLevel = "
+                                  + std::to_string(quietLevel)
+                                  + " must be non-negative");
+    }
+    if (holdSamples < 0)
+    {
+        throw std::invalid_argument("holdSamples = "
+                                  + std::to_string(holdSamples)
+                                  + " must be non-negative");
+    }
+    pImpl->mStates.resize(nChannels);
+    pImpl->mQuietLevel = quietLevel;
+    pImpl->mHoldSamples = holdSamples;
+    pImpl->mChannels = nChannels;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool ActivityGate<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<class T>
+int ActivityGate<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Update
+template<class T>
+GateDecision ActivityGate<T>::update(const int channel, const int nSamples,
+                                     const T x[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->checkChannel(channel, false);
+    if (nSamples < 1){return GateDecision::SKIP;} // Nothing to do
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    // Peak-to-peak range and mean of the packet
+    T minimum = x[0];
+    T maximum = x[0];
+    double sum = 0;
+    #pragma omp simd reduction(min:minimum) reduction(max:maximum) \
+                     reduction(+:sum)
+    for (int i = 0; i < nSamples; ++i)
+    {
+        minimum = std::min(minimum, x[i]);
+        maximum = std::max(maximum, x[i]);
+        sum = sum + static_cast<double> (x[i]);
+    }
+    auto range = static_cast<double> (maximum) - static_cast<double> (minimum);
+    // std::min and std::max skip NaNs so non-finite samples are detected from
+    // the sum.  Such packets are active so they never set the resting level.
+    bool isActive = !std::isfinite(sum) || !(range <= pImpl->mQuietLevel);
+    // Update the gate
+    auto &state = pImpl->mStates[channel];
+    state.mPackets = state.mPackets + 1;
+    state.mSamples = state.mSamples + nSamples;
+    if (isActive)
+    {
+        state.mQuietSamples = 0;
+        if (state.mSkipping)
+        {
+            // Without a quiet packet the chain starts from the first finite
+            // sample
+            if (!state.mHaveRestingLevel)
+            {
+                auto first = std::find_if(x, x + nSamples, [](const T v)
+                                          {return std::isfinite(v);});
+                state.mRestingLevel = (first != x + nSamples) ?
+                                      static_cast<double> (*first) : 0;
+            }
+            state.mSkipping = false;
+            state.mResumptions = state.mResumptions + 1;
+            return GateDecision::RESUME;
+        }
+        return GateDecision::PROCESS;
+    }
+    state.mRestingLevel = sum/nSamples;
+    state.mHaveRestingLevel = true;
+    // Let the chain ring down before skipping
+    if (!state.mSkipping && state.mQuietSamples < pImpl->mHoldSamples)
+    {
+        state.mQuietSamples = state.mQuietSamples + nSamples;
+        return GateDecision::PROCESS;
+    }
+    state.mSkipping = true;
+    state.mSkippedPackets = state.mSkippedPackets + 1;
+    state.mSkippedSamples = state.mSkippedSamples + nSamples;
+    return GateDecision::SKIP;
+}
+
+/// Skipping?
+template<class T>
+bool ActivityGate<T>::isSkipping(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->checkChannel(channel, false);
+    return pImpl->mStates[channel].mSkipping;
+}
+
+/// Resting level
+template<class T>
+double ActivityGate<T>::getRestingLevel(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->checkChannel(channel, false);
+    return pImpl->mStates[channel].mRestingLevel;
+}
+
+/// Reset
+template<class T>
+void ActivityGate<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    for (auto &state : pImpl->mStates)
+    {
+        state.mRestingLevel = 0;
+        state.mQuietSamples = 0;
+        state.mSkipping = true;
+        state.mHaveRestingLevel = false;
+    }
+}
+
+/// Packets
+template<class T>
+int64_t ActivityGate<T>::getNumberOfPackets(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->count(channel, &ActivityGateImpl::ChannelState::mPackets);
+}
+
+/// Skipped packets
+template<class T>
+int64_t ActivityGate<T>::getNumberOfSkippedPackets(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->count(channel,
+                        &ActivityGateImpl::ChannelState::mSkippedPackets);
+}
+
+/// Samples
+template<class T>
+int64_t ActivityGate<T>::getNumberOfSamples(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->count(channel, &ActivityGateImpl::ChannelState::mSamples);
+}
+
+/// Skipped samples
+template<class T>
+int64_t ActivityGate<T>::getNumberOfSkippedSamples(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->count(channel,
+                        &ActivityGateImpl::ChannelState::mSkippedSamples);
+}
+
+/// Resumptions
+template<class T>
+int64_t ActivityGate<T>::getNumberOfResumptions(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->count(channel,
+                        &ActivityGateImpl::ChannelState::mResumptions);
+}
+
+/// Reset counters
+template<class T>
+void ActivityGate<T>::resetCounters()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    for (auto &state : pImpl->mStates)
+    {
+        state.mPackets = 0;
+        state.mSkippedPackets = 0;
+        state.mSamples = 0;
+        state.mSkippedSamples = 0;
+        state.mResumptions = 0;
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::Quality::ActivityGate<double>;
+template class RTSeis::Utilities::Quality::ActivityGate<float>;
@@ -0,0 +1,487 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/quality/qualityMetrics.hpp"
+#include "rtseis/utilities/quality/qualitySummary.hpp"
+
+using namespace RTSeis::Utilities::Quality;
+
+template<class T>
+class QualityMetrics<T>::QualityMetricsImpl
+{
+public:
+    /// The streaming state of a channel
+    class ChannelState
+    {
+    public:
+        /// The open bin
+        QualitySummary mBin;
+        /// The completed bins
+        std::vector<QualitySummary> mCompleted;
+        /// The previous two samples for the spike test.  mPrevious[1] is
+        /// the latest.
+        double mPrevious[2] = {0, 0};
+        /// The latest sample and the length of the run that it ends
+        double mLastValue = 0;
+        int64_t mRun = 0;
+        /// The expected time of the next packet
+        double mNextTime = 0;
+        /// The latest bin that was opened or reported
+        int64_t mBinIndex = 0;
+        int mPreviousSamples = 0;
+        bool mHaveBin = false;
+        bool mHaveBinIndex = false;
+        bool mHaveTime = false;
+    };
+    /// Forgets the previous samples, e.g., after a gap
+    static void breakContinuity(ChannelState &state)
+    {
+        state.mPreviousSamples = 0;
+        state.mRun = 0;
+    }
+    /// Completes the open bin
+    static void completeBin(ChannelState &state)
+    {
+        if (!state.mHaveBin){return;}
+        state.mCompleted.push_back(std::move(state.mBin));
+        state.mBin = QualitySummary();
+        state.mHaveBin = false;
+    }
+    /// A bin without samples
+    [[nodiscard]] QualitySummary emptyBin(const int64_t binIndex) const
+    {
+        auto startTime = static_cast<double> (binIndex)*mBinDuration;
+        QualitySummary summary;
+        summary.initialize(startTime, startTime + mBinDuration,
+                           mExpectedSamples,
+                           0, 0, 0, 0, 0, 0, 0, 0, 0);
+        return summary;
+    }
+    /// Reports the bins after the latest bin and before binIndex, e.g.,
+    /// during an outage, as empty
+    void reportEmptyBins(ChannelState &state, const int64_t binIndex) const
+    {
+        if (!state.mHaveBinIndex){return;}
+        for (auto k = state.mBinIndex + 1; k < binIndex; ++k)
+        {
+            state.mCompleted.push_back(emptyBin(k));
+        }
+        state.mBinIndex = std::max(state.mBinIndex, binIndex - 1);
+    }
+    /// Opens a bin
+    void openBin(ChannelState &state, const int64_t binIndex) const
+    {
+        reportEmptyBins(state, binIndex);
+        state.mBin = emptyBin(binIndex);
+        state.mBinIndex = binIndex;
+        state.mHaveBin = true;
+        state.mHaveBinIndex = true;
+    }
+    /// The bin containing time t.  A thousandth of a sample of jitter is
+    /// tolerated at the bin boundaries.
+    [[nodiscard]] int64_t binOf(const double t) const
+    {
+        return static_cast<int64_t>
+               (std::floor((t + 1.e-3*mSamplingPeriod)/mBinDuration));
+    }
+    /// Summarizes samples [i1, i2) of the packet x.  The spike test of
+    /// sample i1 - 1 may look at the previous packet.
+    QualitySummary summarize(ChannelState &state, const T x[],
+                             const int i1, const int i2,
+                             const double startTime,
+                             const int64_t nGaps) const
+    {
+        const double clipLevel = mClipLevel;
+        const double spikeThreshold = mSpikeThreshold;
+        // Sample j of the packet where j = -1, -2 are from the previous
+        // packet
+        auto sample = [&](const int j)
+        {
+            return j >= 0 ? static_cast<double> (x[j]) :
+                            state.mPrevious[2 + j];
+        };
+        auto isSpike = [&](const double x0, const double x1, const double x2)
+        {
+            auto d1 = x1 - x0;
+            auto d2 = x2 - x1;
+            return std::abs(d1) > spikeThreshold &&
+                   std::abs(d2) > spikeThreshold && d1*d2 < 0;
+        };
+        // Shift the moments by the first sample to limit cancellation
+        const double shift = static_cast<double> (x[i1]);
+        double s1 = 0;
+        double s2 = 0;
+        double minimum = std::numeric_limits<double>::infinity();
+        double maximum =-std::numeric_limits<double>::infinity();
+        int64_t nClipped = 0;
+        int64_t nSpikes = 0;
+        // The first two samples of the packet need the previous packet
+        const int iSimd = std::min(i2, std::max(i1, 2));
+        for (int i = i1; i < iSimd; ++i)
+        {
+            auto v = static_cast<double> (x[i]);
+            auto d = v - shift;
+            s1 = s1 + d;
+            s2 = s2 + d*d;
+            minimum = std::min(minimum, v);
+            maximum = std::max(maximum, v);
+            if (std::abs(v) >= clipLevel){nClipped = nClipped + 1;}
+            if (i + state.mPreviousSamples >= 2 &&
+                isSpike(sample(i - 2), sample(i - 1), v))
+            {
+                nSpikes = nSpikes + 1;
+            }
+        }
+        #pragma omp simd reduction(+:s1, s2, nClipped, nSpikes) \
+                         reduction(min:minimum) reduction(max:maximum)
+        for (int i = iSimd; i < i2; ++i)
+        {
+            auto v = static_cast<double> (x[i]);
+            auto d = v - shift;
+            s1 = s1 + d;
+            s2 = s2 + d*d;
+            minimum = std::min(minimum, v);
+            maximum = std::max(maximum, v);
+            nClipped = nClipped + (std::abs(v) >= clipLevel ? 1 : 0);
+            auto d1 = static_cast<double> (x[i - 1])
+                    - static_cast<double> (x[i - 2]);
+            auto d2 = v - static_cast<double> (x[i - 1]);
+            nSpikes = nSpikes + ((std::abs(d1) > spikeThreshold &&
+                                  std::abs(d2) > spikeThreshold &&
+                                  d1*d2 < 0) ? 1 : 0);
+        }
+        // Runs of identical samples
+        auto &run = state.mRun;
+        auto &lastValue = state.mLastValue;
+        int64_t longestFlatline = 0;
+        for (int i = i1; i < i2; ++i)
+        {
+            auto v = static_cast<double> (x[i]);
+            run = (run > 0 && v == lastValue) ? run + 1 : 1;
+            lastValue = v;
+            longestFlatline = std::max(longestFlatline, run);
+        }
+        const auto n = static_cast<double> (i2 - i1);
+        auto mean = shift + s1/n;
+        auto sumOfSquaredDeviations = std::max(0.0, s2 - s1*s1/n);
+        QualitySummary summary;
+        summary.initialize(startTime + i1*mSamplingPeriod,
+                           startTime + (i2 - 1)*mSamplingPeriod,
+                           0, i2 - i1, nGaps,
+                           mean, sumOfSquaredDeviations, minimum, maximum,
+                           nClipped, nSpikes, longestFlatline);
+        return summary;
+    }
+    std::vector<ChannelState> mStates;
+    double mSamplingRate = 0;
+    double mSamplingPeriod = 0;
+    double mClipLevel = 0;
+    double mSpikeThreshold = 0;
+    double mBinDuration = 3600;
+    int64_t mExpectedSamples = 0;
+    int mChannels = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+QualityMetrics<T>::QualityMetrics() :
+    pImpl(std::make_unique<QualityMetricsImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+QualityMetrics<T>::QualityMetrics(const QualityMetrics &metrics)
+{
+    *this = metrics;
+}
+
+/// Move c'tor
+template<class T>
+QualityMetrics<T>::QualityMetrics(QualityMetrics &&metrics) noexcept
+{
+    *this = std::move(metrics);
+}
+
+/// Copy assignment
+template<class T>
+QualityMetrics<T>& QualityMetrics<T>::operator=(const QualityMetrics &metrics)
+{
+    if (&metrics == this){return *this;}
+    pImpl = std::make_unique<QualityMetricsImpl> (*metrics.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+QualityMetrics<T>&
+QualityMetrics<T>::operator=(QualityMetrics &&metrics) noexcept
+{
+    if (&metrics == this){return *this;}
+    pImpl = std::move(metrics.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+QualityMetrics<T>::~QualityMetrics() = default;
+
+/// Clear
+template<class T>
+void QualityMetrics<T>::clear() noexcept
+{
+    pImpl = std::make_unique<QualityMetricsImpl> ();
+}
+
+/// Initialize
+template<class T>
+void QualityMetrics<T>::initialize(const int nChannels,
+                                   const double samplingRate,
+                                   const double clipLevel,
+                                   const double spikeThreshold,
+                                   const double binDuration)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = " + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (clipLevel <= 0)
+    {
+        throw std::invalid_argument("clipLevel = " + std::to_string(clipLevel)
+                                  + " must be positive");
+    }
+    if (spikeThreshold <= 0)
+    {
+        throw std::invalid_argument("spikeThreshold = "
+                                  + std::to_string(spikeThreshold)
+                                  + " must be positive");
+    }
+    if (binDuration*samplingRate < 1)
+    {
+        throw std::invalid_argument("binDuration = "
+                                  + std::to_string(binDuration)
+                                  + " must be at least one sample");
+    }
+    pImpl->mStates.resize(nChannels);
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mSamplingPeriod = 1/samplingRate;
+    pImpl->mClipLevel = clipLevel;
+    pImpl->mSpikeThreshold = spikeThreshold;
+    pImpl->mBinDuration = binDuration;
+    pImpl->mExpectedSamples = std::llround(binDuration*samplingRate);
+    pImpl->mChannels = nChannels;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool QualityMetrics<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<class T>
+int QualityMetrics<T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Bin duration
+template<class T>
+double QualityMetrics<T>::getBinDuration() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mBinDuration;
+}
+
+/// Update
+template<class T>
+void QualityMetrics<T>::update(const int channel, const double startTime,
+                               const int nSamples, const T x[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(pImpl->mChannels - 1)
+                                  + "]");
+    }
+    if (nSamples < 1){return;} // Nothing to do
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    auto &channelState = pImpl->mStates[channel];
+    const double dt = pImpl->mSamplingPeriod;
+    const double endTime = startTime + nSamples*dt;
+    // A late packet, e.g., backfill, holds no samples after the previous
+    // packets.  It is summarized without the channel's continuity so the
+    // next in-order packet is not mistaken for a gap.
+    const bool isLate = channelState.mHaveTime &&
+                        endTime <= channelState.mNextTime + 0.5*dt;
+    typename QualityMetricsImpl::ChannelState lateState;
+    auto &state = isLate ? lateState : channelState;
+    // Check the continuity with the previous packet
+    int64_t nGaps = 0;
+    if (state.mHaveTime)
+    {
+        auto lag = startTime - state.mNextTime;
+        if (lag > 0.5*dt){nGaps = 1;}
+        if (std::abs(lag) > 0.5*dt){QualityMetricsImpl::breakContinuity(state);}
+    }
+    if (!isLate)
+    {
+        state.mNextTime = endTime;
+        state.mHaveTime = true;
+    }
+    // Split the packet at the bin boundaries
+    int i1 = 0;
+    while (i1 < nSamples)
+    {
+        auto binIndex = pImpl->binOf(startTime + i1*dt);
+        auto binEnd = static_cast<double> (binIndex + 1)*pImpl->mBinDuration;
+        auto iEnd = static_cast<int64_t>
+                    (std::ceil((binEnd - 1.e-3*dt - startTime)
+                              *pImpl->mSamplingRate));
+        auto i2 = static_cast<int> (std::min(static_cast<int64_t> (nSamples),
+                                    std::max(static_cast<int64_t> (i1 + 1),
+                                             iEnd)));
+        auto segment = pImpl->summarize(state, x, i1, i2, startTime,
+                                        i1 == 0 ? nGaps : 0);
+        if (channelState.mHaveBinIndex &&
+            (binIndex < channelState.mBinIndex ||
+             (binIndex == channelState.mBinIndex && !channelState.mHaveBin)))
+        {
+            // Late data for a completed bin
+            channelState.mCompleted.push_back(std::move(segment));
+        }
+        else
+        {
+            if (channelState.mHaveBin && binIndex > channelState.mBinIndex)
+            {
+                QualityMetricsImpl::completeBin(channelState);
+            }
+            if (!channelState.mHaveBin)
+            {
+                pImpl->openBin(channelState, binIndex);
+            }
+            channelState.mBin.merge(segment);
+        }
+        i1 = i2;
+    }
+    if (isLate){return;}
+    // Save the latest samples for the next packet's spike test
+    if (nSamples >= 2)
+    {
+        state.mPrevious[0] = static_cast<double> (x[nSamples - 2]);
+        state.mPrevious[1] = static_cast<double> (x[nSamples - 1]);
+    }
+    else
+    {
+        state.mPrevious[0] = state.mPrevious[1];
+        state.mPrevious[1] = static_cast<double> (x[0]);
+    }
+    state.mPreviousSamples = std::min(2, state.mPreviousSamples + nSamples);
+}
+
+/// Pop completed summaries
+template<class T>
+std::vector<QualitySummary>
+QualityMetrics<T>::popCompletedSummaries(const int channel)
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(pImpl->mChannels - 1)
+                                  + "]");
+    }
+    std::vector<QualitySummary> result;
+    std::swap(result, pImpl->mStates[channel].mCompleted);
+    return result;
+}
+
+/// Current summary
+template<class T>
+QualitySummary QualityMetrics<T>::getCurrentSummary(const int channel) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(pImpl->mChannels - 1)
+                                  + "]");
+    }
+    const auto &state = pImpl->mStates[channel];
+    if (!state.mHaveBin){return QualitySummary();}
+    return state.mBin;
+}
+
+/// Flush
+template<class T>
+void QualityMetrics<T>::flush()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    for (auto &state : pImpl->mStates)
+    {
+        QualityMetricsImpl::completeBin(state);
+    }
+}
+
+/// Advance
+template<class T>
+void QualityMetrics<T>::advance(const double time)
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    // Bins before this one have ended
+    auto binIndex = static_cast<int64_t>
+                    (std::floor(time/pImpl->mBinDuration));
+    for (auto &state : pImpl->mStates)
+    {
+        if (!state.mHaveBinIndex)
+        {
+            // Start reporting with the bin containing time
+            state.mBinIndex = binIndex - 1;
+            state.mHaveBinIndex = true;
+            continue;
+        }
+        if (state.mHaveBin && state.mBinIndex < binIndex)
+        {
+            QualityMetricsImpl::completeBin(state);
+        }
+        if (!state.mHaveBin){pImpl->reportEmptyBins(state, binIndex);}
+    }
+}
+
+/// Reset
+template<class T>
+void QualityMetrics<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    for (auto &state : pImpl->mStates)
+    {
+        state = typename QualityMetricsImpl::ChannelState();
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::Quality::QualityMetrics<double>;
+template class RTSeis::Utilities::Quality::QualityMetrics<float>;
@@ -0,0 +1,329 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/quality/qualitySummary.hpp"
+
+using namespace RTSeis::Utilities::Quality;
+
+namespace
+{
+/// Identifies a serialized summary and its layout
+constexpr int32_t SERIALIZATION_TAG = 0x52515301; // "RQS" version 1
+}
+
+class QualitySummary::QualitySummaryImpl
+{
+public:
+    /// The fields in their serialized order
+    double mStartTime = 0;
+    double mEndTime = 0;
+    double mMean = 0;
+    double mSumOfSquaredDeviations = 0;
+    double mMinimum = std::numeric_limits<double>::infinity();
+    double mMaximum =-std::numeric_limits<double>::infinity();
+    int64_t mExpected = 0;
+    int64_t mSamples = 0;
+    int64_t mGaps = 0;
+    int64_t mClipped = 0;
+    int64_t mSpikes = 0;
+    int64_t mLongestFlatline = 0;
+};
+
+/// C'tor
+QualitySummary::QualitySummary() :
+    pImpl(std::make_unique<QualitySummaryImpl> ())
+{
+}
+
+/// Copy c'tor
+QualitySummary::QualitySummary(const QualitySummary &summary)
+{
+    *this = summary;
+}
+
+/// Move c'tor
+QualitySummary::QualitySummary(QualitySummary &&summary) noexcept
+{
+    *this = std::move(summary);
+}
+
+/// Copy assignment
+QualitySummary& QualitySummary::operator=(const QualitySummary &summary)
+{
+    if (&summary == this){return *this;}
+    pImpl = std::make_unique<QualitySummaryImpl> (*summary.pImpl);
+    return *this;
+}
+
+/// Move assignment
+QualitySummary& QualitySummary::operator=(QualitySummary &&summary) noexcept
+{
+    if (&summary == this){return *this;}
+    pImpl = std::move(summary.pImpl);
+    return *this;
+}
+
+/// Destructor
+QualitySummary::~QualitySummary() = default;
+
+/// Clear
+void QualitySummary::clear() noexcept
+{
+    pImpl = std::make_unique<QualitySummaryImpl> ();
+}
+
+/// Initialize
+void QualitySummary::initialize(const double startTime, const double endTime,
+                                const int64_t nExpected,
+                                const int64_t nSamples,
+                                const int64_t nGaps,
+                                const double mean,
+                                const double sumOfSquaredDeviations,
+                                const double minimum, const double maximum,
+                                const int64_t nClipped, const int64_t nSpikes,
+                                const int64_t longestFlatline)
+{
+    clear();
+    if (endTime < startTime)
+    {
+        throw std::invalid_argument("endTime = " + std::to_string(endTime)
+                                  + " must be at least startTime = "
+                                  + std::to_string(startTime));
+    }
+    if (nExpected < 0 || nSamples < 0 || nGaps < 0 || nClipped < 0 ||
+        nSpikes < 0 || longestFlatline < 0)
+    {
+        throw std::invalid_argument("Counts must be non-negative");
+    }
+    if (nClipped > nSamples || nSpikes > nSamples)
+    {
+        throw std::invalid_argument("Counts cannot exceed nSamples = "
+                                  + std::to_string(nSamples));
+    }
+    if (sumOfSquaredDeviations < 0)
+    {
+        throw std::invalid_argument("sumOfSquaredDeviations = "
+                                  + std::to_string(sumOfSquaredDeviations)
+                                  + " must be non-negative");
+    }
+    if (nSamples > 0 && minimum > maximum)
+    {
+        throw std::invalid_argument("minimum = " + std::to_string(minimum)
+                                  + " cannot exceed maximum = "
+                                  + std::to_string(maximum));
+    }
+    pImpl->mStartTime = startTime;
+    pImpl->mEndTime = endTime;
+    pImpl->mExpected = nExpected;
+    pImpl->mSamples = nSamples;
+    pImpl->mGaps = nGaps;
+    if (nSamples > 0)
+    {
+        pImpl->mMean = mean;
+        pImpl->mSumOfSquaredDeviations = sumOfSquaredDeviations;
+        pImpl->mMinimum = minimum;
+        pImpl->mMaximum = maximum;
+    }
+    pImpl->mClipped = nClipped;
+    pImpl->mSpikes = nSpikes;
+    pImpl->mLongestFlatline = longestFlatline;
+}
+
+/// Merge
+void QualitySummary::merge(const QualitySummary &summary)
+{
+    const auto &a = *pImpl;
+    const auto &b = *summary.pImpl;
+    QualitySummaryImpl result(a);
+    if (a.mSamples + a.mExpected == 0)
+    {
+        result.mStartTime = b.mStartTime;
+        result.mEndTime = b.mEndTime;
+    }
+    else if (b.mSamples + b.mExpected > 0)
+    {
+        result.mStartTime = std::min(a.mStartTime, b.mStartTime);
+        result.mEndTime = std::max(a.mEndTime, b.mEndTime);
+    }
+    result.mExpected = a.mExpected + b.mExpected;
+    result.mSamples = a.mSamples + b.mSamples;
+    result.mGaps = a.mGaps + b.mGaps;
+    result.mClipped = a.mClipped + b.mClipped;
+    result.mSpikes = a.mSpikes + b.mSpikes;
+    result.mLongestFlatline = std::max(a.mLongestFlatline, b.mLongestFlatline);
+    result.mMinimum = std::min(a.mMinimum, b.mMinimum);
+    result.mMaximum = std::max(a.mMaximum, b.mMaximum);
+    if (result.mSamples > 0)
+    {
+        auto na = static_cast<double> (a.mSamples);
+        auto nb = static_cast<double> (b.mSamples);
+        auto n = na + nb;
+        auto delta = b.mMean - a.mMean;
+        result.mMean = a.mMean + delta*(nb/n);
+        result.mSumOfSquaredDeviations = a.mSumOfSquaredDeviations
+                                       + b.mSumOfSquaredDeviations
+                                       + delta*delta*(na*nb/n);
+    }
+    *pImpl = result;
+}
+
+/// Start time
+double QualitySummary::getStartTime() const noexcept
+{
+    return pImpl->mStartTime;
+}
+
+/// End time
+double QualitySummary::getEndTime() const noexcept
+{
+    return pImpl->mEndTime;
+}
+
+/// Expected number of samples
+int64_t QualitySummary::getExpectedNumberOfSamples() const noexcept
+{
+    return pImpl->mExpected;
+}
+
+/// Number of samples
+int64_t QualitySummary::getNumberOfSamples() const noexcept
+{
+    return pImpl->mSamples;
+}
+
+/// Availability
+double QualitySummary::getAvailability() const noexcept
+{
+    if (pImpl->mExpected < 1){return 0;}
+    auto availability = 100*static_cast<double> (pImpl->mSamples)
+                           /static_cast<double> (pImpl->mExpected);
+    return std::min(100.0, availability);
+}
+
+/// Number of gaps
+int64_t QualitySummary::getNumberOfGaps() const noexcept
+{
+    return pImpl->mGaps;
+}
+
+/// Mean
+double QualitySummary::getMean() const noexcept
+{
+    return pImpl->mMean;
+}
+
+/// RMS
+double QualitySummary::getRMS() const noexcept
+{
+    if (pImpl->mSamples < 1){return 0;}
+    auto n = static_cast<double> (pImpl->mSamples);
+    return std::sqrt(pImpl->mMean*pImpl->mMean
+                   + pImpl->mSumOfSquaredDeviations/n);
+}
+
+/// Standard deviation
+double QualitySummary::getStandardDeviation() const noexcept
+{
+    if (pImpl->mSamples < 1){return 0;}
+    auto n = static_cast<double> (pImpl->mSamples);
+    return std::sqrt(pImpl->mSumOfSquaredDeviations/n);
+}
+
+/// Minimum
+double QualitySummary::getMinimum() const noexcept
+{
+    return pImpl->mMinimum;
+}
+
+/// Maximum
+double QualitySummary::getMaximum() const noexcept
+{
+    return pImpl->mMaximum;
+}
+
+/// Clipped samples
+int64_t QualitySummary::getNumberOfClippedSamples() const noexcept
+{
+    return pImpl->mClipped;
+}
+
+/// Spikes
+int64_t QualitySummary::getNumberOfSpikes() const noexcept
+{
+    return pImpl->mSpikes;
+}
+
+/// Flatline
+int64_t QualitySummary::getLongestFlatline() const noexcept
+{
+    return pImpl->mLongestFlatline;
+}
+
+/// Dead?
+bool QualitySummary::isDead() const noexcept
+{
+    return pImpl->mSamples < 1 || pImpl->mMinimum == pImpl->mMaximum;
+}
+
+/// Serialize
+std::vector<char> QualitySummary::serialize() const
+{
+    const auto &s = *pImpl;
+    const double reals[6] = {s.mStartTime, s.mEndTime, s.mMean,
+                             s.mSumOfSquaredDeviations,
+                             s.mMinimum, s.mMaximum};
+    const int64_t counts[6] = {s.mExpected, s.mSamples, s.mGaps,
+                               s.mClipped, s.mSpikes, s.mLongestFlatline};
+    std::vector<char> bytes(sizeof(SERIALIZATION_TAG) + sizeof(reals)
+                          + sizeof(counts));
+    auto ptr = bytes.data();
+    std::memcpy(ptr, &SERIALIZATION_TAG, sizeof(SERIALIZATION_TAG));
+    ptr = ptr + sizeof(SERIALIZATION_TAG);
+    std::memcpy(ptr, reals, sizeof(reals));
+    ptr = ptr + sizeof(reals);
+    std::memcpy(ptr, counts, sizeof(counts));
+    return bytes;
+}
+
+/// Deserialize
+void QualitySummary::deserialize(const std::vector<char> &bytes)
+{
+    double reals[6];
+    int64_t counts[6];
+    int32_t tag;
+    if (bytes.size() != sizeof(tag) + sizeof(reals) + sizeof(counts))
+    {
+        throw std::invalid_argument("bytes has size "
+                                  + std::to_string(bytes.size())
+                                  + " which is not a summary");
+    }
+    auto ptr = bytes.data();
+    std::memcpy(&tag, ptr, sizeof(tag));
+    if (tag != SERIALIZATION_TAG)
+    {
+        throw std::invalid_argument("bytes is not a summary");
+    }
+    ptr = ptr + sizeof(tag);
+    std::memcpy(reals, ptr, sizeof(reals));
+    ptr = ptr + sizeof(reals);
+    std::memcpy(counts, ptr, sizeof(counts));
+    auto &s = *pImpl;
+    s.mStartTime = reals[0];
+    s.mEndTime = reals[1];
+    s.mMean = reals[2];
+    s.mSumOfSquaredDeviations = reals[3];
+    s.mMinimum = reals[4];
+    s.mMaximum = reals[5];
+    s.mExpected = counts[0];
+    s.mSamples = counts[1];
+    s.mGaps = counts[2];
+    s.mClipped = counts[3];
+    s.mSpikes = counts[4];
+    s.mLongestFlatline = counts[5];
+}
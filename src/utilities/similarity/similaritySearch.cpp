@@ -0,0 +1,373 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/similarity/similaritySearch.hpp"
+
+using namespace RTSeis::Utilities::Similarity;
+
+namespace
+{
+/// The splitmix64 finalizer
+uint64_t mix(uint64_t x)
+{
+    x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27))*0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+}
+
+class SimilaritySearch::SimilaritySearchImpl
+{
+public:
+    /// Computes the key of each table for a fingerprint.  MinHash j is
+    /// the minimum of the multiply-add-shift hash
+    ///   h_j(b) = (a_j (b + 1) + c_j) >> 32
+    /// over the set bits b.
+    void computeKeys(const int nBits, const int bits[], uint64_t keys[]) const
+    {
+        for (int it = 0; it < mTables; ++it)
+        {
+            uint64_t key = static_cast<uint64_t> (it);
+            for (int ir = 0; ir < mHashesPerTable; ++ir)
+            {
+                auto j = static_cast<size_t> (it)*mHashesPerTable + ir;
+                const uint64_t a = mA[j];
+                const uint64_t c = mC[j];
+                uint64_t minHash = std::numeric_limits<uint64_t>::max();
+                for (int ib = 0; ib < nBits; ++ib)
+                {
+                    auto b = static_cast<uint64_t> (bits[ib]) + 1;
+                    minHash = std::min(minHash, (a*b + c) >> 32);
+                }
+                key = mix(key ^ minHash);
+            }
+            keys[it] = key;
+        }
+    }
+    /// Hash function coefficients
+    std::vector<uint64_t> mA;
+    std::vector<uint64_t> mC;
+    /// The [nTables x nFingerprints] keys sorted in each table
+    std::vector<uint64_t> mKeys;
+    /// The [nTables x nFingerprints] fingerprint indices of the keys
+    std::vector<int> mIndices;
+    int mTables = 0;
+    int mHashesPerTable = 0;
+    int mThreshold = 0;
+    int mMaxBucketSize = 0;
+    int mMinimumSeparation = 0;
+    int mFingerprints = 0;
+    bool mHaveIndex = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+SimilaritySearch::SimilaritySearch() :
+    pImpl(std::make_unique<SimilaritySearchImpl> ())
+{
+}
+
+/// Copy c'tor
+SimilaritySearch::SimilaritySearch(const SimilaritySearch &search)
+{
+    *this = search;
+}
+
+/// Move c'tor
+SimilaritySearch::SimilaritySearch(SimilaritySearch &&search) noexcept
+{
+    *this = std::move(search);
+}
+
+/// Copy assignment
+SimilaritySearch& SimilaritySearch::operator=(const SimilaritySearch &search)
+{
+    if (&search == this){return *this;}
+    pImpl = std::make_unique<SimilaritySearchImpl> (*search.pImpl);
+    return *this;
+}
+
+/// Move assignment
+SimilaritySearch&
+SimilaritySearch::operator=(SimilaritySearch &&search) noexcept
+{
+    if (&search == this){return *this;}
+    pImpl = std::move(search.pImpl);
+    return *this;
+}
+
+/// Destructor
+SimilaritySearch::~SimilaritySearch() = default;
+
+/// Clear
+void SimilaritySearch::clear() noexcept
+{
+    pImpl = std::make_unique<SimilaritySearchImpl> ();
+}
+
+/// Initialize
+void SimilaritySearch::initialize(const int nTables,
+                                  const int hashesPerTable,
+                                  const int detectionThreshold,
+                                  const int maxBucketSize,
+                                  const int minimumSeparation,
+                                  const uint64_t seed)
+{
+    clear();
+    if (nTables < 1)
+    {
+        throw std::invalid_argument("nTables = " + std::to_string(nTables)
+                                  + " must be positive");
+    }
+    if (hashesPerTable < 1)
+    {
+        throw std::invalid_argument("hashesPerTable = "
+                                  + std::to_string(hashesPerTable)
+                                  + " must be positive");
+    }
+    if (detectionThreshold < 1 || detectionThreshold > nTables)
+    {
+        throw std::invalid_argument("detectionThreshold = "
+                                  + std::to_string(detectionThreshold)
+                                  + " must be in range [1,"
+                                  + std::to_string(nTables) + "]");
+    }
+    auto nHashes = static_cast<size_t> (nTables)*hashesPerTable;
+    pImpl->mA.resize(nHashes);
+    pImpl->mC.resize(nHashes);
+    std::mt19937_64 generator(seed);
+    for (size_t j = 0; j < nHashes; ++j)
+    {
+        pImpl->mA[j] = generator() | 1; // Odd multiplier
+        pImpl->mC[j] = generator();
+    }
+    pImpl->mTables = nTables;
+    pImpl->mHashesPerTable = hashesPerTable;
+    pImpl->mThreshold = detectionThreshold;
+    pImpl->mMaxBucketSize = maxBucketSize;
+    pImpl->mMinimumSeparation = std::max(1, minimumSeparation);
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+bool SimilaritySearch::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of tables
+int SimilaritySearch::getNumberOfTables() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mTables;
+}
+
+/// Build the index
+void SimilaritySearch::buildIndex(const int nFingerprints, const int nBits,
+                                  const int fingerprints[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->mHaveIndex = false;
+    if (nFingerprints < 1)
+    {
+        throw std::invalid_argument("nFingerprints = "
+                                  + std::to_string(nFingerprints)
+                                  + " must be positive");
+    }
+    if (nBits < 1)
+    {
+        throw std::invalid_argument("nBits = " + std::to_string(nBits)
+                                  + " must be positive");
+    }
+    if (fingerprints == nullptr)
+    {
+        throw std::invalid_argument("fingerprints is NULL");
+    }
+    const int nTables = pImpl->mTables;
+    auto nKeys = static_cast<size_t> (nTables)*nFingerprints;
+    // The keys are computed fingerprint by fingerprint
+    std::vector<uint64_t> keys(nKeys);
+    const auto &impl = *pImpl;
+    #pragma omp parallel for default(shared)
+    for (int i = 0; i < nFingerprints; ++i)
+    {
+        impl.computeKeys(nBits,
+                         fingerprints + static_cast<size_t> (i)*nBits,
+                         keys.data() + static_cast<size_t> (i)*nTables);
+    }
+    // and are then sorted table by table
+    pImpl->mKeys.resize(nKeys);
+    pImpl->mIndices.resize(nKeys);
+    auto sortedKeys = pImpl->mKeys.data();
+    auto sortedIndices = pImpl->mIndices.data();
+    #pragma omp parallel default(shared)
+    {
+    std::vector<std::pair<uint64_t, int>> table(nFingerprints);
+    #pragma omp for
+    for (int it = 0; it < nTables; ++it)
+    {
+        for (int i = 0; i < nFingerprints; ++i)
+        {
+            table[i] = std::pair(keys[static_cast<size_t> (i)*nTables + it],
+                                 i);
+        }
+        std::sort(table.begin(), table.end());
+        auto offset = static_cast<size_t> (it)*nFingerprints;
+        for (int i = 0; i < nFingerprints; ++i)
+        {
+            sortedKeys[offset + i] = table[i].first;
+            sortedIndices[offset + i] = table[i].second;
+        }
+    }
+    } // End parallel
+    pImpl->mFingerprints = nFingerprints;
+    pImpl->mHaveIndex = true;
+}
+
+/// Have index?
+bool SimilaritySearch::haveIndex() const noexcept
+{
+    return pImpl->mHaveIndex;
+}
+
+/// Number of fingerprints
+int SimilaritySearch::getNumberOfFingerprints() const
+{
+    if (!haveIndex()){throw std::runtime_error("Index not built");}
+    return pImpl->mFingerprints;
+}
+
+/// All-pairs search
+std::vector<SimilarPair> SimilaritySearch::findSimilarPairs() const
+{
+    if (!haveIndex()){throw std::runtime_error("Index not built");}
+    const int nTables = pImpl->mTables;
+    const int n = pImpl->mFingerprints;
+    const int maxBucketSize = pImpl->mMaxBucketSize;
+    const int minimumSeparation = pImpl->mMinimumSeparation;
+    const auto keys = pImpl->mKeys.data();
+    const auto indices = pImpl->mIndices.data();
+    // Each colliding pair is encoded as (first << 32) | second
+    std::vector<uint64_t> collisions;
+    #pragma omp parallel default(shared)
+    {
+    std::vector<uint64_t> threadCollisions;
+    #pragma omp for schedule(dynamic)
+    for (int it = 0; it < nTables; ++it)
+    {
+        auto tableKeys = keys + static_cast<size_t> (it)*n;
+        auto tableIndices = indices + static_cast<size_t> (it)*n;
+        int i1 = 0;
+        while (i1 < n)
+        {
+            int i2 = i1 + 1;
+            while (i2 < n && tableKeys[i2] == tableKeys[i1]){i2 = i2 + 1;}
+            if (maxBucketSize < 1 || i2 - i1 <= maxBucketSize)
+            {
+                // Indices within a bucket are sorted
+                for (int j = i1; j < i2; ++j)
+                {
+                    for (int k = j + 1; k < i2; ++k)
+                    {
+                        if (tableIndices[k] - tableIndices[j]
+                            < minimumSeparation)
+                        {
+                            continue;
+                        }
+                        auto code
+                            = (static_cast<uint64_t> (tableIndices[j]) << 32)
+                             | static_cast<uint64_t> (tableIndices[k]);
+                        threadCollisions.push_back(code);
+                    }
+                }
+            }
+            i1 = i2;
+        }
+    }
+    #pragma omp critical(RTSeisSimilaritySearchMerge)
+    {
+        collisions.insert(collisions.end(), threadCollisions.begin(),
+                          threadCollisions.end());
+    }
+    } // End parallel
+    // Count the tables in which each pair collides
+    std::sort(collisions.begin(), collisions.end());
+    std::vector<SimilarPair> pairs;
+    size_t i1 = 0;
+    while (i1 < collisions.size())
+    {
+        auto i2 = i1 + 1;
+        while (i2 < collisions.size() && collisions[i2] == collisions[i1])
+        {
+            i2 = i2 + 1;
+        }
+        auto count = static_cast<int> (i2 - i1);
+        if (count >= pImpl->mThreshold)
+        {
+            SimilarPair pair;
+            pair.first = static_cast<int> (collisions[i1] >> 32);
+            pair.second = static_cast<int> (collisions[i1] & 0xffffffffULL);
+            pair.similarity = count;
+            pairs.push_back(pair);
+        }
+        i1 = i2;
+    }
+    return pairs;
+}
+
+/// Query
+std::vector<SimilarPair> SimilaritySearch::query(const int nBits,
+                                                 const int fingerprint[]) const
+{
+    if (!haveIndex()){throw std::runtime_error("Index not built");}
+    if (nBits < 1)
+    {
+        throw std::invalid_argument("nBits = " + std::to_string(nBits)
+                                  + " must be positive");
+    }
+    if (fingerprint == nullptr)
+    {
+        throw std::invalid_argument("fingerprint is NULL");
+    }
+    const int nTables = pImpl->mTables;
+    const int n = pImpl->mFingerprints;
+    std::vector<uint64_t> queryKeys(nTables);
+    pImpl->computeKeys(nBits, fingerprint, queryKeys.data());
+    std::vector<int> matches;
+    for (int it = 0; it < nTables; ++it)
+    {
+        auto tableKeys = pImpl->mKeys.data() + static_cast<size_t> (it)*n;
+        auto tableIndices = pImpl->mIndices.data()
+                          + static_cast<size_t> (it)*n;
+        auto range = std::equal_range(tableKeys, tableKeys + n,
+                                      queryKeys[it]);
+        for (auto k = range.first; k != range.second; ++k)
+        {
+            matches.push_back(tableIndices[k - tableKeys]);
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    std::vector<SimilarPair> pairs;
+    size_t i1 = 0;
+    while (i1 < matches.size())
+    {
+        auto i2 = i1 + 1;
+        while (i2 < matches.size() && matches[i2] == matches[i1]){i2 = i2 + 1;}
+        auto count = static_cast<int> (i2 - i1);
+        if (count >= pImpl->mThreshold)
+        {
+            SimilarPair pair;
+            pair.first = matches[i1];
+            pair.second =-1;
+            pair.similarity = count;
+            pairs.push_back(pair);
+        }
+        i1 = i2;
+    }
+    return pairs;
+}
@@ -0,0 +1,517 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/similarity/spectralFingerprint.hpp"
+#include "rtseis/transforms/spectrogram.hpp"
+#include "rtseis/transforms/slidingWindowRealDFTParameters.hpp"
+#include "rtseis/transforms/discreteWavelet.hpp"
+#include "rtseis/transforms/enums.hpp"
+
+using namespace RTSeis::Utilities::Similarity;
+namespace Transforms = RTSeis::Transforms;
+
+namespace
+{
+/// Number of spectrogram windows computed by one spectrogram transform
+constexpr int BLOCK_WINDOWS = 512;
+/// Maximum number of images used to estimate the coefficient statistics
+constexpr int MAX_STATISTICS_IMAGES = 2000;
+/// Base 2 logarithm of a power of 2
+int log2Int(const int n)
+{
+    int l = 0;
+    while ((1 << l) < n){l = l + 1;}
+    return l;
+}
+/// True if n is a power of 2 that is at least 2
+bool isPowerOfTwo(const int n)
+{
+    return n > 1 && (n & (n - 1)) == 0;
+}
+/// Median of the first n values of x.  x is reordered.
+double median(const int n, double x[])
+{
+    auto half = x + n/2;
+    std::nth_element(x, half, x + n);
+    auto result = *half;
+    if (n%2 == 0){result = 0.5*(result + *std::max_element(x, half));}
+    return result;
+}
+}
+
+template<class T>
+class SpectralFingerprint<T>::SpectralFingerprintImpl
+{
+public:
+    /// Transforms the spectrogram windows [iw1, iw2) and pools their
+    /// amplitudes into the frequency bands
+    void computeBands(const int iw1, const int iw2, const T x[],
+                      Transforms::Spectrogram<T> &spectrogram)
+    {
+        auto i0 = static_cast<size_t> (iw1)*mWindowLag;
+        spectrogram.transform(spectrogram.getNumberOfSamples(), x + i0);
+        const auto amplitude = spectrogram.getAmplitudePointer();
+        auto nFrequencies = spectrogram.getNumberOfFrequencies();
+        const int nBand = mBandStop - mBandStart;
+        for (int iw = iw1; iw < iw2; ++iw)
+        {
+            auto row = amplitude + static_cast<size_t> (iw - iw1)*nFrequencies;
+            auto bands = mBands.data()
+                       + static_cast<size_t> (iw)*mImageFrequencies;
+            for (int ib = 0; ib < mImageFrequencies; ++ib)
+            {
+                auto k1 = mBandStart + (ib*nBand)/mImageFrequencies;
+                auto k2 = mBandStart + ((ib + 1)*nBand)/mImageFrequencies;
+                double sum = 0;
+                for (int k = k1; k < k2; ++k){sum = sum + row[k];}
+                bands[ib] = sum/(k2 - k1);
+            }
+        }
+    }
+    /// Computes the 2D Haar transform of image i.  The image is an
+    /// [imageLength x nImageFrequencies] matrix.  The rows and then the
+    /// columns are fully decomposed.
+    void haar(const int i, std::vector<double> &image,
+              std::vector<double> &work,
+              Transforms::DiscreteWavelet<double> &rowHaar,
+              Transforms::DiscreteWavelet<double> &columnHaar) const
+    {
+        const int nf = mImageFrequencies;
+        const int nt = mImageLength;
+        auto first = mBands.data() + static_cast<size_t> (i)*mImageLag*nf;
+        image.assign(first, first + static_cast<size_t> (nt)*nf);
+        work.resize(2*std::max(nf, nt));
+        for (int it = 0; it < nt; ++it)
+        {
+            auto row = image.data() + static_cast<size_t> (it)*nf;
+            std::copy(row, row + nf, work.begin());
+            rowHaar.forwardTransform(nf, work.data(), &row);
+        }
+        auto column = work.data() + nt;
+        for (int jf = 0; jf < nf; ++jf)
+        {
+            for (int it = 0; it < nt; ++it){work[it] = image[it*nf + jf];}
+            columnHaar.forwardTransform(nt, work.data(), &column);
+            for (int it = 0; it < nt; ++it){image[it*nf + jf] = column[it];}
+        }
+    }
+    /// Makes the Haar transforms that fully decompose the image
+    void makeHaar(Transforms::DiscreteWavelet<double> &rowHaar,
+                  Transforms::DiscreteWavelet<double> &columnHaar) const
+    {
+        rowHaar.initialize(Transforms::DiscreteWaveletFamily::DAUBECHIES, 1,
+                           log2Int(mImageFrequencies));
+        columnHaar.initialize(Transforms::DiscreteWaveletFamily::DAUBECHIES, 1,
+                              log2Int(mImageLength));
+    }
+    /// The [nWindows x nImageFrequencies] pooled spectrogram
+    std::vector<double> mBands;
+    /// The median and median absolute deviation of each Haar coefficient
+    std::vector<double> mMedian;
+    std::vector<double> mMAD;
+    /// The [nFingerprints x nTop] set bits
+    std::vector<int> mFingerprints;
+    std::vector<double> mTimes;
+    double mSamplingRate = 1;
+    int mWindowLength = 0;
+    int mWindowLag = 0;
+    int mImageLength = 0;
+    int mImageLag = 0;
+    int mImageFrequencies = 0;
+    int mTop = 0;
+    int mBandStart = 0;
+    int mBandStop = 0;
+    int mFingerprintCount = 0;
+    bool mHaveFingerprints = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+SpectralFingerprint<T>::SpectralFingerprint() :
+    pImpl(std::make_unique<SpectralFingerprintImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+SpectralFingerprint<T>::SpectralFingerprint(
+    const SpectralFingerprint &fingerprint)
+{
+    *this = fingerprint;
+}
+
+/// Move c'tor
+template<class T>
+SpectralFingerprint<T>::SpectralFingerprint(
+    SpectralFingerprint &&fingerprint) noexcept
+{
+    *this = std::move(fingerprint);
+}
+
+/// Copy assignment
+template<class T>
+SpectralFingerprint<T>&
+SpectralFingerprint<T>::operator=(const SpectralFingerprint &fingerprint)
+{
+    if (&fingerprint == this){return *this;}
+    pImpl = std::make_unique<SpectralFingerprintImpl> (*fingerprint.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+SpectralFingerprint<T>&
+SpectralFingerprint<T>::operator=(SpectralFingerprint &&fingerprint) noexcept
+{
+    if (&fingerprint == this){return *this;}
+    pImpl = std::move(fingerprint.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+SpectralFingerprint<T>::~SpectralFingerprint() = default;
+
+/// Clear
+template<class T>
+void SpectralFingerprint<T>::clear() noexcept
+{
+    pImpl = std::make_unique<SpectralFingerprintImpl> ();
+}
+
+/// Initialize
+template<class T>
+void SpectralFingerprint<T>::initialize(const double samplingRate,
+                                        const int windowLength,
+                                        const int windowLag,
+                                        const int imageLength,
+                                        const int imageLag,
+                                        const int nImageFrequencies,
+                                        const int nTopCoefficients,
+                                        const double minFrequency,
+                                        const double maxFrequency)
+{
+    clear();
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (windowLength < 2)
+    {
+        throw std::invalid_argument("windowLength = "
+                                  + std::to_string(windowLength)
+                                  + " must be at least 2");
+    }
+    if (windowLag < 1 || windowLag > windowLength)
+    {
+        throw std::invalid_argument("windowLag = " + std::to_string(windowLag)
+                                  + " must be in range [1,"
+                                  + std::to_string(windowLength) + "]");
+    }
+    if (!isPowerOfTwo(imageLength) || !isPowerOfTwo(nImageFrequencies))
+    {
+        if (!isPowerOfTwo(imageLength))
+        {
+            throw std::invalid_argument("imageLength = "
+                                      + std::to_string(imageLength)
+                                      + " must be a power of 2 and at least 2");
+        }
+        throw std::invalid_argument("nImageFrequencies = "
+                                  + std::to_string(nImageFrequencies)
+                                  + " must be a power of 2 and at least 2");
+    }
+    if (imageLag < 1)
+    {
+        throw std::invalid_argument("imageLag = " + std::to_string(imageLag)
+                                  + " must be positive");
+    }
+    auto nCoefficients = imageLength*nImageFrequencies;
+    if (nTopCoefficients < 1 || nTopCoefficients > nCoefficients)
+    {
+        throw std::invalid_argument("nTopCoefficients = "
+                                  + std::to_string(nTopCoefficients)
+                                  + " must be in range [1,"
+                                  + std::to_string(nCoefficients) + "]");
+    }
+    const double nyquist = samplingRate/2;
+    auto fMax = maxFrequency;
+    if (fMax < 0){fMax = nyquist;}
+    if (minFrequency < 0 || minFrequency >= fMax || fMax > nyquist)
+    {
+        throw std::invalid_argument("Frequencies must satisfy 0 <= "
+                                  + std::to_string(minFrequency) + " < "
+                                  + std::to_string(fMax) + " <= "
+                                  + std::to_string(nyquist));
+    }
+    // The DFT length is the window length
+    const double df = samplingRate/windowLength;
+    auto bandStart = static_cast<int> (std::ceil(minFrequency/df - 1.e-10));
+    auto bandStop = std::min(windowLength/2,
+                             static_cast<int> (std::floor(fMax/df + 1.e-10)))
+                  + 1;
+    if (bandStop - bandStart < nImageFrequencies)
+    {
+        throw std::invalid_argument("The band has "
+                                  + std::to_string(bandStop - bandStart)
+                                  + " frequencies but must have at least "
+                                  + std::to_string(nImageFrequencies));
+    }
+    pImpl->mSamplingRate = samplingRate;
+    pImpl->mWindowLength = windowLength;
+    pImpl->mWindowLag = windowLag;
+    pImpl->mImageLength = imageLength;
+    pImpl->mImageLag = imageLag;
+    pImpl->mImageFrequencies = nImageFrequencies;
+    pImpl->mTop = nTopCoefficients;
+    pImpl->mBandStart = bandStart;
+    pImpl->mBandStop = bandStop;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool SpectralFingerprint<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Sampling rate
+template<class T>
+double SpectralFingerprint<T>::getSamplingRate() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamplingRate;
+}
+
+/// Fingerprint length
+template<class T>
+int SpectralFingerprint<T>::getFingerprintLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return 2*pImpl->mImageLength*pImpl->mImageFrequencies;
+}
+
+/// Number of set bits
+template<class T>
+int SpectralFingerprint<T>::getNumberOfTopCoefficients() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mTop;
+}
+
+/// Compute the fingerprints
+template<class T>
+void SpectralFingerprint<T>::compute(const int nSamples, const T x[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->mHaveFingerprints = false;
+    pImpl->mFingerprintCount = 0;
+    const int windowLength = pImpl->mWindowLength;
+    const int windowLag = pImpl->mWindowLag;
+    const int imageLength = pImpl->mImageLength;
+    const int imageLag = pImpl->mImageLag;
+    const int nf = pImpl->mImageFrequencies;
+    int nWindows = 0;
+    if (nSamples >= windowLength)
+    {
+        nWindows = (nSamples - windowLength)/windowLag + 1;
+    }
+    if (nWindows < imageLength)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " is too short to make one image");
+    }
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    // Spectrogram in blocks of windows.  The plans are made serially.
+    const int nBlocks = (nWindows + BLOCK_WINDOWS - 1)/BLOCK_WINDOWS;
+    auto makeSpectrogram = [&](const int nBlockWindows)
+    {
+        Transforms::SlidingWindowRealDFTParameters parameters;
+        parameters.setNumberOfSamples((nBlockWindows - 1)*windowLag
+                                    + windowLength);
+        parameters.setWindow(windowLength, Transforms::SlidingWindowType::HANN);
+        parameters.setNumberOfSamplesInOverlap(windowLength - windowLag);
+        Transforms::Spectrogram<T> spectrogram;
+        spectrogram.initialize(parameters, pImpl->mSamplingRate);
+        return spectrogram;
+    };
+    auto nFullWindows = std::min(nWindows, BLOCK_WINDOWS);
+    auto nLastWindows = nWindows - (nBlocks - 1)*BLOCK_WINDOWS;
+    auto fullSpectrogram = makeSpectrogram(nFullWindows);
+    auto lastSpectrogram = fullSpectrogram;
+    if (nLastWindows != nFullWindows)
+    {
+        lastSpectrogram = makeSpectrogram(nLastWindows);
+    }
+    pImpl->mBands.resize(static_cast<size_t> (nWindows)*nf);
+    auto &impl = *pImpl;
+    #pragma omp parallel default(shared)
+    {
+    Transforms::Spectrogram<T> spectrogram;
+    Transforms::Spectrogram<T> lastBlockSpectrogram;
+    #pragma omp critical(RTSeisSpectralFingerprintPlans)
+    {
+        spectrogram = fullSpectrogram;
+        lastBlockSpectrogram = lastSpectrogram;
+    }
+    #pragma omp for schedule(dynamic)
+    for (int ib = 0; ib < nBlocks; ++ib)
+    {
+        auto iw1 = ib*BLOCK_WINDOWS;
+        auto iw2 = std::min(nWindows, iw1 + BLOCK_WINDOWS);
+        if (ib == nBlocks - 1)
+        {
+            impl.computeBands(iw1, iw2, x, lastBlockSpectrogram);
+        }
+        else
+        {
+            impl.computeBands(iw1, iw2, x, spectrogram);
+        }
+    }
+    } // End parallel
+    // Statistics of the Haar coefficients from a subset of the images
+    const int nImages = (nWindows - imageLength)/imageLag + 1;
+    const int nCoefficients = imageLength*nf;
+    const int stride = (nImages + MAX_STATISTICS_IMAGES - 1)
+                      /MAX_STATISTICS_IMAGES;
+    const int nStatistics = (nImages + stride - 1)/stride;
+    std::vector<double> coefficients(static_cast<size_t> (nStatistics)
+                                    *nCoefficients);
+    Transforms::DiscreteWavelet<double> rowHaar;
+    Transforms::DiscreteWavelet<double> columnHaar;
+    pImpl->makeHaar(rowHaar, columnHaar);
+    #pragma omp parallel default(shared)
+    {
+    auto threadRowHaar = rowHaar;
+    auto threadColumnHaar = columnHaar;
+    std::vector<double> image;
+    std::vector<double> work;
+    #pragma omp for
+    for (int is = 0; is < nStatistics; ++is)
+    {
+        impl.haar(is*stride, image, work, threadRowHaar, threadColumnHaar);
+        std::copy(image.begin(), image.end(),
+                  coefficients.begin() + static_cast<size_t> (is)*nCoefficients);
+    }
+    } // End parallel
+    pImpl->mMedian.resize(nCoefficients);
+    pImpl->mMAD.resize(nCoefficients);
+    #pragma omp parallel default(shared)
+    {
+    std::vector<double> values(nStatistics);
+    #pragma omp for
+    for (int ic = 0; ic < nCoefficients; ++ic)
+    {
+        for (int is = 0; is < nStatistics; ++is)
+        {
+            values[is] = coefficients[static_cast<size_t> (is)*nCoefficients
+                                    + ic];
+        }
+        auto center = median(nStatistics, values.data());
+        for (auto &v : values){v = std::abs(v - center);}
+        impl.mMedian[ic] = center;
+        impl.mMAD[ic] = median(nStatistics, values.data());
+    }
+    } // End parallel
+    // Fingerprints
+    const int nTop = pImpl->mTop;
+    pImpl->mFingerprints.resize(static_cast<size_t> (nImages)*nTop);
+    pImpl->mTimes.resize(nImages);
+    #pragma omp parallel default(shared)
+    {
+    auto threadRowHaar = rowHaar;
+    auto threadColumnHaar = columnHaar;
+    std::vector<double> image;
+    std::vector<double> work;
+    std::vector<double> z(nCoefficients);
+    std::vector<int> order(nCoefficients);
+    #pragma omp for
+    for (int i = 0; i < nImages; ++i)
+    {
+        impl.haar(i, image, work, threadRowHaar, threadColumnHaar);
+        for (int ic = 0; ic < nCoefficients; ++ic)
+        {
+            z[ic] = 0;
+            if (impl.mMAD[ic] > 0)
+            {
+                z[ic] = (image[ic] - impl.mMedian[ic])/impl.mMAD[ic];
+            }
+            order[ic] = ic;
+        }
+        // Largest magnitudes first with ties broken by the index
+        std::nth_element(order.begin(), order.begin() + (nTop - 1),
+                         order.end(),
+                         [&](const int a, const int b)
+                         {
+                             auto za = std::abs(z[a]);
+                             auto zb = std::abs(z[b]);
+                             if (za != zb){return za > zb;}
+                             return a < b;
+                         });
+        auto bits = impl.mFingerprints.data() + static_cast<size_t> (i)*nTop;
+        for (int k = 0; k < nTop; ++k)
+        {
+            auto ic = order[k];
+            bits[k] = 2*ic + (z[ic] < 0 ? 1 : 0);
+        }
+        std::sort(bits, bits + nTop);
+        impl.mTimes[i] = static_cast<double> (i)*imageLag*windowLag
+                        /impl.mSamplingRate;
+    }
+    } // End parallel
+    pImpl->mFingerprintCount = nImages;
+    pImpl->mHaveFingerprints = true;
+}
+
+/// Have fingerprints?
+template<class T>
+bool SpectralFingerprint<T>::haveFingerprints() const noexcept
+{
+    return pImpl->mHaveFingerprints;
+}
+
+/// Number of fingerprints
+template<class T>
+int SpectralFingerprint<T>::getNumberOfFingerprints() const
+{
+    if (!haveFingerprints())
+    {
+        throw std::runtime_error("Fingerprints not computed");
+    }
+    return pImpl->mFingerprintCount;
+}
+
+/// Fingerprint times
+template<class T>
+std::vector<double> SpectralFingerprint<T>::getFingerprintTimes() const
+{
+    if (!haveFingerprints())
+    {
+        throw std::runtime_error("Fingerprints not computed");
+    }
+    return pImpl->mTimes;
+}
+
+/// Fingerprints
+template<class T>
+std::vector<int> SpectralFingerprint<T>::getFingerprints() const
+{
+    if (!haveFingerprints())
+    {
+        throw std::runtime_error("Fingerprints not computed");
+    }
+    return pImpl->mFingerprints;
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::Similarity::SpectralFingerprint<double>;
+template class RTSeis::Utilities::Similarity::SpectralFingerprint<float>;
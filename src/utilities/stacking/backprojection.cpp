@@ -0,0 +1,299 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/stacking/backprojection.hpp"
+
+using namespace RTSeis::Utilities::Stacking;
+
+namespace
+{
+/// Number of grid points in a tile
+constexpr int GRID_BLOCK = 64;
+/// Number of origin times in a tile
+constexpr int TIME_BLOCK = 512;
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class Backprojection<E, T>::BackprojectionImpl
+{
+public:
+    /// Computes the brightness for nOut origin times.  Station s's envelope
+    /// starts at signals + s*leadingDimension.
+    void backproject(const T signals[], const int leadingDimension,
+                     const int nOut, T brightness[]) const
+    {
+        const int nGridPoints = mGridPoints;
+        const int nStations = mStations;
+        const int nGridBlocks = (nGridPoints + GRID_BLOCK - 1)/GRID_BLOCK;
+        const int nTimeBlocks = (nOut + TIME_BLOCK - 1)/TIME_BLOCK;
+        const int nTiles = nGridBlocks*nTimeBlocks;
+        const T xnorm = static_cast<T> (1.0/nStations);
+        const int *delays = mDelays.data();
+        #pragma omp parallel default(shared)
+        {
+        // The [GRID_BLOCK x TIME_BLOCK] tile
+        std::vector<T> tile(static_cast<size_t> (GRID_BLOCK)*TIME_BLOCK);
+        #pragma omp for schedule(dynamic)
+        for (int tileIndex = 0; tileIndex < nTiles; ++tileIndex)
+        {
+            auto g1 = (tileIndex%nGridBlocks)*GRID_BLOCK;
+            auto g2 = std::min(nGridPoints, g1 + GRID_BLOCK);
+            auto t1 = (tileIndex/nGridBlocks)*TIME_BLOCK;
+            auto t2 = std::min(nOut, t1 + TIME_BLOCK);
+            const int nt = t2 - t1;
+            std::fill(tile.begin(), tile.end(), 0);
+            for (int s = 0; s < nStations; ++s)
+            {
+                auto envelope = signals
+                              + static_cast<size_t> (s)*leadingDimension + t1;
+                auto stationDelays = delays
+                                   + static_cast<size_t> (s)*nGridPoints;
+                for (int g = g1; g < g2; ++g)
+                {
+                    const T *__restrict__ src = envelope + stationDelays[g];
+                    T *__restrict__ dst = tile.data()
+                                        + static_cast<size_t> (g - g1)
+                                         *TIME_BLOCK;
+                    #pragma omp simd
+                    for (int t = 0; t < nt; ++t)
+                    {
+                        dst[t] = dst[t] + src[t];
+                    }
+                }
+            }
+            for (int t = 0; t < nt; ++t)
+            {
+                auto image = brightness
+                           + static_cast<size_t> (t1 + t)*nGridPoints;
+                for (int g = g1; g < g2; ++g)
+                {
+                    image[g] = tile[static_cast<size_t> (g - g1)*TIME_BLOCK
+                                  + t]*xnorm;
+                }
+            }
+        }
+        } // End parallel
+    }
+    /// The [nStations x nGridPoints] delays
+    std::vector<int> mDelays;
+    /// The [nStations x maxDelay] saved samples
+    std::vector<T> mHistory;
+    /// The [nStations x (maxDelay + nSamples)] envelopes with the saved
+    /// samples prepended
+    std::vector<T> mExtended;
+    int mStations = 0;
+    int mGridPoints = 0;
+    int mMaxDelay = 0;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+Backprojection<E, T>::Backprojection() :
+    pImpl(std::make_unique<BackprojectionImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+Backprojection<E, T>::Backprojection(const Backprojection &backprojection)
+{
+    *this = backprojection;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+Backprojection<E, T>::Backprojection(
+    Backprojection &&backprojection) noexcept
+{
+    *this = std::move(backprojection);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+Backprojection<E, T>&
+Backprojection<E, T>::operator=(const Backprojection &backprojection)
+{
+    if (&backprojection == this){return *this;}
+    pImpl = std::make_unique<BackprojectionImpl> (*backprojection.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+Backprojection<E, T>&
+Backprojection<E, T>::operator=(Backprojection &&backprojection) noexcept
+{
+    if (&backprojection == this){return *this;}
+    pImpl = std::move(backprojection.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+Backprojection<E, T>::~Backprojection() = default;
+
+/// Clear
+template<RTSeis::ProcessingMode E, class T>
+void Backprojection<E, T>::clear() noexcept
+{
+    pImpl = std::make_unique<BackprojectionImpl> ();
+}
+
+/// Initialize
+template<RTSeis::ProcessingMode E, class T>
+void Backprojection<E, T>::initialize(const int nStations,
+                                      const int nGridPoints,
+                                      const int delays[])
+{
+    clear();
+    if (nStations < 1)
+    {
+        throw std::invalid_argument("nStations = " + std::to_string(nStations)
+                                  + " must be positive");
+    }
+    if (nGridPoints < 1)
+    {
+        throw std::invalid_argument("nGridPoints = "
+                                  + std::to_string(nGridPoints)
+                                  + " must be positive");
+    }
+    if (delays == nullptr){throw std::invalid_argument("delays is NULL");}
+    auto minDelay = *std::min_element(delays,
+                                      delays + static_cast<size_t> (nGridPoints)
+                                              *nStations);
+    if (minDelay < 0)
+    {
+        throw std::invalid_argument("delay = " + std::to_string(minDelay)
+                                  + " must be non-negative");
+    }
+    // Station-major so that a tile reads each station's delays contiguously
+    pImpl->mDelays.resize(static_cast<size_t> (nStations)*nGridPoints);
+    int maxDelay = 0;
+    for (int g = 0; g < nGridPoints; ++g)
+    {
+        for (int s = 0; s < nStations; ++s)
+        {
+            auto delay = delays[static_cast<size_t> (g)*nStations + s];
+            pImpl->mDelays[static_cast<size_t> (s)*nGridPoints + g] = delay;
+            maxDelay = std::max(maxDelay, delay);
+        }
+    }
+    pImpl->mHistory.resize(static_cast<size_t> (nStations)*maxDelay, 0);
+    pImpl->mStations = nStations;
+    pImpl->mGridPoints = nGridPoints;
+    pImpl->mMaxDelay = maxDelay;
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool Backprojection<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of stations
+template<RTSeis::ProcessingMode E, class T>
+int Backprojection<E, T>::getNumberOfStations() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mStations;
+}
+
+/// Number of grid points
+template<RTSeis::ProcessingMode E, class T>
+int Backprojection<E, T>::getNumberOfGridPoints() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mGridPoints;
+}
+
+/// Maximum delay
+template<RTSeis::ProcessingMode E, class T>
+int Backprojection<E, T>::getMaximumDelay() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mMaxDelay;
+}
+
+/// Number of output samples
+template<RTSeis::ProcessingMode E, class T>
+int Backprojection<E, T>::getNumberOfOutputSamples(const int nSamples) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if constexpr (E == RTSeis::ProcessingMode::POST)
+    {
+        return std::max(0, nSamples - pImpl->mMaxDelay);
+    }
+    return std::max(0, nSamples);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void Backprojection<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    std::fill(pImpl->mHistory.begin(), pImpl->mHistory.end(), 0);
+}
+
+/// Apply
+template<RTSeis::ProcessingMode E, class T>
+void Backprojection<E, T>::apply(const int nSamples, const T envelopes[],
+                                 T *brightnessIn[])
+{
+    auto nOut = getNumberOfOutputSamples(nSamples); // Throws
+    if (nOut < 1){return;} // Nothing to do
+    T *brightness = *brightnessIn;
+    if (envelopes == nullptr || brightness == nullptr)
+    {
+        if (envelopes == nullptr)
+        {
+            throw std::invalid_argument("envelopes is NULL");
+        }
+        throw std::invalid_argument("brightness is NULL");
+    }
+    if constexpr (E == RTSeis::ProcessingMode::POST)
+    {
+        pImpl->backproject(envelopes, nSamples, nOut, brightness);
+    }
+    else
+    {
+        const int nStations = pImpl->mStations;
+        const int maxDelay = pImpl->mMaxDelay;
+        const int nExtended = maxDelay + nSamples;
+        pImpl->mExtended.resize(static_cast<size_t> (nStations)*nExtended);
+        for (int s = 0; s < nStations; ++s)
+        {
+            auto extended = pImpl->mExtended.data()
+                          + static_cast<size_t> (s)*nExtended;
+            auto history = pImpl->mHistory.data()
+                         + static_cast<size_t> (s)*maxDelay;
+            auto envelope = envelopes + static_cast<size_t> (s)*nSamples;
+            std::copy(history, history + maxDelay, extended);
+            std::copy(envelope, envelope + nSamples, extended + maxDelay);
+        }
+        pImpl->backproject(pImpl->mExtended.data(), nExtended, nOut,
+                           brightness);
+        // Save the newest samples
+        for (int s = 0; s < nStations; ++s)
+        {
+            auto extended = pImpl->mExtended.data()
+                          + static_cast<size_t> (s)*nExtended;
+            auto history = pImpl->mHistory.data()
+                         + static_cast<size_t> (s)*maxDelay;
+            std::copy(extended + nSamples, extended + nExtended, history);
+        }
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::Stacking::Backprojection<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::Stacking::Backprojection<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::Stacking::Backprojection<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::Stacking::Backprojection<RTSeis::ProcessingMode::REAL_TIME, float>;
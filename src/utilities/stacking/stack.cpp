@@ -0,0 +1,491 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <complex> // Put this before fftw
+#include <fftw/fftw3.h>
+#include "rtseis/utilities/stacking/stack.hpp"
+#include "rtseis/transforms/hilbert.hpp"
+#include "rtseis/transforms/utilities.hpp"
+
+using namespace RTSeis::Utilities::Stacking;
+
+namespace
+{
+/// Number of traces accumulated into one partial sum
+constexpr int BLOCK_SIZE = 32;
+/// Half-width in samples of the windowed-sinc interpolator
+constexpr int SINC_HALF_WIDTH = 8;
+/// Hann windowed sinc evaluated at tau
+double windowedSinc(const double tau)
+{
+    if (std::abs(tau) >= SINC_HALF_WIDTH){return 0;}
+    if (tau == 0){return 1;}
+    auto window = 0.5*(1 + std::cos(M_PI*tau/SINC_HALF_WIDTH));
+    return window*std::sin(M_PI*tau)/(M_PI*tau);
+}
+/// Verifies the shifts are less than the trace length in magnitude
+void checkShifts(const int nTraces, const int nSamples, const double shifts[])
+{
+    if (shifts == nullptr){return;}
+    for (int it = 0; it < nTraces; ++it)
+    {
+        if (!(std::abs(shifts[it]) < nSamples))
+        {
+            throw std::invalid_argument("shifts[" + std::to_string(it)
+                                      + "] = " + std::to_string(shifts[it])
+                                      + " must be in range ("
+                                      + std::to_string(-nSamples) + ","
+                                      + std::to_string(nSamples) + ")");
+        }
+    }
+}
+}
+
+template<class T>
+class Stack<T>::StackImpl
+{
+public:
+    StackImpl() = default;
+    /// The plans are rebuilt rather than copied
+    StackImpl(const StackImpl &stack) :
+        mHilbert(stack.mHilbert),
+        mPower(stack.mPower),
+        mSamples(stack.mSamples),
+        mDFTLength(stack.mDFTLength),
+        mType(stack.mType),
+        mShiftMethod(stack.mShiftMethod),
+        mInitialized(stack.mInitialized)
+    {
+        if (mInitialized &&
+            mShiftMethod == FractionalShiftMethod::FREQUENCY_DOMAIN)
+        {
+            makePlans();
+        }
+    }
+    StackImpl& operator=(const StackImpl &) = delete;
+    ~StackImpl()
+    {
+        releasePlans();
+    }
+    void releasePlans() noexcept
+    {
+        if (mHavePlans)
+        {
+            fftw_destroy_plan(mForwardPlan);
+            fftw_destroy_plan(mInversePlan);
+        }
+        if (mInData != nullptr){fftw_free(mInData);}
+        if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        mInData = nullptr;
+        mSpectrum = nullptr;
+        mHavePlans = false;
+    }
+    /// The plans are executed on per-thread buffers
+    void makePlans()
+    {
+        releasePlans();
+        mInData = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (mDFTLength)
+                              *sizeof(double)));
+        mSpectrum = reinterpret_cast<fftw_complex *>
+                    (fftw_malloc(static_cast<size_t> (mDFTLength/2 + 1)
+                                *sizeof(fftw_complex)));
+        mForwardPlan = fftw_plan_dft_r2c_1d(mDFTLength, mInData, mSpectrum,
+                                            FFTW_ESTIMATE);
+        mInversePlan = fftw_plan_dft_c2r_1d(mDFTLength, mSpectrum, mInData,
+                                            FFTW_ESTIMATE);
+        mHavePlans = true;
+    }
+    /// Per-thread workspace
+    class Workspace
+    {
+    public:
+        explicit Workspace(const StackImpl &stack)
+        {
+            if (stack.mHavePlans)
+            {
+                auto n = static_cast<size_t> (stack.mDFTLength);
+                mInData = static_cast<double *>
+                          (fftw_malloc(n*sizeof(double)));
+                mSpectrum = reinterpret_cast<fftw_complex *>
+                            (fftw_malloc((n/2 + 1)*sizeof(fftw_complex)));
+            }
+            if (stack.mType == StackType::PHASE_WEIGHTED)
+            {
+                mHilbert = stack.mHilbert;
+                mAnalytic.resize(stack.mSamples);
+            }
+            mAligned.resize(stack.mSamples);
+        }
+        Workspace(const Workspace &) = delete;
+        Workspace& operator=(const Workspace &) = delete;
+        ~Workspace()
+        {
+            if (mInData != nullptr){fftw_free(mInData);}
+            if (mSpectrum != nullptr){fftw_free(mSpectrum);}
+        }
+        RTSeis::Transforms::Hilbert<T> mHilbert;
+        std::vector<std::complex<T>> mAnalytic;
+        std::vector<T> mAligned;
+        double *mInData = nullptr;
+        fftw_complex *mSpectrum = nullptr;
+    };
+    /// Computes y[i] = x[i - shift]
+    void shift(const double shift, const T x[], T y[],
+               Workspace &work) const
+    {
+        const int n = mSamples;
+        auto i0 = static_cast<int> (std::floor(shift));
+        auto fraction = shift - i0;
+        // Integer shifts are exact
+        if (fraction == 0)
+        {
+            std::fill(y, y + n, 0);
+            auto iStart = std::max(0, i0);
+            auto iEnd = std::min(n, n + i0);
+            for (int i = iStart; i < iEnd; ++i){y[i] = x[i - i0];}
+            return;
+        }
+        if (mShiftMethod == FractionalShiftMethod::FREQUENCY_DOMAIN)
+        {
+            const int nfft = mDFTLength;
+            auto in = work.mInData;
+            auto spectrum = work.mSpectrum;
+            std::copy(x, x + n, in);
+            std::fill(in + n, in + nfft, 0.0);
+            fftw_execute_dft_r2c(mForwardPlan, in, spectrum);
+            const double dPhase =-2*M_PI*shift/nfft;
+            const double xnorm = 1.0/nfft;
+            for (int k = 0; k < nfft/2 + 1; ++k)
+            {
+                auto ramp = std::polar(xnorm, dPhase*k);
+                std::complex<double> zk(spectrum[k][0], spectrum[k][1]);
+                zk = zk*ramp;
+                spectrum[k][0] = std::real(zk);
+                spectrum[k][1] = std::imag(zk);
+            }
+            fftw_execute_dft_c2r(mInversePlan, spectrum, in);
+            for (int i = 0; i < n; ++i){y[i] = static_cast<T> (in[i]);}
+        }
+        else
+        {
+            // y[i] = sum_m c[m] x[i - i0 - m] with c[m] = k(m - fraction)
+            std::fill(y, y + n, 0);
+            for (int m =-SINC_HALF_WIDTH + 1; m <= SINC_HALF_WIDTH; ++m)
+            {
+                auto cm = static_cast<T> (windowedSinc(m - fraction));
+                auto offset = i0 + m;
+                auto iStart = std::max(0, offset);
+                auto iEnd = std::min(n, n + offset);
+                #pragma omp simd
+                for (int i = iStart; i < iEnd; ++i)
+                {
+                    y[i] = y[i] + cm*x[i - offset];
+                }
+            }
+        }
+    }
+    /// Aligns the traces of a block and accumulates them into the block's
+    /// partial sums
+    void accumulate(const int i1, const int i2, const double shifts[],
+                    const T x[], double sum[], std::complex<double> phase[],
+                    Workspace &work) const
+    {
+        const int n = mSamples;
+        std::fill(sum, sum + n, 0.0);
+        if (mType == StackType::PHASE_WEIGHTED)
+        {
+            std::fill(phase, phase + n, std::complex<double> (0, 0));
+        }
+        auto aligned = work.mAligned.data();
+        for (int it = i1; it < i2; ++it)
+        {
+            auto xt = x + static_cast<size_t> (it)*n;
+            auto tau = (shifts != nullptr) ? shifts[it] : 0.0;
+            shift(tau, xt, aligned, work);
+            if (mType == StackType::NTH_ROOT)
+            {
+                const double root = 1.0/mPower;
+                for (int i = 0; i < n; ++i)
+                {
+                    auto ai = static_cast<double> (aligned[i]);
+                    sum[i] = sum[i]
+                           + std::copysign(std::pow(std::abs(ai), root), ai);
+                }
+                continue;
+            }
+            #pragma omp simd
+            for (int i = 0; i < n; ++i)
+            {
+                sum[i] = sum[i] + static_cast<double> (aligned[i]);
+            }
+            if (mType == StackType::PHASE_WEIGHTED)
+            {
+                auto analytic = work.mAnalytic.data();
+                work.mHilbert.transform(n, aligned, &analytic);
+                for (int i = 0; i < n; ++i)
+                {
+                    auto amplitude = std::abs(analytic[i]);
+                    if (amplitude > 0)
+                    {
+                        phase[i] = phase[i]
+                                 + std::complex<double> (analytic[i])
+                                   /static_cast<double> (amplitude);
+                    }
+                }
+            }
+        }
+    }
+    RTSeis::Transforms::Hilbert<T> mHilbert;
+    /// The [nBlocks x nSamples] partial sums
+    std::vector<double> mPartialSums;
+    /// The [nBlocks x nSamples] partial sums of the phasors
+    std::vector<std::complex<double>> mPartialPhases;
+    fftw_plan mForwardPlan;
+    fftw_plan mInversePlan;
+    double *mInData = nullptr;
+    fftw_complex *mSpectrum = nullptr;
+    double mPower = 2;
+    int mSamples = 0;
+    int mDFTLength = 0;
+    StackType mType = StackType::LINEAR;
+    FractionalShiftMethod mShiftMethod = FractionalShiftMethod::FREQUENCY_DOMAIN;
+    bool mHavePlans = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+Stack<T>::Stack() :
+    pImpl(std::make_unique<StackImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+Stack<T>::Stack(const Stack &stack)
+{
+    *this = stack;
+}
+
+/// Move c'tor
+template<class T>
+Stack<T>::Stack(Stack &&stack) noexcept
+{
+    *this = std::move(stack);
+}
+
+/// Copy assignment
+template<class T>
+Stack<T>& Stack<T>::operator=(const Stack &stack)
+{
+    if (&stack == this){return *this;}
+    pImpl = std::make_unique<StackImpl> (*stack.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+Stack<T>& Stack<T>::operator=(Stack &&stack) noexcept
+{
+    if (&stack == this){return *this;}
+    pImpl = std::move(stack.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+Stack<T>::~Stack() = default;
+
+/// Clear
+template<class T>
+void Stack<T>::clear() noexcept
+{
+    pImpl = std::make_unique<StackImpl> ();
+}
+
+/// Initialize
+template<class T>
+void Stack<T>::initialize(const int nSamples,
+                          const StackType type,
+                          const double power,
+                          const FractionalShiftMethod shiftMethod)
+{
+    clear();
+    if (nSamples < 2)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must be at least 2");
+    }
+    if (type != StackType::LINEAR && power <= 0)
+    {
+        throw std::invalid_argument("power = " + std::to_string(power)
+                                  + " must be positive");
+    }
+    if (type == StackType::PHASE_WEIGHTED)
+    {
+        pImpl->mHilbert.initialize(nSamples);
+    }
+    pImpl->mSamples = nSamples;
+    pImpl->mPower = power;
+    pImpl->mType = type;
+    pImpl->mShiftMethod = shiftMethod;
+    if (shiftMethod == FractionalShiftMethod::FREQUENCY_DOMAIN)
+    {
+        pImpl->mDFTLength
+            = RTSeis::Transforms::DFTUtilities::nextFastLength(2*nSamples);
+        pImpl->makePlans();
+    }
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<class T>
+bool Stack<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of samples
+template<class T>
+int Stack<T>::getNumberOfSamples() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSamples;
+}
+
+/// Stack type
+template<class T>
+StackType Stack<T>::getStackType() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mType;
+}
+
+/// Fractional shift method
+template<class T>
+FractionalShiftMethod Stack<T>::getFractionalShiftMethod() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mShiftMethod;
+}
+
+/// Align
+template<class T>
+void Stack<T>::align(const int nTraces, const int nSamples,
+                     const double shifts[], const T x[], T *yIn[])
+{
+    auto nRef = getNumberOfSamples(); // Throws
+    if (nTraces <= 0){return;} // Nothing to do
+    if (nSamples != nRef)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must equal " + std::to_string(nRef));
+    }
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    checkShifts(nTraces, nSamples, shifts); // Throws
+    const auto &impl = *pImpl;
+    #pragma omp parallel default(shared)
+    {
+    typename StackImpl::Workspace work(impl);
+    #pragma omp for schedule(dynamic)
+    for (int it = 0; it < nTraces; ++it)
+    {
+        auto offset = static_cast<size_t> (it)*nSamples;
+        auto tau = (shifts != nullptr) ? shifts[it] : 0.0;
+        impl.shift(tau, x + offset, y + offset, work);
+    }
+    } // End parallel
+}
+
+/// Stack
+template<class T>
+void Stack<T>::apply(const int nTraces, const int nSamples,
+                     const double shifts[], const T x[], T *yIn[])
+{
+    auto nRef = getNumberOfSamples(); // Throws
+    if (nTraces < 1)
+    {
+        throw std::invalid_argument("nTraces = " + std::to_string(nTraces)
+                                  + " must be positive");
+    }
+    if (nSamples != nRef)
+    {
+        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
+                                  + " must equal " + std::to_string(nRef));
+    }
+    T *y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    checkShifts(nTraces, nSamples, shifts); // Throws
+    const int nBlocks = (nTraces + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    const auto type = pImpl->mType;
+    pImpl->mPartialSums.resize(static_cast<size_t> (nBlocks)*nSamples);
+    if (type == StackType::PHASE_WEIGHTED)
+    {
+        pImpl->mPartialPhases.resize(static_cast<size_t> (nBlocks)*nSamples);
+    }
+    auto partialSums = pImpl->mPartialSums.data();
+    auto partialPhases = pImpl->mPartialPhases.data();
+    const auto &impl = *pImpl;
+    // Accumulate each block's partial sum
+    #pragma omp parallel default(shared)
+    {
+    typename StackImpl::Workspace work(impl);
+    #pragma omp for schedule(dynamic)
+    for (int ib = 0; ib < nBlocks; ++ib)
+    {
+        auto i1 = ib*BLOCK_SIZE;
+        auto i2 = std::min(nTraces, i1 + BLOCK_SIZE);
+        auto offset = static_cast<size_t> (ib)*nSamples;
+        impl.accumulate(i1, i2, shifts, x, partialSums + offset,
+                        partialPhases + offset, work);
+    }
+    } // End parallel
+    // Reduce the partial sums in block order
+    const double xnorm = 1.0/nTraces;
+    const double power = pImpl->mPower;
+    #pragma omp parallel for default(shared)
+    for (int i = 0; i < nSamples; ++i)
+    {
+        double sum = 0;
+        for (int ib = 0; ib < nBlocks; ++ib)
+        {
+            sum = sum + partialSums[static_cast<size_t> (ib)*nSamples + i];
+        }
+        auto mean = sum*xnorm;
+        if (type == StackType::NTH_ROOT)
+        {
+            mean = std::copysign(std::pow(std::abs(mean), power), mean);
+        }
+        else if (type == StackType::PHASE_WEIGHTED)
+        {
+            std::complex<double> phase(0, 0);
+            for (int ib = 0; ib < nBlocks; ++ib)
+            {
+                phase = phase
+                      + partialPhases[static_cast<size_t> (ib)*nSamples + i];
+            }
+            mean = mean*std::pow(std::abs(phase)*xnorm, power);
+        }
+        y[i] = static_cast<T> (mean);
+    }
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::Stacking::Stack<double>;
+template class RTSeis::Utilities::Stacking::Stack<float>;
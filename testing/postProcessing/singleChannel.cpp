@@ -11,6 +11,7 @@
 #define RTSEIS_LOGGING 1
 #include "rtseis/log.h"
 #include "rtseis/postProcessing/singleChannel/waveform.hpp"
+#include "rtseis/postProcessing/singleChannel/chunkedWaveform.hpp"
 #include "rtseis/filterDesign/fir.hpp"
 #include "rtseis/filterDesign/iir.hpp"
 #include "rtseis/filterRepresentations/fir.hpp"
@@ -21,6 +22,7 @@
 #include "rtseis/filterImplementations/firFilter.hpp"
 #include "rtseis/filterImplementations/iiriirFilter.hpp"
 #include "rtseis/filterImplementations/iirFilter.hpp"
+#include "rtseis/filterImplementations/frequencyDomainFilter.hpp"
 
 const std::string dataDir = "data/";
 const std::string taperSolns100FileName = dataDir + "taper100.all.txt";
@@ -43,6 +45,9 @@ int testBandSpecificSOSFilters(const std::vector<double> &x);
 int testBandSpecificIIRFilters(const std::vector<double> &x);
 int testBandSpecificFIRFilters(const std::vector<double> &x);
 int testTaper(void);
+int testFloatPrecision(const std::vector<double> &x);
+int testChunkedWaveform(const std::vector<double> &x);
+int testFrequencyDomainFilter(const std::vector<double> &x);
 void readData(const std::string &fname, std::vector<double> &x);
 
 int main(void)
@@ -143,6 +148,30 @@ int main(void)
         return EXIT_FAILURE;
     }
     RTSEIS_INFOMSG("%s", "Passed window test");
+
+    ierr = testFloatPrecision(gse2);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed float precision test");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed float precision test");
+
+    ierr = testChunkedWaveform(gse2);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed chunked waveform test");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed chunked waveform test");
+
+    ierr = testFrequencyDomainFilter(gse2);
+    if (ierr != EXIT_SUCCESS)
+    {
+        RTSEIS_ERRMSG("%s", "Failed frequency domain filter test");
+        return EXIT_FAILURE;
+    }
+    RTSEIS_INFOMSG("%s", "Passed frequency domain filter test");
     return EXIT_SUCCESS; 
 }
 
@@ -181,6 +210,62 @@ int testFilter(const std::vector<double> &x)
         RTSEIS_ERRMSG("%s", "Failed to print fir filter");
         return EXIT_FAILURE;
     }
+    // Block-parallel filtering
+    try
+    {
+        PostProcessing::SingleChannel::Waveform waveform;
+        waveform.setNumberOfThreads(4);
+        waveform.setData(x);
+        waveform.firFilter(fir);
+        y = waveform.getData();
+    }
+    catch (const std::exception &e)
+    {
+        RTSEIS_ERRMSG("%s", e.what());
+        return EXIT_FAILURE;
+    }
+    ippsNormDiff_L1_64f(yref.data(), y.data(), len, &l1Norm);
+    if (l1Norm > 1.e-8)
+    {
+        RTSEIS_ERRMSG("%s", "Failed parallel fir filter");
+        return EXIT_FAILURE;
+    }
+    // The result does not depend on the number of threads.  The signal
+    // spans several blocks.
+    std::vector<double> xlong;
+    for (int k = 0; k < 8; ++k){xlong.insert(xlong.end(), x.begin(), x.end());}
+    std::vector<double> s({1, -2, 3, 0.5, -1, 0.25, 2});
+    std::vector<double> yfir1, yfirN, yconv1, yconvN;
+    for (int nThreads : {1, 4})
+    {
+        try
+        {
+            PostProcessing::SingleChannel::Waveform waveform;
+            waveform.setNumberOfThreads(nThreads);
+            waveform.setData(xlong);
+            waveform.firFilter(fir, true);
+            (nThreads == 1 ? yfir1 : yfirN) = waveform.getData();
+            waveform.setData(xlong);
+            waveform.convolve(s, ConvolutionMode::FULL,
+                              ConvolutionImplementation::DIRECT);
+            (nThreads == 1 ? yconv1 : yconvN) = waveform.getData();
+        }
+        catch (const std::exception &e)
+        {
+            RTSEIS_ERRMSG("%s", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+    if (yfir1.size() != xlong.size() || yfir1 != yfirN)
+    {
+        RTSEIS_ERRMSG("%s", "FIR filter depends on the number of threads");
+        return EXIT_FAILURE;
+    }
+    if (yconv1.size() != xlong.size() + s.size() - 1 || yconv1 != yconvN)
+    {
+        RTSEIS_ERRMSG("%s", "Convolution depends on the number of threads");
+        return EXIT_FAILURE;
+    }
     return EXIT_SUCCESS;
 }
 
@@ -1256,6 +1341,280 @@ int testTaper()
     return EXIT_SUCCESS;
 }
 
+/// Runs one post-processing chain in the desired precision
+template<class T>
+std::vector<double> processInPrecision(const std::vector<double> &x,
+                                       const double dt, const int iop)
+{
+    namespace SC = PostProcessing::SingleChannel;
+    std::vector<T> xt(x.begin(), x.end());
+    SC::Waveform<T> waveform;
+    waveform.setSamplingPeriod(dt);
+    waveform.setData(xt);
+    waveform.detrend();
+    if (iop == 0)
+    {
+        waveform.demean();
+        waveform.taper(5, SC::TaperParameters::HANN);
+    }
+    else if (iop == 1)
+    {
+        waveform.firLowpassFilter(51, 10, SC::FIRWindow::HAMMING, true);
+    }
+    else if (iop == 2)
+    {
+        waveform.sosBandpassFilter(4, std::make_pair(1.0, 10.0),
+                                   SC::IIRPrototype::BUTTERWORTH, 5, true);
+    }
+    else if (iop == 3)
+    {
+        waveform.iirLowpassFilter(2, 10, SC::IIRPrototype::BUTTERWORTH, 5,
+                                  false);
+    }
+    else if (iop == 4)
+    {
+        waveform.decimate(4, 33);
+    }
+    else if (iop == 5)
+    {
+        waveform.interpolate(dt/2, InterpolationMethod::DFT);
+    }
+    else if (iop == 6)
+    {
+        waveform.interpolate(dt/2,
+                             InterpolationMethod::WEIGHTED_AVERAGE_SLOPES);
+    }
+    else if (iop == 7)
+    {
+        waveform.envelope();
+    }
+    else if (iop == 8)
+    {
+        waveform.firEnvelope(301);
+    }
+    else if (iop == 9)
+    {
+        std::vector<T> s({1, 2, 3, 2, 1});
+        waveform.convolve(s, SC::ConvolutionMode::SAME);
+    }
+    else if (iop == 10)
+    {
+        waveform.normalizeZScore();
+    }
+    auto y = waveform.getData();
+    return std::vector<double> (y.begin(), y.end());
+}
+
+int testFloatPrecision(const std::vector<double> &x)
+{
+    const double dt = 1./200.;
+    // Relative error tolerance of float path w.r.t. double path
+    constexpr double tol = 1.e-3;
+    const std::vector<std::string> names({"taper", "fir", "sos", "iir",
+                                          "decimate", "interpft", "was",
+                                          "envelope", "firEnvelope",
+                                          "convolve", "zscore"});
+    for (int iop = 0; iop < static_cast<int> (names.size()); ++iop)
+    {
+        std::vector<double> y64, y32;
+        try
+        {
+            y64 = processInPrecision<double> (x, dt, iop);
+            y32 = processInPrecision<float>  (x, dt, iop);
+        }
+        catch (const std::exception &e)
+        {
+            RTSEIS_ERRMSG("%s failed with %s", names[iop].c_str(), e.what());
+            return EXIT_FAILURE;
+        }
+        if (y64.size() != y32.size() || y64.empty())
+        {
+            RTSEIS_ERRMSG("Inconsistent %s output sizes: %d %d",
+                          names[iop].c_str(), static_cast<int> (y64.size()),
+                          static_cast<int> (y32.size()));
+            return EXIT_FAILURE;
+        }
+        double ymax = 0;
+        double emax = 0;
+        for (int i = 0; i < static_cast<int> (y64.size()); ++i)
+        {
+            ymax = std::max(ymax, std::abs(y64[i]));
+            emax = std::max(emax, std::abs(y64[i] - y32[i]));
+        }
+        if (emax > tol*std::max(1.0, ymax))
+        {
+            RTSEIS_ERRMSG("Float %s error %e exceeds %e",
+                          names[iop].c_str(), emax, tol*std::max(1.0, ymax));
+            return EXIT_FAILURE;
+        }
+    }
+    // A long trace keeps its sub-sample timing in float precision
+    const double dtLong = 0.01;
+    std::vector<double> xlong(2000000);
+    for (int i = 0; i < static_cast<int> (xlong.size()); ++i)
+    {
+        xlong[i] = std::sin(2*M_PI*1.0*i*dtLong);
+    }
+    std::vector<double> y64, y32;
+    try
+    {
+        y64 = processInPrecision<double> (xlong, dtLong, 6);
+        y32 = processInPrecision<float>  (xlong, dtLong, 6);
+    }
+    catch (const std::exception &e)
+    {
+        RTSEIS_ERRMSG("Long was failed with %s", e.what());
+        return EXIT_FAILURE;
+    }
+    if (y64.size() != y32.size() || y64.empty())
+    {
+        RTSEIS_ERRMSG("%s", "Inconsistent long was output sizes");
+        return EXIT_FAILURE;
+    }
+    double emax = 0;
+    for (int i = 0; i < static_cast<int> (y64.size()); ++i)
+    {
+        emax = std::max(emax, std::abs(y64[i] - y32[i]));
+    }
+    if (emax > tol)
+    {
+        RTSEIS_ERRMSG("Float long was error %e exceeds %e", emax, tol);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+//============================================================================//
+
+int testChunkedWaveform(const std::vector<double> &x)
+{
+    const double dt = 1./200.;
+    auto npts = x.size();
+    double fcV[2] = {0.5*2*dt, 10*2*dt};
+    auto sos = FilterDesign::IIR::designSOSIIRFilter(2, fcV, 5, 0,
+                      FilterDesign::Bandtype::BANDPASS,
+                      FilterDesign::IIRPrototype::BUTTERWORTH,
+                      FilterDesign::IIRFilterDomain::DIGITAL);
+    auto fir = FilterDesign::FIR::FIR1Lowpass(50, 0.4,
+                                              FilterDesign::FIRWindow::HAMMING);
+    // Blocks that do not divide the signal length nor the decimation factor.
+    // Odd blocks stream from a source and even blocks read from memory.
+    const std::vector<int> blockSizes({1, 17, 22, 998, 1001,
+                                       static_cast<int> (npts)});
+    for (int iop = 0; iop < 5; ++iop)
+    {
+        // Reference result
+        Waveform<double> waveform;
+        waveform.setSamplingPeriod(dt);
+        waveform.setData(x);
+        double tol = 1.e-10;
+        if (iop == 0)
+        {
+            waveform.sosFilter(sos, false);
+        }
+        else if (iop == 1)
+        {
+            waveform.firFilter(fir, true);
+        }
+        else if (iop == 2)
+        {
+            waveform.sosFilter(sos, true);
+            tol = 1.e-6; // Truncated impulse response
+        }
+        else if (iop == 3)
+        {
+            waveform.firFilter(fir, false);
+            waveform.decimate(4, 33);
+        }
+        else
+        {
+            waveform.downsample(3);
+        }
+        auto yref = waveform.getData();
+        double ymax = 0;
+        for (const auto &y : yref){ymax = std::max(ymax, std::abs(y));}
+        for (const auto &blockSize : blockSizes)
+        {
+            ChunkedWaveform<double> chunked;
+            chunked.setBlockSize(blockSize);
+            if (iop == 0)
+            {
+                chunked.sosFilter(sos, false);
+            }
+            else if (iop == 1)
+            {
+                chunked.firFilter(fir, true);
+            }
+            else if (iop == 2)
+            {
+                chunked.sosFilter(sos, true);
+            }
+            else if (iop == 3)
+            {
+                chunked.firFilter(fir, false);
+                chunked.decimate(4, 33);
+            }
+            else
+            {
+                chunked.downsample(3);
+            }
+            std::vector<double> y;
+            auto sink = [&y](const int n, const double yblock[])
+            {
+                y.insert(y.end(), yblock, yblock + n);
+            };
+            // Alternate between a streaming source and an in-memory array
+            try
+            {
+                if (blockSize%2 == 1)
+                {
+                    size_t i0 = 0;
+                    auto source = [&](const int nmax, double xblock[])
+                    {
+                        auto n = std::min(npts - i0,
+                                          static_cast<size_t> (nmax));
+                        std::copy(x.data() + i0, x.data() + i0 + n, xblock);
+                        i0 = i0 + n;
+                        return static_cast<int> (n);
+                    };
+                    chunked.process(source, sink);
+                }
+                else
+                {
+                    chunked.process(npts, x.data(), sink);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                RTSEIS_ERRMSG("Chunked processing failed with %s", e.what());
+                return EXIT_FAILURE;
+            }
+            if (y.size() != yref.size() ||
+                chunked.getNumberOfOutputSamples() != yref.size())
+            {
+                RTSEIS_ERRMSG("Operation %d block %d has %d samples not %d",
+                              iop, blockSize, static_cast<int> (y.size()),
+                              static_cast<int> (yref.size()));
+                return EXIT_FAILURE;
+            }
+            double emax = 0;
+            for (size_t i = 0; i < y.size(); ++i)
+            {
+                emax = std::max(emax, std::abs(y[i] - yref[i]));
+            }
+            if (emax > tol*std::max(1.0, ymax))
+            {
+                RTSEIS_ERRMSG("Operation %d block %d error %e too large",
+                              iop, blockSize, emax);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+//============================================================================//
+
 void readData(const std::string &fname, std::vector<double> &x)
 {
     x.reserve(12000);
@@ -1270,3 +1629,82 @@ void readData(const std::string &fname, std::vector<double> &x)
     }
     return;
 }
+
+int testFrequencyDomainFilter(const std::vector<double> &x)
+{
+    const double dt = 1./200.;
+    const int npts = static_cast<int> (x.size());
+    double fcV[2] = {0.5*2*dt, 10*2*dt};
+    auto sos = FilterDesign::IIR::designSOSIIRFilter(2, fcV, 5, 0,
+                      FilterDesign::Bandtype::BANDPASS,
+                      FilterDesign::IIRPrototype::BUTTERWORTH,
+                      FilterDesign::IIRFilterDomain::DIGITAL);
+    Waveform<double> waveform;
+    waveform.setSamplingPeriod(dt);
+    waveform.setData(x);
+    waveform.sosFilter(sos, true);
+    auto yref = waveform.getData();
+    waveform.setZeroPhaseImplementation(ZeroPhaseImplementation::FREQUENCY_DOMAIN);
+    if (waveform.getZeroPhaseImplementation() !=
+        ZeroPhaseImplementation::FREQUENCY_DOMAIN)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to set zero phase implementation");
+        return EXIT_FAILURE;
+    }
+    waveform.setData(x);
+    waveform.sosFilter(sos, true);
+    auto y = waveform.getData();
+    if (static_cast<int> (y.size()) != npts)
+    {
+        RTSEIS_ERRMSG("%s", "Frequency domain filter has wrong length");
+        return EXIT_FAILURE;
+    }
+    // The implementations only differ over the final impulse response length
+    FilterImplementations::FrequencyDomainFilter<double> fdFilter;
+    fdFilter.initialize(sos);
+    auto npad = fdFilter.getPadLength(npts);
+    double ymax = 0;
+    for (const auto &yi : yref){ymax = std::max(ymax, std::abs(yi));}
+    double emax = 0;
+    for (int i = 0; i < npts - npad; ++i)
+    {
+        emax = std::max(emax, std::abs(y[i] - yref[i]));
+    }
+    if (emax > 1.e-6*ymax)
+    {
+        RTSEIS_ERRMSG("Frequency domain sos filter error = %e", emax);
+        return EXIT_FAILURE;
+    }
+    // Tapered bandpass
+    try
+    {
+        waveform.setData(x);
+        waveform.cosineTaperBandpassFilter({0.25, 0.5, 10, 15});
+        y = waveform.getData();
+    }
+    catch (const std::exception &e)
+    {
+        RTSEIS_ERRMSG("Cosine taper bandpass failed with %s", e.what());
+        return EXIT_FAILURE;
+    }
+    if (static_cast<int> (y.size()) != npts)
+    {
+        RTSEIS_ERRMSG("%s", "Cosine taper bandpass has wrong length");
+        return EXIT_FAILURE;
+    }
+    bool lthrew = false;
+    try
+    {
+        waveform.cosineTaperBandpassFilter({0.25, 10, 5, 15});
+    }
+    catch (const std::invalid_argument &e)
+    {
+        lthrew = true;
+    }
+    if (!lthrew)
+    {
+        RTSEIS_ERRMSG("%s", "Failed to detect invalid corners");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <random>
+#include "rtseis/utilities/math/autoRegressive.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace RTSeis::Utilities::Math::AutoRegressive;
+
+/// Generates an AR(2) process x[n] = 1.2 x[n-1] - 0.6 x[n-2] + e[n]
+std::vector<double> makeAR2(const int n)
+{
+    std::mt19937 rng(4082);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<double> x(n, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        x[i] = noise(rng);
+        if (i > 0){x[i] = x[i] + 1.2*x[i - 1];}
+        if (i > 1){x[i] = x[i] - 0.6*x[i - 2];}
+    }
+    return x;
+}
+
+TEST(UtilitiesAutoRegressive, estimate)
+{
+    const int n = 20000;
+    auto x = makeAR2(n);
+    for (auto method : {Method::BURG, Method::YULE_WALKER})
+    {
+        double variance;
+        auto a = estimate(n, x.data(), 2, &variance, method);
+        ASSERT_EQ(static_cast<int> (a.size()), 3);
+        EXPECT_NEAR(a[0],  1.0, 1.e-14);
+        EXPECT_NEAR(a[1], -1.2, 0.02);
+        EXPECT_NEAR(a[2],  0.6, 0.02);
+        EXPECT_NEAR(variance, 1, 0.05);
+    }
+    // Levinson-Durbin on the exact autocorrelation of an AR(1)
+    double phi = 0.5;
+    std::vector<double> r{1, phi, phi*phi, phi*phi*phi};
+    double variance;
+    auto a = levinsonDurbin(3, r.data(), &variance);
+    EXPECT_NEAR(a[1], -phi, 1.e-14);
+    EXPECT_NEAR(a[2], 0, 1.e-14);
+    EXPECT_NEAR(a[3], 0, 1.e-14);
+    EXPECT_NEAR(variance, 1 - phi*phi, 1.e-14);
+    EXPECT_THROW(estimate(2, x.data(), 2), std::invalid_argument);
+}
+
+TEST(UtilitiesAutoRegressive, sliding)
+{
+    const int n = 5000;
+    const int windowLength = 700;
+    const int order = 3;
+    auto x = makeAR2(n);
+    SlidingAutoRegressive<double> ar;
+    EXPECT_NO_THROW(ar.initialize(windowLength, order));
+    EXPECT_EQ(ar.getWindowLength(), windowLength);
+    EXPECT_EQ(ar.getOrder(), order);
+    // Stream in uneven packets and compare to the batch estimate
+    int i0 = 0;
+    int packet = 1;
+    while (i0 < n)
+    {
+        auto nCopy = std::min(packet, n - i0);
+        ar.update(nCopy, x.data() + i0);
+        i0 = i0 + nCopy;
+        packet = packet%251 + 17;
+        if (i0 < windowLength){continue;}
+        double variance, varianceRef;
+        auto a = ar.getCoefficients(&variance);
+        auto aRef = estimate(windowLength, x.data() + i0 - windowLength,
+                             order, &varianceRef, Method::YULE_WALKER);
+        for (int k = 0; k <= order; ++k)
+        {
+            EXPECT_NEAR(a[k], aRef[k], 1.e-10);
+        }
+        EXPECT_NEAR(variance, varianceRef, 1.e-10);
+    }
+    // Copy and reset
+    auto arCopy = ar;
+    EXPECT_EQ(arCopy.getAutocorrelation(), ar.getAutocorrelation());
+    ar.resetInitialConditions();
+    for (auto r : ar.getAutocorrelation()){EXPECT_EQ(r, 0);}
+}
+
+}
@@ -6,9 +6,12 @@
 #include <cmath>
 #include <vector>
 #include <chrono>
+#include <random>
+#include <algorithm>
 #include <ipps.h>
 #include "rtseis/utilities/characteristicFunction/classicSTALTA.hpp"
 #include "rtseis/utilities/characteristicFunction/carlSTALTA.hpp"
+#include "rtseis/utilities/characteristicFunction/subspaceDetector.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -91,6 +94,144 @@ TEST(UtilitiesCharacteristicFunction, carlSTALTA)
 */
 }
 
+TEST(UtilitiesCharacteristicFunction, subspaceDetector)
+{
+    const int nChannels = 3;
+    const int templateLength = 100;
+    const int nTemplates = 10;
+    const int nSamples = 5000;
+    const int onset = 3000;
+    const int nRows = nChannels*templateLength;
+    // Templates are mixtures of two waveforms so they span a 2D subspace
+    std::mt19937 rng(3030);
+    std::normal_distribution<double> gaussian(0, 1);
+    std::vector<double> w1(nRows);
+    std::vector<double> w2(nRows);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        for (int i = 0; i < templateLength; ++i)
+        {
+            auto t = static_cast<double> (i)/templateLength;
+            w1[c*templateLength + i] = std::exp(-4*t)
+                                      *std::sin(2*M_PI*(5 + c)*t);
+            w2[c*templateLength + i] = std::exp(-6*t)
+                                      *std::cos(2*M_PI*(9 - c)*t);
+        }
+    }
+    std::vector<double> templates(nTemplates*nRows);
+    for (int it = 0; it < nTemplates; ++it)
+    {
+        auto a = gaussian(rng);
+        auto b = gaussian(rng);
+        for (int i = 0; i < nRows; ++i)
+        {
+            templates[it*nRows + i] = a*w1[i] + b*w2[i];
+        }
+    }
+    // Noise with an event that is a new mixture of the waveforms
+    std::vector<double> x(nChannels*nSamples);
+    for (auto &v : x){v = 0.01*gaussian(rng);}
+    for (int c = 0; c < nChannels; ++c)
+    {
+        for (int i = 0; i < templateLength; ++i)
+        {
+            x[c*nSamples + onset + i] += 0.3*w1[c*templateLength + i]
+                                       - 0.8*w2[c*templateLength + i];
+        }
+    }
+    SubspaceDetector<RTSeis::ProcessingMode::POST, double> detector;
+    EXPECT_NO_THROW(detector.initialize(nChannels, templateLength, nTemplates,
+                                        templates.data(), 2));
+    EXPECT_EQ(detector.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(detector.getTemplateLength(), templateLength);
+    EXPECT_EQ(detector.getDimension(), 2);
+    auto s = detector.getSingularValues();
+    ASSERT_EQ(static_cast<int> (s.size()), nTemplates);
+    EXPECT_LT(s[2], 1.e-10*s[0]);
+    EXPECT_NEAR(detector.getCapturedEnergyFraction(), 1, 1.e-12);
+    std::vector<double> y(nSamples);
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(detector.apply(nSamples, x.data(), &yPtr));
+    // Compare to the direct projection onto the orthonormalized waveforms
+    auto dot = [](const std::vector<double> &a, const std::vector<double> &b)
+    {
+        return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+    };
+    std::vector<double> u1(w1);
+    std::vector<double> u2(w2);
+    auto norm1 = std::sqrt(dot(u1, u1));
+    for (auto &v : u1){v = v/norm1;}
+    auto proj = dot(u1, u2);
+    for (int i = 0; i < nRows; ++i){u2[i] = u2[i] - proj*u1[i];}
+    auto norm2 = std::sqrt(dot(u2, u2));
+    for (auto &v : u2){v = v/norm2;}
+    double error = 0;
+    for (int n = 0; n < nSamples; ++n)
+    {
+        double p1 = 0;
+        double p2 = 0;
+        double energy = 0;
+        for (int c = 0; c < nChannels; ++c)
+        {
+            for (int i = 0; i < templateLength; ++i)
+            {
+                auto k = n - templateLength + 1 + i;
+                if (k < 0){continue;}
+                auto xi = x[c*nSamples + k];
+                p1 = p1 + u1[c*templateLength + i]*xi;
+                p2 = p2 + u2[c*templateLength + i]*xi;
+                energy = energy + xi*xi;
+            }
+        }
+        error = std::max(error, std::abs(y[n] - (p1*p1 + p2*p2)/energy));
+    }
+    EXPECT_LT(error, 1.e-10);
+    // The event is detected and the noise is not
+    auto peak = std::distance(y.begin(), std::max_element(y.begin(), y.end()));
+    EXPECT_EQ(peak, onset + templateLength - 1);
+    EXPECT_GT(y[peak], 0.95);
+    EXPECT_LT(*std::max_element(y.begin() + templateLength,
+                                y.begin() + onset), 0.2);
+    // The real-time detector matches on packets of varying size
+    SubspaceDetector<RTSeis::ProcessingMode::REAL_TIME, double> rtDetector;
+    rtDetector.initialize(nChannels, templateLength, nTemplates,
+                          templates.data(), 2);
+    auto rtCopy = rtDetector;
+    std::vector<double> yRT(nSamples);
+    std::vector<double> packet;
+    int i1 = 0;
+    int packetSize = 1;
+    while (i1 < nSamples)
+    {
+        auto nPacket = std::min(packetSize, nSamples - i1);
+        packet.resize(nChannels*nPacket);
+        for (int c = 0; c < nChannels; ++c)
+        {
+            std::copy(x.begin() + c*nSamples + i1,
+                      x.begin() + c*nSamples + i1 + nPacket,
+                      packet.begin() + c*nPacket);
+        }
+        auto yRTPtr = yRT.data() + i1;
+        rtCopy.apply(nPacket, packet.data(), &yRTPtr);
+        i1 = i1 + nPacket;
+        packetSize = (packetSize*7)%1500 + 1;
+    }
+    error = 0;
+    for (int n = 0; n < nSamples; ++n)
+    {
+        error = std::max(error, std::abs(yRT[n] - y[n]));
+    }
+    EXPECT_LT(error, 1.e-10);
+    // Errors
+    EXPECT_THROW(detector.initialize(nChannels, templateLength, nTemplates,
+                                     templates.data(), nTemplates + 1),
+                 std::invalid_argument);
+    std::fill(templates.begin(), templates.begin() + nRows, 0.0);
+    EXPECT_THROW(detector.initialize(nChannels, templateLength, nTemplates,
+                                     templates.data(), 2),
+                 std::invalid_argument);
+}
+
 std::vector<double> computeCarlSTALTA(const int n,
                                       const double x[],
                                       const int nsta,
@@ -2,11 +2,14 @@
 #include <vector>
 #include <cmath>
 #include <complex>
+#include <random>
+#include <algorithm>
 #include "rtseis/filterDesign/response.hpp"
 #include "rtseis/filterDesign/iir.hpp"
 #include "rtseis/filterRepresentations/ba.hpp"
 #include "rtseis/filterRepresentations/zpk.hpp"
 #include "rtseis/deconvolution/instruments/woodAnderson.hpp"
+#include "rtseis/deconvolution/receiverFunction.hpp"
 #include <gtest/gtest.h>
 namespace
 {
@@ -45,4 +48,116 @@ TEST(Deconvolution, WoodAnderson)
     EXPECT_NEAR(pi,  om0*rad, 1.e-13); //  4.712388980384689
 }
 
+TEST(Deconvolution, ReceiverFunction)
+{
+    using namespace RTSeis::Deconvolution;
+    const int nSamples = 1024;
+    const double samplingRate = 20;
+    const double gaussianWidth = 2.5;
+    const double timeShift = 5;
+    // A broadband source and receiver functions made of a few spikes
+    std::mt19937 rng(1999);
+    std::normal_distribution<double> gaussian(0, 1);
+    const int nEvents = 5;
+    const std::vector<int> lags({0, 40, 90});
+    const std::vector<double> radial({1, 0.4, -0.25});
+    const int transverseLag = 60;
+    const double transverse = 0.2;
+    std::vector<double> denominators(nEvents*nSamples, 0);
+    std::vector<double> numerators(2*nEvents*nSamples, 0);
+    for (int ie = 0; ie < nEvents; ++ie)
+    {
+        auto z = denominators.data() + ie*nSamples;
+        for (int i = 0; i < 300; ++i)
+        {
+            z[i] = gaussian(rng)*std::exp(-i/80.0);
+        }
+        auto r = numerators.data() + 2*ie*nSamples;
+        auto t = r + nSamples;
+        for (int i = 0; i < 300; ++i)
+        {
+            for (int k = 0; k < static_cast<int> (lags.size()); ++k)
+            {
+                r[i + lags[k]] += radial[k]*z[i];
+            }
+            t[i + transverseLag] += transverse*z[i];
+        }
+    }
+    // The expected receiver functions are unit peak Gaussian pulses
+    auto pulse = [&](const int i, const int lag)
+    {
+        auto tau = i/samplingRate - lag/samplingRate - timeShift;
+        return std::exp(-gaussianWidth*gaussianWidth*tau*tau);
+    };
+    std::vector<double> radialRef(nSamples, 0);
+    std::vector<double> transverseRef(nSamples, 0);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        for (int k = 0; k < static_cast<int> (lags.size()); ++k)
+        {
+            radialRef[i] += radial[k]*pulse(i, lags[k]);
+        }
+        transverseRef[i] = transverse*pulse(i, transverseLag);
+    }
+    for (const auto method : {ReceiverFunctionMethod::ITERATIVE_TIME_DOMAIN,
+                              ReceiverFunctionMethod::WATER_LEVEL})
+    {
+        ReceiverFunction<double> rf;
+        EXPECT_NO_THROW(rf.initialize(nSamples, samplingRate, method,
+                                      gaussianWidth, timeShift, 1.e-6,
+                                      1000, 1.e-8));
+        EXPECT_EQ(rf.getMethod(), method);
+        EXPECT_EQ(rf.getNumberOfSamples(), nSamples);
+        std::vector<double> rfs(2*nEvents*nSamples);
+        auto rfPtr = rfs.data();
+        EXPECT_NO_THROW(rf.apply(nEvents, nSamples, 2, numerators.data(),
+                                 denominators.data(), &rfPtr));
+        for (int ie = 0; ie < nEvents; ++ie)
+        {
+            double error = 0;
+            for (int i = 0; i < nSamples; ++i)
+            {
+                error = std::max(error,
+                                 std::abs(rfs[2*ie*nSamples + i]
+                                        - radialRef[i]));
+                error = std::max(error,
+                                 std::abs(rfs[(2*ie + 1)*nSamples + i]
+                                        - transverseRef[i]));
+            }
+            EXPECT_LT(error, 1.e-2);
+        }
+        auto fits = rf.getFits();
+        ASSERT_EQ(static_cast<int> (fits.size()), 2*nEvents);
+        for (const auto &fit : fits){EXPECT_GT(fit, 0.999);}
+        // Events are independent
+        ReceiverFunction<double> rfCopy(rf);
+        std::vector<double> rfs1(2*nSamples);
+        rfPtr = rfs1.data();
+        rfCopy.apply(1, nSamples, 2, numerators.data() + 6*nSamples,
+                     denominators.data() + 3*nSamples, &rfPtr);
+        for (int i = 0; i < 2*nSamples; ++i)
+        {
+            EXPECT_EQ(rfs1[i], rfs[6*nSamples + i]);
+        }
+        // Deconvolving a signal from itself is the Gaussian
+        rfPtr = rfs1.data();
+        rfCopy.apply(1, nSamples, 1, denominators.data(),
+                     denominators.data(), &rfPtr);
+        auto peak = std::distance(rfs1.begin(),
+                                  std::max_element(rfs1.begin(),
+                                                   rfs1.begin() + nSamples));
+        EXPECT_EQ(peak, static_cast<int> (timeShift*samplingRate));
+        EXPECT_NEAR(rfs1[peak], 1, 1.e-6);
+    }
+    ReceiverFunction<double> rf;
+    EXPECT_THROW(rf.initialize(nSamples, samplingRate,
+                               ReceiverFunctionMethod::WATER_LEVEL,
+                               gaussianWidth, nSamples/samplingRate),
+                 std::invalid_argument);
+    EXPECT_THROW(rf.initialize(nSamples, samplingRate,
+                               ReceiverFunctionMethod::WATER_LEVEL,
+                               gaussianWidth, timeShift, 0),
+                 std::invalid_argument);
+}
+
 }
@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <complex>
 #include <vector>
+#include <array>
+#include <limits>
+#include <random>
 #include <ipps.h>
 #include "rtseis/filterDesign/fir.hpp"
 #include "rtseis/filterRepresentations/fir.hpp"
@@ -16,8 +19,19 @@
 #include "rtseis/filterImplementations/iirFilter.hpp"
 #include "rtseis/filterImplementations/iiriirFilter.hpp"
 #include "rtseis/filterImplementations/firFilter.hpp"
+#include "rtseis/filterImplementations/parallelFIRFilter.hpp"
+#include "rtseis/filterImplementations/frequencyDomainFilter.hpp"
+#include "rtseis/filterImplementations/adaptiveFilter.hpp"
+#include "rtseis/filterImplementations/multiChannelFIRFilter.hpp"
+#include "rtseis/filterImplementations/multiChannelDecimate.hpp"
+#include "rtseis/filterImplementations/cicDecimate.hpp"
+#include "rtseis/filterImplementations/slidingDetrend.hpp"
+#include "rtseis/filterImplementations/detrend.hpp"
+#include "rtseis/filterRepresentations/sos.hpp"
+#include "rtseis/utilities/math/convolve.hpp"
 #include "rtseis/filterImplementations/multiRateFIRFilter.hpp"
 #include "rtseis/filterImplementations/medianFilter.hpp"
+#include "rtseis/filterImplementations/hampelFilter.hpp"
 #include "rtseis/filterImplementations/sosFilter.hpp"
 #include "rtseis/filterImplementations/enums.hpp"
 #include <gtest/gtest.h>
@@ -656,9 +670,150 @@ TEST(UtilitiesFilterImplementations, fir)
     free(yref);
     free(x);
 }
+//============================================================================//
+
+TEST(UtilitiesFilterImplementations, parallelFIR)
+{
+    double *x = NULL;
+    int npts;
+    auto ierr = readTextFile(&npts, &x, "data/gse2.txt");
+    EXPECT_EQ(ierr, 0);
+    auto firDesign = RTSeis::FilterDesign::FIR::FIR1Lowpass(50, 0.4,
+                         RTSeis::FilterDesign::FIRWindow::HAMMING);
+    auto b = firDesign.getFilterTaps();
+    auto nb = static_cast<int> (b.size());
+    // Serial reference
+    FIRFilter<RTSeis::ProcessingMode::POST, double> fir;
+    EXPECT_NO_THROW(fir.initialize(nb, b.data(), FIRImplementation::DIRECT));
+    std::vector<double> yref(npts);
+    double *yptr = yref.data();
+    fir.apply(npts, x, &yptr);
+    // The block size does not divide the signal length
+    ParallelFIRFilter<double> pfir;
+    EXPECT_NO_THROW(pfir.initialize(nb, b.data(), 1001));
+    EXPECT_TRUE(pfir.isInitialized());
+    EXPECT_EQ(pfir.getBlockSize(), 1001);
+    std::vector<double> y1(npts), y4(npts);
+    pfir.setNumberOfThreads(1);
+    yptr = y1.data();
+    EXPECT_NO_THROW(pfir.apply(npts, x, &yptr));
+    pfir.setNumberOfThreads(4);
+    yptr = y4.data();
+    EXPECT_NO_THROW(pfir.apply(npts, x, &yptr));
+    // Bit-identical irrespective of the number of threads
+    EXPECT_TRUE(std::equal(y1.begin(), y1.end(), y4.begin()));
+    // The blocks are not bit-identical to the serial filter but agree to
+    // within rounding
+    double error = 0;
+    ippsNormDiff_Inf_64f(yref.data(), y4.data(), npts, &error);
+    EXPECT_LE(error, 1.e-12);
+    // The FFT implementation agrees only to the FFT's rounding
+    ParallelFIRFilter<double> pfirFFT;
+    pfirFFT.initialize(nb, b.data(), 1001, FIRImplementation::FFT);
+    pfirFFT.setNumberOfThreads(4);
+    std::vector<double> yfft(npts);
+    yptr = yfft.data();
+    EXPECT_NO_THROW(pfirFFT.apply(npts, x, &yptr));
+    ippsNormDiff_Inf_64f(yref.data(), yfft.data(), npts, &error);
+    EXPECT_LE(error, 1.e-8);
+    // Convolution
+    namespace Convolve = RTSeis::Utilities::Math::Convolve;
+    std::vector<double> xv(x, x + npts);
+    for (auto mode : {Convolve::Mode::FULL, Convolve::Mode::SAME,
+                      Convolve::Mode::VALID})
+    {
+        auto cref = Convolve::convolve(xv, b, mode,
+                                       Convolve::Implementation::DIRECT);
+        auto nc = static_cast<int> (cref.size());
+        std::vector<double> c(nc);
+        double *cptr = c.data();
+        int ncOut = 0;
+        EXPECT_NO_THROW(pfir.convolve(npts, x, nc, &ncOut, &cptr, mode));
+        EXPECT_EQ(ncOut, nc);
+        ippsNormDiff_Inf_64f(cref.data(), c.data(), nc, &error);
+        EXPECT_LE(error, 1.e-10);
+    }
+    free(x);
+}
+
 //============================================================================//
 //int filters_sosFilter_test(const int npts, const double x[],
 //                           const std::string fileName)
+TEST(UtilitiesFilterImplementations, multiChannelFIR)
+{
+    const int nChannels = 7;
+    const int npts = 2003;
+    auto firDesign = RTSeis::FilterDesign::FIR::FIR1Lowpass(40, 0.2,
+                         RTSeis::FilterDesign::FIRWindow::HAMMING);
+    auto b = firDesign.getFilterTaps();
+    auto nb = static_cast<int> (b.size());
+    std::mt19937 rng(8032);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> x(nChannels*npts);
+    for (auto &xi : x){xi = normal(rng);}
+    // Single channel reference
+    std::vector<double> yref(nChannels*npts);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        FIRFilter<RTSeis::ProcessingMode::POST, double> fir;
+        fir.initialize(nb, b.data());
+        double *yptr = yref.data() + c*npts;
+        fir.apply(npts, x.data() + c*npts, &yptr);
+    }
+    // Post-processing
+    MultiChannelFIRFilter<RTSeis::ProcessingMode::POST, double> mcFIR;
+    EXPECT_NO_THROW(mcFIR.initialize(nChannels, nb, b.data()));
+    EXPECT_EQ(mcFIR.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(mcFIR.getInitialConditionLength(), nChannels*(nb - 1));
+    std::vector<double> y(nChannels*npts);
+    double *yptr = y.data();
+    EXPECT_NO_THROW(mcFIR.apply(npts, x.data(), &yptr));
+    double error;
+    ippsNormDiff_Inf_64f(y.data(), yref.data(), nChannels*npts, &error);
+    EXPECT_LE(error, 1.e-12);
+    // Real-time with uneven packets and a block that does not divide them
+    MultiChannelFIRFilter<RTSeis::ProcessingMode::REAL_TIME, double> mcFIRRT;
+    EXPECT_NO_THROW(mcFIRRT.initialize(nChannels, nb, b.data(), 13));
+    for (int job = 0; job < 2; ++job)
+    {
+        std::fill(y.begin(), y.end(), 0);
+        int nxloc = 0;
+        for (int packetSize = 1; nxloc < npts;
+             packetSize = packetSize%97 + 5)
+        {
+            auto n = std::min(packetSize, npts - nxloc);
+            std::vector<double> xPacket(nChannels*n), yPacket(nChannels*n);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                std::copy(x.data() + c*npts + nxloc,
+                          x.data() + c*npts + nxloc + n,
+                          xPacket.data() + c*n);
+            }
+            yptr = yPacket.data();
+            mcFIRRT.apply(n, xPacket.data(), &yptr);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                std::copy(yPacket.data() + c*n, yPacket.data() + (c + 1)*n,
+                          y.data() + c*npts + nxloc);
+            }
+            nxloc = nxloc + n;
+        }
+        ippsNormDiff_Inf_64f(y.data(), yref.data(), nChannels*npts, &error);
+        EXPECT_LE(error, 1.e-12);
+        mcFIRRT.resetInitialConditions();
+    }
+    // Float
+    MultiChannelFIRFilter<RTSeis::ProcessingMode::POST, float> mcFIR32;
+    EXPECT_NO_THROW(mcFIR32.initialize(nChannels, nb, b.data()));
+    std::vector<float> x32(x.begin(), x.end()), y32(nChannels*npts);
+    float *y32ptr = y32.data();
+    mcFIR32.apply(npts, x32.data(), &y32ptr);
+    for (int i = 0; i < nChannels*npts; ++i)
+    {
+        EXPECT_NEAR(y32[i], yref[i], 1.e-4);
+    }
+}
+
 TEST(UtilitiesFilterImplementations, sos)
 {
     double *x = NULL;
@@ -780,6 +935,97 @@ TEST(UtilitiesFilterImplementations, sos)
     free(yref);
     free(x);
 }
+TEST(UtilitiesFilterImplementations, frequencyDomainFilter)
+{
+    const int npts = 30000;
+    std::mt19937 rng(4043);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> x(npts);
+    for (auto &xi : x){xi = normal(rng);}
+    const std::vector<double> bs{
+        0.000401587491686,  0.000803175141692,  0.000401587491549,
+        1.000000000000000, -2.000000394412897,  0.999999999730209,
+        1.000000000000000,  1.999999605765104,  1.000000000341065,
+        1.000000000000000, -1.999999605588274,  1.000000000269794};
+    const std::vector<double> as{
+        1.000000000000000, -1.488513049541281,  0.562472929601870,
+        1.000000000000000, -1.704970593447777,  0.792206889942566,
+        1.000000000000000, -1.994269533089365,  0.994278822534674,
+        1.000000000000000, -1.997472946622339,  0.997483252685326};
+    RTSeis::FilterRepresentations::SOS sosRep(4, bs, as);
+    // Time domain filtfilt reference
+    SOSFilter<RTSeis::ProcessingMode::POST, double> sos;
+    EXPECT_NO_THROW(sos.initialize(4, bs.data(), as.data()));
+    std::vector<double> work(npts), yref(npts);
+    double *wptr = work.data();
+    double *yptr = yref.data();
+    sos.apply(npts, x.data(), &wptr);
+    std::reverse_copy(work.begin(), work.end(), yref.begin());
+    sos.apply(npts, yref.data(), &wptr);
+    std::reverse_copy(work.begin(), work.end(), yref.begin());
+    // Frequency domain
+    FrequencyDomainFilter<double> fdFilter;
+    EXPECT_NO_THROW(fdFilter.initialize(sosRep));
+    auto npad = fdFilter.getPadLength(npts);
+    EXPECT_GT(npad, 0);
+    EXPECT_LT(npad, npts);
+    std::vector<double> y(npts);
+    yptr = y.data();
+    EXPECT_NO_THROW(fdFilter.apply(npts, x.data(), &yptr));
+    // The results differ only over the last impulse response length
+    double ymax = 0;
+    for (const auto &yi : yref){ymax = std::max(ymax, std::abs(yi));}
+    double error = 0;
+    for (int i = 0; i < npts - npad; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - yref[i]));
+    }
+    EXPECT_LE(error, 1.e-6*ymax);
+    // Copies work and float is consistent with double
+    auto fdCopy = fdFilter;
+    std::vector<double> ycopy(npts);
+    yptr = ycopy.data();
+    fdCopy.apply(npts, x.data(), &yptr);
+    for (int i = 0; i < npts; ++i){EXPECT_NEAR(y[i], ycopy[i], 1.e-12);}
+    FrequencyDomainFilter<float> fdFilter32;
+    EXPECT_NO_THROW(fdFilter32.initialize(sosRep));
+    std::vector<float> x32(x.begin(), x.end()), y32(npts);
+    float *y32ptr = y32.data();
+    fdFilter32.apply(npts, x32.data(), &y32ptr);
+    error = 0;
+    for (int i = 0; i < npts; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - static_cast<double> (y32[i])));
+    }
+    EXPECT_LE(error, 1.e-4*ymax);
+    // Cosine tapered bandpass: sinusoids in the stop and pass bands
+    const std::array<double, 4> corners{0.1, 0.2, 0.4, 0.5};
+    EXPECT_THROW(fdFilter.initialize(std::array<double, 4> {0.1, 0.3, 0.3, 0.5}),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(fdFilter.initialize(corners));
+    const int nsine = 4096;
+    std::vector<double> xpass(nsine), xstop(nsine), ypass(nsine), ystop(nsine);
+    for (int i = 0; i < nsine; ++i)
+    {
+        xpass[i] = std::sin(M_PI*0.3*i);
+        xstop[i] = std::sin(M_PI*0.8*i);
+    }
+    yptr = ypass.data();
+    fdFilter.apply(nsine, xpass.data(), &yptr);
+    yptr = ystop.data();
+    fdFilter.apply(nsine, xstop.data(), &yptr);
+    // Avoid the truncation at the signal edges
+    double passError = 0;
+    double stopMax = 0;
+    for (int i = nsine/4; i < 3*nsine/4; ++i)
+    {
+        passError = std::max(passError, std::abs(ypass[i] - xpass[i]));
+        stopMax = std::max(stopMax, std::abs(ystop[i]));
+    }
+    EXPECT_LE(passError, 1.e-2);
+    EXPECT_LE(stopMax, 1.e-2);
+}
+
 //============================================================================//
 //int filters_medianFilter_test(const int npts, const double x[],
 //                              const std::string fileName)
@@ -1090,6 +1336,685 @@ TEST(UtilitiesFilterImplementations, decimate)
     } // Loop on different downsampling factors
     free(x);
 }
+TEST(UtilitiesFilterImplementations, decimateInitialConditions)
+{
+    // The polyphase decimator must match filtering then downsampling when
+    // the delay line is primed
+    const int npts = 1001;
+    const int downFactor = 3;
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i){x[i] = std::sin(0.01*i) + 0.1*std::cos(1.3*i);}
+    Decimate<RTSeis::ProcessingMode::REAL_TIME, double> decimate;
+    EXPECT_NO_THROW(decimate.initialize(downFactor, 31, false));
+    auto nfir = decimate.getFIRFilterLength();
+    auto nz = decimate.getInitialConditionLength();
+    EXPECT_EQ(nz, nfir - 1);
+    std::vector<double> zi(nz);
+    for (int i = 0; i < nz; ++i){zi[i] = 0.5 - 0.01*i;}
+    EXPECT_NO_THROW(decimate.setInitialConditions(nz, zi.data()));
+    // Reference
+    auto fir = RTSeis::FilterDesign::FIR::FIR1Lowpass(nfir - 1,
+                   1.0/static_cast<double> (downFactor),
+                   RTSeis::FilterDesign::FIRWindow::HAMMING);
+    auto taps = fir.getFilterTaps();
+    FIRFilter<RTSeis::ProcessingMode::REAL_TIME, double> firFilter;
+    firFilter.initialize(static_cast<int> (taps.size()), taps.data());
+    firFilter.setInitialConditions(nz, zi.data());
+    std::vector<double> yfilt(npts);
+    double *yptr = yfilt.data();
+    firFilter.apply(npts, x.data(), &yptr);
+    Downsample<RTSeis::ProcessingMode::REAL_TIME, double> downsample;
+    downsample.initialize(downFactor);
+    auto nref = downsample.estimateSpace(npts);
+    std::vector<double> yref(nref);
+    int nyref = 0;
+    yptr = yref.data();
+    downsample.apply(npts, yfilt.data(), nref, &nyref, &yptr);
+    // Apply in uneven packets
+    std::vector<double> y(nref + 1);
+    int nxloc = 0;
+    int nyloc = 0;
+    for (int packetSize = 1; nxloc < npts; packetSize = packetSize%7 + 1)
+    {
+        auto nx = std::min(packetSize, npts - nxloc);
+        int ny = 0;
+        yptr = y.data() + nyloc;
+        decimate.apply(nx, x.data() + nxloc,
+                       static_cast<int> (y.size()) - nyloc, &ny, &yptr);
+        nxloc = nxloc + nx;
+        nyloc = nyloc + ny;
+    }
+    EXPECT_EQ(nyloc, nyref);
+    for (int i = 0; i < nyref; ++i){EXPECT_NEAR(y[i], yref[i], 1.e-12);}
+    // Resetting restores the primed delay line
+    decimate.resetInitialConditions();
+    int ny = 0;
+    yptr = y.data();
+    decimate.apply(npts, x.data(), static_cast<int> (y.size()), &ny, &yptr);
+    EXPECT_EQ(ny, nyref);
+    for (int i = 0; i < nyref; ++i){EXPECT_NEAR(y[i], yref[i], 1.e-12);}
+}
+TEST(UtilitiesFilterImplementations, multiChannelDecimate)
+{
+    const int nChannels = 5;
+    const int npts = 1203;
+    const int downFactor = 4;
+    std::mt19937 rng(3083);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> x(nChannels*npts);
+    for (auto &xi : x){xi = normal(rng);}
+    // Post-processing with phase removal
+    MultiChannelDecimate<RTSeis::ProcessingMode::POST, double> mcPost;
+    EXPECT_NO_THROW(mcPost.initialize(nChannels, downFactor, 31, true));
+    EXPECT_EQ(mcPost.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(mcPost.getDownsamplingFactor(), downFactor);
+    auto nyPost = mcPost.estimateSpace(npts);
+    std::vector<double> y(nChannels*nyPost);
+    double *yptr = y.data();
+    std::vector<int> nyDown(nChannels, 0);
+    int *nyDownPtr = nyDown.data();
+    EXPECT_NO_THROW(mcPost.apply(npts, x.data(), nyPost, &nyDownPtr, &yptr));
+    for (const auto &nyc : nyDown){EXPECT_EQ(nyc, nyPost);}
+    for (int c = 0; c < nChannels; ++c)
+    {
+        Decimate<RTSeis::ProcessingMode::POST, double> decimate;
+        decimate.initialize(downFactor, 31, true);
+        EXPECT_EQ(decimate.getFIRFilterLength(), mcPost.getFIRFilterLength());
+        std::vector<double> yref(decimate.estimateSpace(npts));
+        int nyref = 0;
+        double *yrefPtr = yref.data();
+        decimate.apply(npts, x.data() + c*npts, static_cast<int> (yref.size()),
+                       &nyref, &yrefPtr);
+        EXPECT_EQ(nyref, nyPost);
+        for (int i = 0; i < nyref; ++i)
+        {
+            EXPECT_NEAR(y[c*nyPost + i], yref[i], 1.e-12);
+        }
+    }
+    // Real-time with uneven packets and primed delay lines
+    MultiChannelDecimate<RTSeis::ProcessingMode::REAL_TIME, double> mcRT;
+    EXPECT_NO_THROW(mcRT.initialize(nChannels, downFactor, 30, false));
+    auto order = mcRT.getFIRFilterLength() - 1;
+    EXPECT_EQ(mcRT.getInitialConditionLength(), nChannels*order);
+    std::vector<double> zi(nChannels*order);
+    for (auto &z : zi){z = normal(rng);}
+    EXPECT_NO_THROW(mcRT.setInitialConditions(nChannels*order, zi.data()));
+    std::vector<std::vector<double>> yref(nChannels);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        Decimate<RTSeis::ProcessingMode::REAL_TIME, double> decimate;
+        decimate.initialize(downFactor, 30, false);
+        decimate.setInitialConditions(order, zi.data() + c*order);
+        yref[c].resize(decimate.estimateSpace(npts));
+        int nyref = 0;
+        double *yrefPtr = yref[c].data();
+        decimate.apply(npts, x.data() + c*npts,
+                       static_cast<int> (yref[c].size()), &nyref, &yrefPtr);
+        yref[c].resize(nyref);
+    }
+    for (int job = 0; job < 2; ++job)
+    {
+        std::vector<std::vector<double>> yrt(nChannels);
+        int nxloc = 0;
+        for (int packetSize = 1; nxloc < npts; packetSize = packetSize%11 + 1)
+        {
+            auto n = std::min(packetSize, npts - nxloc);
+            std::vector<double> xPacket(nChannels*n);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                std::copy(x.data() + c*npts + nxloc,
+                          x.data() + c*npts + nxloc + n,
+                          xPacket.data() + c*n);
+            }
+            auto ny = mcRT.estimateSpace(n);
+            std::vector<double> yPacket(nChannels*std::max(1, ny));
+            yptr = yPacket.data();
+            mcRT.apply(n, xPacket.data(), ny, &nyDownPtr, &yptr);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                EXPECT_EQ(nyDown[c], ny);
+                yrt[c].insert(yrt[c].end(), yPacket.data() + c*ny,
+                              yPacket.data() + c*ny + nyDown[c]);
+            }
+            nxloc = nxloc + n;
+        }
+        for (int c = 0; c < nChannels; ++c)
+        {
+            EXPECT_EQ(yrt[c].size(), yref[c].size());
+            for (int i = 0; i < static_cast<int> (yref[c].size()); ++i)
+            {
+                EXPECT_NEAR(yrt[c][i], yref[c][i], 1.e-12);
+            }
+        }
+        mcRT.resetInitialConditions();
+    }
+    // Reset one channel mid-stream while the others continue
+    const int resetChannel = 2;
+    const int resetSample = 502; // Not a multiple of downFactor
+    std::vector<Decimate<RTSeis::ProcessingMode::REAL_TIME, double>>
+        decimators(nChannels);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        decimators[c].initialize(downFactor, 30, false);
+        decimators[c].setInitialConditions(order, zi.data() + c*order);
+        yref[c].clear();
+    }
+    std::vector<std::vector<double>> yrt(nChannels);
+    int nxloc = 0;
+    for (int packetSize = 3; nxloc < npts; packetSize = packetSize%13 + 2)
+    {
+        auto n = std::min(packetSize, npts - nxloc);
+        if (nxloc < resetSample){n = std::min(n, resetSample - nxloc);}
+        if (nxloc == resetSample)
+        {
+            mcRT.resetInitialConditions(resetChannel);
+            decimators[resetChannel].resetInitialConditions();
+        }
+        std::vector<double> xPacket(nChannels*n);
+        for (int c = 0; c < nChannels; ++c)
+        {
+            std::copy(x.data() + c*npts + nxloc,
+                      x.data() + c*npts + nxloc + n,
+                      xPacket.data() + c*n);
+        }
+        auto ny = mcRT.estimateSpace(n);
+        std::vector<double> yPacket(nChannels*std::max(1, ny));
+        yptr = yPacket.data();
+        mcRT.apply(n, xPacket.data(), ny, &nyDownPtr, &yptr);
+        for (int c = 0; c < nChannels; ++c)
+        {
+            std::vector<double> yc(std::max(1, decimators[c].estimateSpace(n)));
+            int nyc = 0;
+            double *ycPtr = yc.data();
+            decimators[c].apply(n, xPacket.data() + c*n,
+                                static_cast<int> (yc.size()), &nyc, &ycPtr);
+            EXPECT_EQ(nyDown[c], nyc);
+            yref[c].insert(yref[c].end(), yc.data(), yc.data() + nyc);
+            yrt[c].insert(yrt[c].end(), yPacket.data() + c*ny,
+                          yPacket.data() + c*ny + nyDown[c]);
+        }
+        nxloc = nxloc + n;
+    }
+    for (int c = 0; c < nChannels; ++c)
+    {
+        EXPECT_EQ(yrt[c].size(), yref[c].size());
+        for (int i = 0; i < static_cast<int> (yref[c].size()); ++i)
+        {
+            EXPECT_NEAR(yrt[c][i], yref[c][i], 1.e-12);
+        }
+    }
+    EXPECT_THROW(mcRT.resetInitialConditions(nChannels),
+                 std::invalid_argument);
+    // Float
+    MultiChannelDecimate<RTSeis::ProcessingMode::POST, float> mcPost32;
+    EXPECT_NO_THROW(mcPost32.initialize(nChannels, downFactor, 31, true));
+    std::vector<float> x32(x.begin(), x.end()), y32(nChannels*nyPost);
+    float *y32ptr = y32.data();
+    mcPost32.apply(npts, x32.data(), nyPost, &nyDownPtr, &y32ptr);
+    EXPECT_EQ(nyDown[0], nyPost);
+    for (int i = 0; i < nChannels*nyPost; ++i)
+    {
+        EXPECT_NEAR(y32[i], y[i], 1.e-4);
+    }
+}
+
+TEST(UtilitiesFilterImplementations, cicDecimate)
+{
+    const int downFactor = 20;
+    const int nStages = 4;
+    const int nTaps = 31;
+    const int npts = 20000;
+    CICDecimate<RTSeis::ProcessingMode::REAL_TIME, double> cic;
+    EXPECT_NO_THROW(cic.initialize(downFactor, nStages, 1, nTaps, 0.75, 1000));
+    EXPECT_EQ(cic.getDownsamplingFactor(), downFactor);
+    EXPECT_EQ(cic.getNumberOfStages(), nStages);
+    auto b = cic.getCompensationFilterTaps();
+    EXPECT_EQ(static_cast<int> (b.size()), nTaps);
+    double bsum = 0;
+    for (const auto &bi : b){bsum = bsum + bi;}
+    EXPECT_NEAR(bsum, 1, 1.e-12);
+    std::mt19937 rng(4084);
+    std::normal_distribution<double> normal(300, 100);
+    std::vector<double> x(npts);
+    for (auto &xi : x){xi = normal(rng);}
+    // Reference: the CIC is a boxcar of length downFactor applied nStages
+    // times followed by downsampling
+    std::vector<double> h(1, 1);
+    for (int s = 0; s < nStages; ++s)
+    {
+        std::vector<double> g(h.size() + downFactor - 1, 0);
+        for (int i = 0; i < static_cast<int> (h.size()); ++i)
+        {
+            for (int j = 0; j < downFactor; ++j)
+            {
+                g[i + j] = g[i + j] + h[i]/downFactor;
+            }
+        }
+        h = g;
+    }
+    std::vector<double> ycic;
+    for (int n = 0; n < npts; n = n + downFactor)
+    {
+        double yn = 0;
+        for (int k = 0; k < std::min(n + 1, static_cast<int> (h.size())); ++k)
+        {
+            yn = yn + h[k]*x[n - k];
+        }
+        ycic.push_back(yn);
+    }
+    std::vector<double> yref(ycic.size());
+    for (int n = 0; n < static_cast<int> (ycic.size()); ++n)
+    {
+        double yn = 0;
+        for (int k = 0; k < std::min(n + 1, nTaps); ++k)
+        {
+            yn = yn + b[k]*ycic[n - k];
+        }
+        yref[n] = yn;
+    }
+    // Apply in uneven packets
+    for (int job = 0; job < 2; ++job)
+    {
+        std::vector<double> y;
+        int nxloc = 0;
+        for (int packetSize = 1; nxloc < npts; packetSize = packetSize%53 + 1)
+        {
+            auto n = std::min(packetSize, npts - nxloc);
+            auto ny = cic.estimateSpace(n);
+            std::vector<double> yPacket(std::max(1, ny));
+            double *yptr = yPacket.data();
+            int nyDown = 0;
+            cic.apply(n, x.data() + nxloc, ny, &nyDown, &yptr);
+            EXPECT_EQ(nyDown, ny);
+            y.insert(y.end(), yPacket.begin(), yPacket.begin() + nyDown);
+            nxloc = nxloc + n;
+        }
+        EXPECT_EQ(y.size(), yref.size());
+        for (int i = 0; i < static_cast<int> (yref.size()); ++i)
+        {
+            EXPECT_NEAR(y[i], yref[i], 1.e-8);
+        }
+        cic.resetInitialConditions();
+    }
+    // Post-processing starts from zero state on every call
+    CICDecimate<RTSeis::ProcessingMode::POST, float> cic32;
+    EXPECT_NO_THROW(cic32.initialize(downFactor, nStages, 1, nTaps, 0.75, 1000));
+    std::vector<float> x32(x.begin(), x.end());
+    auto ny = cic32.estimateSpace(npts);
+    EXPECT_EQ(ny, static_cast<int> (yref.size()));
+    std::vector<float> y32(ny);
+    float *y32ptr = y32.data();
+    int nyDown = 0;
+    for (int job = 0; job < 2; ++job)
+    {
+        cic32.apply(npts, x32.data(), ny, &nyDown, &y32ptr);
+        EXPECT_EQ(nyDown, ny);
+        for (int i = 0; i < ny; ++i){EXPECT_NEAR(y32[i], yref[i], 1.e-3);}
+    }
+    // Excessive register growth
+    EXPECT_THROW(cic.initialize(100, 12), std::invalid_argument);
+}
+
+TEST(UtilitiesFilterImplementations, slidingDetrend)
+{
+    const int windowLength = 50;
+    const int npts = 5000;
+    const int nChannels = 3;
+    std::mt19937 rng(5085);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> x(nChannels*npts);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        for (int i = 0; i < npts; ++i)
+        {
+            x[c*npts + i] = 1000*(c + 1) + 0.01*i + normal(rng);
+        }
+    }
+    for (auto type : {DetrendType::LINEAR, DetrendType::CONSTANT})
+    {
+        // Reference: refit the window ending at each sample
+        std::vector<double> yref(nChannels*npts);
+        for (int c = 0; c < nChannels; ++c)
+        {
+            for (int i = 0; i < npts; ++i)
+            {
+                auto i0 = std::max(0, i - windowLength + 1);
+                auto m = i - i0 + 1;
+                std::vector<double> work(m);
+                double *wptr = work.data();
+                double mean = 0;
+                double intercept = 0;
+                double slope = 0;
+                if (type == DetrendType::LINEAR)
+                {
+                    removeTrend(m, x.data() + c*npts + i0, &wptr,
+                                &intercept, &slope);
+                }
+                else
+                {
+                    removeMean(m, x.data() + c*npts + i0, &wptr, &mean);
+                }
+                yref[c*npts + i] = work[m - 1];
+            }
+        }
+        SlidingDetrend<double> detrend;
+        EXPECT_NO_THROW(detrend.initialize(windowLength, type, nChannels));
+        EXPECT_EQ(detrend.getWindowLength(), windowLength);
+        EXPECT_EQ(detrend.getNumberOfChannels(), nChannels);
+        for (int job = 0; job < 2; ++job)
+        {
+            std::vector<double> y(nChannels*npts);
+            int nxloc = 0;
+            for (int packetSize = 1; nxloc < npts;
+                 packetSize = packetSize%37 + 1)
+            {
+                auto n = std::min(packetSize, npts - nxloc);
+                std::vector<double> xPacket(nChannels*n), yPacket(nChannels*n);
+                for (int c = 0; c < nChannels; ++c)
+                {
+                    std::copy(x.data() + c*npts + nxloc,
+                              x.data() + c*npts + nxloc + n,
+                              xPacket.data() + c*n);
+                }
+                double *yptr = yPacket.data();
+                detrend.apply(n, xPacket.data(), &yptr);
+                for (int c = 0; c < nChannels; ++c)
+                {
+                    std::copy(yPacket.data() + c*n, yPacket.data() + (c + 1)*n,
+                              y.data() + c*npts + nxloc);
+                }
+                nxloc = nxloc + n;
+            }
+            for (int i = 0; i < nChannels*npts; ++i)
+            {
+                EXPECT_NEAR(y[i], yref[i], 1.e-8);
+            }
+            detrend.resetInitialConditions();
+        }
+    }
+    // Float
+    SlidingDetrend<float> detrend32;
+    EXPECT_NO_THROW(detrend32.initialize(windowLength, DetrendType::CONSTANT));
+    std::vector<float> x32(npts), y32(npts);
+    for (int i = 0; i < npts; ++i){x32[i] = 5;}
+    float *y32ptr = y32.data();
+    detrend32.apply(npts, x32.data(), &y32ptr);
+    for (const auto &yi : y32){EXPECT_NEAR(yi, 0, 1.e-6);}
+}
+
+TEST(UtilitiesFilterImplementations, adaptiveFilter)
+{
+    // Each channel's noise is its references filtered by known filters
+    const int nChannels = 2;
+    const int nReferences = 2;
+    const int filterLength = 8;
+    const int nSamples = 20000;
+    std::mt19937 rng(8723);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<double> filters(nChannels*nReferences*filterLength);
+    for (auto &h : filters){h = 0.5*noise(rng);}
+    std::vector<double> references(nChannels*nReferences*nSamples);
+    for (auto &u : references){u = noise(rng);}
+    std::vector<double> signal(nChannels*nSamples);
+    std::vector<double> primary(nChannels*nSamples);
+    for (int c = 0; c < nChannels; ++c)
+    {
+        for (int i = 0; i < nSamples; ++i)
+        {
+            auto s = 0.01*std::sin(2*M_PI*0.003*(c + 1)*i);
+            auto d = s;
+            for (int r = 0; r < nReferences; ++r)
+            {
+                auto u = references.data() + (c*nReferences + r)*nSamples;
+                auto h = filters.data() + (c*nReferences + r)*filterLength;
+                for (int j = 0; j < std::min(filterLength, i + 1); ++j)
+                {
+                    d = d + h[j]*u[i - j];
+                }
+            }
+            signal[c*nSamples + i] = s;
+            primary[c*nSamples + i] = d;
+        }
+    }
+    for (auto type : {AdaptiveFilterType::NLMS,
+                      AdaptiveFilterType::BLOCK_LMS,
+                      AdaptiveFilterType::RLS})
+    {
+        AdaptiveFilter<double> filter;
+        EXPECT_NO_THROW(filter.initialize(nChannels, nReferences,
+                                          filterLength, type, 0.05, 0.9999));
+        EXPECT_EQ(filter.getNumberOfChannels(), nChannels);
+        EXPECT_EQ(filter.getNumberOfReferences(), nReferences);
+        EXPECT_EQ(filter.getFilterLength(), filterLength);
+        EXPECT_EQ(filter.getType(), type);
+        // Stream uneven packets
+        std::vector<double> cleaned(nChannels*nSamples);
+        int i0 = 0;
+        int packet = 1;
+        while (i0 < nSamples)
+        {
+            auto n = std::min(packet, nSamples - i0);
+            std::vector<double> d(nChannels*n), u(nChannels*nReferences*n);
+            std::vector<double> e(nChannels*n);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                std::copy(primary.data() + c*nSamples + i0,
+                          primary.data() + c*nSamples + i0 + n,
+                          d.data() + c*n);
+                for (int r = 0; r < nReferences; ++r)
+                {
+                    auto src = references.data()
+                             + (c*nReferences + r)*nSamples + i0;
+                    std::copy(src, src + n,
+                              u.data() + (c*nReferences + r)*n);
+                }
+            }
+            auto ePtr = e.data();
+            filter.apply(n, d.data(), u.data(), &ePtr);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                std::copy(e.data() + c*n, e.data() + (c + 1)*n,
+                          cleaned.data() + c*nSamples + i0);
+            }
+            i0 = i0 + n;
+            packet = packet%397 + 23;
+        }
+        // After convergence only the signal remains.  The residual is the
+        // misadjustment.
+        for (int c = 0; c < nChannels; ++c)
+        {
+            double error = 0;
+            for (int i = nSamples/2; i < nSamples; ++i)
+            {
+                auto ei = cleaned[c*nSamples + i] - signal[c*nSamples + i];
+                error = error + ei*ei;
+            }
+            error = std::sqrt(error/(nSamples - nSamples/2));
+            EXPECT_LT(error, 2.e-3);
+            auto weights = filter.getWeights(c);
+            for (int k = 0; k < nReferences*filterLength; ++k)
+            {
+                EXPECT_NEAR(weights[k],
+                            filters[c*nReferences*filterLength + k], 1.e-2);
+            }
+        }
+        filter.resetInitialConditions();
+        for (auto w : filter.getWeights(0)){EXPECT_EQ(w, 0);}
+    }
+}
+
+TEST(UtilitiesFilterImplementations, hampelFilter)
+{
+    const int npts = 3000;
+    const int windowLength = 11;
+    const double threshold = 3;
+    const int h = windowLength/2;
+    std::mt19937 rng(5021);
+    std::normal_distribution<double> noise(0, 1);
+    std::uniform_int_distribution<int> spikeIndex(0, npts - 1);
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+        x[i] = std::sin(2*M_PI*0.01*i) + 0.1*noise(rng);
+    }
+    for (int k = 0; k < 40; ++k){x[spikeIndex(rng)] = 50*noise(rng);}
+    // A flat segment has a zero MAD
+    for (int i = 1000; i < 1020; ++i){x[i] = 2;}
+    x[1010] = 2.5;
+    // Reference by sorting each window
+    std::vector<double> yRef(x);
+    std::vector<int> flagsRef;
+    for (int i = h; i < npts - h; ++i)
+    {
+        std::vector<double> window(x.begin() + i - h, x.begin() + i + h + 1);
+        std::sort(window.begin(), window.end());
+        auto median = window[h];
+        for (auto &w : window){w = std::abs(w - median);}
+        std::sort(window.begin(), window.end());
+        auto mad = window[h];
+        if (std::abs(x[i] - median) > threshold*1.4826*mad)
+        {
+            yRef[i] = median;
+            flagsRef.push_back(i);
+        }
+    }
+    EXPECT_GT(static_cast<int> (flagsRef.size()), 30);
+    HampelFilter<RTSeis::ProcessingMode::POST, double> hampel;
+    EXPECT_NO_THROW(hampel.initialize(windowLength, threshold));
+    EXPECT_EQ(hampel.getWindowLength(), windowLength);
+    EXPECT_EQ(hampel.getGroupDelay(), 0);
+    std::vector<double> y(npts);
+    auto yPtr = y.data();
+    hampel.apply(npts, x.data(), &yPtr);
+    for (int i = 0; i < npts; ++i){EXPECT_EQ(y[i], yRef[i]);}
+    EXPECT_EQ(hampel.getFlaggedSamples(), flagsRef);
+    // Real-time with uneven packets is delayed by half a window
+    HampelFilter<RTSeis::ProcessingMode::REAL_TIME, double> hampelRT;
+    EXPECT_NO_THROW(hampelRT.initialize(windowLength, threshold));
+    EXPECT_EQ(hampelRT.getGroupDelay(), h);
+    std::vector<int> flagsRT;
+    int i0 = 0;
+    int packet = 1;
+    while (i0 < npts)
+    {
+        auto n = std::min(packet, npts - i0);
+        yPtr = y.data() + i0;
+        hampelRT.apply(n, x.data() + i0, &yPtr);
+        for (auto flag : hampelRT.getFlaggedSamples())
+        {
+            flagsRT.push_back(i0 + flag - h);
+        }
+        i0 = i0 + n;
+        packet = packet%53 + 7;
+    }
+    for (int i = 0; i < h; ++i){EXPECT_EQ(y[i], 0);}
+    for (int i = h; i < npts; ++i){EXPECT_EQ(y[i], yRef[i - h]);}
+    EXPECT_EQ(flagsRT, flagsRef);
+}
+
+TEST(UtilitiesFilterImplementations, hampelFilterNonFinite)
+{
+    const int npts = 500;
+    const int windowLength = 11;
+    const double threshold = 3;
+    const int h = windowLength/2;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    std::mt19937 rng(7103);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+        x[i] = std::sin(2*M_PI*0.01*i) + 0.1*noise(rng);
+    }
+    x[3] = nan;    // Leading edge
+    x[100] = nan;
+    x[101] = inf;
+    x[200] = 30;
+    for (int i = 250; i < 257; ++i){x[i] = nan;} // Most of a window
+    x[npts - 2] =-inf; // Trailing edge
+    // Reference from the sorted finite samples of each window
+    auto statistics = [&](const int i0, const int i1, double *median,
+                          double *mad)
+    {
+        std::vector<double> window;
+        for (int i = i0; i < i1; ++i)
+        {
+            if (std::isfinite(x[i])){window.push_back(x[i]);}
+        }
+        *median = 0;
+        *mad = 0;
+        if (window.empty()){return;}
+        auto c = (window.size() - 1)/2;
+        std::sort(window.begin(), window.end());
+        *median = window[c];
+        for (auto &w : window){w = std::abs(w - *median);}
+        std::sort(window.begin(), window.end());
+        *mad = window[c];
+    };
+    std::vector<double> yRef(x);
+    std::vector<int> flagsRef;
+    double median, mad;
+    for (int i = 0; i < npts; ++i)
+    {
+        if (i < h || i >= npts - h)
+        {
+            if (std::isfinite(x[i])){continue;}
+            auto i0 = i < h ? 0 : npts - windowLength;
+            statistics(i0, i0 + windowLength, &median, &mad);
+            yRef[i] = median;
+            flagsRef.push_back(i);
+            continue;
+        }
+        statistics(i - h, i + h + 1, &median, &mad);
+        if (!std::isfinite(x[i]) ||
+            std::abs(x[i] - median) > threshold*1.4826*mad)
+        {
+            yRef[i] = median;
+            flagsRef.push_back(i);
+        }
+    }
+    HampelFilter<RTSeis::ProcessingMode::POST, double> hampel;
+    hampel.initialize(windowLength, threshold);
+    std::vector<double> y(npts);
+    auto yPtr = y.data();
+    hampel.apply(npts, x.data(), &yPtr);
+    for (int i = 0; i < npts; ++i)
+    {
+        EXPECT_TRUE(std::isfinite(y[i]));
+        EXPECT_EQ(y[i], yRef[i]);
+    }
+    EXPECT_EQ(hampel.getFlaggedSamples(), flagsRef);
+    // The spike after the NaNs is still found so they left the window
+    auto flags = hampel.getFlaggedSamples();
+    EXPECT_TRUE(std::find(flags.begin(), flags.end(), 200) != flags.end());
+    // Real-time matches post-processing away from the leading edge, where
+    // the real-time median is of the partial window
+    HampelFilter<RTSeis::ProcessingMode::REAL_TIME, double> hampelRT;
+    hampelRT.initialize(windowLength, threshold);
+    hampelRT.apply(npts, x.data(), &yPtr);
+    for (int i = 0; i < npts; ++i){EXPECT_TRUE(std::isfinite(y[i]));}
+    for (int i = windowLength - 1; i < npts; ++i)
+    {
+        EXPECT_EQ(y[i], yRef[i - h]);
+    }
+    // The trailing edge is still in the delay line
+    std::vector<int> flagsRT;
+    for (auto flag : hampelRT.getFlaggedSamples())
+    {
+        flagsRT.push_back(flag - h);
+    }
+    flagsRef.pop_back();
+    EXPECT_EQ(flagsRT, flagsRef);
+    // A packet shorter than the window is all edge.  The NaN takes the
+    // lower median of the two finite samples.
+    hampel.apply(3, x.data() + 2, &yPtr);
+    EXPECT_EQ(y[0], x[2]);
+    EXPECT_EQ(y[1], std::min(x[2], x[4]));
+    EXPECT_EQ(y[2], x[4]);
+    EXPECT_EQ(hampel.getFlaggedSamples(), std::vector<int> {1});
+}
+
 //============================================================================//
 void read_decimate(const int nq, std::vector<double> *xdecim)
 {
@@ -0,0 +1,423 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <random>
+#include "rtseis/utilities/quality/qualityMetrics.hpp"
+#include "rtseis/utilities/quality/qualitySummary.hpp"
+#include "rtseis/utilities/quality/activityGate.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace RTSeis::Utilities::Quality;
+
+/// Brute force metrics of the samples in [t0, t1)
+struct Reference
+{
+    double mean = 0;
+    double sumOfSquaredDeviations = 0;
+    double minimum = 0;
+    double maximum = 0;
+    int64_t nSamples = 0;
+    int64_t nClipped = 0;
+    int64_t nSpikes = 0;
+    int64_t longestFlatline = 0;
+};
+
+Reference reference(const std::vector<double> &x,
+                    const std::vector<double> &times,
+                    const std::vector<bool> &continues,
+                    const double t0, const double t1,
+                    const double clipLevel, const double spikeThreshold)
+{
+    Reference result;
+    std::vector<double> y;
+    int64_t run = 0;
+    for (int i = 0; i < static_cast<int> (x.size()); ++i)
+    {
+        run = (continues[i] && x[i] == x[i - 1]) ? run + 1 : 1;
+        if (times[i] < t0 || times[i] >= t1){continue;}
+        y.push_back(x[i]);
+        if (std::abs(x[i]) >= clipLevel){result.nClipped++;}
+        result.longestFlatline = std::max(result.longestFlatline, run);
+        if (i >= 2 && continues[i] && continues[i - 1])
+        {
+            auto d1 = x[i - 1] - x[i - 2];
+            auto d2 = x[i] - x[i - 1];
+            if (std::abs(d1) > spikeThreshold &&
+                std::abs(d2) > spikeThreshold && d1*d2 < 0)
+            {
+                result.nSpikes++;
+            }
+        }
+    }
+    result.nSamples = static_cast<int64_t> (y.size());
+    if (y.empty()){return result;}
+    double sum = 0;
+    for (const auto &v : y){sum = sum + v;}
+    result.mean = sum/static_cast<double> (y.size());
+    for (const auto &v : y)
+    {
+        result.sumOfSquaredDeviations = result.sumOfSquaredDeviations
+                                      + (v - result.mean)*(v - result.mean);
+    }
+    result.minimum = *std::min_element(y.begin(), y.end());
+    result.maximum = *std::max_element(y.begin(), y.end());
+    return result;
+}
+
+TEST(UtilitiesQuality, qualityMetrics)
+{
+    const double samplingRate = 100;
+    const double binDuration = 60;
+    const double clipLevel = 900;
+    const double spikeThreshold = 300;
+    const double startTime = 1200; // Aligned to a bin
+    const int packetSize = 250;
+    const int nPackets = 60;
+    const int skippedPacket = 17;
+    const double dt = 1/samplingRate;
+    // Make a signal with an offset, clips, spikes, and a flatline
+    std::vector<double> signal(packetSize*nPackets);
+    for (int i = 0; i < static_cast<int> (signal.size()); ++i)
+    {
+        signal[i] = 12 + 100*std::sin(2*M_PI*1.3*i*dt);
+    }
+    for (int i = 1000; i < 1005; ++i){signal[i] = 950;}
+    signal[3333] =-950;
+    signal[4500] = 600;
+    signal[5001] =-600;
+    signal[7499] = 700;  // Spike straddles packets 29 and 30
+    signal[7500] =-700;
+    signal[9999] = 650;  // Spike on a packet boundary
+    for (int i = 11980; i < 12070; ++i){signal[i] = 7;} // Straddles bins
+    // Drop a packet
+    std::vector<double> x;
+    std::vector<double> times;
+    std::vector<bool> continues;
+    for (int ip = 0; ip < nPackets; ++ip)
+    {
+        if (ip == skippedPacket){continue;}
+        for (int i = 0; i < packetSize; ++i)
+        {
+            auto j = ip*packetSize + i;
+            x.push_back(signal[j]);
+            times.push_back(startTime + j*dt);
+            continues.push_back(x.size() > 1 &&
+                                !(i == 0 && ip == skippedPacket + 1));
+        }
+    }
+
+    QualityMetrics<double> metrics;
+    EXPECT_NO_THROW(metrics.initialize(2, samplingRate, clipLevel,
+                                       spikeThreshold, binDuration));
+    EXPECT_EQ(metrics.getNumberOfChannels(), 2);
+    EXPECT_NEAR(metrics.getBinDuration(), binDuration, 1.e-14);
+    for (int ip = 0; ip < nPackets; ++ip)
+    {
+        if (ip == skippedPacket){continue;}
+        auto j = ip*packetSize;
+        metrics.update(0, startTime + j*dt, packetSize, signal.data() + j);
+        // A dead channel
+        std::vector<double> zeros(packetSize, 0);
+        metrics.update(1, startTime + j*dt, packetSize, zeros.data());
+    }
+    auto current = metrics.getCurrentSummary(0);
+    EXPECT_GT(current.getNumberOfSamples(), 0);
+    metrics.flush();
+    auto summaries = metrics.popCompletedSummaries(0);
+    auto nBins = static_cast<int> (std::ceil(nPackets*packetSize*dt
+                                            /binDuration));
+    ASSERT_EQ(static_cast<int> (summaries.size()), nBins);
+    EXPECT_TRUE(metrics.popCompletedSummaries(0).empty());
+    QualitySummary total;
+    int64_t nGaps = 0;
+    for (int ib = 0; ib < nBins; ++ib)
+    {
+        const auto &s = summaries[ib];
+        auto t0 = startTime + ib*binDuration;
+        auto t1 = t0 + binDuration;
+        EXPECT_NEAR(s.getStartTime(), t0, 1.e-8);
+        EXPECT_NEAR(s.getEndTime(), t1, 1.e-8);
+        auto r = reference(x, times, continues, t0 - 1.e-5, t1 - 1.e-5,
+                           clipLevel, spikeThreshold);
+        EXPECT_EQ(s.getExpectedNumberOfSamples(),
+                  static_cast<int64_t> (binDuration*samplingRate));
+        EXPECT_EQ(s.getNumberOfSamples(), r.nSamples);
+        EXPECT_NEAR(s.getAvailability(),
+                    100.0*r.nSamples/(binDuration*samplingRate), 1.e-10);
+        EXPECT_NEAR(s.getMean(), r.mean, 1.e-9);
+        EXPECT_NEAR(s.getStandardDeviation(),
+                    std::sqrt(r.sumOfSquaredDeviations/r.nSamples), 1.e-9);
+        EXPECT_NEAR(s.getMinimum(), r.minimum, 1.e-12);
+        EXPECT_NEAR(s.getMaximum(), r.maximum, 1.e-12);
+        EXPECT_EQ(s.getNumberOfClippedSamples(), r.nClipped);
+        EXPECT_EQ(s.getNumberOfSpikes(), r.nSpikes);
+        EXPECT_EQ(s.getLongestFlatline(), r.longestFlatline);
+        EXPECT_FALSE(s.isDead());
+        nGaps = nGaps + s.getNumberOfGaps();
+        total.merge(s);
+    }
+    EXPECT_EQ(nGaps, 1);
+    // Hourly bins merge to the summary of the whole
+    auto r = reference(x, times, continues, 0, 1.e10,
+                       clipLevel, spikeThreshold);
+    EXPECT_EQ(total.getNumberOfSamples(), static_cast<int64_t> (x.size()));
+    EXPECT_EQ(total.getNumberOfGaps(), 1);
+    EXPECT_NEAR(total.getMean(), r.mean, 1.e-9);
+    EXPECT_NEAR(total.getRMS(),
+                std::sqrt(r.mean*r.mean + r.sumOfSquaredDeviations/r.nSamples),
+                1.e-9);
+    EXPECT_EQ(total.getNumberOfClippedSamples(), 6);
+    EXPECT_EQ(total.getNumberOfSpikes(), r.nSpikes);
+    EXPECT_EQ(total.getLongestFlatline(), 90);
+    EXPECT_NEAR(total.getStartTime(), startTime, 1.e-8);
+    // The dead channel
+    auto dead = metrics.popCompletedSummaries(1);
+    ASSERT_EQ(static_cast<int> (dead.size()), nBins);
+    for (const auto &s : dead){EXPECT_TRUE(s.isDead());}
+    // Serialization round trip
+    auto bytes = total.serialize();
+    QualitySummary copy;
+    EXPECT_NO_THROW(copy.deserialize(bytes));
+    EXPECT_EQ(copy.serialize(), bytes);
+    EXPECT_EQ(copy.getNumberOfSamples(), total.getNumberOfSamples());
+    EXPECT_NEAR(copy.getMean(), total.getMean(), 0);
+    bytes.pop_back();
+    EXPECT_THROW(copy.deserialize(bytes), std::invalid_argument);
+    // Float matches double in a bin without the gap
+    QualityMetrics<float> metricsFloat;
+    metricsFloat.initialize(1, samplingRate, clipLevel, spikeThreshold,
+                            binDuration);
+    std::vector<float> signalFloat(signal.begin(), signal.end());
+    metricsFloat.update(0, startTime, static_cast<int> (signalFloat.size()),
+                        signalFloat.data());
+    metricsFloat.flush();
+    auto summariesFloat = metricsFloat.popCompletedSummaries(0);
+    ASSERT_EQ(static_cast<int> (summariesFloat.size()), nBins);
+    EXPECT_EQ(summariesFloat[1].getNumberOfSpikes(),
+              summaries[1].getNumberOfSpikes());
+    EXPECT_EQ(summariesFloat[1].getNumberOfClippedSamples(),
+              summaries[1].getNumberOfClippedSamples());
+}
+
+TEST(UtilitiesQuality, qualityMetricsOutages)
+{
+    const double samplingRate = 10;
+    const double binDuration = 10;
+    const int packetSize = 50;
+    const double dt = 1/samplingRate;
+    auto packet = [&](const double startTime)
+    {
+        std::vector<double> x(packetSize);
+        for (int i = 0; i < packetSize; ++i)
+        {
+            x[i] = 100*std::sin(2*M_PI*0.7*(startTime + i*dt));
+        }
+        return x;
+    };
+    QualityMetrics<double> metrics;
+    metrics.initialize(2, samplingRate, 2000, 300, binDuration);
+    // Both channels send [0,20) then stop
+    for (double t0 : {0.0, 5.0, 10.0, 15.0})
+    {
+        auto x = packet(t0);
+        metrics.update(0, t0, packetSize, x.data());
+        metrics.update(1, t0, packetSize, x.data());
+    }
+    // The wall clock closes the bins of the stopped channels once
+    metrics.advance(45);
+    metrics.advance(45);
+    auto stopped = metrics.popCompletedSummaries(1);
+    ASSERT_EQ(static_cast<int> (stopped.size()), 4);
+    for (int ib = 0; ib < 4; ++ib)
+    {
+        EXPECT_NEAR(stopped[ib].getStartTime(), ib*binDuration, 1.e-10);
+        EXPECT_EQ(stopped[ib].getExpectedNumberOfSamples(), 100);
+    }
+    EXPECT_EQ(stopped[1].getNumberOfSamples(), 100);
+    EXPECT_FALSE(stopped[1].isDead());
+    for (int ib = 2; ib < 4; ++ib)
+    {
+        EXPECT_EQ(stopped[ib].getNumberOfSamples(), 0);
+        EXPECT_NEAR(stopped[ib].getAvailability(), 0, 1.e-14);
+        EXPECT_TRUE(stopped[ib].isDead());
+    }
+    EXPECT_EQ(metrics.getCurrentSummary(1).getNumberOfSamples(), 0);
+    // Channel 0 resumes in bin 5 so bin 4 is reported empty.  A spike
+    // straddles the in-order packets and a late packet arrives between them.
+    auto x = packet(50);
+    x[packetSize - 1] = 1000;
+    metrics.update(0, 50, packetSize, x.data());
+    auto late = packet(45);
+    metrics.update(0, 45, packetSize, late.data());
+    x = packet(55);
+    metrics.update(0, 55, packetSize, x.data());
+    metrics.flush();
+    auto summaries = metrics.popCompletedSummaries(0);
+    ASSERT_EQ(static_cast<int> (summaries.size()), 7);
+    for (int ib = 2; ib < 5; ++ib)
+    {
+        EXPECT_NEAR(summaries[ib].getStartTime(), ib*binDuration, 1.e-10);
+        EXPECT_EQ(summaries[ib].getNumberOfSamples(), 0);
+        EXPECT_EQ(summaries[ib].getExpectedNumberOfSamples(), 100);
+        EXPECT_TRUE(summaries[ib].isDead());
+    }
+    // The late packet is summarized on its own
+    EXPECT_NEAR(summaries[5].getStartTime(), 45, 1.e-10);
+    EXPECT_EQ(summaries[5].getNumberOfSamples(), packetSize);
+    EXPECT_EQ(summaries[5].getNumberOfGaps(), 0);
+    // The late packet neither adds a gap nor breaks the continuity
+    const auto &resumed = summaries[6];
+    EXPECT_NEAR(resumed.getStartTime(), 50, 1.e-10);
+    EXPECT_EQ(resumed.getNumberOfSamples(), 2*packetSize);
+    EXPECT_EQ(resumed.getNumberOfGaps(), 1);
+    EXPECT_EQ(resumed.getNumberOfSpikes(), 1);
+}
+
+TEST(UtilitiesQuality, activityGate)
+{
+    const int packetSize = 100;
+    const int holdSamples = 250;
+    const double quietLevel = 5;
+    ActivityGate<double> gate;
+    EXPECT_NO_THROW(gate.initialize(3, quietLevel, holdSamples));
+    EXPECT_EQ(gate.getNumberOfChannels(), 3);
+    std::mt19937 rng(5023);
+    std::uniform_real_distribution<double> loud(-100, 100);
+    std::uniform_real_distribution<double> quiet(-1, 1);
+    auto makePacket = [&](std::uniform_real_distribution<double> &noise)
+    {
+        std::vector<double> packet(packetSize);
+        for (auto &v : packet){v = noise(rng);}
+        return packet;
+    };
+    // A dead channel is never processed
+    std::vector<double> zeros(packetSize, 0);
+    for (int ip = 0; ip < 10; ++ip)
+    {
+        EXPECT_EQ(gate.update(0, packetSize, zeros.data()),
+                  GateDecision::SKIP);
+    }
+    EXPECT_TRUE(gate.isSkipping(0));
+    EXPECT_EQ(gate.getNumberOfSkippedPackets(0), 10);
+    EXPECT_EQ(gate.getNumberOfResumptions(0), 0);
+    // An active channel that goes quiet and resumes
+    std::vector<GateDecision> reference{GateDecision::RESUME,
+                                        GateDecision::PROCESS,
+                                        GateDecision::PROCESS,
+                                        GateDecision::PROCESS,
+                                        GateDecision::PROCESS,
+                                        GateDecision::PROCESS,
+                                        GateDecision::SKIP,
+                                        GateDecision::SKIP,
+                                        GateDecision::SKIP,
+                                        GateDecision::RESUME};
+    for (int ip = 0; ip < static_cast<int> (reference.size()); ++ip)
+    {
+        auto packet = (ip < 3 || ip == 9) ? makePacket(loud) :
+                                            makePacket(quiet);
+        EXPECT_EQ(gate.update(1, packetSize, packet.data()), reference[ip]);
+    }
+    EXPECT_EQ(gate.getNumberOfSkippedPackets(1), 3);
+    EXPECT_EQ(gate.getNumberOfSkippedSamples(1), 3*packetSize);
+    EXPECT_EQ(gate.getNumberOfResumptions(1), 2);
+    // A single spike in a quiet packet is active
+    auto packet = makePacket(quiet);
+    EXPECT_EQ(gate.update(2, packetSize, packet.data()), GateDecision::SKIP);
+    packet[37] = 20;
+    EXPECT_EQ(gate.update(2, packetSize, packet.data()), GateDecision::RESUME);
+    // Totals
+    EXPECT_EQ(gate.getNumberOfPackets(), 22);
+    EXPECT_EQ(gate.getNumberOfSamples(), 22*packetSize);
+    EXPECT_EQ(gate.getNumberOfSkippedPackets(), 14);
+    EXPECT_EQ(gate.getNumberOfSkippedSamples(), 14*packetSize);
+    EXPECT_EQ(gate.getNumberOfResumptions(), 3);
+    gate.resetCounters();
+    EXPECT_EQ(gate.getNumberOfPackets(), 0);
+    EXPECT_FALSE(gate.isSkipping(1));
+    gate.resetInitialConditions();
+    EXPECT_TRUE(gate.isSkipping(1));
+    // A NaN anywhere in a quiet packet makes it active and never becomes the
+    // resting level
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> offsetPacket(packetSize, 3);
+    EXPECT_EQ(gate.update(0, packetSize, offsetPacket.data()),
+              GateDecision::SKIP);
+    offsetPacket[packetSize/2] = nan;
+    EXPECT_EQ(gate.update(0, packetSize, offsetPacket.data()),
+              GateDecision::RESUME);
+    EXPECT_EQ(gate.getRestingLevel(0), 3);
+    for (int ip = 0; ip < 5; ++ip)
+    {
+        EXPECT_EQ(gate.update(0, packetSize, offsetPacket.data()),
+                  GateDecision::PROCESS);
+    }
+    EXPECT_EQ(gate.getRestingLevel(0), 3);
+    // Without a quiet packet the resting level is the first finite sample
+    offsetPacket[0] = nan;
+    offsetPacket[1] = 4;
+    EXPECT_EQ(gate.update(1, packetSize, offsetPacket.data()),
+              GateDecision::RESUME);
+    EXPECT_EQ(gate.getRestingLevel(1), 4);
+    EXPECT_THROW(static_cast<void> (gate.getNumberOfPackets(3)),
+                 std::invalid_argument);
+
+    // A gated recursive average matches the ungated average once the hold
+    // exceeds its memory.  The quiet stretches sit at a DC offset so the
+    // chain must restart from the resting level, not from zero.
+    const double alpha = 0.9;
+    const double offset = 500;
+    ActivityGate<float> gateFloat;
+    gateFloat.initialize(1, quietLevel, 200);
+    std::vector<float> signal(40*packetSize, 0);
+    for (int i = 0; i < static_cast<int> (signal.size()); ++i)
+    {
+        auto noise = ((i/1000)%2 == 0) ? loud(rng) : quiet(rng);
+        signal[i] = static_cast<float> (offset + noise);
+    }
+    double stateAll = 0;
+    double stateGated = 0;
+    double stateZeroReset = 0;
+    double maxError = 0;
+    double maxErrorZeroReset = 0;
+    for (int ip = 0; ip < 40; ++ip)
+    {
+        const float *x = signal.data() + ip*packetSize;
+        auto decision = gateFloat.update(0, packetSize, x);
+        if (decision == GateDecision::RESUME)
+        {
+            // The steady state of the average for a constant input
+            stateGated = gateFloat.getRestingLevel(0);
+            stateZeroReset = 0;
+        }
+        for (int i = 0; i < packetSize; ++i)
+        {
+            auto xi = static_cast<double> (x[i]);
+            stateAll = alpha*stateAll + (1 - alpha)*xi;
+            if (decision != GateDecision::SKIP)
+            {
+                stateGated = alpha*stateGated + (1 - alpha)*xi;
+                stateZeroReset = alpha*stateZeroReset + (1 - alpha)*xi;
+            }
+            // The first packet is a resumption from an unknown state
+            if (ip == 0){continue;}
+            auto yGated = (decision == GateDecision::SKIP) ?
+                          gateFloat.getRestingLevel(0) : stateGated;
+            maxError = std::max(maxError, std::abs(stateAll - yGated));
+            maxErrorZeroReset = std::max(maxErrorZeroReset,
+                                         std::abs(stateAll - stateZeroReset));
+        }
+    }
+    EXPECT_LT(maxError, 1);
+    EXPECT_GT(maxErrorZeroReset, 0.5*offset);
+    EXPECT_EQ(gateFloat.getNumberOfSkippedSamples(), 16*packetSize);
+}
+
+}
@@ -0,0 +1,197 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "rtseis/utilities/similarity/spectralFingerprint.hpp"
+#include "rtseis/utilities/similarity/similaritySearch.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace RTSeis::Utilities::Similarity;
+
+TEST(UtilitiesSimilarity, fingerprint)
+{
+    const double samplingRate = 100;
+    const int windowLength = 64;
+    const int windowLag = 8;
+    const int imageLength = 32;
+    const int imageLag = 4;
+    const int nImageFrequencies = 16;
+    const int nTop = 100;
+    const int nSamples = 24000;
+    // Noise with a repeated event
+    std::mt19937 rng(4092);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<double> x(nSamples);
+    for (auto &v : x){v = noise(rng);}
+    std::vector<double> event(512);
+    for (int i = 0; i < static_cast<int> (event.size()); ++i)
+    {
+        auto t = i/samplingRate;
+        event[i] = 20*std::exp(-3*t)*(std::sin(2*M_PI*8*t)
+                                    + 0.5*std::sin(2*M_PI*17*t));
+    }
+    // Place the events on an image boundary so the images are identical up
+    // to the noise
+    const int imageSamples = imageLag*windowLag;
+    const int first = 100*imageSamples;
+    const int second = 500*imageSamples;
+    for (int i = 0; i < static_cast<int> (event.size()); ++i)
+    {
+        x[first + i] = x[first + i] + event[i];
+        x[second + i] = x[second + i] + event[i];
+    }
+    SpectralFingerprint<double> fingerprint;
+    EXPECT_NO_THROW(fingerprint.initialize(samplingRate, windowLength,
+                                           windowLag, imageLength, imageLag,
+                                           nImageFrequencies, nTop, 1, 30));
+    EXPECT_EQ(fingerprint.getFingerprintLength(),
+              2*imageLength*nImageFrequencies);
+    EXPECT_EQ(fingerprint.getNumberOfTopCoefficients(), nTop);
+    EXPECT_NO_THROW(fingerprint.compute(nSamples, x.data()));
+    auto nWindows = (nSamples - windowLength)/windowLag + 1;
+    auto nImages = (nWindows - imageLength)/imageLag + 1;
+    EXPECT_EQ(fingerprint.getNumberOfFingerprints(), nImages);
+    auto times = fingerprint.getFingerprintTimes();
+    EXPECT_NEAR(times.at(100), first/samplingRate, 1.e-10);
+    auto fingerprints = fingerprint.getFingerprints();
+    EXPECT_EQ(static_cast<int> (fingerprints.size()), nImages*nTop);
+    // Bits are sorted, distinct, and in range
+    for (int i = 0; i < nImages; ++i)
+    {
+        for (int k = 0; k < nTop; ++k)
+        {
+            auto bit = fingerprints[i*nTop + k];
+            EXPECT_TRUE(bit >= 0 &&
+                        bit < fingerprint.getFingerprintLength());
+            if (k > 0){EXPECT_LT(fingerprints[i*nTop + k - 1], bit);}
+        }
+    }
+    // A copy gives the same fingerprints
+    SpectralFingerprint<double> fingerprintCopy(fingerprint);
+    fingerprintCopy.compute(nSamples, x.data());
+    EXPECT_EQ(fingerprintCopy.getFingerprints(), fingerprints);
+    // The repeated event's fingerprints are the most similar pair
+    auto jaccard = [&](const int i, const int j)
+    {
+        std::vector<int> common;
+        std::set_intersection(fingerprints.begin() + i*nTop,
+                              fingerprints.begin() + (i + 1)*nTop,
+                              fingerprints.begin() + j*nTop,
+                              fingerprints.begin() + (j + 1)*nTop,
+                              std::back_inserter(common));
+        auto n = static_cast<double> (common.size());
+        return n/(2*nTop - n);
+    };
+    EXPECT_GT(jaccard(100, 500), 0.4);
+    EXPECT_LT(jaccard(100, 300), 0.2);
+    // Search the fingerprints
+    SimilaritySearch search;
+    search.initialize(100, 4, 10, 0, imageLength/imageLag);
+    search.buildIndex(nImages, nTop, fingerprints.data());
+    auto pairs = search.findSimilarPairs();
+    EXPECT_FALSE(pairs.empty());
+    bool found = false;
+    for (const auto &pair : pairs)
+    {
+        if (pair.first == 100 && pair.second == 500){found = true;}
+    }
+    EXPECT_TRUE(found);
+    // Errors
+    EXPECT_THROW(fingerprint.initialize(samplingRate, windowLength, windowLag,
+                                        48, imageLag),
+                 std::invalid_argument);
+    EXPECT_THROW(fingerprint.initialize(samplingRate, windowLength, windowLag,
+                                        imageLength, imageLag, 64),
+                 std::invalid_argument);
+    fingerprint.initialize(samplingRate, windowLength, windowLag, imageLength,
+                           imageLag, nImageFrequencies, nTop);
+    EXPECT_THROW(fingerprint.compute(windowLength, x.data()),
+                 std::invalid_argument);
+}
+
+TEST(UtilitiesSimilarity, search)
+{
+    // Random sets and their perturbations with known Jaccard similarity
+    const int nBits = 50;
+    const int nSets = 400;
+    const int universe = 4096;
+    std::mt19937 rng(86753);
+    std::vector<int> all(universe);
+    for (int i = 0; i < universe; ++i){all[i] = i;}
+    std::vector<int> fingerprints(nSets*nBits);
+    for (int i = 0; i < nSets; ++i)
+    {
+        std::shuffle(all.begin(), all.end(), rng);
+        std::copy(all.begin(), all.begin() + nBits,
+                  fingerprints.begin() + i*nBits);
+    }
+    // Set 2k+1 is set 2k with 5 elements replaced so J = 45/55
+    for (int i = 1; i < nSets; i = i + 2)
+    {
+        std::copy(fingerprints.begin() + (i - 1)*nBits,
+                  fingerprints.begin() + i*nBits,
+                  fingerprints.begin() + i*nBits);
+        for (int k = 0; k < 5; ++k)
+        {
+            fingerprints[i*nBits + k] = universe + i*5 + k;
+        }
+    }
+    SimilaritySearch search;
+    EXPECT_NO_THROW(search.initialize(50, 2, 20));
+    EXPECT_EQ(search.getNumberOfTables(), 50);
+    EXPECT_NO_THROW(search.buildIndex(nSets, nBits, fingerprints.data()));
+    EXPECT_TRUE(search.haveIndex());
+    EXPECT_EQ(search.getNumberOfFingerprints(), nSets);
+    auto pairs = search.findSimilarPairs();
+    // With J^2 = 0.67 a pair is expected in 33 of 50 tables.  Unrelated sets
+    // collide with probability about 1.e-4 per table.
+    int nFound = 0;
+    for (const auto &pair : pairs)
+    {
+        EXPECT_EQ(pair.first%2, 0);
+        EXPECT_EQ(pair.second, pair.first + 1);
+        EXPECT_GE(pair.similarity, 20);
+        nFound = nFound + 1;
+    }
+    EXPECT_GE(nFound, nSets/2 - 2);
+    // The pairs are sorted and do not depend on the copy
+    SimilaritySearch searchCopy(search);
+    auto pairsCopy = searchCopy.findSimilarPairs();
+    ASSERT_EQ(pairsCopy.size(), pairs.size());
+    for (int i = 0; i < static_cast<int> (pairs.size()); ++i)
+    {
+        EXPECT_EQ(pairsCopy[i].first, pairs[i].first);
+        EXPECT_EQ(pairsCopy[i].second, pairs[i].second);
+        EXPECT_EQ(pairsCopy[i].similarity, pairs[i].similarity);
+        if (i > 0){EXPECT_LT(pairs[i - 1].first, pairs[i].first);}
+    }
+    // Querying with a set finds itself in every table
+    auto matches = search.query(nBits, fingerprints.data() + 10*nBits);
+    ASSERT_FALSE(matches.empty());
+    bool found = false;
+    for (const auto &match : matches)
+    {
+        if (match.first == 10)
+        {
+            EXPECT_EQ(match.similarity, 50);
+            found = true;
+        }
+        EXPECT_EQ(match.second, -1);
+    }
+    EXPECT_TRUE(found);
+    // Errors
+    EXPECT_THROW(search.initialize(50, 2, 51), std::invalid_argument);
+    EXPECT_THROW(search.initialize(0, 2, 1), std::invalid_argument);
+    search.clear();
+    EXPECT_THROW(search.buildIndex(nSets, nBits, fingerprints.data()),
+                 std::runtime_error);
+}
+
+}
@@ -0,0 +1,296 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include "rtseis/utilities/stacking/stack.hpp"
+#include "rtseis/utilities/stacking/backprojection.hpp"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using namespace RTSeis::Utilities::Stacking;
+
+/// A smooth pulse centered at t0
+double pulse(const double t, const double t0)
+{
+    const double sigma = 6;
+    auto tau = (t - t0)/sigma;
+    return (1 - tau*tau)*std::exp(-tau*tau/2);
+}
+
+TEST(UtilitiesStacking, align)
+{
+    const int nSamples = 200;
+    const double t0 = 90;
+    std::vector<double> shifts({0, 17, -23, 3.25, -11.6, 40.5});
+    auto nTraces = static_cast<int> (shifts.size());
+    std::vector<double> x(nTraces*nSamples);
+    std::vector<double> yRef(nTraces*nSamples);
+    for (int k = 0; k < nTraces; ++k)
+    {
+        for (int i = 0; i < nSamples; ++i)
+        {
+            x[k*nSamples + i] = pulse(i, t0);
+            yRef[k*nSamples + i] = pulse(i, t0 + shifts[k]);
+        }
+    }
+    for (const auto method : {FractionalShiftMethod::FREQUENCY_DOMAIN,
+                              FractionalShiftMethod::WINDOWED_SINC})
+    {
+        Stack<double> stack;
+        EXPECT_NO_THROW(stack.initialize(nSamples, StackType::LINEAR, 2,
+                                         method));
+        EXPECT_EQ(stack.getFractionalShiftMethod(), method);
+        Stack<double> stackCopy(stack);
+        std::vector<double> y(nTraces*nSamples);
+        auto yPtr = y.data();
+        EXPECT_NO_THROW(stackCopy.align(nTraces, nSamples, shifts.data(),
+                                        x.data(), &yPtr));
+        double tol = 1.e-8;
+        if (method == FractionalShiftMethod::WINDOWED_SINC){tol = 5.e-3;}
+        for (int k = 0; k < nTraces; ++k)
+        {
+            double error = 0;
+            for (int i = 0; i < nSamples; ++i)
+            {
+                error = std::max(error, std::abs(y[k*nSamples + i]
+                                               - yRef[k*nSamples + i]));
+            }
+            // Integer shifts are exact
+            if (shifts[k] == std::round(shifts[k]))
+            {
+                EXPECT_NEAR(error, 0, 1.e-14);
+            }
+            EXPECT_NEAR(error, 0, tol);
+        }
+        shifts[1] = nSamples;
+        EXPECT_THROW(stack.align(nTraces, nSamples, shifts.data(),
+                                 x.data(), &yPtr),
+                     std::invalid_argument);
+        shifts[1] = 17;
+    }
+}
+
+TEST(UtilitiesStacking, stack)
+{
+    const int nSamples = 256;
+    const int nTraces = 150;
+    const double t0 = 128;
+    // Delayed pulses with noise
+    std::mt19937 rng(5021);
+    std::uniform_real_distribution<double> delay(-30, 30);
+    std::normal_distribution<double> noise(0, 0.1);
+    std::vector<double> x(nTraces*nSamples);
+    std::vector<double> shifts(nTraces);
+    for (int k = 0; k < nTraces; ++k)
+    {
+        auto d = delay(rng);
+        shifts[k] =-d;
+        for (int i = 0; i < nSamples; ++i)
+        {
+            x[k*nSamples + i] = pulse(i, t0 + d) + noise(rng);
+        }
+    }
+    std::vector<double> linear(nSamples);
+    auto yPtr = linear.data();
+    Stack<double> stack;
+    stack.initialize(nSamples, StackType::LINEAR);
+    EXPECT_NO_THROW(stack.apply(nTraces, nSamples, shifts.data(),
+                                x.data(), &yPtr));
+    double error = 0;
+    for (int i = 0; i < nSamples; ++i)
+    {
+        error = std::max(error, std::abs(linear[i] - pulse(i, t0)));
+    }
+    EXPECT_LT(error, 0.05);
+    // Repeating the stack gives the identical result
+    std::vector<double> linear2(nSamples);
+    yPtr = linear2.data();
+    stack.apply(nTraces, nSamples, shifts.data(), x.data(), &yPtr);
+    for (int i = 0; i < nSamples; ++i){EXPECT_EQ(linear[i], linear2[i]);}
+    // A first-root stack is a linear stack
+    std::vector<double> y(nSamples);
+    yPtr = y.data();
+    stack.initialize(nSamples, StackType::NTH_ROOT, 1);
+    stack.apply(nTraces, nSamples, shifts.data(), x.data(), &yPtr);
+    error = 0;
+    for (int i = 0; i < nSamples; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - linear[i]));
+    }
+    EXPECT_NEAR(error, 0, 1.e-12);
+    // An nth-root stack of identical traces is that trace
+    std::vector<double> same(nTraces*nSamples);
+    for (int k = 0; k < nTraces; ++k)
+    {
+        std::copy(x.begin(), x.begin() + nSamples,
+                  same.begin() + k*nSamples);
+    }
+    stack.initialize(nSamples, StackType::NTH_ROOT, 4);
+    stack.apply(nTraces, nSamples, nullptr, same.data(), &yPtr);
+    error = 0;
+    for (int i = 0; i < nSamples; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - x[i]));
+    }
+    EXPECT_NEAR(error, 0, 1.e-12);
+    // The phases of identical traces are coherent
+    stack.initialize(nSamples, StackType::PHASE_WEIGHTED, 2);
+    stack.apply(nTraces, nSamples, nullptr, same.data(), &yPtr);
+    error = 0;
+    for (int i = 0; i < nSamples; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - x[i]));
+    }
+    EXPECT_NEAR(error, 0, 1.e-10);
+    // The phase-weighted stack suppresses incoherent noise
+    stack.initialize(nSamples, StackType::PHASE_WEIGHTED, 2,
+                     FractionalShiftMethod::WINDOWED_SINC);
+    stack.apply(nTraces, nSamples, shifts.data(), x.data(), &yPtr);
+    double linearNoise = 0;
+    double pwsNoise = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        linearNoise = linearNoise + linear[i]*linear[i];
+        pwsNoise = pwsNoise + y[i]*y[i];
+    }
+    EXPECT_LT(pwsNoise, 0.1*linearNoise);
+    EXPECT_NEAR(y[static_cast<int> (t0)], 1, 0.1);
+    EXPECT_THROW(stack.initialize(nSamples, StackType::NTH_ROOT, 0),
+                 std::invalid_argument);
+}
+
+TEST(UtilitiesStacking, backprojection)
+{
+    // A 3D grid of trial sources and randomly placed stations
+    const int nx = 10;
+    const int ny = 8;
+    const int nz = 6;
+    const int nGridPoints = nx*ny*nz;
+    const int nStations = 12;
+    const int nSamples = 1500;
+    const double velocity = 3.5; // km/s
+    const double dt = 0.1;
+    std::mt19937 rng(9424);
+    std::uniform_real_distribution<double> position(0, 50);
+    std::vector<double> stationX(nStations);
+    std::vector<double> stationY(nStations);
+    for (int s = 0; s < nStations; ++s)
+    {
+        stationX[s] = position(rng);
+        stationY[s] = position(rng);
+    }
+    std::vector<int> delays(nGridPoints*nStations);
+    for (int iz = 0; iz < nz; ++iz)
+    {
+        for (int iy = 0; iy < ny; ++iy)
+        {
+            for (int ix = 0; ix < nx; ++ix)
+            {
+                auto g = (iz*ny + iy)*nx + ix;
+                for (int s = 0; s < nStations; ++s)
+                {
+                    auto distance = std::hypot(5.0*ix - stationX[s],
+                                               5.0*iy - stationY[s],
+                                               3.0*iz);
+                    delays[g*nStations + s]
+                        = static_cast<int> (std::round(distance/velocity/dt));
+                }
+            }
+        }
+    }
+    // Envelopes of a source at grid point g0 and origin time t0
+    const int g0 = (3*ny + 5)*nx + 2;
+    const int t0 = 400;
+    std::uniform_real_distribution<double> noise(0, 0.2);
+    std::vector<double> envelopes(nStations*nSamples);
+    for (int s = 0; s < nStations; ++s)
+    {
+        auto arrival = t0 + delays[g0*nStations + s];
+        for (int i = 0; i < nSamples; ++i)
+        {
+            auto tau = (i - arrival)/2.0;
+            envelopes[s*nSamples + i] = noise(rng) + std::exp(-tau*tau);
+        }
+    }
+    Backprojection<RTSeis::ProcessingMode::POST, double> backprojection;
+    EXPECT_NO_THROW(backprojection.initialize(nStations, nGridPoints,
+                                              delays.data()));
+    EXPECT_EQ(backprojection.getNumberOfStations(), nStations);
+    EXPECT_EQ(backprojection.getNumberOfGridPoints(), nGridPoints);
+    auto maxDelay = *std::max_element(delays.begin(), delays.end());
+    EXPECT_EQ(backprojection.getMaximumDelay(), maxDelay);
+    auto nOut = backprojection.getNumberOfOutputSamples(nSamples);
+    EXPECT_EQ(nOut, nSamples - maxDelay);
+    std::vector<double> brightness(nOut*nGridPoints);
+    auto bPtr = brightness.data();
+    EXPECT_NO_THROW(backprojection.apply(nSamples, envelopes.data(), &bPtr));
+    double error = 0;
+    for (int t = 0; t < nOut; ++t)
+    {
+        for (int g = 0; g < nGridPoints; ++g)
+        {
+            double sum = 0;
+            for (int s = 0; s < nStations; ++s)
+            {
+                sum = sum + envelopes[s*nSamples + t + delays[g*nStations + s]];
+            }
+            error = std::max(error, std::abs(brightness[t*nGridPoints + g]
+                                           - sum/nStations));
+        }
+    }
+    EXPECT_NEAR(error, 0, 1.e-12);
+    // The brightest point is the source
+    auto peak = std::distance(brightness.begin(),
+                              std::max_element(brightness.begin(),
+                                               brightness.end()));
+    EXPECT_EQ(peak/nGridPoints, t0);
+    EXPECT_EQ(peak%nGridPoints, g0);
+    // The real-time backprojection lags by the maximum delay
+    Backprojection<RTSeis::ProcessingMode::REAL_TIME, double> rtBackprojection;
+    rtBackprojection.initialize(nStations, nGridPoints, delays.data());
+    auto rtCopy = rtBackprojection;
+    EXPECT_EQ(rtCopy.getNumberOfOutputSamples(17), 17);
+    std::vector<double> rtBrightness(nSamples*nGridPoints);
+    std::vector<double> packet;
+    int i1 = 0;
+    int packetSize = 1;
+    while (i1 < nSamples)
+    {
+        auto nPacket = std::min(packetSize, nSamples - i1);
+        packet.resize(nStations*nPacket);
+        for (int s = 0; s < nStations; ++s)
+        {
+            std::copy(envelopes.begin() + s*nSamples + i1,
+                      envelopes.begin() + s*nSamples + i1 + nPacket,
+                      packet.begin() + s*nPacket);
+        }
+        auto rtPtr = rtBrightness.data() + i1*nGridPoints;
+        rtCopy.apply(nPacket, packet.data(), &rtPtr);
+        i1 = i1 + nPacket;
+        packetSize = (packetSize*5)%700 + 1;
+    }
+    error = 0;
+    for (int t = 0; t < nOut; ++t)
+    {
+        for (int g = 0; g < nGridPoints; ++g)
+        {
+            error = std::max(error,
+                             std::abs(rtBrightness[(t + maxDelay)*nGridPoints + g]
+                                    - brightness[t*nGridPoints + g]));
+        }
+    }
+    EXPECT_NEAR(error, 0, 1.e-12);
+    // Errors
+    delays[5] =-1;
+    EXPECT_THROW(backprojection.initialize(nStations, nGridPoints,
+                                           delays.data()),
+                 std::invalid_argument);
+}
+
+}
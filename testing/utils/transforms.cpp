@@ -23,6 +23,10 @@
 #include "rtseis/transforms/welch.hpp"
 #include "rtseis/transforms/slidingWindowRealDFTParameters.hpp"
 #include "rtseis/transforms/slidingWindowRealDFT.hpp"
+#include "rtseis/transforms/slidingDFT.hpp"
+#include "rtseis/transforms/streamingWelch.hpp"
+#include "rtseis/transforms/stockwell.hpp"
+#include "rtseis/transforms/constantQ.hpp"
 #include "rtseis/transforms/utilities.hpp"
 #include "rtseis/transforms/wavelets/morlet.hpp"
 #include "rtseis/transforms/continuousWavelet.hpp"
@@ -1225,6 +1229,408 @@ TEST(UtilitiesTransforms, Welch)
     EXPECT_LE(error, 1.e-5);
 }
 
+TEST(UtilitiesTransforms, SlidingDFT)
+{
+    const int windowLength = 64;
+    const int npts = 3000;
+    const int nChannels = 2;
+    const std::vector<int> bins{0, 1, 5, 31, 32};
+    const auto nBins = static_cast<int> (bins.size());
+    std::vector<double> x(nChannels*npts);
+    for (int i = 0; i < nChannels*npts; ++i)
+    {
+        x[i] = 10 + std::sin(0.3*i) + 0.5*std::cos(1.7*i + 0.2);
+    }
+    for (auto window : {SlidingWindowType::BOXCAR, SlidingWindowType::HANN,
+                        SlidingWindowType::BLACKMAN})
+    {
+        SlidingDFT<double> sdft;
+        EXPECT_NO_THROW(sdft.initialize(windowLength, bins, window, nChannels));
+        EXPECT_EQ(sdft.getWindowLength(), windowLength);
+        EXPECT_EQ(sdft.getNumberOfBins(), nBins);
+        EXPECT_EQ(sdft.getNumberOfChannels(), nChannels);
+        // Apply in uneven packets
+        std::vector<std::complex<double>> y(nChannels*nBins*npts);
+        int nxloc = 0;
+        for (int packetSize = 1; nxloc < npts; packetSize = packetSize%71 + 1)
+        {
+            auto n = std::min(packetSize, npts - nxloc);
+            std::vector<double> xPacket(nChannels*n);
+            std::vector<std::complex<double>> yPacket(nChannels*nBins*n);
+            for (int c = 0; c < nChannels; ++c)
+            {
+                std::copy(x.data() + c*npts + nxloc,
+                          x.data() + c*npts + nxloc + n,
+                          xPacket.data() + c*n);
+            }
+            auto yptr = yPacket.data();
+            sdft.transform(n, xPacket.data(), &yptr);
+            for (int cb = 0; cb < nChannels*nBins; ++cb)
+            {
+                std::copy(yPacket.data() + cb*n, yPacket.data() + (cb + 1)*n,
+                          y.data() + cb*npts + nxloc);
+            }
+            nxloc = nxloc + n;
+        }
+        // Compare to the windowed DFT of the window ending at each sample
+        double emax = 0;
+        for (int c = 0; c < nChannels; ++c)
+        {
+            for (int i = 0; i < npts; ++i)
+            {
+                for (int b = 0; b < nBins; ++b)
+                {
+                    std::complex<double> yref(0, 0);
+                    for (int m = 0; m < windowLength; ++m)
+                    {
+                        auto idx = i - windowLength + 1 + m;
+                        if (idx < 0){continue;}
+                        auto arg = 2*M_PI*m/windowLength;
+                        double w = 1;
+                        if (window == SlidingWindowType::HANN)
+                        {
+                            w = 0.5 - 0.5*std::cos(arg);
+                        }
+                        else if (window == SlidingWindowType::BLACKMAN)
+                        {
+                            w = 0.42 - 0.5*std::cos(arg) + 0.08*std::cos(2*arg);
+                        }
+                        yref = yref + w*x[c*npts + idx]
+                                     *std::polar(1.0, -arg*bins[b]);
+                    }
+                    emax = std::max(emax,
+                                    std::abs(yref - y[(c*nBins + b)*npts + i]));
+                }
+            }
+        }
+        EXPECT_LE(emax, 1.e-10);
+    }
+    SlidingDFT<float> sdft32;
+    EXPECT_THROW(sdft32.initialize(windowLength, {33}), std::invalid_argument);
+    EXPECT_THROW(sdft32.initialize(windowLength, {1}, SlidingWindowType::CUSTOM),
+                 std::invalid_argument);
+}
+
+TEST(UtilitiesTransforms, StreamingWelch)
+{
+    SlidingWindowRealDFTParameters parameters;
+    double samplingRate = 100;
+    int nSamples = 4000;
+    int nWindowLength = 256;
+    int nSamplesInOverlap = 128;
+    std::vector<double> x(2*nSamples);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        auto time = static_cast<double> (i)/samplingRate;
+        x[i] = std::sin(2*M_PI*12.5*time) + 0.1*std::cos(2*M_PI*31*time);
+        x[nSamples + i] = std::cos(2*M_PI*3*time) + 0.001*i;
+    }
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nSamples));
+    EXPECT_NO_THROW(parameters.setWindow(nWindowLength,
+                                         SlidingWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(nSamplesInOverlap));
+    EXPECT_NO_THROW(parameters.setDetrendType(SlidingWindowDetrendType::REMOVE_MEAN));
+    EXPECT_NO_THROW(parameters.setDFTLength(300));
+    // Reference
+    std::vector<std::vector<double>> psdRef(2), spectrumRef(2);
+    Welch welch;
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    auto frequenciesRef = welch.getFrequencies();
+    for (int c = 0; c < 2; ++c)
+    {
+        EXPECT_NO_THROW(welch.transform(nSamples, x.data() + c*nSamples));
+        psdRef[c] = welch.getPowerSpectralDensity();
+        spectrumRef[c] = welch.getPowerSpectrum();
+    }
+    auto nSegments = (nSamples - nSamplesInOverlap)
+                    /(nWindowLength - nSamplesInOverlap);
+    // A sliding average over all segments and an exponential average whose
+    // time constant exceeds the number of segments both reproduce Welch
+    for (auto averaging : {WelchAverageType::SLIDING,
+                           WelchAverageType::EXPONENTIAL})
+    {
+        StreamingWelch<double> streamingWelch;
+        EXPECT_NO_THROW(streamingWelch.initialize(parameters, samplingRate,
+                                                  2, averaging,
+                                                  nSegments + 1));
+        EXPECT_EQ(streamingWelch.getNumberOfFrequencies(),
+                  welch.getNumberOfFrequencies());
+        EXPECT_FALSE(streamingWelch.haveTransform());
+        auto frequencies = streamingWelch.getFrequencies();
+        for (int k = 0; k < static_cast<int> (frequencies.size()); ++k)
+        {
+            EXPECT_NEAR(frequencies[k], frequenciesRef[k], 1.e-10);
+        }
+        // Feed awkward packet sizes
+        int i0 = 0;
+        int packetSize = 1;
+        std::vector<double> packet;
+        while (i0 < nSamples)
+        {
+            auto n = std::min(packetSize, nSamples - i0);
+            packet.resize(2*n);
+            for (int c = 0; c < 2; ++c)
+            {
+                std::copy(x.data() + c*nSamples + i0,
+                          x.data() + c*nSamples + i0 + n,
+                          packet.data() + c*n);
+            }
+            EXPECT_NO_THROW(streamingWelch.transform(n, packet.data()));
+            i0 = i0 + n;
+            packetSize = (packetSize*7 + 3)%97 + 1;
+        }
+        EXPECT_EQ(streamingWelch.getNumberOfSegments(), nSegments);
+        for (int c = 0; c < 2; ++c)
+        {
+            auto psd = streamingWelch.getPowerSpectralDensity(c);
+            auto spectrum = streamingWelch.getPowerSpectrum(c);
+            double pMax = *std::max_element(psdRef[c].begin(),
+                                            psdRef[c].end());
+            double sMax = *std::max_element(spectrumRef[c].begin(),
+                                            spectrumRef[c].end());
+            for (int k = 0; k < static_cast<int> (psd.size()); ++k)
+            {
+                EXPECT_NEAR(psd[k], psdRef[c][k], 1.e-10*pMax);
+                EXPECT_NEAR(spectrum[k], spectrumRef[c][k], 1.e-10*sMax);
+            }
+        }
+    }
+    // A short sliding average tracks the most recent segments
+    StreamingWelch<float> streamingWelch;
+    EXPECT_NO_THROW(streamingWelch.initialize(parameters, samplingRate, 1,
+                                              WelchAverageType::SLIDING, 3));
+    std::vector<float> x32(x.begin(), x.begin() + nSamples);
+    EXPECT_NO_THROW(streamingWelch.transform(nSamples, x32.data()));
+    auto nKeep = nWindowLength + 2*(nWindowLength - nSamplesInOverlap);
+    auto i0 = (nSegments - 3)*(nWindowLength - nSamplesInOverlap);
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nKeep));
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    EXPECT_NO_THROW(welch.transform(nKeep, x.data() + i0));
+    auto psdRecent = welch.getPowerSpectralDensity();
+    auto psd = streamingWelch.getPowerSpectralDensity(0);
+    double pMax = *std::max_element(psdRecent.begin(), psdRecent.end());
+    for (int k = 0; k < static_cast<int> (psd.size()); ++k)
+    {
+        EXPECT_NEAR(psd[k], psdRecent[k], 1.e-4*pMax);
+    }
+    EXPECT_THROW(psd = streamingWelch.getPowerSpectralDensity(1),
+                 std::invalid_argument);
+}
+
+TEST(UtilitiesTransforms, Stockwell)
+{
+    const int nSamples = 201;
+    const double samplingRate = 50;
+    std::vector<double> x(nSamples);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        auto time = static_cast<double> (i)/samplingRate;
+        x[i] = std::sin(2*M_PI*5*time)*std::exp(-0.5*std::pow(time - 2, 2))
+             + 0.2*std::cos(2*M_PI*17*time);
+    }
+    // Reference from the definition
+    std::vector<std::complex<double>> spectrum(nSamples, 0);
+    for (int k = 0; k < nSamples; ++k)
+    {
+        for (int i = 0; i < nSamples; ++i)
+        {
+            spectrum[k] = spectrum[k]
+                        + x[i]*std::polar(1.0, -2*M_PI*k*i/nSamples);
+        }
+    }
+    auto nVoices = nSamples/2 + 1;
+    std::vector<std::complex<double>> stRef(nVoices*nSamples, 0);
+    for (int n = 0; n < nVoices; ++n)
+    {
+        for (int j = 0; j < nSamples; ++j)
+        {
+            if (n == 0)
+            {
+                stRef[j] = spectrum[0]/static_cast<double> (nSamples);
+                continue;
+            }
+            std::complex<double> s = 0;
+            for (int m =-(nSamples - 1)/2; m <= nSamples/2; ++m)
+            {
+                auto g = std::exp(-2*M_PI*M_PI*m*m/static_cast<double> (n*n));
+                s = s + spectrum[(m + n + nSamples)%nSamples]*g
+                       *std::polar(1.0, 2*M_PI*m*j/nSamples);
+            }
+            stRef[n*nSamples + j] = s/static_cast<double> (nSamples);
+        }
+    }
+    Stockwell<double> stockwell;
+    EXPECT_NO_THROW(stockwell.initialize(nSamples, samplingRate));
+    EXPECT_EQ(stockwell.getNumberOfFrequencies(), nVoices);
+    EXPECT_NO_THROW(stockwell.transform(nSamples, x.data()));
+    EXPECT_TRUE(stockwell.haveTransform());
+    std::vector<std::complex<double>> st(nVoices*nSamples);
+    auto stPtr = st.data();
+    EXPECT_NO_THROW(stockwell.getTransform(nSamples, nVoices, &stPtr));
+    double error = 0;
+    for (int i = 0; i < static_cast<int> (st.size()); ++i)
+    {
+        error = std::max(error, std::abs(st[i] - stRef[i]));
+    }
+    EXPECT_LE(error, 1.e-10);
+    // Averaging a voice over time recovers the spectrum
+    for (int n = 0; n < nVoices; ++n)
+    {
+        std::complex<double> s = 0;
+        for (int j = 0; j < nSamples; ++j){s = s + st[n*nSamples + j];}
+        EXPECT_NEAR(std::abs(s - spectrum[n]), 0, 1.e-8);
+    }
+    // Decimated band with only the amplitude
+    Stockwell<float> stockwellAmp;
+    EXPECT_NO_THROW(stockwellAmp.initialize(nSamples, samplingRate,
+                                            2, 20, 3, true));
+    auto frequencies = stockwellAmp.getFrequencies();
+    auto nFrequencies = stockwellAmp.getNumberOfFrequencies();
+    EXPECT_EQ(nFrequencies, static_cast<int> (frequencies.size()));
+    std::vector<float> x32(x.begin(), x.end());
+    EXPECT_NO_THROW(stockwellAmp.transform(nSamples, x32.data()));
+    std::vector<float> amplitude(nFrequencies*nSamples);
+    auto aPtr = amplitude.data();
+    EXPECT_NO_THROW(stockwellAmp.getAmplitudeTransform(nSamples, nFrequencies,
+                                                       &aPtr));
+    std::vector<std::complex<float>> st32(nFrequencies*nSamples);
+    auto st32Ptr = st32.data();
+    EXPECT_THROW(stockwellAmp.getTransform(nSamples, nFrequencies, &st32Ptr),
+                 std::runtime_error);
+    for (int i = 0; i < nFrequencies; ++i)
+    {
+        auto n = static_cast<int> (std::lround(frequencies[i]*nSamples
+                                               /samplingRate));
+        EXPECT_EQ((n - 8)%3, 0);
+        for (int j = 0; j < nSamples; ++j)
+        {
+            EXPECT_NEAR(amplitude[i*nSamples + j],
+                        std::abs(stRef[n*nSamples + j]), 1.e-5);
+        }
+    }
+}
+
+TEST(UtilitiesTransforms, ConstantQ)
+{
+    const double samplingRate = 100;
+    const int nSamples = 12000;
+    const int binsPerOctave = 6;
+    std::vector<double> x(nSamples);
+    for (int i = 0; i < nSamples; ++i)
+    {
+        auto time = static_cast<double> (i)/samplingRate;
+        x[i] = std::sin(2*M_PI*8*time)
+             + 0.5*std::cos(2*M_PI*1.1*time + 0.3)
+             + 0.3*std::sin(2*M_PI*0.5*time);
+    }
+    ConstantQ<RTSeis::ProcessingMode::POST, double> cqt;
+    EXPECT_NO_THROW(cqt.initialize(samplingRate, 0.5, 35, binsPerOctave));
+    auto frequencies = cqt.getFrequencies();
+    auto nBins = cqt.getNumberOfFrequencies();
+    EXPECT_EQ(nBins, 6*6 + 1);
+    EXPECT_EQ(cqt.getNumberOfOctaves(), 7);
+    auto hop = cqt.getHopLength();
+    EXPECT_EQ(hop, 64);
+    EXPECT_NEAR(frequencies.back(), 32, 1.e-10);
+    // Reference from the definition at the original sampling rate
+    auto q = 1/(std::pow(2.0, 1.0/binsPerOctave) - 1);
+    auto reference = [&](const int m, const int k)
+    {
+        auto width = q*samplingRate/frequencies[k];
+        std::complex<double> c = 0;
+        double wsum = 0;
+        for (int i = 0; i < nSamples; ++i)
+        {
+            auto t = static_cast<double> (i - m*hop);
+            if (std::abs(t) < width/2)
+            {
+                auto w = 0.5*(1 + std::cos(2*M_PI*t/width));
+                c = c + x[i]*w*std::polar(1.0, -2*M_PI*frequencies[k]*t
+                                               /samplingRate);
+            }
+        }
+        for (int i =-nSamples; i <= nSamples; ++i)
+        {
+            if (std::abs(i) < width/2)
+            {
+                wsum = wsum + 0.5*(1 + std::cos(2*M_PI*i/width));
+            }
+        }
+        return c/wsum;
+    };
+    auto inside = [&](const int m, const int k)
+    {
+        auto width = q*samplingRate/frequencies[k];
+        return m*hop - width/2 >= 0 && m*hop + width/2 <= nSamples - 1;
+    };
+    EXPECT_NO_THROW(cqt.transform(nSamples, x.data()));
+    auto nWindows = cqt.getNumberOfTransformWindows();
+    EXPECT_EQ(nWindows, (nSamples - 1)/hop + 1);
+    auto times = cqt.getTimeWindows();
+    EXPECT_NEAR(times.at(2), 2*hop/samplingRate, 1.e-10);
+    auto cq = cqt.getTransform();
+    auto amplitude = cqt.getAmplitude();
+    double error = 0;
+    for (int m = 0; m < nWindows; ++m)
+    {
+        for (int k = 0; k < nBins; ++k)
+        {
+            if (!inside(m, k)){continue;}
+            error = std::max(error,
+                             std::abs(cq[m*nBins + k] - reference(m, k)));
+        }
+    }
+    EXPECT_LE(error, 5.e-3);
+    // A sinusoid at a bin's frequency has half its amplitude
+    auto k8 = 4*binsPerOctave;
+    EXPECT_NEAR(frequencies[k8], 8, 1.e-10);
+    EXPECT_NEAR(amplitude[(nWindows/2)*nBins + k8], 0.5, 1.e-2);
+    // Stream the signal in packets
+    ConstantQ<RTSeis::ProcessingMode::REAL_TIME, double> cqtRT;
+    EXPECT_NO_THROW(cqtRT.initialize(samplingRate, 0.5, 35, binsPerOctave));
+    std::vector<std::complex<double>> cqRT;
+    std::vector<double> timesRT;
+    int i0 = 0;
+    int packetSize = 5;
+    while (i0 < nSamples)
+    {
+        auto n = std::min(packetSize, nSamples - i0);
+        EXPECT_NO_THROW(cqtRT.transform(n, x.data() + i0));
+        auto c = cqtRT.getTransform();
+        auto t = cqtRT.getTimeWindows();
+        EXPECT_EQ(static_cast<int> (c.size()),
+                  cqtRT.getNumberOfTransformWindows()*nBins);
+        cqRT.insert(cqRT.end(), c.begin(), c.end());
+        timesRT.insert(timesRT.end(), t.begin(), t.end());
+        i0 = i0 + n;
+        packetSize = (packetSize*13 + 7)%300 + 1;
+    }
+    auto nWindowsRT = static_cast<int> (cqRT.size())/nBins;
+    EXPECT_GT(nWindowsRT, 0);
+    EXPECT_LT(nWindowsRT, nWindows);
+    error = 0;
+    for (int m = 0; m < nWindowsRT; ++m)
+    {
+        EXPECT_NEAR(timesRT[m], m*hop/samplingRate, 1.e-8);
+        for (int k = 0; k < nBins; ++k)
+        {
+            if (!inside(m, k)){continue;}
+            error = std::max(error,
+                             std::abs(cqRT[m*nBins + k] - reference(m, k)));
+        }
+    }
+    EXPECT_LE(error, 5.e-3);
+    // A streamed window does not depend on the samples that arrive after it
+    // is returned
+    ConstantQ<RTSeis::ProcessingMode::REAL_TIME, double> cqtWhole;
+    cqtWhole.initialize(samplingRate, 0.5, 35, binsPerOctave);
+    cqtWhole.transform(nSamples, x.data());
+    auto cqWhole = cqtWhole.getTransform();
+    ASSERT_EQ(cqWhole.size(), cqRT.size());
+    for (size_t i = 0; i < cqRT.size(); ++i){EXPECT_EQ(cqWhole[i], cqRT[i]);}
+    EXPECT_THROW(cqt.initialize(samplingRate, 0.5, 45), std::invalid_argument);
+}
+
 TEST(UtilitiesTransforms, CWT)
 {
     // Read the signal and answer
@@ -5,7 +5,9 @@
 #include <string>
 #include <vector>
 #include <ipps.h>
+#include <random>
 #include "rtseis/trigger/waterLevel.hpp"
+#include "rtseis/trigger/arAICPicker.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -56,4 +58,46 @@ fclose(fout);
 */
 }
 
+TEST(UtilitiesTrigger, arAICPicker)
+{
+    // Noise followed by a higher amplitude, differently colored signal
+    const int nSamples = 20000;
+    std::mt19937 rng(1034);
+    std::normal_distribution<double> noise(0, 1);
+    std::vector<int> onsets;
+    for (int i = 1000; i < nSamples - 500; i = i + 700){onsets.push_back(i);}
+    std::vector<double> x(nSamples);
+    for (int i = 0; i < nSamples; ++i){x[i] = 0.1*noise(rng);}
+    for (auto onset : onsets)
+    {
+        for (int i = onset; i < onset + 300; ++i)
+        {
+            x[i] = x[i] + std::exp(-(i - onset)/100.)
+                         *std::sin(2*M_PI*0.05*(i - onset));
+        }
+    }
+    // Coarse triggers that are late by up to 20 samples
+    std::vector<int> triggers;
+    for (int i = 0; i < static_cast<int> (onsets.size()); ++i)
+    {
+        triggers.push_back(onsets[i] + (7*i)%21);
+    }
+    triggers.push_back(50); // Window does not fit
+    RTSeis::Trigger::ARAICPicker<double> picker;
+    EXPECT_NO_THROW(picker.initialize(100, 100, 60, 60, 4));
+    EXPECT_EQ(picker.getWindowBefore(), 100);
+    EXPECT_EQ(picker.getWindowAfter(), 100);
+    EXPECT_EQ(picker.getOrder(), 4);
+    std::vector<int> picks(triggers.size());
+    auto picksPtr = picks.data();
+    EXPECT_NO_THROW(picker.pick(nSamples, x.data(),
+                                static_cast<int> (triggers.size()),
+                                triggers.data(), &picksPtr));
+    for (int i = 0; i < static_cast<int> (onsets.size()); ++i)
+    {
+        EXPECT_LE(std::abs(picks[i] - onsets[i]), 3);
+    }
+    EXPECT_EQ(picks.back(), -1);
+}
+
 }
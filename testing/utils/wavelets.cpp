@@ -4,9 +4,14 @@
 #include <cmath>
 #include <exception>
 #include <vector>
+#include <random>
+#include <algorithm>
 #include <ipps.h>
 //#include "rtseis/utilities/transforms/wavelets/derivativeOfGaussian.hpp"
 #include "rtseis/transforms/wavelets/morlet.hpp"
+#include "rtseis/transforms/discreteWavelet.hpp"
+#include "rtseis/transforms/stationaryWavelet.hpp"
+#include "rtseis/transforms/waveletDenoiser.hpp"
 //#include "rtseis/utilities/transforms/wavelets/ricker.hpp"
 #include <gtest/gtest.h>
 
@@ -238,5 +243,248 @@ TEST(UtilitiesTransformsWavelets, morlet)
     EXPECT_NEAR(error, 0, 1.e-14);
 }
 
+TEST(UtilitiesTransformsWavelets, dwt)
+{
+    // Filter properties for every available wavelet
+    std::vector<std::pair<DiscreteWaveletFamily, std::pair<int, int>>> families{
+        {DiscreteWaveletFamily::DAUBECHIES, {1, 10}},
+        {DiscreteWaveletFamily::SYMLET,     {2, 10}},
+        {DiscreteWaveletFamily::COIFLET,    {1, 4}} };
+    DiscreteWavelet<double> dwt;
+    for (const auto &family : families)
+    {
+        for (int order = family.second.first;
+             order <= family.second.second; ++order)
+        {
+            EXPECT_NO_THROW(dwt.initialize(family.first, order, 1));
+            auto h = dwt.getScalingFilter();
+            auto g = dwt.getWaveletFilter();
+            auto nh = static_cast<int> (h.size());
+            double sum = 0;
+            for (const auto &hi : h){sum = sum + hi;}
+            EXPECT_NEAR(sum, std::sqrt(2.0), 1.e-12);
+            // Orthonormal to even shifts
+            for (int m = 0; m < nh/2; ++m)
+            {
+                double dot = 0;
+                for (int l = 0; l < nh - 2*m; ++l){dot = dot + h[l]*h[l + 2*m];}
+                EXPECT_NEAR(dot, m == 0 ? 1 : 0, 1.e-12);
+            }
+            // Vanishing moments of the wavelet
+            int nMoments = order;
+            if (family.first == DiscreteWaveletFamily::COIFLET)
+            {
+                nMoments = 2*order;
+            }
+            for (int p = 0; p < nMoments; ++p)
+            {
+                double moment = 0;
+                for (int l = 0; l < nh; ++l)
+                {
+                    moment = moment + g[l]*std::pow(static_cast<double> (l)/nh, p);
+                }
+                EXPECT_NEAR(moment, 0, 1.e-10);
+            }
+        }
+    }
+    EXPECT_THROW(dwt.initialize(DiscreteWaveletFamily::SYMLET, 1, 1),
+                 std::invalid_argument);
+    EXPECT_THROW(dwt.initialize(DiscreteWaveletFamily::COIFLET, 5, 1),
+                 std::invalid_argument);
+    // Daubechies 2 from Daubechies (1988)
+    dwt.initialize(DiscreteWaveletFamily::DAUBECHIES, 2, 1);
+    auto h = dwt.getScalingFilter();
+    EXPECT_NEAR(h[0], (1 + std::sqrt(3.0))/(4*std::sqrt(2.0)), 1.e-15);
+    EXPECT_NEAR(h[1], (3 + std::sqrt(3.0))/(4*std::sqrt(2.0)), 1.e-15);
+    EXPECT_NEAR(h[2], (3 - std::sqrt(3.0))/(4*std::sqrt(2.0)), 1.e-15);
+    EXPECT_NEAR(h[3], (1 - std::sqrt(3.0))/(4*std::sqrt(2.0)), 1.e-15);
+    // Haar transform
+    std::vector<double> x({1, 3, -2, 4, 5, 5, 0, -1});
+    std::vector<double> c(x.size());
+    auto cPtr = c.data();
+    dwt.initialize(DiscreteWaveletFamily::DAUBECHIES, 1, 1);
+    dwt.forwardTransform(static_cast<int> (x.size()), x.data(), &cPtr);
+    for (int k = 0; k < 4; ++k)
+    {
+        EXPECT_NEAR(c[k], (x[2*k] + x[2*k+1])/std::sqrt(2.0), 1.e-14);
+        EXPECT_NEAR(c[4+k], (x[2*k] - x[2*k+1])/std::sqrt(2.0), 1.e-14);
+    }
+    // Perfect reconstruction and energy conservation
+    const int n = 320;
+    std::mt19937 rng(86754);
+    std::normal_distribution<double> normal(0, 1);
+    x.resize(n);
+    for (auto &xi : x){xi = normal(rng);}
+    double energy = 0;
+    for (const auto &xi : x){energy = energy + xi*xi;}
+    c.resize(n);
+    std::vector<double> xr(n);
+    for (const auto &family : families)
+    {
+        dwt.initialize(family.first, family.second.second, 4);
+        EXPECT_THROW(dwt.forwardTransform(n + 8, x.data(), &cPtr),
+                     std::invalid_argument);
+        cPtr = c.data();
+        dwt.forwardTransform(n, x.data(), &cPtr);
+        double cEnergy = 0;
+        for (const auto &ci : c){cEnergy = cEnergy + ci*ci;}
+        EXPECT_NEAR(cEnergy, energy, 1.e-9*energy);
+        auto xPtr = xr.data();
+        DiscreteWavelet<double> dwtCopy(dwt);
+        dwtCopy.inverseTransform(n, c.data(), &xPtr);
+        double error = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            error = std::max(error, std::abs(xr[i] - x[i]));
+        }
+        EXPECT_NEAR(error, 0, 1.e-10);
+    }
+    // Float
+    DiscreteWavelet<float> dwtf;
+    dwtf.initialize(DiscreteWaveletFamily::SYMLET, 4, 3);
+    std::vector<float> xf(x.begin(), x.end());
+    std::vector<float> cf(n);
+    std::vector<float> xrf(n);
+    auto cfPtr = cf.data();
+    auto xrfPtr = xrf.data();
+    dwtf.forwardTransform(n, xf.data(), &cfPtr);
+    dwtf.inverseTransform(n, cf.data(), &xrfPtr);
+    float errorf = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        errorf = std::max(errorf, std::abs(xrf[i] - xf[i]));
+    }
+    EXPECT_NEAR(errorf, 0, 1.e-4);
+}
+
+TEST(UtilitiesTransformsWavelets, modwt)
+{
+    const int n = 300;
+    const int nLevels = 3;
+    std::mt19937 rng(4352);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<double> x(n);
+    for (auto &xi : x){xi = normal(rng);}
+    double energy = 0;
+    for (const auto &xi : x){energy = energy + xi*xi;}
+    StationaryWavelet<RTSeis::ProcessingMode::POST, double> modwt;
+    EXPECT_NO_THROW(modwt.initialize(DiscreteWaveletFamily::COIFLET, 2,
+                                     nLevels));
+    EXPECT_EQ(modwt.getNumberOfLevels(), nLevels);
+    std::vector<double> c((nLevels + 1)*n);
+    auto cPtr = c.data();
+    modwt.forwardTransform(n, x.data(), &cPtr);
+    double cEnergy = 0;
+    for (const auto &ci : c){cEnergy = cEnergy + ci*ci;}
+    EXPECT_NEAR(cEnergy, energy, 1.e-9*energy);
+    // Inverse
+    std::vector<double> xr(n);
+    auto xPtr = xr.data();
+    modwt.inverseTransform(n, c.data(), &xPtr);
+    double error = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        error = std::max(error, std::abs(xr[i] - x[i]));
+    }
+    EXPECT_NEAR(error, 0, 1.e-10);
+    // Shift invariance
+    const int shift = 7;
+    std::vector<double> xs(n);
+    for (int i = 0; i < n; ++i){xs[(i + shift)%n] = x[i];}
+    std::vector<double> cs((nLevels + 1)*n);
+    auto csPtr = cs.data();
+    modwt.forwardTransform(n, xs.data(), &csPtr);
+    error = 0;
+    for (int j = 0; j < nLevels + 1; ++j)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            error = std::max(error, std::abs(cs[j*n + (i + shift)%n]
+                                           - c[j*n + i]));
+        }
+    }
+    EXPECT_NEAR(error, 0, 1.e-12);
+    // Real-time with random packet sizes
+    StationaryWavelet<RTSeis::ProcessingMode::REAL_TIME, double> modwtRT;
+    modwtRT.initialize(DiscreteWaveletFamily::COIFLET, 2, nLevels);
+    EXPECT_THROW(modwtRT.inverseTransform(n, c.data(), &xPtr),
+                 std::runtime_error);
+    auto nTransient = modwtRT.getTransientLength();
+    EXPECT_EQ(nTransient, ((1 << nLevels) - 1)*11);
+    std::uniform_int_distribution<int> packetSize(1, 40);
+    std::vector<double> cRT((nLevels + 1)*n);
+    std::vector<double> packet;
+    int i0 = 0;
+    while (i0 < n)
+    {
+        auto nPacket = std::min(packetSize(rng), n - i0);
+        packet.resize((nLevels + 1)*nPacket);
+        auto pPtr = packet.data();
+        modwtRT.forwardTransform(nPacket, x.data() + i0, &pPtr);
+        for (int j = 0; j < nLevels + 1; ++j)
+        {
+            std::copy(packet.begin() + j*nPacket,
+                      packet.begin() + (j + 1)*nPacket,
+                      cRT.begin() + j*n + i0);
+        }
+        i0 = i0 + nPacket;
+    }
+    error = 0;
+    for (int j = 0; j < nLevels + 1; ++j)
+    {
+        for (int i = nTransient; i < n; ++i)
+        {
+            error = std::max(error, std::abs(cRT[j*n + i] - c[j*n + i]));
+        }
+    }
+    EXPECT_NEAR(error, 0, 1.e-12);
+}
+
+TEST(UtilitiesTransformsWavelets, waveletDenoiser)
+{
+    const int nTraces = 3;
+    const int nSamples = 1000;
+    const double sigma = 0.2;
+    std::mt19937 rng(2093);
+    std::normal_distribution<double> normal(0, sigma);
+    std::vector<double> signal(nTraces*nSamples);
+    std::vector<double> x(nTraces*nSamples);
+    for (int k = 0; k < nTraces; ++k)
+    {
+        for (int i = 0; i < nSamples; ++i)
+        {
+            auto t = static_cast<double> (i)/nSamples;
+            signal[k*nSamples + i] = std::sin(2*M_PI*(k + 2)*t)
+                                   + (t > 0.5 ? 1 : 0);
+            x[k*nSamples + i] = signal[k*nSamples + i] + normal(rng);
+        }
+    }
+    for (const auto type : {WaveletThresholdType::SOFT,
+                            WaveletThresholdType::HARD})
+    {
+        WaveletDenoiser<double> denoiser;
+        EXPECT_NO_THROW(denoiser.initialize(DiscreteWaveletFamily::SYMLET,
+                                            8, 5, type));
+        EXPECT_EQ(denoiser.getThresholdType(), type);
+        std::vector<double> y(nTraces*nSamples);
+        auto yPtr = y.data();
+        EXPECT_NO_THROW(denoiser.apply(nTraces, nSamples, x.data(), &yPtr));
+        auto thresholds = denoiser.getThresholds();
+        EXPECT_EQ(static_cast<int> (thresholds.size()), nTraces);
+        const double lambda = sigma*std::sqrt(2*std::log(nSamples*1.0));
+        for (int k = 0; k < nTraces; ++k)
+        {
+            EXPECT_NEAR(thresholds[k], lambda, 0.2*lambda);
+            double noisyError = 0;
+            double denoisedError = 0;
+            for (int i = k*nSamples; i < (k + 1)*nSamples; ++i)
+            {
+                noisyError = noisyError + std::pow(x[i] - signal[i], 2);
+                denoisedError = denoisedError + std::pow(y[i] - signal[i], 2);
+            }
+            EXPECT_LT(denoisedError, 0.25*noisyError);
+        }
+    }
+}
 
 }
@@ -2,6 +2,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <exception>
+#include <vector>
+#include <thread>
 #include <ipps.h>
 #include "rtseis/utilities/windowFunctions.hpp"
 #include <gtest/gtest.h>
@@ -347,4 +349,54 @@ TEST(UtilitiesWindowFunctions, sine)
     ASSERT_LE(error, 1.e-14);
 }
 
+TEST(UtilitiesWindowFunctions, windowCache)
+{
+    clearWindowCache();
+    EXPECT_EQ(getWindowCacheSize(), 0u);
+    // Cached windows match the generated windows
+    std::vector<double> kaiser20(20);
+    double *data = kaiser20.data();
+    kaiser(20, &data, 2.5);
+    auto w1 = getCachedWindow<double>(WindowType::KAISER, 20, 2.5);
+    EXPECT_EQ(static_cast<int> (w1->size()), 20);
+    double error;
+    ippsNormDiff_Inf_64f(kaiser20.data(), w1->data(), 20, &error);
+    EXPECT_LE(error, 1.e-14);
+    // Identical requests share memory and the parameter is part of the key
+    auto w2 = getCachedWindow<double>(WindowType::KAISER, 20, 2.5);
+    EXPECT_EQ(w1.get(), w2.get());
+    auto w3 = getCachedWindow<double>(WindowType::KAISER, 20, 3.5);
+    EXPECT_NE(w1.get(), w3.get());
+    // Precision is part of the key
+    auto w4 = getCachedWindow<float>(WindowType::HAMMING, 20);
+    std::vector<float> hamming20(20);
+    float *data32 = hamming20.data();
+    hamming(20, &data32);
+    for (int i = 0; i < 20; ++i){EXPECT_NEAR((*w4)[i], hamming20[i], 1.e-7);}
+    EXPECT_EQ(getWindowCacheSize(), 2*20*sizeof(double) + 20*sizeof(float));
+    EXPECT_THROW(getCachedWindow<double>(WindowType::HANN, 0),
+                 std::invalid_argument);
+    // Evicted windows remain valid
+    auto capacity = getWindowCacheCapacity();
+    setWindowCacheCapacity(20*sizeof(double));
+    EXPECT_LE(getWindowCacheSize(), 20*sizeof(double));
+    ippsNormDiff_Inf_64f(kaiser20.data(), w1->data(), 20, &error);
+    EXPECT_LE(error, 1.e-14);
+    // Concurrent lookups of the same window
+    std::vector<std::shared_ptr<const std::vector<double>>> windows(8);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < static_cast<int> (windows.size()); ++i)
+    {
+        threads.push_back(std::thread([&windows, i]()
+        {
+            windows[i] = getCachedWindow<double>(WindowType::BLACKMAN, 10);
+        }));
+    }
+    for (auto &thread : threads){thread.join();}
+    for (const auto &w : windows){EXPECT_EQ(*w, *windows[0]);}
+    setWindowCacheCapacity(capacity);
+    clearWindowCache();
+    EXPECT_EQ(getWindowCacheSize(), 0u);
+}
+
 }